@@ -0,0 +1,128 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "annotationprocess.h"
+
+AnnotationProcess::AnnotationProcess(QObject *pParent) : HexProcess(pParent)
+{
+    g_mode = MODE_IMPORT;
+    g_pDevice = nullptr;
+    g_nInvalidCount = 0;
+}
+
+void AnnotationProcess::setData(MODE mode, QIODevice *pDevice, const QVector<QHexViewAnnotations::ANNOTATION> &listAnnotations)
+{
+    g_mode = mode;
+    g_pDevice = pDevice;
+    g_listAnnotations = listAnnotations;
+}
+
+QVector<QHexViewAnnotations::ANNOTATION> AnnotationProcess::getResult()
+{
+    return g_listAnnotations;
+}
+
+qint64 AnnotationProcess::getInvalidCount()
+{
+    return g_nInvalidCount;
+}
+
+bool AnnotationProcess::_process()
+{
+    bool bResult = false;
+
+    if (g_mode == MODE_IMPORT) {
+        bResult = _import();
+    } else if (g_mode == MODE_EXPORT) {
+        bResult = _export();
+    }
+
+    return bResult;
+}
+
+bool AnnotationProcess::_import()
+{
+    bool bResult = true;
+
+    g_listAnnotations.clear();
+    g_nInvalidCount = 0;
+
+    setTotal(g_pDevice->size());
+    setStatus(tr("Import"));
+
+    qint32 nLines = 0;
+
+    while ((!g_pDevice->atEnd()) && (!isStopped())) {
+        QByteArray baLine = g_pDevice->readLine();
+        QHexViewAnnotations::ANNOTATION annotation = {};
+
+        if (QHexViewAnnotations::lineToAnnotation(baLine, &annotation)) {
+            g_listAnnotations.append(annotation);
+        } else if ((!baLine.trimmed().isEmpty()) && (!baLine.startsWith(';'))) {
+            g_nInvalidCount++;
+        }
+
+        nLines++;
+
+        if (nLines == N_STATS_LINES) {
+            nLines = 0;
+            setCurrent(g_pDevice->pos());
+        }
+    }
+
+    if (isStopped()) {
+        g_listAnnotations.clear();
+    }
+
+    setCurrent(g_pDevice->pos());
+
+    return bResult;
+}
+
+bool AnnotationProcess::_export()
+{
+    bool bResult = true;
+
+    qint32 nNumberOfAnnotations = g_listAnnotations.count();
+
+    setTotal(nNumberOfAnnotations);
+    setStatus(tr("Export"));
+
+    QByteArray baOut;
+    baOut.reserve(N_BUFFER_SIZE + 0x1000);
+
+    for (qint32 i = 0; (i < nNumberOfAnnotations) && (!isStopped()); i++) {
+        baOut += QHexViewAnnotations::annotationToLine(g_listAnnotations.at(i));
+
+        if ((baOut.size() >= N_BUFFER_SIZE) || (i == nNumberOfAnnotations - 1)) {
+            if (g_pDevice->write(baOut) != baOut.size()) {
+                emit errorMessage(tr("Write error"));
+                bResult = false;
+                break;
+            }
+
+            baOut.resize(0);
+
+            setCurrent(i + 1);
+        }
+    }
+
+    return bResult;
+}
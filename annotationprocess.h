@@ -0,0 +1,60 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef ANNOTATIONPROCESS_H
+#define ANNOTATIONPROCESS_H
+
+#include <QIODevice>
+
+#include "hexprocess.h"
+#include "qhexviewannotations.h"
+
+// Import and export of annotation lists line by line, the file is never loaded at once
+class AnnotationProcess : public HexProcess {
+    Q_OBJECT
+
+public:
+    enum MODE {
+        MODE_IMPORT = 0,
+        MODE_EXPORT
+    };
+
+    explicit AnnotationProcess(QObject *pParent = nullptr);
+    void setData(MODE mode, QIODevice *pDevice, const QVector<QHexViewAnnotations::ANNOTATION> &listAnnotations = QVector<QHexViewAnnotations::ANNOTATION>());
+    QVector<QHexViewAnnotations::ANNOTATION> getResult();  // imported records
+    qint64 getInvalidCount();                              // lines that are not records
+
+protected:
+    bool _process() override;
+
+private:
+    bool _import();
+    bool _export();
+
+    const qint64 N_BUFFER_SIZE = 0x100000;
+    const qint32 N_STATS_LINES = 0x1000;  // progress is updated once per this many lines
+
+    MODE g_mode;
+    QIODevice *g_pDevice;
+    QVector<QHexViewAnnotations::ANNOTATION> g_listAnnotations;
+    qint64 g_nInvalidCount;
+};
+
+#endif  // ANNOTATIONPROCESS_H
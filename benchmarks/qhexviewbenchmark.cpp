@@ -0,0 +1,370 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include <QApplication>
+#include <QImage>
+#include <QtTest>
+
+#include "qhexview.h"
+
+// Bytes are computed from the offset and nothing is stored, so any size can be opened
+class PatternDevice : public QIODevice {
+public:
+    explicit PatternDevice(qint64 nSize, QObject *pParent = nullptr) : QIODevice(pParent)
+    {
+        g_nSize = nSize;
+    }
+
+    qint64 size() const override
+    {
+        return g_nSize;
+    }
+
+    bool isSequential() const override
+    {
+        return false;
+    }
+
+protected:
+    qint64 readData(char *pData, qint64 nMaxSize) override
+    {
+        qint64 nOffset = pos();
+        qint64 nSize = qMax((qint64)0, qMin(nMaxSize, g_nSize - nOffset));
+
+        for (qint64 i = 0; i < nSize; i++) {
+            quint64 nValue = (quint64)(nOffset + i);
+            // Runs of zeros between noise, as in binaries
+            pData[i] = (char)(((nValue >> 6) & 3) ? ((quint32)(nValue * 0x9E3779B1) >> 24) : 0);
+        }
+
+        return nSize;
+    }
+
+    qint64 writeData(const char *pData, qint64 nSize) override
+    {
+        Q_UNUSED(pData)
+        Q_UNUSED(nSize)
+
+        return -1;
+    }
+
+private:
+    qint64 g_nSize;
+};
+
+class QHexViewBenchmark : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void paint_data();
+    void paint();
+    void paintSelection_data();
+    void paintSelection();
+    void paintAnnotations();
+    void adjust_data();
+    void adjust();
+    void goToOffset_data();
+    void goToOffset();
+    void offsetToAddress_data();
+    void offsetToAddress();
+
+private:
+    void _setData(QIODevice *pDevice);
+    void _setLayout(QSize size, qint32 nBytesProLine);
+    void _adjust();
+    void _addLayoutRows();
+    void _addDeviceRows();
+
+    const qint64 N_SMALL_SIZE = 0x4000000;      // 64 MB
+    const qint64 N_LARGE_SIZE = 0x40000000000;  // 4 TB
+
+    PatternDevice *g_pSmallDevice;
+    PatternDevice *g_pLargeDevice;
+    QIODevice *g_pCurrentDevice;
+    QHexView *g_pView;
+};
+
+void QHexViewBenchmark::initTestCase()
+{
+    g_pSmallDevice = new PatternDevice(N_SMALL_SIZE, this);
+    g_pLargeDevice = new PatternDevice(N_LARGE_SIZE, this);
+    g_pCurrentDevice = nullptr;
+
+    QVERIFY(g_pSmallDevice->open(QIODevice::ReadOnly | QIODevice::Unbuffered));
+    QVERIFY(g_pLargeDevice->open(QIODevice::ReadOnly | QIODevice::Unbuffered));
+
+    g_pView = new QHexView;
+    g_pView->show();
+
+    // The font is set and the data is read on the first show
+    QVERIFY(QTest::qWaitForWindowExposed(g_pView));
+}
+
+void QHexViewBenchmark::cleanupTestCase()
+{
+    delete g_pView;
+    g_pView = nullptr;
+}
+
+void QHexViewBenchmark::paint_data()
+{
+    _addLayoutRows();
+}
+
+void QHexViewBenchmark::paint()
+{
+    QFETCH(QSize, size);
+    QFETCH(qint32, nBytesProLine);
+
+    _setData(g_pSmallDevice);
+    _setLayout(size, nBytesProLine);
+
+    QImage image(g_pView->viewport()->size(), QImage::Format_ARGB32_Premultiplied);
+
+    QBENCHMARK {
+        g_pView->viewport()->render(&image);
+    }
+}
+
+void QHexViewBenchmark::paintSelection_data()
+{
+    _addLayoutRows();
+}
+
+void QHexViewBenchmark::paintSelection()
+{
+    QFETCH(QSize, size);
+    QFETCH(qint32, nBytesProLine);
+
+    _setData(g_pSmallDevice);
+    _setLayout(size, nBytesProLine);
+
+    // Begins inside the first line and ends after the page
+    g_pView->setSelection(g_pView->getBaseAddress() + 3, 0x100000);
+    _adjust();
+
+    QImage image(g_pView->viewport()->size(), QImage::Format_ARGB32_Premultiplied);
+
+    QBENCHMARK {
+        g_pView->viewport()->render(&image);
+    }
+
+    g_pView->setSelection(g_pView->getBaseAddress(), 1);
+}
+
+void QHexViewBenchmark::paintAnnotations()
+{
+    _setData(g_pSmallDevice);
+    _setLayout(QSize(1920, 1080), 16);
+
+    // A million ranges, the visible ones are found in the interval tree on adjust
+    QVector<QHexViewAnnotations::ANNOTATION> listAnnotations;
+    qint64 nNumberOfAnnotations = 1000000;
+    qint64 nStride = N_SMALL_SIZE / nNumberOfAnnotations;
+
+    listAnnotations.reserve((qint32)nNumberOfAnnotations);
+
+    for (qint64 i = 0; i < nNumberOfAnnotations; i++) {
+        QHexViewAnnotations::ANNOTATION annotation = {};
+        annotation.nOffset = i * nStride;
+        annotation.nSize = (i % 7) * 5 + 1;
+        annotation.nColor = qRgba(0, 255, 255, 110);
+        annotation.bBookmark = ((i % 100) == 0);
+
+        listAnnotations.append(annotation);
+    }
+
+    g_pView->appendAnnotations(listAnnotations);
+    _adjust();
+
+    QImage image(g_pView->viewport()->size(), QImage::Format_ARGB32_Premultiplied);
+
+    QBENCHMARK {
+        _adjust();
+        g_pView->viewport()->render(&image);
+    }
+
+    g_pView->clearAnnotations();
+}
+
+void QHexViewBenchmark::adjust_data()
+{
+    _addLayoutRows();
+}
+
+void QHexViewBenchmark::adjust()
+{
+    QFETCH(QSize, size);
+    QFETCH(qint32, nBytesProLine);
+
+    _setData(g_pSmallDevice);
+    _setLayout(size, nBytesProLine);
+
+    QBENCHMARK {
+        _adjust();
+    }
+}
+
+void QHexViewBenchmark::goToOffset_data()
+{
+    _addDeviceRows();
+}
+
+void QHexViewBenchmark::goToOffset()
+{
+    QFETCH(bool, bLarge);
+
+    _setData(bLarge ? g_pLargeDevice : g_pSmallDevice);
+    _setLayout(QSize(1280, 800), 16);
+
+    // The scroll bar has int lines, the offsets past it cannot be shown
+    qint64 nLimit = qMin(bLarge ? N_LARGE_SIZE : N_SMALL_SIZE, (qint64)(0x7FFFFFFF - 0x1000) * g_pView->getBytesProLine());
+    qint64 nStep = (nLimit / 97) + 0x1003;
+    qint64 nOffset = 0;
+
+    QBENCHMARK {
+        g_pView->goToOffset(nOffset);
+        _adjust();
+
+        nOffset = (nOffset + nStep) % nLimit;
+    }
+}
+
+void QHexViewBenchmark::offsetToAddress_data()
+{
+    _addDeviceRows();
+}
+
+void QHexViewBenchmark::offsetToAddress()
+{
+    QFETCH(bool, bLarge);
+
+    _setData(bLarge ? g_pLargeDevice : g_pSmallDevice);
+
+    XBinary::_MEMORY_MAP *pMemoryMap = g_pView->getMemoryMap();
+    qint64 nSize = bLarge ? N_LARGE_SIZE : N_SMALL_SIZE;
+    qint64 nStep = nSize / 0x10000;
+    qint64 nSum = 0;
+
+    QBENCHMARK {
+        for (qint64 i = 0; i < 0x10000; i++) {
+            qint64 nAddress = XBinary::offsetToAddress(pMemoryMap, i * nStep);
+
+            nSum += XBinary::addressToOffset(pMemoryMap, nAddress);
+        }
+    }
+
+    QVERIFY(nSum != -1);
+}
+
+void QHexViewBenchmark::_setData(QIODevice *pDevice)
+{
+    if (g_pCurrentDevice != pDevice) {
+        g_pView->setData(pDevice);
+        g_pCurrentDevice = pDevice;
+    }
+}
+
+void QHexViewBenchmark::_setLayout(QSize size, qint32 nBytesProLine)
+{
+    g_pView->resize(size);
+    g_pView->setBytesProLine(nBytesProLine);
+
+    // The fetches started by the resize finish here, the measured calls are not disturbed by them
+    QTest::qWait(50);
+
+    _adjust();
+}
+
+void QHexViewBenchmark::_adjust()
+{
+    // Synchronous layout and read of the visible lines
+    QMetaObject::invokeMethod(g_pView, "adjust", Qt::DirectConnection);
+}
+
+void QHexViewBenchmark::_addLayoutRows()
+{
+    QTest::addColumn<QSize>("size");
+    QTest::addColumn<qint32>("nBytesProLine");
+
+    QList<QSize> listSizes;
+    listSizes.append(QSize(640, 480));
+    listSizes.append(QSize(1280, 800));
+    listSizes.append(QSize(1920, 1080));
+    listSizes.append(QSize(3840, 2160));
+
+    QList<qint32> listBytesProLine;
+    listBytesProLine.append(8);
+    listBytesProLine.append(16);
+    listBytesProLine.append(32);
+    listBytesProLine.append(64);
+
+    for (qint32 i = 0; i < listSizes.count(); i++) {
+        for (qint32 j = 0; j < listBytesProLine.count(); j++) {
+            QString sName = QString("%1x%2/%3").arg(listSizes.at(i).width()).arg(listSizes.at(i).height()).arg(listBytesProLine.at(j));
+
+            QTest::newRow(sName.toLatin1().constData()) << listSizes.at(i) << listBytesProLine.at(j);
+        }
+    }
+}
+
+void QHexViewBenchmark::_addDeviceRows()
+{
+    QTest::addColumn<bool>("bLarge");
+
+    QTest::newRow("64MB") << false;
+    QTest::newRow("4TB") << true;
+}
+
+int main(int argc, char *argv[])
+{
+    // Headless unless a platform is given
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication app(argc, argv);
+
+    QStringList listArguments = app.arguments();
+    bool bOutput = false;
+
+    for (qint32 i = 1; i < listArguments.count(); i++) {
+        QString sArgument = listArguments.at(i);
+
+        if ((sArgument == "-o") || (sArgument == "-txt") || (sArgument == "-csv") || (sArgument == "-xml") || (sArgument == "-lightxml") ||
+            (sArgument == "-junitxml") || (sArgument == "-teamcity") || (sArgument == "-tap")) {
+            bOutput = true;
+        }
+    }
+
+    // Machine-readable by default, to be compared between builds
+    if (!bOutput) {
+        listArguments.append("-o");
+        listArguments.append("-,xml");
+    }
+
+    QHexViewBenchmark benchmark;
+
+    return QTest::qExec(&benchmark, listArguments);
+}
+
+#include "qhexviewbenchmark.moc"
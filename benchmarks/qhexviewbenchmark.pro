@@ -0,0 +1,12 @@
+QT += testlib widgets
+
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+TARGET = qhexviewbenchmark
+TEMPLATE = app
+
+SOURCES += \
+    qhexviewbenchmark.cpp
+
+include(../qhexview.pri)
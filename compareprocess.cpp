@@ -0,0 +1,165 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "compareprocess.h"
+
+CompareProcess::CompareProcess(QObject *pParent) : HexProcess(pParent)
+{
+    g_pDataSource1 = nullptr;
+    g_pDataSource2 = nullptr;
+    g_nDiffStart = -1;
+}
+
+void CompareProcess::setData(QHexViewDataSource *pDataSource1, QHexViewDataSource *pDataSource2)
+{
+    g_pDataSource1 = pDataSource1;
+    g_pDataSource2 = pDataSource2;
+}
+
+QVector<QHexView::RANGE> CompareProcess::getResult()
+{
+    return g_listResult;
+}
+
+bool CompareProcess::_process()
+{
+    bool bResult = false;
+
+    g_listResult.clear();
+    g_nDiffStart = -1;
+
+    if (openSource(g_pDataSource1, 0) && openSource(g_pDataSource2, 1)) {
+        bResult = true;
+
+        qint64 nSize1 = g_pDataSource1->getSize();
+        qint64 nSize2 = g_pDataSource2->getSize();
+        qint64 nCommonSize = qMin(nSize1, nSize2);
+
+        setTotal(nCommonSize);
+        setStatus(tr("Compare"));
+
+        QByteArray baBuffer1;
+        QByteArray baBuffer2;
+        baBuffer1.resize(N_BUFFER_SIZE);
+        baBuffer2.resize(N_BUFFER_SIZE);
+
+        bool bIsSparse = g_pDataSource1->isSparse() && g_pDataSource2->isSparse();
+
+        qint64 nCurrent = 0;
+
+        while ((nCurrent < nCommonSize) && (!isStopped())) {
+            if (bIsSparse) {
+                qint64 nDataOffset1 = g_pDataSource1->getNextData(nCurrent);
+                qint64 nDataOffset2 = g_pDataSource2->getNextData(nCurrent);
+
+                if (nDataOffset1 == -1) {
+                    nDataOffset1 = nCommonSize;
+                }
+
+                if (nDataOffset2 == -1) {
+                    nDataOffset2 = nCommonSize;
+                }
+
+                qint64 nDataOffset = qMin(qMin(nDataOffset1, nDataOffset2), nCommonSize);
+
+                // Holes in both are equal
+                if (nDataOffset > nCurrent) {
+                    if (g_nDiffStart != -1) {
+                        QHexView::RANGE range = {};
+                        range.nOffset = g_nDiffStart;
+                        range.nSize = nCurrent - g_nDiffStart;
+
+                        g_listResult.append(range);
+
+                        g_nDiffStart = -1;
+                    }
+
+                    nCurrent = nDataOffset;
+
+                    setCurrent(nCurrent);
+
+                    continue;
+                }
+            }
+
+            qint32 nBlockSize = (qint32)qMin(nCommonSize - nCurrent, (qint64)N_BUFFER_SIZE);
+
+            if ((readAt(nCurrent, baBuffer1.data(), nBlockSize, 0) != nBlockSize) || (readAt(nCurrent, baBuffer2.data(), nBlockSize, 1) != nBlockSize)) {
+                emit errorMessage(tr("Read error"));
+                bResult = false;
+                break;
+            }
+
+            _compareBlock(baBuffer1.constData(), baBuffer2.constData(), nBlockSize, nCurrent);
+
+            nCurrent += nBlockSize;
+
+            setCurrent(nCurrent);
+        }
+
+        if (bResult && (!isStopped())) {
+            // The tail of the larger device is a difference
+            if (g_nDiffStart == -1) {
+                g_nDiffStart = nCommonSize;
+            }
+
+            qint64 nEnd = qMax(nSize1, nSize2);
+
+            if (nEnd > g_nDiffStart) {
+                QHexView::RANGE range = {};
+                range.nOffset = g_nDiffStart;
+                range.nSize = nEnd - g_nDiffStart;
+
+                g_listResult.append(range);
+            }
+        }
+
+        closeSource();
+    }
+
+    return bResult;
+}
+
+void CompareProcess::_compareBlock(const char *pData1, const char *pData2, qint32 nSize, qint64 nBase)
+{
+    qint32 nCurrent = 0;
+
+    while (nCurrent < nSize) {
+        if (g_nDiffStart == -1) {
+            nCurrent += QHexViewUtils::getEqualSize(pData1 + nCurrent, pData2 + nCurrent, nSize - nCurrent);
+
+            if (nCurrent < nSize) {
+                g_nDiffStart = nBase + nCurrent;
+            }
+        } else {
+            nCurrent += QHexViewUtils::getDiffSize(pData1 + nCurrent, pData2 + nCurrent, nSize - nCurrent);
+
+            if (nCurrent < nSize) {
+                QHexView::RANGE range = {};
+                range.nOffset = g_nDiffStart;
+                range.nSize = nBase + nCurrent - g_nDiffStart;
+
+                g_listResult.append(range);
+
+                g_nDiffStart = -1;
+            }
+        }
+    }
+}
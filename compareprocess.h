@@ -0,0 +1,50 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef COMPAREPROCESS_H
+#define COMPAREPROCESS_H
+
+#include "hexprocess.h"
+#include "qhexview.h"
+#include "qhexviewutils.h"
+
+class CompareProcess : public HexProcess {
+    Q_OBJECT
+
+public:
+    explicit CompareProcess(QObject *pParent = nullptr);
+    void setData(QHexViewDataSource *pDataSource1, QHexViewDataSource *pDataSource2);
+    QVector<QHexView::RANGE> getResult();
+
+protected:
+    bool _process() override;
+
+private:
+    void _compareBlock(const char *pData1, const char *pData2, qint32 nSize, qint64 nBase);
+
+    const qint32 N_BUFFER_SIZE = 0x400000;
+
+    QHexViewDataSource *g_pDataSource1;
+    QHexViewDataSource *g_pDataSource2;
+    qint64 g_nDiffStart;
+    QVector<QHexView::RANGE> g_listResult;
+};
+
+#endif  // COMPAREPROCESS_H
@@ -0,0 +1,403 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "compressedindexprocess.h"
+
+#include <QtEndian>
+#include <zlib.h>
+
+#ifdef QHEXVIEW_ZSTD
+#include <zstd.h>
+#endif
+#ifdef QHEXVIEW_XZ
+#include <lzma.h>
+#endif
+
+CompressedIndexProcess::CompressedIndexProcess(QObject *pParent) : HexProcess(pParent)
+{
+    g_pDataSource = nullptr;
+    g_index = {};
+}
+
+void CompressedIndexProcess::setData(QHexViewDataSource *pDataSource, QHexViewCompressedDataSource::CF format)
+{
+    g_pDataSource = pDataSource;
+    g_index = {};
+    g_index.format = format;
+}
+
+QHexViewCompressedDataSource::INDEX CompressedIndexProcess::getResult()
+{
+    return g_index;
+}
+
+bool CompressedIndexProcess::_process()
+{
+    bool bResult = false;
+
+    if (openSource(g_pDataSource)) {
+        g_index.nCompressedSize = g_pDataSource->getSize();
+        g_index.nUncompressedSize = 0;
+        g_index.listPoints.clear();
+
+        setTotal(g_index.nCompressedSize);
+        setStatus(tr("Index"));
+
+        if ((g_index.format == QHexViewCompressedDataSource::CF_GZIP) || (g_index.format == QHexViewCompressedDataSource::CF_DEFLATE)) {
+            bResult = _buildGzip();
+        } else if (g_index.format == QHexViewCompressedDataSource::CF_ZSTD) {
+            bResult = _buildZstd();
+        } else if (g_index.format == QHexViewCompressedDataSource::CF_XZ) {
+            bResult = _buildXz();
+        }
+
+        if ((!bResult) && (!isStopped())) {
+            emit errorMessage(QString("%1: %2").arg(tr("Cannot read"), QHexViewCompressedDataSource::formatToString(g_index.format)));
+        }
+
+        closeSource();
+    }
+
+    return bResult;
+}
+
+bool CompressedIndexProcess::_buildGzip()
+{
+    bool bResult = false;
+
+    z_stream strm = {};
+
+    bool bRaw = (g_index.format == QHexViewCompressedDataSource::CF_DEFLATE);
+
+    // 47: gzip or zlib header, 32 KiB window
+    if (inflateInit2(&strm, bRaw ? -15 : 47) == Z_OK) {
+        QByteArray baInput(N_READ_SIZE, 0);
+        QByteArray baWindow(N_WINDOW_SIZE, 0);
+
+        qint64 nReadOffset = 0;
+        qint64 nTotalIn = 0;
+        qint64 nTotalOut = 0;
+        qint64 nLast = 0;
+        bool bMemberStart = true;
+        bool bRun = true;
+
+        strm.avail_out = 0;
+
+        if (bRaw) {
+            // No header to stop after, the stream starts with a block
+            QHexViewCompressedDataSource::POINT point = {};
+            point.baWindow = qCompress(baWindow);
+
+            g_index.listPoints.append(point);
+
+            bMemberStart = false;
+        }
+
+        while (bRun && (!isStopped())) {
+            if (strm.avail_in == 0) {
+                qint64 nRead = readAt(nReadOffset, baInput.data(), N_READ_SIZE);
+
+                if (nRead <= 0) {
+                    break;
+                }
+
+                nReadOffset += nRead;
+                strm.next_in = (Bytef *)baInput.data();
+                strm.avail_in = (uInt)nRead;
+
+                setCurrent(nReadOffset);
+            }
+
+            // The output buffer is the circular 32 KiB history, the seek points copy it
+            if (strm.avail_out == 0) {
+                strm.next_out = (Bytef *)baWindow.data();
+                strm.avail_out = (uInt)N_WINDOW_SIZE;
+            }
+
+            nTotalIn += strm.avail_in;
+            nTotalOut += strm.avail_out;
+
+            int nRet = inflate(&strm, Z_BLOCK);
+
+            nTotalIn -= strm.avail_in;
+            nTotalOut -= strm.avail_out;
+
+            if (nRet == Z_STREAM_END) {
+                if (bRaw || ((strm.avail_in == 0) && (nReadOffset >= g_index.nCompressedSize))) {
+                    bResult = true;
+                    bRun = false;
+                } else {
+                    // Concatenated members
+                    inflateReset(&strm);
+                    bMemberStart = true;
+                }
+            } else if ((nRet == Z_NEED_DICT) || (nRet == Z_DATA_ERROR) || (nRet == Z_MEM_ERROR)) {
+                // Trailing garbage after a complete member is ignored
+                bResult = bMemberStart && g_index.listPoints.count();
+                bRun = false;
+            } else if ((strm.data_type & 128) && (!(strm.data_type & 64)) && (bMemberStart || (nTotalOut - nLast > N_SPAN_SIZE))) {
+                QHexViewCompressedDataSource::POINT point = {};
+                point.nOutOffset = nTotalOut;
+                point.nInOffset = nTotalIn;
+                point.nBits = strm.data_type & 7;
+
+                QByteArray baHistory(N_WINDOW_SIZE, 0);
+                qint32 nLeft = (qint32)strm.avail_out;
+
+                if (nLeft) {
+                    memcpy(baHistory.data(), baWindow.constData() + N_WINDOW_SIZE - nLeft, nLeft);
+                }
+
+                if (nLeft < N_WINDOW_SIZE) {
+                    memcpy(baHistory.data() + nLeft, baWindow.constData(), N_WINDOW_SIZE - nLeft);
+                }
+
+                point.baWindow = qCompress(baHistory);
+
+                g_index.listPoints.append(point);
+
+                nLast = nTotalOut;
+                bMemberStart = false;
+            }
+        }
+
+        inflateEnd(&strm);
+
+        g_index.nUncompressedSize = nTotalOut;
+    }
+
+    return bResult;
+}
+
+bool CompressedIndexProcess::_buildZstd()
+{
+    bool bResult = false;
+
+#ifdef QHEXVIEW_ZSTD
+    // Seekable format: the frame table is stored in a skippable frame at the end
+    bResult = _readZstdSeekTable();
+
+    if (!bResult) {
+        ZSTD_DCtx *pContext = ZSTD_createDCtx();
+
+        if (pContext) {
+            QByteArray baInput(N_READ_SIZE, 0);
+            QByteArray baOutput((qint32)ZSTD_DStreamOutSize(), 0);
+
+            qint64 nReadOffset = 0;
+            qint64 nBufferOffset = 0;
+            qint64 nTotalOut = 0;
+            qint64 nFrameIn = 0;
+            qint64 nFrameOut = 0;
+            bool bFrameStart = true;
+            bool bValid = true;
+
+            ZSTD_inBuffer input = {baInput.data(), 0, 0};
+
+            while (bValid && (!isStopped())) {
+                if (input.pos == input.size) {
+                    qint64 nRead = readAt(nReadOffset, baInput.data(), N_READ_SIZE);
+
+                    if (nRead <= 0) {
+                        break;
+                    }
+
+                    nBufferOffset = nReadOffset;
+                    nReadOffset += nRead;
+                    input.size = (size_t)nRead;
+                    input.pos = 0;
+
+                    setCurrent(nReadOffset);
+                }
+
+                if (bFrameStart) {
+                    nFrameIn = nBufferOffset + (qint64)input.pos;
+                    nFrameOut = nTotalOut;
+                    bFrameStart = false;
+                }
+
+                ZSTD_outBuffer output = {baOutput.data(), (size_t)baOutput.size(), 0};
+
+                size_t nRet = ZSTD_decompressStream(pContext, &output, &input);
+
+                if (ZSTD_isError(nRet)) {
+                    bValid = false;
+                } else {
+                    nTotalOut += (qint64)output.pos;
+
+                    if (nRet == 0) {
+                        // Skippable frames have no output
+                        if (nTotalOut > nFrameOut) {
+                            QHexViewCompressedDataSource::POINT point = {};
+                            point.nOutOffset = nFrameOut;
+                            point.nInOffset = nFrameIn;
+                            point.nInSize = nBufferOffset + (qint64)input.pos - nFrameIn;
+
+                            g_index.listPoints.append(point);
+                        }
+
+                        bFrameStart = true;
+                    }
+                }
+            }
+
+            ZSTD_freeDCtx(pContext);
+
+            g_index.nUncompressedSize = nTotalOut;
+
+            bResult = bValid && bFrameStart && (!isStopped());
+        }
+    }
+#endif
+
+    return bResult;
+}
+
+bool CompressedIndexProcess::_readZstdSeekTable()
+{
+    bool bResult = false;
+
+    const qint64 nFooterSize = 9;
+    qint64 nSize = g_index.nCompressedSize;
+
+    if (nSize > 8 + nFooterSize) {
+        quint8 footer[9] = {};
+
+        if (readAt(nSize - nFooterSize, (char *)footer, nFooterSize) == nFooterSize) {
+            quint32 nNumberOfFrames = qFromLittleEndian<quint32>(footer);
+            quint8 nDescriptor = footer[4];
+            quint32 nMagic = qFromLittleEndian<quint32>(footer + 5);
+
+            qint64 nEntrySize = (nDescriptor & 0x80) ? 12 : 8;
+            qint64 nTableSize = nNumberOfFrames * nEntrySize + nFooterSize;
+
+            if ((nMagic == 0x8F92EAB1) && (8 + nTableSize <= nSize)) {
+                QByteArray baTable(8 + nTableSize, 0);
+
+                if (readAt(nSize - baTable.size(), baTable.data(), baTable.size()) == baTable.size()) {
+                    const quint8 *pTable = (const quint8 *)baTable.constData();
+
+                    if ((qFromLittleEndian<quint32>(pTable) == 0x184D2A5E) && (qFromLittleEndian<quint32>(pTable + 4) == nTableSize)) {
+                        qint64 nInOffset = 0;
+                        qint64 nOutOffset = 0;
+
+                        for (quint32 i = 0; i < nNumberOfFrames; i++) {
+                            const quint8 *pEntry = pTable + 8 + i * nEntrySize;
+
+                            QHexViewCompressedDataSource::POINT point = {};
+                            point.nOutOffset = nOutOffset;
+                            point.nInOffset = nInOffset;
+                            point.nInSize = qFromLittleEndian<quint32>(pEntry);
+
+                            qint64 nFrameSize = qFromLittleEndian<quint32>(pEntry + 4);
+
+                            if (nFrameSize) {
+                                g_index.listPoints.append(point);
+                            }
+
+                            nInOffset += point.nInSize;
+                            nOutOffset += nFrameSize;
+                        }
+
+                        g_index.nUncompressedSize = nOutOffset;
+
+                        bResult = (nInOffset + baTable.size() == nSize);
+                    }
+                }
+            }
+        }
+    }
+
+    if (!bResult) {
+        g_index.listPoints.clear();
+        g_index.nUncompressedSize = 0;
+    }
+
+    return bResult;
+}
+
+bool CompressedIndexProcess::_buildXz()
+{
+    bool bResult = false;
+
+#ifdef QHEXVIEW_XZ
+    lzma_stream strm = LZMA_STREAM_INIT;
+    lzma_index *pIndex = nullptr;
+
+    // Only the stream footers and indexes are read, the decoder asks for the positions it needs
+    if (lzma_file_info_decoder(&strm, &pIndex, UINT64_MAX, (uint64_t)g_index.nCompressedSize) == LZMA_OK) {
+        QByteArray baInput(N_READ_SIZE, 0);
+
+        qint64 nReadOffset = 0;
+        lzma_ret ret = LZMA_OK;
+
+        while ((ret == LZMA_OK) && (!isStopped())) {
+            if (strm.avail_in == 0) {
+                qint64 nRead = readAt(nReadOffset, baInput.data(), N_READ_SIZE);
+
+                if (nRead <= 0) {
+                    break;
+                }
+
+                nReadOffset += nRead;
+                strm.next_in = (const uint8_t *)baInput.constData();
+                strm.avail_in = (size_t)nRead;
+
+                setCurrent(nReadOffset);
+            }
+
+            ret = lzma_code(&strm, LZMA_RUN);
+
+            if (ret == LZMA_SEEK_NEEDED) {
+                nReadOffset = (qint64)strm.seek_pos;
+                strm.avail_in = 0;
+                ret = LZMA_OK;
+            }
+        }
+
+        if ((ret == LZMA_STREAM_END) && pIndex) {
+            lzma_index_iter iter;
+            lzma_index_iter_init(&iter, pIndex);
+
+            while (!lzma_index_iter_next(&iter, LZMA_INDEX_ITER_NONEMPTY_BLOCK)) {
+                QHexViewCompressedDataSource::POINT point = {};
+                point.nOutOffset = (qint64)iter.block.uncompressed_file_offset;
+                point.nInOffset = (qint64)iter.block.compressed_file_offset;
+                point.nInSize = (qint64)iter.block.total_size;
+                point.nBits = (qint32)iter.stream.flags->check;
+
+                g_index.listPoints.append(point);
+            }
+
+            g_index.nUncompressedSize = (qint64)lzma_index_uncompressed_size(pIndex);
+
+            bResult = true;
+        }
+
+        if (pIndex) {
+            lzma_index_end(pIndex, nullptr);
+        }
+    }
+
+    lzma_end(&strm);
+#endif
+
+    return bResult;
+}
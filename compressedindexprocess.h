@@ -0,0 +1,52 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef COMPRESSEDINDEXPROCESS_H
+#define COMPRESSEDINDEXPROCESS_H
+
+#include "hexprocess.h"
+#include "qhexviewcompresseddatasource.h"
+
+class CompressedIndexProcess : public HexProcess {
+    Q_OBJECT
+
+public:
+    explicit CompressedIndexProcess(QObject *pParent = nullptr);
+    void setData(QHexViewDataSource *pDataSource, QHexViewCompressedDataSource::CF format);
+    QHexViewCompressedDataSource::INDEX getResult();
+
+protected:
+    bool _process() override;
+
+private:
+    bool _buildGzip();
+    bool _buildZstd();
+    bool _readZstdSeekTable();
+    bool _buildXz();
+
+    const qint64 N_READ_SIZE = 0x100000;
+    const qint64 N_SPAN_SIZE = 0x100000;  // output bytes between gzip seek points
+    const qint32 N_WINDOW_SIZE = 0x8000;
+
+    QHexViewDataSource *g_pDataSource;
+    QHexViewCompressedDataSource::INDEX g_index;
+};
+
+#endif  // COMPRESSEDINDEXPROCESS_H
@@ -36,6 +36,20 @@ DialogHex::DialogHex(QWidget *pParent, QIODevice *pDevice, QHexView::OPTIONS *pO
     ui->widgetHex->setData(pDevice, pOptions);
 }
 
+DialogHex::DialogHex(QWidget *pParent, QHexViewDataSource *pDataSource, QHexView::OPTIONS *pOptions) : QDialog(pParent), ui(new Ui::DialogHex)
+{
+    ui->setupUi(this);
+
+    setWindowFlags(Qt::Window);
+
+    connect(ui->widgetHex, SIGNAL(editState(bool)), this, SIGNAL(editState(bool)));
+
+    ui->widgetHex->enableHeader(true);
+    ui->widgetHex->enableReadOnly(true);
+
+    ui->widgetHex->setDataSource(pDataSource, pOptions);
+}
+
 DialogHex::~DialogHex()
 {
     delete ui;
@@ -24,6 +24,7 @@
 #include <QDialog>
 
 #include "qhexview.h"
+#include "qhexviewdatasource.h"
 
 namespace Ui {
 class DialogHex;
@@ -34,6 +35,7 @@ class DialogHex : public QDialog {
 
 public:
     explicit DialogHex(QWidget *pParent, QIODevice *pDevice, QHexView::OPTIONS *pOptions = nullptr);
+    explicit DialogHex(QWidget *pParent, QHexViewDataSource *pDataSource, QHexView::OPTIONS *pOptions = nullptr);
     ~DialogHex();
 
 signals:
@@ -0,0 +1,155 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "dialoghexcompare.h"
+
+#include "ui_dialoghexcompare.h"
+
+DialogHexCompare::DialogHexCompare(QWidget *pParent, QIODevice *pDevice1, QIODevice *pDevice2) : QDialog(pParent), ui(new Ui::DialogHexCompare)
+{
+    ui->setupUi(this);
+
+    ui->scrollAreaHex1->setData(pDevice1);
+    ui->scrollAreaHex2->setData(pDevice2);
+
+    _init();
+}
+
+DialogHexCompare::DialogHexCompare(QWidget *pParent, QHexViewDataSource *pDataSource1, QIODevice *pDevice2) : QDialog(pParent), ui(new Ui::DialogHexCompare)
+{
+    ui->setupUi(this);
+
+    ui->scrollAreaHex1->setDataSource(pDataSource1);
+    ui->scrollAreaHex2->setData(pDevice2);
+
+    _init();
+}
+
+DialogHexCompare::~DialogHexCompare()
+{
+    delete ui;
+}
+
+void DialogHexCompare::_init()
+{
+    setWindowFlags(Qt::Window);
+
+    g_bSyncScroll = false;
+
+    // Locked scrolling
+    connect(ui->scrollAreaHex1->verticalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(verticalScroll1(int)));
+    connect(ui->scrollAreaHex2->verticalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(verticalScroll2(int)));
+    connect(ui->scrollAreaHex1->horizontalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(horizontalScroll1(int)));
+    connect(ui->scrollAreaHex2->horizontalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(horizontalScroll2(int)));
+
+    ui->pushButtonPrev->setEnabled(false);
+    ui->pushButtonNext->setEnabled(false);
+}
+
+void DialogHexCompare::on_pushButtonCompare_clicked()
+{
+    CompareProcess compareProcess;
+    compareProcess.setData(ui->scrollAreaHex1->getDataSource(), ui->scrollAreaHex2->getDataSource());
+
+    DialogHexProcess dhp(this, &compareProcess, tr("Compare"));
+
+    if (dhp.exec() == QDialog::Accepted) {
+        g_listDiffRanges = compareProcess.getResult();
+
+        ui->scrollAreaHex1->setDiffRanges(g_listDiffRanges);
+        ui->scrollAreaHex2->setDiffRanges(g_listDiffRanges);
+
+        ui->labelStatus->setText(QString("%1: %2").arg(tr("Differences"), QString::number(g_listDiffRanges.count())));
+
+        ui->pushButtonPrev->setEnabled(g_listDiffRanges.count());
+        ui->pushButtonNext->setEnabled(g_listDiffRanges.count());
+    }
+}
+
+void DialogHexCompare::on_pushButtonPrev_clicked()
+{
+    QHexView::STATE state = ui->scrollAreaHex1->getState();
+
+    _goToDiff(ui->scrollAreaHex1->getPrevDiffOffset(state.nCursorOffset));
+}
+
+void DialogHexCompare::on_pushButtonNext_clicked()
+{
+    QHexView::STATE state = ui->scrollAreaHex1->getState();
+
+    _goToDiff(ui->scrollAreaHex1->getNextDiffOffset(state.nCursorOffset));
+}
+
+void DialogHexCompare::on_pushButtonClose_clicked()
+{
+    this->close();
+}
+
+void DialogHexCompare::verticalScroll1(int nValue)
+{
+    _syncScroll(ui->scrollAreaHex2->verticalScrollBar(), nValue);
+}
+
+void DialogHexCompare::verticalScroll2(int nValue)
+{
+    _syncScroll(ui->scrollAreaHex1->verticalScrollBar(), nValue);
+}
+
+void DialogHexCompare::horizontalScroll1(int nValue)
+{
+    _syncScroll(ui->scrollAreaHex2->horizontalScrollBar(), nValue);
+}
+
+void DialogHexCompare::horizontalScroll2(int nValue)
+{
+    _syncScroll(ui->scrollAreaHex1->horizontalScrollBar(), nValue);
+}
+
+void DialogHexCompare::_syncScroll(QScrollBar *pScrollBar, int nValue)
+{
+    // The shorter view stops at its end and does not pull the other one back
+    if ((!g_bSyncScroll) && (pScrollBar->value() != nValue)) {
+        g_bSyncScroll = true;
+        pScrollBar->setValue(nValue);
+        g_bSyncScroll = false;
+    }
+}
+
+void DialogHexCompare::_goToDiff(qint64 nOffset)
+{
+    if (nOffset != -1) {
+        QHexView *pViews[2] = {ui->scrollAreaHex1, ui->scrollAreaHex2};
+
+        // A difference past the end of the shorter data is shown at its last byte
+        g_bSyncScroll = true;
+
+        for (qint32 i = 0; i < 2; i++) {
+            qint64 nSize = pViews[i]->getDataSource() ? pViews[i]->getDataSource()->getSize() : 0;
+
+            if (nSize > 0) {
+                pViews[i]->goToOffset(qMin(nOffset, nSize - 1));
+            }
+        }
+
+        g_bSyncScroll = false;
+
+        ui->scrollAreaHex1->setFocus();
+    }
+}
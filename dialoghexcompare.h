@@ -0,0 +1,62 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef DIALOGHEXCOMPARE_H
+#define DIALOGHEXCOMPARE_H
+
+#include <QDialog>
+
+#include "compareprocess.h"
+#include "dialoghexprocess.h"
+#include "qhexview.h"
+
+namespace Ui {
+class DialogHexCompare;
+}
+
+class DialogHexCompare : public QDialog {
+    Q_OBJECT
+
+public:
+    explicit DialogHexCompare(QWidget *pParent, QIODevice *pDevice1, QIODevice *pDevice2);
+    explicit DialogHexCompare(QWidget *pParent, QHexViewDataSource *pDataSource1, QIODevice *pDevice2);  // the data of a view with a file
+    ~DialogHexCompare();
+
+private slots:
+    void on_pushButtonCompare_clicked();
+    void on_pushButtonPrev_clicked();
+    void on_pushButtonNext_clicked();
+    void on_pushButtonClose_clicked();
+    void verticalScroll1(int nValue);
+    void verticalScroll2(int nValue);
+    void horizontalScroll1(int nValue);
+    void horizontalScroll2(int nValue);
+
+private:
+    void _init();
+    void _goToDiff(qint64 nOffset);
+    void _syncScroll(QScrollBar *pScrollBar, int nValue);
+
+    Ui::DialogHexCompare *ui;
+    QVector<QHexView::RANGE> g_listDiffRanges;
+    bool g_bSyncScroll;  // the other view is being moved, not followed back
+};
+
+#endif  // DIALOGHEXCOMPARE_H
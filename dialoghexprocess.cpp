@@ -0,0 +1,91 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "dialoghexprocess.h"
+
+#include "ui_dialoghexprocess.h"
+
+DialogHexProcess::DialogHexProcess(QWidget *pParent, HexProcess *pProcess, QString sTitle) : QDialog(pParent), ui(new Ui::DialogHexProcess)
+{
+    ui->setupUi(this);
+
+    setWindowTitle(sTitle);
+
+    g_pProcess = pProcess;
+    g_pThread = new QThread;
+
+    g_pProcess->moveToThread(g_pThread);
+
+    connect(g_pThread, SIGNAL(started()), g_pProcess, SLOT(process()));
+    connect(g_pProcess, SIGNAL(completed(qint64)), this, SLOT(onCompleted(qint64)));
+    connect(g_pProcess, SIGNAL(errorMessage(QString)), this, SLOT(errorMessage(QString)));
+
+    g_pTimer = new QTimer(this);
+    connect(g_pTimer, SIGNAL(timeout()), this, SLOT(timerSlot()));
+
+    g_pThread->start();
+    g_pTimer->start(N_REFRESH_INTERVAL);
+}
+
+DialogHexProcess::~DialogHexProcess()
+{
+    g_pProcess->stop();
+
+    g_pThread->quit();
+    g_pThread->wait();
+
+    delete g_pThread;
+
+    delete ui;
+}
+
+void DialogHexProcess::on_pushButtonCancel_clicked()
+{
+    g_pProcess->stop();
+}
+
+void DialogHexProcess::errorMessage(QString sText)
+{
+    QMessageBox::critical(this, tr("Error"), sText);
+}
+
+void DialogHexProcess::onCompleted(qint64 nElapsed)
+{
+    Q_UNUSED(nElapsed)
+
+    g_pTimer->stop();
+
+    if (g_pProcess->isSuccess()) {
+        accept();
+    } else {
+        reject();
+    }
+}
+
+void DialogHexProcess::timerSlot()
+{
+    HexProcess::STATS stats = g_pProcess->getCurrentStats();
+
+    ui->labelStatus->setText(stats.sStatus);
+
+    if (stats.nTotal) {
+        ui->progressBar->setValue((int)((stats.nCurrent * 100) / stats.nTotal));
+    }
+}
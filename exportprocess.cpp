@@ -0,0 +1,473 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "exportprocess.h"
+
+#ifdef Q_PROCESSOR_X86_64
+#include <emmintrin.h>
+#endif
+
+#if defined(Q_PROCESSOR_X86_64) && (defined(Q_CC_GNU) || defined(Q_CC_CLANG) || defined(Q_CC_MSVC))
+#define EXPORTPROCESS_SSSE3
+#include <immintrin.h>
+#ifdef Q_CC_MSVC
+#include <intrin.h>
+#define EXPORTPROCESS_TARGET_SSSE3
+#else
+#define EXPORTPROCESS_TARGET_SSSE3 __attribute__((target("ssse3")))
+#endif
+#endif
+
+static const char g_szBase64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+#ifdef EXPORTPROCESS_SSSE3
+static bool _isSSSE3()
+{
+    static const bool bResult = []() {
+#ifdef Q_CC_MSVC
+        int cpuInfo[4] = {};
+        __cpuid(cpuInfo, 1);
+        return (cpuInfo[2] & (1 << 9)) != 0;
+#else
+        return (bool)__builtin_cpu_supports("ssse3");
+#endif
+    }();
+
+    return bResult;
+}
+
+// 12 bytes to 16 characters per step, W. Mula's shuffle/multiply split and pshufb lookup. Returns the number of bytes encoded
+EXPORTPROCESS_TARGET_SSSE3 static qint64 _toBase64Ssse3(const quint8 *pData, qint64 nSize, char *pOut)
+{
+    const __m128i shuffle = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+    const __m128i shiftLUT = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                           '/' - 63, 'A', 0, 0);
+
+    qint64 i = 0;
+
+    // 16 bytes are loaded for 12
+    for (; i + 16 <= nSize; i += 12) {
+        __m128i input = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(pData + i)), shuffle);
+
+        __m128i t0 = _mm_and_si128(input, _mm_set1_epi32(0x0fc0fc00));
+        __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+        __m128i t2 = _mm_and_si128(input, _mm_set1_epi32(0x003f03f0));
+        __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+        __m128i indices = _mm_or_si128(t1, t3);
+
+        __m128i result = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+        __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+        result = _mm_or_si128(result, _mm_and_si128(less, _mm_set1_epi8(13)));
+        result = _mm_shuffle_epi8(shiftLUT, result);
+
+        _mm_storeu_si128((__m128i *)(pOut + (i / 3) * 4), _mm_add_epi8(result, indices));
+    }
+
+    return i;
+}
+#endif
+
+ExportProcess::ExportProcess(QObject *pParent) : HexProcess(pParent)
+{
+    g_pDataSource = nullptr;
+    g_nOffset = 0;
+    g_nSize = 0;
+    g_format = EF_HEX;
+    g_pOutput = nullptr;
+    g_nAddress = 0;
+    g_nUpperAddress = 0;
+}
+
+void ExportProcess::setData(QHexViewDataSource *pDataSource, qint64 nOffset, qint64 nSize, EF format, QIODevice *pOutput, qint64 nAddress)
+{
+    g_pDataSource = pDataSource;
+    g_nOffset = nOffset;
+    g_nSize = nSize;
+    g_format = format;
+    g_pOutput = pOutput;
+    g_nAddress = nAddress;
+}
+
+QList<ExportProcess::EF> ExportProcess::getFormats()
+{
+    QList<EF> listResult;
+
+    listResult.append(EF_HEX);
+    listResult.append(EF_XXD);
+    listResult.append(EF_C);
+    listResult.append(EF_PYTHON);
+    listResult.append(EF_RUST);
+    listResult.append(EF_BASE64);
+    listResult.append(EF_INTELHEX);
+
+    return listResult;
+}
+
+QString ExportProcess::formatToString(EF format)
+{
+    QString sResult = tr("Unknown");
+
+    switch (format) {
+        case EF_HEX: sResult = tr("Hex"); break;
+        case EF_XXD: sResult = QString("xxd"); break;
+        case EF_C: sResult = tr("C array"); break;
+        case EF_PYTHON: sResult = tr("Python bytes"); break;
+        case EF_RUST: sResult = tr("Rust array"); break;
+        case EF_BASE64: sResult = QString("Base64"); break;
+        case EF_INTELHEX: sResult = QString("Intel HEX"); break;
+    }
+
+    return sResult;
+}
+
+QString ExportProcess::getFileSuffix(EF format)
+{
+    QString sResult = QString("txt");
+
+    switch (format) {
+        case EF_C: sResult = QString("c"); break;
+        case EF_PYTHON: sResult = QString("py"); break;
+        case EF_RUST: sResult = QString("rs"); break;
+        case EF_BASE64: sResult = QString("b64"); break;
+        case EF_INTELHEX: sResult = QString("hex"); break;
+        default: break;
+    }
+
+    return sResult;
+}
+
+qint64 ExportProcess::getOutputSize(EF format, qint64 nSize)
+{
+    qint64 nResult = 0;
+
+    switch (format) {
+        case EF_HEX: nResult = nSize * 2; break;
+        case EF_XXD: nResult = ((nSize + 15) / 16) * 84; break;
+        case EF_C:
+        case EF_PYTHON:
+        case EF_RUST: nResult = nSize * 6 + ((nSize + 11) / 12) * 6 + 64; break;
+        case EF_BASE64: nResult = ((nSize + 56) / 57) * 77; break;
+        case EF_INTELHEX: nResult = ((nSize + 15) / 16 + 1) * 44 + (nSize / 0x10000 + 2) * 17 + 16; break;
+    }
+
+    return nResult;
+}
+
+void ExportProcess::toHex(const char *pData, qint64 nSize, char *pOut)
+{
+    static const char szDigits[] = "0123456789abcdef";
+
+    qint64 i = 0;
+
+#ifdef Q_PROCESSOR_X86_64
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i digit = _mm_set1_epi8('0');
+    const __m128i letter = _mm_set1_epi8('a' - '0' - 10);
+
+    for (; i + 16 <= nSize; i += 16) {
+        __m128i value = _mm_loadu_si128((const __m128i *)(pData + i));
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(value, 4), mask);
+        __m128i lo = _mm_and_si128(value, mask);
+
+        hi = _mm_add_epi8(_mm_add_epi8(hi, digit), _mm_and_si128(_mm_cmpgt_epi8(hi, nine), letter));
+        lo = _mm_add_epi8(_mm_add_epi8(lo, digit), _mm_and_si128(_mm_cmpgt_epi8(lo, nine), letter));
+
+        _mm_storeu_si128((__m128i *)(pOut + i * 2), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i *)(pOut + i * 2 + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+#endif
+
+    for (; i < nSize; i++) {
+        quint8 nByte = (quint8)pData[i];
+
+        pOut[i * 2] = szDigits[nByte >> 4];
+        pOut[i * 2 + 1] = szDigits[nByte & 0x0F];
+    }
+}
+
+qint64 ExportProcess::toBase64(const char *pData, qint64 nSize, char *pOut)
+{
+    const quint8 *_pData = (const quint8 *)pData;
+
+    qint64 i = 0;
+
+#ifdef EXPORTPROCESS_SSSE3
+    if (_isSSSE3()) {
+        i = _toBase64Ssse3(_pData, nSize, pOut);
+    }
+#endif
+
+    char *_pOut = pOut + (i / 3) * 4;
+
+    for (; i + 3 <= nSize; i += 3) {
+        quint32 nGroup = (_pData[i] << 16) | (_pData[i + 1] << 8) | _pData[i + 2];
+
+        _pOut[0] = g_szBase64[(nGroup >> 18) & 0x3F];
+        _pOut[1] = g_szBase64[(nGroup >> 12) & 0x3F];
+        _pOut[2] = g_szBase64[(nGroup >> 6) & 0x3F];
+        _pOut[3] = g_szBase64[nGroup & 0x3F];
+        _pOut += 4;
+    }
+
+    if (i < nSize) {
+        quint32 nGroup = _pData[i] << 16;
+
+        if (i + 1 < nSize) {
+            nGroup |= _pData[i + 1] << 8;
+        }
+
+        _pOut[0] = g_szBase64[(nGroup >> 18) & 0x3F];
+        _pOut[1] = g_szBase64[(nGroup >> 12) & 0x3F];
+        _pOut[2] = (i + 1 < nSize) ? g_szBase64[(nGroup >> 6) & 0x3F] : '=';
+        _pOut[3] = '=';
+        _pOut += 4;
+    }
+
+    return _pOut - pOut;
+}
+
+bool ExportProcess::_process()
+{
+    bool bResult = false;
+
+    g_nUpperAddress = 0;
+
+    setTotal(g_nSize);
+    setStatus(tr("Export"));
+
+    if ((g_format == EF_INTELHEX) && ((g_nAddress < 0) || (g_nAddress + g_nSize > N_INTELHEX_LIMIT))) {
+        // 32-bit addresses: extended linear address records cannot go further
+        emit errorMessage(tr("Intel HEX addresses are limited to 4 GiB"));
+    } else if (openSource(g_pDataSource)) {
+        QByteArray baHeader = _getHeader();
+
+        bResult = (g_pOutput->write(baHeader) == baHeader.size());
+
+        qint32 nBytesProLine = _getBytesProLine();
+        // Intel HEX records do not cross 16-byte address boundaries
+        qint64 nOrigin = (g_format == EF_INTELHEX) ? (g_nAddress % nBytesProLine) : 0;
+        qint64 nBlockSize = (N_BUFFER_SIZE / nBytesProLine) * nBytesProLine;
+
+        QByteArray baBuffer(nBlockSize, 0);
+        QByteArray baOut;
+        baOut.reserve(getOutputSize(g_format, nBlockSize));
+
+        qint64 nCurrent = 0;
+
+        while (bResult && (nCurrent < g_nSize) && (!isStopped())) {
+            // Blocks end on a line boundary
+            qint64 nSize = qMin(g_nSize - nCurrent, nBlockSize - ((nOrigin + nCurrent) % nBytesProLine));
+            char *pBuffer = baBuffer.data();
+
+            if (readAt(g_nOffset + nCurrent, pBuffer, nSize) != nSize) {
+                emit errorMessage(tr("Read error"));
+                bResult = false;
+                break;
+            }
+
+            baOut.resize(0);
+
+            qint64 nPosition = 0;
+
+            while (nPosition < nSize) {
+                qint64 nRelOffset = nCurrent + nPosition;
+                qint32 nLineSize = (qint32)qMin(nBytesProLine - ((nOrigin + nRelOffset) % nBytesProLine), nSize - nPosition);
+
+                _formatLine(pBuffer + nPosition, nLineSize, nRelOffset, (nRelOffset + nLineSize == g_nSize), &baOut);
+
+                nPosition += nLineSize;
+            }
+
+            if (g_pOutput->write(baOut) != baOut.size()) {
+                emit errorMessage(tr("Write error"));
+                bResult = false;
+                break;
+            }
+
+            nCurrent += nSize;
+
+            setCurrent(nCurrent);
+        }
+
+        if (bResult && (!isStopped())) {
+            QByteArray baFooter = _getFooter();
+
+            if (g_pOutput->write(baFooter) != baFooter.size()) {
+                emit errorMessage(tr("Write error"));
+                bResult = false;
+            }
+        }
+
+        closeSource();
+    }
+
+    return bResult;
+}
+
+qint32 ExportProcess::_getBytesProLine()
+{
+    qint32 nResult = 16;
+
+    switch (g_format) {
+        case EF_HEX: nResult = 0x1000; break;  // no line breaks
+        case EF_C:
+        case EF_PYTHON:
+        case EF_RUST: nResult = 12; break;
+        case EF_BASE64: nResult = 57; break;  // 76 characters
+        default: break;
+    }
+
+    return nResult;
+}
+
+QByteArray ExportProcess::_getHeader()
+{
+    QByteArray baResult;
+
+    if (g_format == EF_C) {
+        baResult = QString("unsigned char data[%1] = {\n").arg(g_nSize).toLatin1();
+    } else if (g_format == EF_PYTHON) {
+        baResult = "data = bytes([\n";
+    } else if (g_format == EF_RUST) {
+        baResult = QString("pub const DATA: [u8; %1] = [\n").arg(g_nSize).toLatin1();
+    }
+
+    return baResult;
+}
+
+QByteArray ExportProcess::_getFooter()
+{
+    QByteArray baResult;
+
+    if (g_format == EF_C) {
+        baResult = "};\n";
+    } else if (g_format == EF_PYTHON) {
+        baResult = "])\n";
+    } else if (g_format == EF_RUST) {
+        baResult = "];\n";
+    } else if (g_format == EF_INTELHEX) {
+        baResult = ":00000001FF\n";
+    }
+
+    return baResult;
+}
+
+void ExportProcess::_formatLine(const char *pData, qint32 nSize, qint64 nRelOffset, bool bIsLast, QByteArray *pbaOut)
+{
+    qint32 nStart = pbaOut->size();
+
+    if (g_format == EF_HEX) {
+        pbaOut->resize(nStart + nSize * 2);
+        toHex(pData, nSize, pbaOut->data() + nStart);
+    } else if (g_format == EF_XXD) {
+        // 00000010: 0011 2233 4455 6677 8899 aabb ccdd eeff  ................
+        char szHex[32];
+        toHex(pData, nSize, szHex);
+
+        pbaOut->append(QString("%1: ").arg(g_nAddress + nRelOffset, 8, 16, QChar('0')).toLatin1());
+
+        for (qint32 i = 0; i < 16; i++) {
+            if (i < nSize) {
+                pbaOut->append(szHex + i * 2, 2);
+            } else {
+                pbaOut->append("  ");
+            }
+
+            if ((i % 2) && (i != 15)) {
+                pbaOut->append(' ');
+            }
+        }
+
+        pbaOut->append("  ");
+
+        for (qint32 i = 0; i < nSize; i++) {
+            char cChar = pData[i];
+
+            pbaOut->append(((cChar >= 0x20) && (cChar < 0x7F)) ? cChar : '.');
+        }
+
+        pbaOut->append('\n');
+    } else if ((g_format == EF_C) || (g_format == EF_PYTHON) || (g_format == EF_RUST)) {
+        char szHex[24];
+        toHex(pData, nSize, szHex);
+
+        pbaOut->append("    ");
+
+        for (qint32 i = 0; i < nSize; i++) {
+            pbaOut->append("0x");
+            pbaOut->append(szHex + i * 2, 2);
+
+            if ((i != nSize - 1) || (!bIsLast)) {
+                pbaOut->append(',');
+            }
+
+            if (i != nSize - 1) {
+                pbaOut->append(' ');
+            }
+        }
+
+        pbaOut->append('\n');
+    } else if (g_format == EF_BASE64) {
+        pbaOut->resize(nStart + ((nSize + 2) / 3) * 4);
+        toBase64(pData, nSize, pbaOut->data() + nStart);
+        pbaOut->append('\n');
+    } else if (g_format == EF_INTELHEX) {
+        quint32 nAddress = (quint32)(g_nAddress + nRelOffset);
+
+        // :LLAAAATT<data>CC, the upper 16 bits of the address go to an extended linear address record
+        if ((nAddress >> 16) != g_nUpperAddress) {
+            g_nUpperAddress = nAddress >> 16;
+
+            quint8 record[6] = {0x02, 0x00, 0x00, 0x04, (quint8)(g_nUpperAddress >> 8), (quint8)g_nUpperAddress};
+            _appendRecord(record, sizeof(record), pbaOut);
+        }
+
+        quint8 record[4 + 16];
+        record[0] = (quint8)nSize;
+        record[1] = (quint8)(nAddress >> 8);
+        record[2] = (quint8)nAddress;
+        record[3] = 0x00;
+        memcpy(record + 4, pData, nSize);
+
+        _appendRecord(record, 4 + nSize, pbaOut);
+    }
+}
+
+void ExportProcess::_appendRecord(const quint8 *pRecord, qint32 nSize, QByteArray *pbaOut)
+{
+    static const char szDigits[] = "0123456789ABCDEF";
+
+    quint8 nChecksum = 0;
+
+    pbaOut->append(':');
+
+    for (qint32 i = 0; i < nSize; i++) {
+        pbaOut->append(szDigits[pRecord[i] >> 4]);
+        pbaOut->append(szDigits[pRecord[i] & 0x0F]);
+        nChecksum += pRecord[i];
+    }
+
+    nChecksum = (quint8)(0 - nChecksum);
+
+    pbaOut->append(szDigits[nChecksum >> 4]);
+    pbaOut->append(szDigits[nChecksum & 0x0F]);
+    pbaOut->append('\n');
+}
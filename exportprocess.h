@@ -0,0 +1,75 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef EXPORTPROCESS_H
+#define EXPORTPROCESS_H
+
+#include <QIODevice>
+
+#include "hexprocess.h"
+
+class ExportProcess : public HexProcess {
+    Q_OBJECT
+
+public:
+    enum EF {
+        EF_HEX = 0,
+        EF_XXD,
+        EF_C,
+        EF_PYTHON,
+        EF_RUST,
+        EF_BASE64,
+        EF_INTELHEX
+    };
+
+    explicit ExportProcess(QObject *pParent = nullptr);
+    // nAddress is shown in the xxd offsets and used for the Intel HEX records
+    void setData(QHexViewDataSource *pDataSource, qint64 nOffset, qint64 nSize, EF format, QIODevice *pOutput, qint64 nAddress = 0);
+
+    static QList<EF> getFormats();
+    static QString formatToString(EF format);
+    static QString getFileSuffix(EF format);
+    static qint64 getOutputSize(EF format, qint64 nSize);  // upper bound
+    static void toHex(const char *pData, qint64 nSize, char *pOut);
+    static qint64 toBase64(const char *pData, qint64 nSize, char *pOut);
+
+protected:
+    bool _process() override;
+
+private:
+    qint32 _getBytesProLine();
+    QByteArray _getHeader();
+    QByteArray _getFooter();
+    void _formatLine(const char *pData, qint32 nSize, qint64 nRelOffset, bool bIsLast, QByteArray *pbaOut);
+    static void _appendRecord(const quint8 *pRecord, qint32 nSize, QByteArray *pbaOut);
+
+    const qint64 N_BUFFER_SIZE = 0x100000;
+    const qint64 N_INTELHEX_LIMIT = 0x100000000LL;
+
+    QHexViewDataSource *g_pDataSource;
+    qint64 g_nOffset;
+    qint64 g_nSize;
+    EF g_format;
+    QIODevice *g_pOutput;
+    qint64 g_nAddress;
+    quint32 g_nUpperAddress;  // last Intel HEX extended linear address
+};
+
+#endif  // EXPORTPROCESS_H
@@ -0,0 +1,266 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "filedumpprocess.h"
+
+#ifdef Q_OS_LINUX
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+FileDumpProcess::FileDumpProcess(QObject *pParent) : HexProcess(pParent)
+{
+    g_pDataSource = nullptr;
+    g_nOffset = 0;
+    g_nSize = 0;
+    g_bAtomic = false;
+}
+
+void FileDumpProcess::setData(QHexViewDataSource *pDataSource, qint64 nOffset, qint64 nSize, QString sFileName)
+{
+    g_pDataSource = pDataSource;
+    g_nOffset = nOffset;
+    g_nSize = nSize;
+    g_sFileName = sFileName;
+}
+
+void FileDumpProcess::setAtomic(bool bState)
+{
+    g_bAtomic = bState;
+}
+
+bool FileDumpProcess::_process()
+{
+    bool bResult = false;
+
+    setTotal(g_nSize);
+    setStatus(tr("Dump"));
+
+    // The file under the edits is copied, the edits are written over it
+    QHexViewOverlayDataSource *pOverlay = qobject_cast<QHexViewOverlayDataSource *>(g_pDataSource);
+    QHexViewDataSource *pSource = pOverlay ? pOverlay->getSource() : g_pDataSource;
+
+    QFile file(g_sFileName);
+    QSaveFile saveFile(g_sFileName);
+    QFileDevice *pFile = g_bAtomic ? (QFileDevice *)&saveFile : (QFileDevice *)&file;
+
+    // Unbuffered: QFile writes and kernel copies go to the same descriptor
+    QIODevice::OpenMode mode = QIODevice::WriteOnly | QIODevice::Unbuffered;
+
+    if (!g_bAtomic) {
+        mode |= QIODevice::Truncate;
+    }
+
+    if (openSource(pSource)) {
+        if (pFile->open(mode)) {
+            int nSourceHandle = pSource->getHandle();
+            int nHandle = pFile->handle();
+            bool bKernelCopy = (nSourceHandle != -1) && (nHandle != -1);
+
+            QByteArray baBuffer;
+
+            qint64 nCurrent = 0;
+
+            if (bKernelCopy) {
+                nCurrent = _clone(nSourceHandle, nHandle);
+                setCurrent(nCurrent);
+            }
+
+            bResult = true;
+
+            while (bResult && (nCurrent < g_nSize) && (!isStopped())) {
+                // Holes of sparse sources are skipped and stay holes in the dump
+                qint64 nDataOffset = pSource->getNextData(g_nOffset + nCurrent);
+
+                if ((nDataOffset == -1) || (nDataOffset >= g_nOffset + g_nSize)) {
+                    nCurrent = g_nSize;
+                    break;
+                }
+
+                nCurrent = qMax(nCurrent, nDataOffset - g_nOffset);
+
+                qint64 nExtentEnd = qMin(pSource->getNextHole(g_nOffset + nCurrent), g_nOffset + g_nSize) - g_nOffset;
+                qint64 nSize = nExtentEnd - nCurrent;
+                qint64 nCopied = -1;
+
+                if (nSize <= 0) {
+                    nSize = g_nSize - nCurrent;
+                }
+
+                if (bKernelCopy) {
+                    nCopied = _copyFileRange(nSourceHandle, nHandle, nCurrent, qMin(nSize, N_COPY_SIZE));
+
+                    if (nCopied <= 0) {
+                        // Not supported for these files (other file system types, old kernels), copy through a buffer
+                        bKernelCopy = false;
+                        nCopied = -1;
+                    }
+                }
+
+                if (nCopied == -1) {
+                    if (baBuffer.isEmpty()) {
+                        baBuffer.resize(N_BUFFER_SIZE);
+                    }
+
+                    nCopied = _copyBuffer(pFile, baBuffer.data(), nCurrent, qMin(nSize, N_BUFFER_SIZE));
+                }
+
+                if (nCopied > 0) {
+                    nCurrent += nCopied;
+                    setCurrent(nCurrent);
+                } else {
+                    emit errorMessage(tr("Write error"));
+                    bResult = false;
+                }
+            }
+
+            if (bResult && (!isStopped()) && pOverlay) {
+                bResult = _writeExtents(pFile, pOverlay);
+            }
+
+            if (bResult && (!isStopped())) {
+                // Trailing hole
+                if (!pFile->resize(g_nSize)) {
+                    emit errorMessage(tr("Write error"));
+                    bResult = false;
+                }
+            }
+
+            if (!g_bAtomic) {
+                file.close();
+            } else if (bResult && (!isStopped())) {
+                // Rename over the old file
+                if (!saveFile.commit()) {
+                    emit errorMessage(QString("%1: %2").arg(tr("Cannot save file"), g_sFileName));
+                    bResult = false;
+                }
+            } else {
+                saveFile.cancelWriting();
+            }
+        } else {
+            emit errorMessage(QString("%1: %2").arg(tr("Cannot open file"), g_sFileName));
+        }
+
+        closeSource();
+    }
+
+    return bResult;
+}
+
+qint64 FileDumpProcess::_clone(int nSourceHandle, int nHandle)
+{
+    qint64 nResult = 0;
+
+#if defined(Q_OS_LINUX) && defined(FICLONERANGE)
+    struct stat st = {};
+
+    if ((fstat(nSourceHandle, &st) == 0) && (st.st_blksize > 0)) {
+        qint64 nBlockSize = st.st_blksize;
+
+        // The offset has to be block aligned, the length too unless the range ends with the file
+        if ((g_nOffset % nBlockSize) == 0) {
+            qint64 nSize = g_nSize;
+
+            if (g_nOffset + g_nSize < (qint64)st.st_size) {
+                nSize = (nSize / nBlockSize) * nBlockSize;
+            }
+
+            if (nSize > 0) {
+                struct file_clone_range range = {};
+                range.src_fd = nSourceHandle;
+                range.src_offset = (quint64)g_nOffset;
+                range.src_length = (quint64)nSize;
+                range.dest_offset = 0;
+
+                // EOPNOTSUPP/EXDEV/EINVAL: no shared extents here
+                if (ioctl(nHandle, FICLONERANGE, &range) == 0) {
+                    nResult = nSize;
+                }
+            }
+        }
+    }
+#else
+    Q_UNUSED(nSourceHandle)
+    Q_UNUSED(nHandle)
+#endif
+
+    return nResult;
+}
+
+qint64 FileDumpProcess::_copyFileRange(int nSourceHandle, int nHandle, qint64 nRelOffset, qint64 nSize)
+{
+    qint64 nResult = -1;
+
+#if defined(Q_OS_LINUX) && defined(__NR_copy_file_range)
+    // Explicit offsets, the file positions of both descriptors are not used
+    qint64 nSourceOffset = g_nOffset + nRelOffset;
+    qint64 nOffset = nRelOffset;
+
+    nResult = (qint64)syscall(__NR_copy_file_range, nSourceHandle, &nSourceOffset, nHandle, &nOffset, (size_t)nSize, 0);
+#else
+    Q_UNUSED(nSourceHandle)
+    Q_UNUSED(nHandle)
+    Q_UNUSED(nRelOffset)
+    Q_UNUSED(nSize)
+#endif
+
+    return nResult;
+}
+
+qint64 FileDumpProcess::_copyBuffer(QFileDevice *pFile, char *pBuffer, qint64 nRelOffset, qint64 nSize)
+{
+    qint64 nResult = -1;
+
+    qint64 nRead = readAt(g_nOffset + nRelOffset, pBuffer, nSize);
+
+    if ((nRead > 0) && pFile->seek(nRelOffset)) {
+        nResult = pFile->write(pBuffer, nRead);
+    }
+
+    return nResult;
+}
+
+bool FileDumpProcess::_writeExtents(QFileDevice *pFile, QHexViewOverlayDataSource *pOverlay)
+{
+    bool bResult = true;
+
+    QMap<qint64, QByteArray> mapExtents = pOverlay->getExtents();
+
+    qint64 nEnd = g_nOffset + g_nSize;
+
+    for (QMap<qint64, QByteArray>::const_iterator it = mapExtents.constBegin(); bResult && (it != mapExtents.constEnd()); it++) {
+        qint64 nStart = qMax(it.key(), g_nOffset);
+        qint64 nStop = qMin(it.key() + it.value().size(), nEnd);
+
+        if (nStart < nStop) {
+            qint64 nSize = nStop - nStart;
+
+            if ((!pFile->seek(nStart - g_nOffset)) || (pFile->write(it.value().constData() + (nStart - it.key()), nSize) != nSize)) {
+                emit errorMessage(tr("Write error"));
+                bResult = false;
+            }
+        }
+    }
+
+    return bResult;
+}
@@ -0,0 +1,59 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef FILEDUMPPROCESS_H
+#define FILEDUMPPROCESS_H
+
+#include <QFile>
+#include <QSaveFile>
+
+#include "hexprocess.h"
+#include "qhexviewoverlaydatasource.h"
+
+// Copies a range of a data source to a file. Local files are reflinked or copied in the kernel, holes are kept.
+// Edits of an overlay are written over the copy of the file under it
+class FileDumpProcess : public HexProcess {
+    Q_OBJECT
+
+public:
+    explicit FileDumpProcess(QObject *pParent = nullptr);
+    void setData(QHexViewDataSource *pDataSource, qint64 nOffset, qint64 nSize, QString sFileName);
+    void setAtomic(bool bState);  // written to a temporary file that replaces sFileName when complete
+
+protected:
+    bool _process() override;
+
+private:
+    qint64 _clone(int nSourceHandle, int nHandle);  // size of the reflinked head of the range, 0 if not supported
+    qint64 _copyFileRange(int nSourceHandle, int nHandle, qint64 nRelOffset, qint64 nSize);
+    qint64 _copyBuffer(QFileDevice *pFile, char *pBuffer, qint64 nRelOffset, qint64 nSize);
+    bool _writeExtents(QFileDevice *pFile, QHexViewOverlayDataSource *pOverlay);
+
+    const qint64 N_BUFFER_SIZE = 0x100000;
+    const qint64 N_COPY_SIZE = 0x4000000;  // per call, for progress and stop
+
+    QHexViewDataSource *g_pDataSource;
+    qint64 g_nOffset;
+    qint64 g_nSize;
+    QString g_sFileName;
+    bool g_bAtomic;
+};
+
+#endif  // FILEDUMPPROCESS_H
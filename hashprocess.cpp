@@ -0,0 +1,482 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "hashprocess.h"
+
+#if defined(Q_PROCESSOR_X86_64) && (defined(Q_CC_GNU) || defined(Q_CC_CLANG) || defined(Q_CC_MSVC))
+#define HASHPROCESS_CLMUL
+#include <immintrin.h>
+#ifdef Q_CC_MSVC
+#include <intrin.h>
+#define HASHPROCESS_TARGET_CLMUL
+#else
+#define HASHPROCESS_TARGET_CLMUL __attribute__((target("pclmul,sse2")))
+#endif
+#endif
+
+static quint32 g_crc32Table[8][256];
+
+static bool _initCrc32()
+{
+    for (quint32 i = 0; i < 256; i++) {
+        quint32 nValue = i;
+
+        for (qint32 j = 0; j < 8; j++) {
+            nValue = (nValue >> 1) ^ (0xEDB88320 & (0 - (nValue & 1)));
+        }
+
+        g_crc32Table[0][i] = nValue;
+    }
+
+    for (quint32 i = 0; i < 256; i++) {
+        for (qint32 j = 1; j < 8; j++) {
+            g_crc32Table[j][i] = (g_crc32Table[j - 1][i] >> 8) ^ g_crc32Table[0][g_crc32Table[j - 1][i] & 0xFF];
+        }
+    }
+
+    bool bResult = false;
+#ifdef HASHPROCESS_CLMUL
+#ifdef Q_CC_MSVC
+    int cpuInfo[4] = {};
+    __cpuid(cpuInfo, 1);
+    bResult = (cpuInfo[2] & (1 << 1)) != 0;
+#else
+    bResult = __builtin_cpu_supports("pclmul");
+#endif
+#endif
+    // true if the carry-less multiply path can be used
+    return bResult;
+}
+
+static bool _isClmul()
+{
+    // The tables are built once, by the first caller
+    static const bool bResult = _initCrc32();
+
+    return bResult;
+}
+
+// Slicing-by-8, the register is not inverted here
+static quint32 _crc32Slice8(quint32 nCRC, const quint8 *pData, qint64 nSize)
+{
+    while (nSize >= 8) {
+        quint32 nValue1 = 0;
+        quint32 nValue2 = 0;
+        memcpy(&nValue1, pData, 4);
+        memcpy(&nValue2, pData + 4, 4);
+        nValue1 = qFromLittleEndian(nValue1) ^ nCRC;
+        nValue2 = qFromLittleEndian(nValue2);
+
+        nCRC = g_crc32Table[7][nValue1 & 0xFF] ^ g_crc32Table[6][(nValue1 >> 8) & 0xFF] ^ g_crc32Table[5][(nValue1 >> 16) & 0xFF] ^ g_crc32Table[4][nValue1 >> 24] ^
+               g_crc32Table[3][nValue2 & 0xFF] ^ g_crc32Table[2][(nValue2 >> 8) & 0xFF] ^ g_crc32Table[1][(nValue2 >> 16) & 0xFF] ^ g_crc32Table[0][nValue2 >> 24];
+
+        pData += 8;
+        nSize -= 8;
+    }
+
+    while (nSize > 0) {
+        nCRC = (nCRC >> 8) ^ g_crc32Table[0][(nCRC ^ *pData) & 0xFF];
+        pData++;
+        nSize--;
+    }
+
+    return nCRC;
+}
+
+#ifdef HASHPROCESS_CLMUL
+// Carry-less multiply folding (4x128 bit), constants for the reflected polynomial 0xEDB88320
+HASHPROCESS_TARGET_CLMUL static quint32 _crc32Clmul(quint32 nCRC, const quint8 *pData, qint64 nSize)
+{
+    const __m128i k1k2 = _mm_set_epi64x(0x1c6e41596, 0x154442bd4);
+    const __m128i k3k4 = _mm_set_epi64x(0x0ccaa009e, 0x1751997d0);
+
+    __m128i x[4];
+
+    for (qint32 i = 0; i < 4; i++) {
+        x[i] = _mm_loadu_si128((const __m128i *)(pData + i * 16));
+    }
+
+    x[0] = _mm_xor_si128(x[0], _mm_cvtsi32_si128((int)nCRC));
+
+    pData += 64;
+    nSize -= 64;
+
+    while (nSize >= 64) {
+        for (qint32 i = 0; i < 4; i++) {
+            __m128i xHi = _mm_clmulepi64_si128(x[i], k1k2, 0x11);
+            __m128i xLo = _mm_clmulepi64_si128(x[i], k1k2, 0x00);
+            x[i] = _mm_xor_si128(_mm_xor_si128(xLo, xHi), _mm_loadu_si128((const __m128i *)(pData + i * 16)));
+        }
+
+        pData += 64;
+        nSize -= 64;
+    }
+
+    __m128i xResult = x[0];
+
+    for (qint32 i = 1; i < 4; i++) {
+        __m128i xHi = _mm_clmulepi64_si128(xResult, k3k4, 0x11);
+        __m128i xLo = _mm_clmulepi64_si128(xResult, k3k4, 0x00);
+        xResult = _mm_xor_si128(_mm_xor_si128(xLo, xHi), x[i]);
+    }
+
+    while (nSize >= 16) {
+        __m128i xHi = _mm_clmulepi64_si128(xResult, k3k4, 0x11);
+        __m128i xLo = _mm_clmulepi64_si128(xResult, k3k4, 0x00);
+        xResult = _mm_xor_si128(_mm_xor_si128(xLo, xHi), _mm_loadu_si128((const __m128i *)pData));
+
+        pData += 16;
+        nSize -= 16;
+    }
+
+    // The folded remainder is reduced by the table path together with the tail
+    quint8 remainder[16];
+    _mm_storeu_si128((__m128i *)remainder, xResult);
+
+    nCRC = _crc32Slice8(0, remainder, 16);
+
+    return _crc32Slice8(nCRC, pData, nSize);
+}
+#endif
+
+static const quint64 XXH_PRIME64_1 = 0x9E3779B185EBCA87ULL;
+static const quint64 XXH_PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+static const quint64 XXH_PRIME64_3 = 0x165667B19E3779F9ULL;
+static const quint64 XXH_PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+static const quint64 XXH_PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+static inline quint64 _rotl64(quint64 nValue, qint32 nShift)
+{
+    return (nValue << nShift) | (nValue >> (64 - nShift));
+}
+
+static inline quint64 _read64(const quint8 *pData)
+{
+    quint64 nResult = 0;
+    memcpy(&nResult, pData, 8);
+
+    return qFromLittleEndian(nResult);
+}
+
+static inline quint64 _xxh64Round(quint64 nAcc, quint64 nInput)
+{
+    nAcc += nInput * XXH_PRIME64_2;
+    nAcc = _rotl64(nAcc, 31);
+
+    return nAcc * XXH_PRIME64_1;
+}
+
+static inline quint64 _xxh64Merge(quint64 nAcc, quint64 nValue)
+{
+    nAcc ^= _xxh64Round(0, nValue);
+
+    return nAcc * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+
+HashProcess::HashProcess(QObject *pParent)
+    : HexProcess(pParent), g_hashMD5(QCryptographicHash::Md5), g_hashSHA1(QCryptographicHash::Sha1), g_hashSHA256(QCryptographicHash::Sha256)
+{
+    g_pDataSource = nullptr;
+    g_nOffset = 0;
+    g_nSize = 0;
+    g_nHashes = 0;
+    g_nCRC32 = 0;
+    g_stateXXH64 = {};
+}
+
+void HashProcess::setData(QHexViewDataSource *pDataSource, qint64 nOffset, qint64 nSize, quint32 nHashes)
+{
+    g_pDataSource = pDataSource;
+    g_nOffset = nOffset;
+    g_nSize = nSize;
+    g_nHashes = nHashes;
+}
+
+QList<HashProcess::RECORD> HashProcess::getResult()
+{
+    return g_listResult;
+}
+
+QString HashProcess::hashIdToString(HashProcess::HASH hash)
+{
+    QString sResult = tr("Unknown");
+
+    switch (hash) {
+        case HASH_CRC32: sResult = QString("CRC32"); break;
+        case HASH_MD5: sResult = QString("MD5"); break;
+        case HASH_SHA1: sResult = QString("SHA1"); break;
+        case HASH_SHA256: sResult = QString("SHA256"); break;
+        case HASH_XXHASH64: sResult = QString("XXH64"); break;
+        default: break;
+    }
+
+    return sResult;
+}
+
+quint32 HashProcess::crc32(quint32 nCRC, const char *pData, qint64 nSize)
+{
+    return ~_crc32(~nCRC, pData, nSize);
+}
+
+quint32 HashProcess::crc32Table(quint32 nCRC, const char *pData, qint64 nSize)
+{
+    _isClmul();
+
+    return ~_crc32Slice8(~nCRC, (const quint8 *)pData, nSize);
+}
+
+void HashProcess::xxh64Init(XXH64_STATE *pState)
+{
+    *pState = {};
+
+    pState->v[0] = XXH_PRIME64_1 + XXH_PRIME64_2;
+    pState->v[1] = XXH_PRIME64_2;
+    pState->v[2] = 0;
+    pState->v[3] = 0 - XXH_PRIME64_1;
+}
+
+void HashProcess::xxh64Update(XXH64_STATE *pState, const char *pData, qint64 nSize)
+{
+    const quint8 *_pData = (const quint8 *)pData;
+
+    pState->nTotal += nSize;
+
+    if (pState->nBufferSize + nSize < 32) {
+        memcpy(pState->buffer + pState->nBufferSize, _pData, nSize);
+        pState->nBufferSize += (quint32)nSize;
+        nSize = 0;
+    } else if (pState->nBufferSize) {
+        quint32 nFill = 32 - pState->nBufferSize;
+        memcpy(pState->buffer + pState->nBufferSize, _pData, nFill);
+
+        for (qint32 i = 0; i < 4; i++) {
+            pState->v[i] = _xxh64Round(pState->v[i], _read64(pState->buffer + i * 8));
+        }
+
+        _pData += nFill;
+        nSize -= nFill;
+        pState->nBufferSize = 0;
+    }
+
+    quint64 v0 = pState->v[0];
+    quint64 v1 = pState->v[1];
+    quint64 v2 = pState->v[2];
+    quint64 v3 = pState->v[3];
+
+    while (nSize >= 32) {
+        v0 = _xxh64Round(v0, _read64(_pData));
+        v1 = _xxh64Round(v1, _read64(_pData + 8));
+        v2 = _xxh64Round(v2, _read64(_pData + 16));
+        v3 = _xxh64Round(v3, _read64(_pData + 24));
+
+        _pData += 32;
+        nSize -= 32;
+    }
+
+    pState->v[0] = v0;
+    pState->v[1] = v1;
+    pState->v[2] = v2;
+    pState->v[3] = v3;
+
+    if (nSize) {
+        memcpy(pState->buffer, _pData, nSize);
+        pState->nBufferSize = (quint32)nSize;
+    }
+}
+
+quint64 HashProcess::xxh64Digest(const XXH64_STATE *pState)
+{
+    quint64 nResult = 0;
+
+    if (pState->nTotal >= 32) {
+        nResult = _rotl64(pState->v[0], 1) + _rotl64(pState->v[1], 7) + _rotl64(pState->v[2], 12) + _rotl64(pState->v[3], 18);
+
+        for (qint32 i = 0; i < 4; i++) {
+            nResult = _xxh64Merge(nResult, pState->v[i]);
+        }
+    } else {
+        nResult = pState->v[2] + XXH_PRIME64_5;
+    }
+
+    nResult += pState->nTotal;
+
+    const quint8 *pData = pState->buffer;
+    quint32 nSize = pState->nBufferSize;
+
+    while (nSize >= 8) {
+        nResult ^= _xxh64Round(0, _read64(pData));
+        nResult = _rotl64(nResult, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+        pData += 8;
+        nSize -= 8;
+    }
+
+    if (nSize >= 4) {
+        quint32 nValue = 0;
+        memcpy(&nValue, pData, 4);
+        nResult ^= (quint64)qFromLittleEndian(nValue) * XXH_PRIME64_1;
+        nResult = _rotl64(nResult, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+        pData += 4;
+        nSize -= 4;
+    }
+
+    while (nSize > 0) {
+        nResult ^= (*pData) * XXH_PRIME64_5;
+        nResult = _rotl64(nResult, 11) * XXH_PRIME64_1;
+        pData++;
+        nSize--;
+    }
+
+    nResult ^= nResult >> 33;
+    nResult *= XXH_PRIME64_2;
+    nResult ^= nResult >> 29;
+    nResult *= XXH_PRIME64_3;
+    nResult ^= nResult >> 32;
+
+    return nResult;
+}
+
+bool HashProcess::_process()
+{
+    bool bResult = false;
+
+    g_listResult.clear();
+
+    g_nCRC32 = 0xFFFFFFFF;
+    g_hashMD5.reset();
+    g_hashSHA1.reset();
+    g_hashSHA256.reset();
+    xxh64Init(&g_stateXXH64);
+
+    QList<HASH> listHashes;
+
+    if (g_nHashes & HASH_CRC32) listHashes.append(HASH_CRC32);
+    if (g_nHashes & HASH_MD5) listHashes.append(HASH_MD5);
+    if (g_nHashes & HASH_SHA1) listHashes.append(HASH_SHA1);
+    if (g_nHashes & HASH_SHA256) listHashes.append(HASH_SHA256);
+    if (g_nHashes & HASH_XXHASH64) listHashes.append(HASH_XXHASH64);
+
+    setTotal(g_nSize);
+    setStatus(tr("Hash"));
+
+    if (openSource(g_pDataSource)) {
+        bResult = true;
+
+        // Double buffering: the next block is read while the digests of the current one are computed in the pool
+        QByteArray baBuffer[2];
+        baBuffer[0].resize(N_BUFFER_SIZE);
+        baBuffer[1].resize(N_BUFFER_SIZE);
+
+        QList<QFuture<void>> listFutures;
+
+        qint64 nCurrent = 0;
+        qint32 nIndex = 0;
+
+        while ((nCurrent < g_nSize) && (!isStopped())) {
+            qint64 nBlockSize = qMin(g_nSize - nCurrent, N_BUFFER_SIZE);
+            char *pBuffer = baBuffer[nIndex].data();
+
+            if (readAt(g_nOffset + nCurrent, pBuffer, nBlockSize) != nBlockSize) {
+                emit errorMessage(tr("Read error"));
+                bResult = false;
+                break;
+            }
+
+            for (qint32 i = 0; i < listFutures.count(); i++) {
+                listFutures[i].waitForFinished();
+            }
+
+            listFutures.clear();
+
+            for (qint32 i = 0; i < listHashes.count(); i++) {
+                HASH hash = listHashes.at(i);
+                listFutures.append(QtConcurrent::run([=]() { _update(hash, pBuffer, nBlockSize); }));
+            }
+
+            nCurrent += nBlockSize;
+            nIndex ^= 1;
+
+            setCurrent(nCurrent);
+        }
+
+        for (qint32 i = 0; i < listFutures.count(); i++) {
+            listFutures[i].waitForFinished();
+        }
+
+        closeSource();
+    }
+
+    if (bResult && (!isStopped())) {
+        for (qint32 i = 0; i < listHashes.count(); i++) {
+            RECORD record = {};
+            record.hash = listHashes.at(i);
+
+            if (record.hash == HASH_CRC32) {
+                record.sValue = QString("%1").arg(~g_nCRC32, 8, 16, QChar('0'));
+            } else if (record.hash == HASH_MD5) {
+                record.sValue = g_hashMD5.result().toHex();
+            } else if (record.hash == HASH_SHA1) {
+                record.sValue = g_hashSHA1.result().toHex();
+            } else if (record.hash == HASH_SHA256) {
+                record.sValue = g_hashSHA256.result().toHex();
+            } else if (record.hash == HASH_XXHASH64) {
+                record.sValue = QString("%1").arg(xxh64Digest(&g_stateXXH64), 16, 16, QChar('0'));
+            }
+
+            g_listResult.append(record);
+        }
+    }
+
+    return bResult;
+}
+
+void HashProcess::_update(HashProcess::HASH hash, const char *pData, qint64 nSize)
+{
+    if (hash == HASH_CRC32) {
+        g_nCRC32 = _crc32(g_nCRC32, pData, nSize);
+    } else if (hash == HASH_MD5) {
+        g_hashMD5.addData(QByteArray::fromRawData(pData, (int)nSize));
+    } else if (hash == HASH_SHA1) {
+        g_hashSHA1.addData(QByteArray::fromRawData(pData, (int)nSize));
+    } else if (hash == HASH_SHA256) {
+        g_hashSHA256.addData(QByteArray::fromRawData(pData, (int)nSize));
+    } else if (hash == HASH_XXHASH64) {
+        xxh64Update(&g_stateXXH64, pData, nSize);
+    }
+}
+
+quint32 HashProcess::_crc32(quint32 nCRC, const char *pData, qint64 nSize)
+{
+    bool bClmul = _isClmul();
+
+    quint32 nResult = 0;
+
+#ifdef HASHPROCESS_CLMUL
+    if (bClmul && (nSize >= 64)) {
+        nResult = _crc32Clmul(nCRC, (const quint8 *)pData, nSize);
+    } else {
+        nResult = _crc32Slice8(nCRC, (const quint8 *)pData, nSize);
+    }
+#else
+    Q_UNUSED(bClmul)
+    nResult = _crc32Slice8(nCRC, (const quint8 *)pData, nSize);
+#endif
+
+    return nResult;
+}
@@ -0,0 +1,88 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef HASHPROCESS_H
+#define HASHPROCESS_H
+
+#include <QCryptographicHash>
+#include <QFuture>
+#include <QtEndian>
+#include <QtConcurrent>
+
+#include "hexprocess.h"
+
+class HashProcess : public HexProcess {
+    Q_OBJECT
+
+public:
+    enum HASH {
+        HASH_CRC32 = 0x01,
+        HASH_MD5 = 0x02,
+        HASH_SHA1 = 0x04,
+        HASH_SHA256 = 0x08,
+        HASH_XXHASH64 = 0x10,
+        HASH_ALL = 0x1F
+    };
+
+    struct RECORD {
+        HASH hash;
+        QString sValue;
+    };
+
+    struct XXH64_STATE {
+        quint64 nTotal;
+        quint64 v[4];
+        quint8 buffer[32];
+        quint32 nBufferSize;
+    };
+
+    explicit HashProcess(QObject *pParent = nullptr);
+    void setData(QHexViewDataSource *pDataSource, qint64 nOffset, qint64 nSize, quint32 nHashes);
+    QList<RECORD> getResult();
+
+    static QString hashIdToString(HASH hash);
+    static quint32 crc32(quint32 nCRC, const char *pData, qint64 nSize);
+    static quint32 crc32Table(quint32 nCRC, const char *pData, qint64 nSize);  // table path only, the reference of crc32()
+    static void xxh64Init(XXH64_STATE *pState);
+    static void xxh64Update(XXH64_STATE *pState, const char *pData, qint64 nSize);
+    static quint64 xxh64Digest(const XXH64_STATE *pState);
+
+protected:
+    bool _process() override;
+
+private:
+    void _update(HASH hash, const char *pData, qint64 nSize);
+    static quint32 _crc32(quint32 nCRC, const char *pData, qint64 nSize);
+
+    const qint64 N_BUFFER_SIZE = 0x400000;
+
+    QHexViewDataSource *g_pDataSource;
+    qint64 g_nOffset;
+    qint64 g_nSize;
+    quint32 g_nHashes;
+    quint32 g_nCRC32;
+    QCryptographicHash g_hashMD5;
+    QCryptographicHash g_hashSHA1;
+    QCryptographicHash g_hashSHA256;
+    XXH64_STATE g_stateXXH64;
+    QList<RECORD> g_listResult;
+};
+
+#endif  // HASHPROCESS_H
@@ -0,0 +1,118 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "hexprocess.h"
+
+HexProcess::HexProcess(QObject *pParent) : QObject(pParent)
+{
+    g_nIsStop = 0;
+    g_bIsSuccess = false;
+    g_stats = {};
+
+    for (qint32 i = 0; i < N_MAX_SOURCES; i++) {
+        g_pSources[i] = nullptr;
+    }
+}
+
+void HexProcess::stop()
+{
+    g_nIsStop.storeRelease(1);
+}
+
+bool HexProcess::isStopped()
+{
+    return g_nIsStop.loadAcquire() != 0;
+}
+
+bool HexProcess::isSuccess()
+{
+    return g_bIsSuccess;
+}
+
+HexProcess::STATS HexProcess::getCurrentStats()
+{
+    QMutexLocker locker(&g_mutexStats);
+
+    return g_stats;
+}
+
+void HexProcess::process()
+{
+    QElapsedTimer scanTimer;
+    scanTimer.start();
+
+    // Not cleared here: a stop() before the thread started must not be lost
+    g_bIsSuccess = _process() && (!isStopped());
+
+    emit completed(scanTimer.elapsed());
+}
+
+void HexProcess::setTotal(qint64 nTotal)
+{
+    QMutexLocker locker(&g_mutexStats);
+
+    g_stats.nTotal = nTotal;
+}
+
+void HexProcess::setCurrent(qint64 nCurrent)
+{
+    QMutexLocker locker(&g_mutexStats);
+
+    g_stats.nCurrent = nCurrent;
+}
+
+void HexProcess::setStatus(QString sStatus)
+{
+    QMutexLocker locker(&g_mutexStats);
+
+    g_stats.sStatus = sStatus;
+}
+
+bool HexProcess::openSource(QHexViewDataSource *pDataSource, qint32 nSourceIndex)
+{
+    bool bResult = false;
+
+    if (pDataSource && (nSourceIndex >= 0) && (nSourceIndex < N_MAX_SOURCES)) {
+        // Positional reads: the view keeps using the same source while the worker runs
+        g_pSources[nSourceIndex] = pDataSource;
+
+        bResult = true;
+    }
+
+    return bResult;
+}
+
+qint64 HexProcess::readAt(qint64 nOffset, char *pBuffer, qint64 nSize, qint32 nSourceIndex)
+{
+    qint64 nResult = -1;
+
+    if (g_pSources[nSourceIndex]) {
+        nResult = g_pSources[nSourceIndex]->readAt(nOffset, pBuffer, nSize);
+    }
+
+    return nResult;
+}
+
+void HexProcess::closeSource()
+{
+    for (qint32 i = 0; i < N_MAX_SOURCES; i++) {
+        g_pSources[i] = nullptr;
+    }
+}
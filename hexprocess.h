@@ -0,0 +1,75 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef HEXPROCESS_H
+#define HEXPROCESS_H
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QObject>
+
+#include "qhexviewdatasource.h"
+
+class HexProcess : public QObject {
+    Q_OBJECT
+
+public:
+    struct STATS {
+        qint64 nTotal;
+        qint64 nCurrent;
+        QString sStatus;
+    };
+
+    explicit HexProcess(QObject *pParent = nullptr);
+    void stop();
+    bool isStopped();
+    bool isSuccess();
+    STATS getCurrentStats();
+
+signals:
+    void errorMessage(QString sText);
+    void completed(qint64 nElapsed);
+
+public slots:
+    void process();
+
+protected:
+    virtual bool _process() = 0;
+    void setTotal(qint64 nTotal);
+    void setCurrent(qint64 nCurrent);
+    void setStatus(QString sStatus);
+    bool openSource(QHexViewDataSource *pDataSource, qint32 nSourceIndex = 0);
+    qint64 readAt(qint64 nOffset, char *pBuffer, qint64 nSize, qint32 nSourceIndex = 0);
+    void closeSource();
+
+private:
+    enum {
+        N_MAX_SOURCES = 2
+    };
+
+    QAtomicInt g_nIsStop;  // set by the GUI thread, read by the worker
+    bool g_bIsSuccess;
+    QMutex g_mutexStats;
+    STATS g_stats;
+    QHexViewDataSource *g_pSources[N_MAX_SOURCES];
+};
+
+#endif  // HEXPROCESS_H
@@ -0,0 +1,302 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "patchprocess.h"
+
+#ifdef Q_PROCESSOR_X86_64
+#include <emmintrin.h>
+#endif
+
+PatchProcess::PatchProcess(QObject *pParent) : HexProcess(pParent)
+{
+    g_pDataSource = nullptr;
+    g_nOffset = 0;
+    g_nSize = 0;
+    g_op = PO_WRITE;
+    g_pInput = nullptr;
+    g_pUndo = nullptr;
+    g_nWrittenSize = 0;
+}
+
+void PatchProcess::setData(QHexViewDataSource *pDataSource, qint64 nOffset, qint64 nSize, PO op, const QByteArray &baPattern, QIODevice *pInput)
+{
+    g_pDataSource = pDataSource;
+    g_nOffset = nOffset;
+    g_nSize = nSize;
+    g_op = op;
+    g_baPattern = baPattern;
+    g_pInput = pInput;
+}
+
+void PatchProcess::setUndoDevice(QIODevice *pDevice)
+{
+    g_pUndo = pDevice;
+}
+
+qint64 PatchProcess::getWrittenSize()
+{
+    return g_nWrittenSize;
+}
+
+bool PatchProcess::hexToBytes(const QByteArray &baText, QByteArray *pbaResult)
+{
+    bool bResult = false;
+
+    pbaResult->resize(baText.size() / 2);
+
+    qint64 nSize = _decodeHex(baText.constData(), baText.size(), pbaResult->data());
+
+    if (nSize == -1) {
+        // Separators, copied from dumps and source code
+        QByteArray baCompact;
+        baCompact.reserve(baText.size());
+
+        const char *pText = baText.constData();
+        qint32 nTextSize = baText.size();
+
+        for (qint32 i = 0; i < nTextSize; i++) {
+            char cChar = pText[i];
+
+            if ((cChar == ' ') || (cChar == '\t') || (cChar == '\r') || (cChar == '\n') || (cChar == ',')) {
+                continue;
+            }
+
+            if ((i + 1 < nTextSize) && ((cChar == '0') || (cChar == '\\')) && ((pText[i + 1] == 'x') || (pText[i + 1] == 'X'))) {
+                i++;
+                continue;
+            }
+
+            baCompact.append(cChar);
+        }
+
+        pbaResult->resize(baCompact.size() / 2);
+
+        nSize = _decodeHex(baCompact.constData(), baCompact.size(), pbaResult->data());
+    }
+
+    if (nSize > 0) {
+        bResult = true;
+    } else {
+        pbaResult->clear();
+    }
+
+    return bResult;
+}
+
+qint64 PatchProcess::_decodeHex(const char *pText, qint64 nSize, char *pOut)
+{
+    qint64 nResult = -1;
+
+    if ((nSize % 2) == 0) {
+        qint64 i = 0;
+        bool bValid = true;
+
+#ifdef Q_PROCESSOR_X86_64
+        // 32 characters to 16 bytes, any character out of [0-9a-fA-F] stops the fast path
+        const __m128i digitLow = _mm_set1_epi8('0' - 1);
+        const __m128i digitHigh = _mm_set1_epi8('9' + 1);
+        const __m128i letterLow = _mm_set1_epi8('a' - 1);
+        const __m128i letterHigh = _mm_set1_epi8('f' + 1);
+        const __m128i lowerCase = _mm_set1_epi8(0x20);
+        const __m128i digitBase = _mm_set1_epi8('0');
+        const __m128i letterBase = _mm_set1_epi8('a' - 10);
+        const __m128i nibbleMask = _mm_set1_epi16(0x00F0);
+
+        for (; i + 32 <= nSize; i += 32) {
+            __m128i nibbles[2];
+
+            for (qint32 j = 0; j < 2; j++) {
+                __m128i text = _mm_loadu_si128((const __m128i *)(pText + i + j * 16));
+                __m128i lower = _mm_or_si128(text, lowerCase);
+                __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(text, digitLow), _mm_cmpgt_epi8(digitHigh, text));
+                __m128i isLetter = _mm_and_si128(_mm_cmpgt_epi8(lower, letterLow), _mm_cmpgt_epi8(letterHigh, lower));
+
+                if (_mm_movemask_epi8(_mm_or_si128(isDigit, isLetter)) != 0xFFFF) {
+                    bValid = false;
+                    break;
+                }
+
+                __m128i value = _mm_or_si128(_mm_and_si128(isDigit, _mm_sub_epi8(text, digitBase)), _mm_and_si128(isLetter, _mm_sub_epi8(lower, letterBase)));
+
+                // High nibble in the even byte, low nibble in the odd byte of each word
+                nibbles[j] = _mm_or_si128(_mm_and_si128(_mm_slli_epi16(value, 4), nibbleMask), _mm_srli_epi16(value, 8));
+            }
+
+            if (!bValid) {
+                break;
+            }
+
+            _mm_storeu_si128((__m128i *)(pOut + i / 2), _mm_packus_epi16(nibbles[0], nibbles[1]));
+        }
+#endif
+
+        for (; bValid && (i < nSize); i += 2) {
+            quint8 nByte = 0;
+
+            for (qint32 j = 0; j < 2; j++) {
+                char cChar = pText[i + j];
+
+                nByte <<= 4;
+
+                if ((cChar >= '0') && (cChar <= '9')) {
+                    nByte |= (quint8)(cChar - '0');
+                } else if ((cChar >= 'a') && (cChar <= 'f')) {
+                    nByte |= (quint8)(cChar - 'a' + 10);
+                } else if ((cChar >= 'A') && (cChar <= 'F')) {
+                    nByte |= (quint8)(cChar - 'A' + 10);
+                } else {
+                    bValid = false;
+                }
+            }
+
+            pOut[i / 2] = (char)nByte;
+        }
+
+        if (bValid) {
+            nResult = nSize / 2;
+        }
+    }
+
+    return nResult;
+}
+
+void PatchProcess::_combine(PO op, char *pData, const char *pPattern, qint64 nSize)
+{
+    qint64 i = 0;
+
+#ifdef Q_PROCESSOR_X86_64
+    for (; i + 16 <= nSize; i += 16) {
+        __m128i data = _mm_loadu_si128((const __m128i *)(pData + i));
+        __m128i pattern = _mm_loadu_si128((const __m128i *)(pPattern + i));
+
+        data = (op == PO_XOR) ? _mm_xor_si128(data, pattern) : _mm_add_epi8(data, pattern);
+
+        _mm_storeu_si128((__m128i *)(pData + i), data);
+    }
+#endif
+
+    for (; i < nSize; i++) {
+        if (op == PO_XOR) {
+            pData[i] = (char)(pData[i] ^ pPattern[i]);
+        } else {
+            pData[i] = (char)((quint8)pData[i] + (quint8)pPattern[i]);
+        }
+    }
+}
+
+bool PatchProcess::_process()
+{
+    bool bResult = false;
+
+    g_nWrittenSize = 0;
+
+    setTotal(g_nSize);
+    setStatus(tr("Patch"));
+
+    bool bValid = false;
+
+    if (g_op == PO_WRITE) {
+        bValid = g_pInput || (g_baPattern.size() >= g_nSize);
+    } else {
+        bValid = !g_baPattern.isEmpty();
+    }
+
+    if (bValid && openSource(g_pDataSource)) {
+        qint64 nBlockSize = qMin(N_BUFFER_SIZE, g_nSize);
+        qint64 nPatternSize = g_baPattern.size();
+
+        // The pattern repeated over a block plus one period, a block starts at any phase
+        QByteArray baTiled;
+
+        if (g_op != PO_WRITE) {
+            baTiled.resize(nBlockSize + nPatternSize);
+
+            char *pTiled = baTiled.data();
+            qint64 nTiled = qMin(nPatternSize, (qint64)baTiled.size());
+
+            memcpy(pTiled, g_baPattern.constData(), nTiled);
+
+            while (nTiled < baTiled.size()) {
+                qint64 nCopy = qMin(nTiled, baTiled.size() - nTiled);
+
+                memcpy(pTiled + nTiled, pTiled, nCopy);
+                nTiled += nCopy;
+            }
+        }
+
+        bool bReadData = g_pUndo || (g_op == PO_ADD) || (g_op == PO_XOR);
+
+        QByteArray baBuffer(nBlockSize, 0);
+
+        bResult = true;
+
+        while (bResult && (g_nWrittenSize < g_nSize) && (!isStopped())) {
+            qint64 nCurrent = g_nWrittenSize;
+            qint64 nSize = qMin(g_nSize - nCurrent, nBlockSize);
+            char *pBuffer = baBuffer.data();
+
+            if (bReadData) {
+                if (readAt(g_nOffset + nCurrent, pBuffer, nSize) != nSize) {
+                    emit errorMessage(tr("Read error"));
+                    bResult = false;
+                    break;
+                }
+
+                if (g_pUndo && (g_pUndo->write(pBuffer, nSize) != nSize)) {
+                    emit errorMessage(tr("Write error"));
+                    bResult = false;
+                    break;
+                }
+            }
+
+            const char *pPattern = baTiled.constData() + (nPatternSize ? (nCurrent % nPatternSize) : 0);
+
+            if (g_op == PO_WRITE) {
+                if (g_pInput) {
+                    if (g_pInput->read(pBuffer, nSize) != nSize) {
+                        emit errorMessage(tr("Read error"));
+                        bResult = false;
+                        break;
+                    }
+                } else {
+                    memcpy(pBuffer, g_baPattern.constData() + nCurrent, nSize);
+                }
+            } else if (g_op == PO_FILL) {
+                memcpy(pBuffer, pPattern, nSize);
+            } else {
+                _combine(g_op, pBuffer, pPattern, nSize);
+            }
+
+            if (g_pDataSource->writeAt(g_nOffset + nCurrent, pBuffer, nSize) != nSize) {
+                emit errorMessage(tr("Write error"));
+                bResult = false;
+                break;
+            }
+
+            g_nWrittenSize += nSize;
+
+            setCurrent(g_nWrittenSize);
+        }
+
+        closeSource();
+    }
+
+    return bResult;
+}
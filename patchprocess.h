@@ -0,0 +1,66 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef PATCHPROCESS_H
+#define PATCHPROCESS_H
+
+#include <QIODevice>
+
+#include "hexprocess.h"
+
+// Writes a range in large blocks, the previous data can be saved to an undo device
+class PatchProcess : public HexProcess {
+    Q_OBJECT
+
+public:
+    enum PO {
+        PO_WRITE = 0,  // data from the input device or the pattern, not repeated
+        PO_FILL,
+        PO_ADD,
+        PO_XOR
+    };
+
+    explicit PatchProcess(QObject *pParent = nullptr);
+    void setData(QHexViewDataSource *pDataSource, qint64 nOffset, qint64 nSize, PO op, const QByteArray &baPattern, QIODevice *pInput = nullptr);
+    void setUndoDevice(QIODevice *pDevice);
+    qint64 getWrittenSize();
+    // Hex text with optional whitespace, commas and 0x/\x prefixes
+    static bool hexToBytes(const QByteArray &baText, QByteArray *pbaResult);
+
+protected:
+    bool _process() override;
+
+private:
+    static qint64 _decodeHex(const char *pText, qint64 nSize, char *pOut);  // -1 if not hex
+    static void _combine(PO op, char *pData, const char *pPattern, qint64 nSize);
+
+    const qint64 N_BUFFER_SIZE = 0x400000;
+
+    QHexViewDataSource *g_pDataSource;
+    qint64 g_nOffset;
+    qint64 g_nSize;
+    PO g_op;
+    QByteArray g_baPattern;
+    QIODevice *g_pInput;
+    QIODevice *g_pUndo;
+    qint64 g_nWrittenSize;
+};
+
+#endif  // PATCHPROCESS_H
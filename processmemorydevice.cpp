@@ -0,0 +1,377 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "processmemorydevice.h"
+
+#ifdef Q_OS_LINUX
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+ProcessMemoryDevice::ProcessMemoryDevice(qint64 nPID, QObject *pParent) : QIODevice(pParent)
+{
+    g_nPID = nPID;
+    g_nHandle = -1;
+    g_nSize = 0;
+    g_bVmReadv = true;
+}
+
+ProcessMemoryDevice::~ProcessMemoryDevice()
+{
+    close();
+}
+
+bool ProcessMemoryDevice::open(OpenMode mode)
+{
+    bool bResult = false;
+
+#ifdef Q_OS_LINUX
+    g_listRegions = readRegions(g_nPID);
+
+    g_nSize = 0;
+
+    if (g_listRegions.count()) {
+        const REGION &lastRegion = g_listRegions.last();
+        g_nSize = lastRegion.nOffset + lastRegion.nSize;
+    }
+
+    int nFlags = O_RDONLY;
+
+    if (mode & QIODevice::WriteOnly) {
+        nFlags = O_RDWR;
+    }
+
+    g_nHandle = ::open(QString("/proc/%1/mem").arg(g_nPID).toLocal8Bit().constData(), nFlags);
+
+    if ((g_nHandle != -1) && g_nSize) {
+        g_stFaultPages.clear();
+        g_bVmReadv = true;
+
+        bResult = QIODevice::open(mode | QIODevice::Unbuffered);
+    }
+#else
+    Q_UNUSED(mode)
+#endif
+
+    return bResult;
+}
+
+void ProcessMemoryDevice::close()
+{
+#ifdef Q_OS_LINUX
+    if (g_nHandle != -1) {
+        ::close(g_nHandle);
+        g_nHandle = -1;
+    }
+#endif
+
+    QIODevice::close();
+}
+
+bool ProcessMemoryDevice::isSequential() const
+{
+    return false;
+}
+
+qint64 ProcessMemoryDevice::size() const
+{
+    return g_nSize;
+}
+
+XBinary::_MEMORY_MAP ProcessMemoryDevice::getMemoryMap()
+{
+    XBinary::_MEMORY_MAP result = {};
+
+    qint32 nNumberOfRegions = g_listRegions.count();
+
+    if (nNumberOfRegions) {
+        result.nModuleAddress = g_listRegions.at(0).nAddress;
+        result.nBinarySize = g_nSize;
+        result.nImageSize = g_listRegions.last().nAddress + g_listRegions.last().nSize - g_listRegions.at(0).nAddress;
+    }
+
+    for (qint32 i = 0; i < nNumberOfRegions; i++) {
+        XBinary::_MEMORY_RECORD record = {};
+
+        record.nOffset = g_listRegions.at(i).nOffset;
+        record.nAddress = g_listRegions.at(i).nAddress;
+        record.nSize = g_listRegions.at(i).nSize;
+        record.type = XBinary::MMT_LOADSEGMENT;
+        record.nIndex = i;
+        record.sName = g_listRegions.at(i).sName;
+
+        result.listRecords.append(record);
+    }
+
+    return result;
+}
+
+QList<ProcessMemoryDevice::REGION> ProcessMemoryDevice::getRegions()
+{
+    return g_listRegions;
+}
+
+bool ProcessMemoryDevice::isOffsetReadable(qint64 nOffset)
+{
+    bool bResult = false;
+
+    qint32 nIndex = findRegion(nOffset);
+
+    if (nIndex != -1) {
+        bResult = g_listRegions.at(nIndex).bReadable && (!isFault(nOffset));
+    }
+
+    return bResult;
+}
+
+QList<ProcessMemoryDevice::REGION> ProcessMemoryDevice::readRegions(qint64 nPID)
+{
+    QList<REGION> listResult;
+
+    QFile file(QString("/proc/%1/maps").arg(nPID));
+
+    if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qint64 nOffset = 0;
+
+        // 55d0c8a00000-55d0c8a02000 r--p 00000000 fd:01 1234  /usr/bin/cat
+        while (!file.atEnd()) {
+            QString sLine = QString::fromLocal8Bit(file.readLine()).trimmed();
+
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 14, 0))
+            QStringList listParts = sLine.split(" ", Qt::SkipEmptyParts);
+#else
+            QStringList listParts = sLine.split(" ", QString::SkipEmptyParts);
+#endif
+
+            if (listParts.count() >= 2) {
+                QString sRange = listParts.at(0);
+                QString sPerms = listParts.at(1);
+
+                quint64 nStart = sRange.section("-", 0, 0).toULongLong(nullptr, 16);
+                quint64 nEnd = sRange.section("-", 1, 1).toULongLong(nullptr, 16);
+
+                if (nEnd > nStart) {
+                    REGION region = {};
+                    region.nAddress = nStart;
+                    region.nSize = (qint64)(nEnd - nStart);
+                    region.nOffset = nOffset;
+                    region.bReadable = sPerms.startsWith("r");
+                    region.bWritable = (sPerms.mid(1, 1) == "w");
+
+                    if (listParts.count() >= 6) {
+                        region.sName = listParts.mid(5).join(" ");
+                    }
+
+                    // vsyscall is mapped at a kernel address and cannot be read
+                    if (region.sName == "[vsyscall]") {
+                        region.bReadable = false;
+                    }
+
+                    listResult.append(region);
+
+                    nOffset += region.nSize;
+                }
+            }
+        }
+    }
+
+    return listResult;
+}
+
+qint64 ProcessMemoryDevice::readData(char *pData, qint64 nMaxSize)
+{
+    qint64 nResult = -1;
+
+#ifdef Q_OS_LINUX
+    qint64 nOffset = pos();
+
+    // Pieces of the request up to the first known unreadable page, one syscall for all of them
+    struct iovec localIov = {};
+    QVector<struct iovec> listRemoteIov;
+
+    qint64 nRequested = 0;
+    qint32 nIndex = findRegion(nOffset);
+
+    while ((nRequested < nMaxSize) && (nIndex != -1) && (nIndex < g_listRegions.count())) {
+        const REGION &region = g_listRegions.at(nIndex);
+
+        if (!region.bReadable) {
+            addFault(nOffset + nRequested);
+            break;
+        }
+
+        qint64 nDelta = nOffset + nRequested - region.nOffset;
+        qint64 nPieceSize = qMin(region.nSize - nDelta, nMaxSize - nRequested);
+
+        // Stop before a cached fault
+        for (qint64 nPage = (nOffset + nRequested) / N_PAGE_SIZE; nPage * N_PAGE_SIZE < nOffset + nRequested + nPieceSize; nPage++) {
+            if (isFault(nPage * N_PAGE_SIZE)) {
+                nPieceSize = qMax(nPage * N_PAGE_SIZE - (nOffset + nRequested), (qint64)0);
+                break;
+            }
+        }
+
+        if (nPieceSize == 0) {
+            break;
+        }
+
+        struct iovec remoteIov = {};
+        remoteIov.iov_base = (void *)(region.nAddress + nDelta);
+        remoteIov.iov_len = (size_t)nPieceSize;
+        listRemoteIov.append(remoteIov);
+
+        nRequested += nPieceSize;
+
+        if (nDelta + nPieceSize < region.nSize) {
+            break;
+        }
+
+        nIndex++;
+    }
+
+    if (nRequested) {
+        qint64 nRead = -1;
+
+        if (g_bVmReadv) {
+            localIov.iov_base = pData;
+            localIov.iov_len = (size_t)nRequested;
+
+            nRead = process_vm_readv((pid_t)g_nPID, &localIov, 1, listRemoteIov.data(), (unsigned long)listRemoteIov.count(), 0);
+
+            if ((nRead == -1) && ((errno == ENOSYS) || (errno == EPERM))) {
+                g_bVmReadv = false;
+            }
+        }
+
+        if (nRead < 0) {
+            nRead = 0;
+        }
+
+        if (nRead < nRequested) {
+            // process_vm_readv fails whole iovec elements, pread stops at the faulting page
+            qint64 nPieceStart = 0;
+
+            for (qint32 i = 0; i < listRemoteIov.count(); i++) {
+                qint64 nPieceSize = (qint64)listRemoteIov.at(i).iov_len;
+
+                if (nRead < nPieceStart + nPieceSize) {
+                    qint64 nSkip = nRead - nPieceStart;
+                    quint64 nAddress = (quint64)listRemoteIov.at(i).iov_base + nSkip;
+
+                    ssize_t nPieceRead = pread(g_nHandle, pData + nRead, (size_t)(nPieceSize - nSkip), (off_t)nAddress);
+
+                    if (nPieceRead > 0) {
+                        nRead += nPieceRead;
+                    }
+
+                    if (nPieceRead != (ssize_t)(nPieceSize - nSkip)) {
+                        break;
+                    }
+                }
+
+                nPieceStart += nPieceSize;
+            }
+        }
+
+        if (nRead < nRequested) {
+            addFault(nOffset + nRead);
+        }
+
+        if (nRead > 0) {
+            nResult = nRead;
+        }
+    }
+#else
+    Q_UNUSED(pData)
+    Q_UNUSED(nMaxSize)
+#endif
+
+    return nResult;
+}
+
+qint64 ProcessMemoryDevice::writeData(const char *pData, qint64 nMaxSize)
+{
+    qint64 nResult = -1;
+
+#ifdef Q_OS_LINUX
+    qint64 nOffset = pos();
+    qint32 nIndex = findRegion(nOffset);
+
+    if (nIndex != -1) {
+        const REGION &region = g_listRegions.at(nIndex);
+
+        qint64 nDelta = nOffset - region.nOffset;
+        qint64 nSize = qMin(region.nSize - nDelta, nMaxSize);
+
+        // /proc/pid/mem can write to read-only mappings as a debugger does
+        ssize_t nWritten = pwrite(g_nHandle, pData, (size_t)nSize, (off_t)(region.nAddress + nDelta));
+
+        if (nWritten > 0) {
+            nResult = nWritten;
+        }
+    }
+#else
+    Q_UNUSED(pData)
+    Q_UNUSED(nMaxSize)
+#endif
+
+    return nResult;
+}
+
+qint32 ProcessMemoryDevice::findRegion(qint64 nOffset) const
+{
+    qint32 nResult = -1;
+
+    qint32 nLow = 0;
+    qint32 nHigh = g_listRegions.count() - 1;
+
+    while (nLow <= nHigh) {
+        qint32 nMid = (nLow + nHigh) / 2;
+
+        const REGION &region = g_listRegions.at(nMid);
+
+        if (nOffset < region.nOffset) {
+            nHigh = nMid - 1;
+        } else if (nOffset >= region.nOffset + region.nSize) {
+            nLow = nMid + 1;
+        } else {
+            nResult = nMid;
+            break;
+        }
+    }
+
+    return nResult;
+}
+
+void ProcessMemoryDevice::addFault(qint64 nOffset)
+{
+    QMutexLocker locker(&g_mutexFaults);
+
+    g_stFaultPages.insert(nOffset / N_PAGE_SIZE);
+}
+
+bool ProcessMemoryDevice::isFault(qint64 nOffset)
+{
+    QMutexLocker locker(&g_mutexFaults);
+
+    return g_stFaultPages.contains(nOffset / N_PAGE_SIZE);
+}
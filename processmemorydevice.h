@@ -0,0 +1,78 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef PROCESSMEMORYDEVICE_H
+#define PROCESSMEMORYDEVICE_H
+
+#include <QIODevice>
+#include <QMutex>
+#include <QSet>
+
+#include "xbinary.h"
+
+// Linux only: the mapped regions of a running process as one contiguous device
+class ProcessMemoryDevice : public QIODevice {
+    Q_OBJECT
+
+public:
+    struct REGION {
+        quint64 nAddress;
+        qint64 nSize;
+        qint64 nOffset;  // in the device
+        bool bReadable;
+        bool bWritable;
+        QString sName;
+    };
+
+    explicit ProcessMemoryDevice(qint64 nPID, QObject *pParent = nullptr);
+    ~ProcessMemoryDevice();
+
+    bool open(OpenMode mode) override;
+    void close() override;
+    bool isSequential() const override;
+    qint64 size() const override;
+
+    XBinary::_MEMORY_MAP getMemoryMap();
+    QList<REGION> getRegions();
+    bool isOffsetReadable(qint64 nOffset);
+
+    static QList<REGION> readRegions(qint64 nPID);
+
+protected:
+    qint64 readData(char *pData, qint64 nMaxSize) override;
+    qint64 writeData(const char *pData, qint64 nMaxSize) override;
+
+private:
+    qint32 findRegion(qint64 nOffset) const;
+    void addFault(qint64 nOffset);
+    bool isFault(qint64 nOffset);
+
+    const qint64 N_PAGE_SIZE = 0x1000;
+
+    qint64 g_nPID;
+    int g_nHandle;
+    qint64 g_nSize;
+    bool g_bVmReadv;
+    QList<REGION> g_listRegions;
+    QMutex g_mutexFaults;
+    QSet<qint64> g_stFaultPages;
+};
+
+#endif  // PROCESSMEMORYDEVICE_H
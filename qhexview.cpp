@@ -20,9 +20,246 @@
 //
 #include "qhexview.h"
 
+#include <QLocale>
+#include <QToolTip>
+#include <QtEndian>
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+#include "processmemorydevice.h"
+#include "qhexviewutils.h"
+
+QHexView *QHexView::g_pCursorView = nullptr;
+
+// Formatters are instantiated per element type and byte order, every unit is written with a fixed width
+typedef void (*FORMAT_PROC)(const char *pData, qint32 nNumberOfUnits, char *pOut);
+typedef bool (*PARSE_PROC)(const QString &sText, char *pOut);
+
+template <typename T>
+static qint32 _getDecimalWidth()
+{
+    return std::numeric_limits<T>::digits10 + 1 + (std::numeric_limits<T>::is_signed ? 1 : 0);
+}
+
+template <typename T>
+static qint32 _getFloatPrecision()
+{
+    return std::numeric_limits<T>::digits10 + 1;
+}
+
+template <typename T>
+static qint32 _getFloatWidth()
+{
+    return _getFloatPrecision<T>() + 7;  // sign, point, "e-308"
+}
+
+template <typename T, bool bIsBigEndian>
+static T _readUnit(const char *pData)
+{
+    return bIsBigEndian ? qFromBigEndian<T>(pData) : qFromLittleEndian<T>(pData);
+}
+
+template <typename T, bool bIsBigEndian>
+static void _writeUnit(T nValue, char *pOut)
+{
+    if (bIsBigEndian) {
+        qToBigEndian<T>(nValue, pOut);
+    } else {
+        qToLittleEndian<T>(nValue, pOut);
+    }
+}
+
+template <typename T, bool bIsBigEndian>
+static void _formatHex(const char *pData, qint32 nNumberOfUnits, char *pOut)
+{
+    static const char szDigits[] = "0123456789abcdef";
+
+    for (qint32 i = 0; i < nNumberOfUnits; i++) {
+        T nValue = _readUnit<T, bIsBigEndian>(pData + i * sizeof(T));
+
+        for (qint32 j = (qint32)sizeof(T) * 2 - 1; j >= 0; j--) {
+            pOut[j] = szDigits[nValue & 0xF];
+            nValue >>= 4;
+        }
+
+        pOut += sizeof(T) * 2;
+    }
+}
+
+template <typename T, bool bIsBigEndian>
+static void _formatDecimal(const char *pData, qint32 nNumberOfUnits, char *pOut)
+{
+    typedef typename std::make_unsigned<T>::type U;
+
+    const qint32 nWidth = _getDecimalWidth<T>();
+
+    for (qint32 i = 0; i < nNumberOfUnits; i++) {
+        T nValue = _readUnit<typename std::make_unsigned<T>::type, bIsBigEndian>(pData + i * sizeof(T));
+        // nValue < 0, written so that unsigned types do not warn
+        bool bNegative = std::numeric_limits<T>::is_signed && (nValue < (T)1) && (nValue != (T)0);
+        U nAbs = bNegative ? (U)(0 - (U)nValue) : (U)nValue;
+
+        qint32 j = nWidth - 1;
+
+        do {
+            pOut[j--] = (char)('0' + (nAbs % 10));
+            nAbs /= 10;
+        } while (nAbs);
+
+        if (bNegative) {
+            pOut[j--] = '-';
+        }
+
+        while (j >= 0) {
+            pOut[j--] = ' ';
+        }
+
+        pOut += nWidth;
+    }
+}
+
+template <typename T, bool bIsBigEndian>
+static void _formatFloat(const char *pData, qint32 nNumberOfUnits, char *pOut)
+{
+    typedef typename std::conditional<sizeof(T) == 4, quint32, quint64>::type I;
+
+    const qint32 nWidth = _getFloatWidth<T>();
+    const qint32 nPrecision = _getFloatPrecision<T>();
+
+    // Not the system locale: the same text on every machine, and it parses back
+    const QLocale locale = QLocale::c();
+
+    for (qint32 i = 0; i < nNumberOfUnits; i++) {
+        I nBits = _readUnit<I, bIsBigEndian>(pData + i * sizeof(T));
+        T fValue = 0;
+        memcpy(&fValue, &nBits, sizeof(T));
+
+        QByteArray baText = locale.toString((double)fValue, 'g', nPrecision).toLatin1();
+        qint32 nSize = qMin(baText.size(), nWidth);
+
+        memset(pOut, ' ', (size_t)(nWidth - nSize));
+        memcpy(pOut + nWidth - nSize, baText.constData(), (size_t)nSize);
+
+        pOut += nWidth;
+    }
+}
+
+template <typename T, bool bIsBigEndian>
+static bool _parseDecimal(const QString &sText, char *pOut)
+{
+    bool bResult = false;
+
+    T nValue = 0;
+
+    if (std::numeric_limits<T>::is_signed) {
+        qlonglong nNumber = sText.toLongLong(&bResult);
+
+        if (bResult) {
+            bResult = (nNumber >= (qlonglong)std::numeric_limits<T>::min()) && (nNumber <= (qlonglong)std::numeric_limits<T>::max());
+            nValue = (T)nNumber;
+        }
+    } else {
+        qulonglong nNumber = sText.toULongLong(&bResult);
+
+        if (bResult) {
+            bResult = (nNumber <= (qulonglong)std::numeric_limits<T>::max());
+            nValue = (T)nNumber;
+        }
+    }
+
+    if (bResult) {
+        _writeUnit<typename std::make_unsigned<T>::type, bIsBigEndian>((typename std::make_unsigned<T>::type)nValue, pOut);
+    }
+
+    return bResult;
+}
+
+template <typename T, bool bIsBigEndian>
+static bool _parseFloat(const QString &sText, char *pOut)
+{
+    typedef typename std::conditional<sizeof(T) == 4, quint32, quint64>::type I;
+
+    bool bResult = false;
+
+    T fValue = (T)QLocale::c().toDouble(sText.trimmed(), &bResult);
+
+    if (bResult) {
+        I nBits = 0;
+        memcpy(&nBits, &fValue, sizeof(T));
+
+        _writeUnit<I, bIsBigEndian>(nBits, pOut);
+    }
+
+    return bResult;
+}
+
+static FORMAT_PROC _getFormatProc(QHexView::DM displayMode, bool bIsBigEndian)
+{
+    FORMAT_PROC pResult = &_formatHex<quint8, false>;
+
+    switch (displayMode) {
+        case QHexView::DM_BYTE: pResult = &_formatHex<quint8, false>; break;
+        case QHexView::DM_WORD: pResult = bIsBigEndian ? &_formatHex<quint16, true> : &_formatHex<quint16, false>; break;
+        case QHexView::DM_DWORD: pResult = bIsBigEndian ? &_formatHex<quint32, true> : &_formatHex<quint32, false>; break;
+        case QHexView::DM_QWORD: pResult = bIsBigEndian ? &_formatHex<quint64, true> : &_formatHex<quint64, false>; break;
+        case QHexView::DM_INT16: pResult = bIsBigEndian ? &_formatDecimal<qint16, true> : &_formatDecimal<qint16, false>; break;
+        case QHexView::DM_INT32: pResult = bIsBigEndian ? &_formatDecimal<qint32, true> : &_formatDecimal<qint32, false>; break;
+        case QHexView::DM_INT64: pResult = bIsBigEndian ? &_formatDecimal<qint64, true> : &_formatDecimal<qint64, false>; break;
+        case QHexView::DM_UINT16: pResult = bIsBigEndian ? &_formatDecimal<quint16, true> : &_formatDecimal<quint16, false>; break;
+        case QHexView::DM_UINT32: pResult = bIsBigEndian ? &_formatDecimal<quint32, true> : &_formatDecimal<quint32, false>; break;
+        case QHexView::DM_UINT64: pResult = bIsBigEndian ? &_formatDecimal<quint64, true> : &_formatDecimal<quint64, false>; break;
+        case QHexView::DM_FLOAT: pResult = bIsBigEndian ? &_formatFloat<float, true> : &_formatFloat<float, false>; break;
+        case QHexView::DM_DOUBLE: pResult = bIsBigEndian ? &_formatFloat<double, true> : &_formatFloat<double, false>; break;
+    }
+
+    return pResult;
+}
+
+static PARSE_PROC _getParseProc(QHexView::DM displayMode, bool bIsBigEndian)
+{
+    PARSE_PROC pResult = nullptr;  // hex modes are edited by nibbles
+
+    switch (displayMode) {
+        case QHexView::DM_INT16: pResult = bIsBigEndian ? &_parseDecimal<qint16, true> : &_parseDecimal<qint16, false>; break;
+        case QHexView::DM_INT32: pResult = bIsBigEndian ? &_parseDecimal<qint32, true> : &_parseDecimal<qint32, false>; break;
+        case QHexView::DM_INT64: pResult = bIsBigEndian ? &_parseDecimal<qint64, true> : &_parseDecimal<qint64, false>; break;
+        case QHexView::DM_UINT16: pResult = bIsBigEndian ? &_parseDecimal<quint16, true> : &_parseDecimal<quint16, false>; break;
+        case QHexView::DM_UINT32: pResult = bIsBigEndian ? &_parseDecimal<quint32, true> : &_parseDecimal<quint32, false>; break;
+        case QHexView::DM_UINT64: pResult = bIsBigEndian ? &_parseDecimal<quint64, true> : &_parseDecimal<quint64, false>; break;
+        case QHexView::DM_FLOAT: pResult = bIsBigEndian ? &_parseFloat<float, true> : &_parseFloat<float, false>; break;
+        case QHexView::DM_DOUBLE: pResult = bIsBigEndian ? &_parseFloat<double, true> : &_parseFloat<double, false>; break;
+        default: break;
+    }
+
+    return pResult;
+}
+
+static void _getUnitInfo(QHexView::DM displayMode, qint32 *pnUnitSize, qint32 *pnUnitChars)
+{
+    switch (displayMode) {
+        case QHexView::DM_BYTE: *pnUnitSize = 1; *pnUnitChars = 2; break;
+        case QHexView::DM_WORD: *pnUnitSize = 2; *pnUnitChars = 4; break;
+        case QHexView::DM_DWORD: *pnUnitSize = 4; *pnUnitChars = 8; break;
+        case QHexView::DM_QWORD: *pnUnitSize = 8; *pnUnitChars = 16; break;
+        case QHexView::DM_INT16: *pnUnitSize = 2; *pnUnitChars = _getDecimalWidth<qint16>(); break;
+        case QHexView::DM_INT32: *pnUnitSize = 4; *pnUnitChars = _getDecimalWidth<qint32>(); break;
+        case QHexView::DM_INT64: *pnUnitSize = 8; *pnUnitChars = _getDecimalWidth<qint64>(); break;
+        case QHexView::DM_UINT16: *pnUnitSize = 2; *pnUnitChars = _getDecimalWidth<quint16>(); break;
+        case QHexView::DM_UINT32: *pnUnitSize = 4; *pnUnitChars = _getDecimalWidth<quint32>(); break;
+        case QHexView::DM_UINT64: *pnUnitSize = 8; *pnUnitChars = _getDecimalWidth<quint64>(); break;
+        case QHexView::DM_FLOAT: *pnUnitSize = 4; *pnUnitChars = _getFloatWidth<float>(); break;
+        case QHexView::DM_DOUBLE: *pnUnitSize = 8; *pnUnitChars = _getFloatWidth<double>(); break;
+    }
+}
+
 QHexView::QHexView(QWidget *pParent) : QAbstractScrollArea(pParent)
 {
     g_pDevice = nullptr;
+    g_pDataSource = nullptr;
+    g_pOverlay = nullptr;
+    g_bDataSourceOwned = false;
 
     g_bReadonly = true;
     g_bIsEdited = false;
@@ -30,26 +267,38 @@ QHexView::QHexView(QWidget *pParent) : QAbstractScrollArea(pParent)
     g_bMouseSelection = false;
     g_nDataSize = 0;
     g_bBlink = false;
+    g_bInit = false;
     g_nBytesProLine = 0;
+    g_nBytesProLineRequested = 0;
 
     g_nStartOffset = 0;
     g_nStartOffsetDelta = 0;
+    g_nBufferOffset = 0;
+    g_nBufferBlockSize = 0;
+    g_nFetchOffset = 0;
+    g_nFetchBlockSize = 0;
+
+    g_bFollowMode = false;
+    g_bFollowPinToEnd = false;
+    g_pFollowWatcher = nullptr;
+    g_bRefreshMode = false;
+    g_nHeatStartOffset = 0;
+    g_bMemoryMapColors = false;
+    g_encoding = QHexViewEncoding::ENC_ASCII;
+    g_displayMode = DM_BYTE;
+    g_bIsBigEndian = false;
+    g_nUnitSize = 1;
+    g_nUnitChars = 2;
 
     setBytesProLine(16);
     _initSelection(-1);
     g_nLineDelta = 4;  // mb 3
     g_posInfo.cursorPosition.nOffset = 0;
     g_posInfo.cursorPosition.type = CT_HIWORD;
+    g_posInfoEmitted = {};
 
-#ifdef Q_OS_WIN
-    setFont(QFont("Courier", 10));
-#endif
-#ifdef Q_OS_LINUX
-    setFont(QFont("Monospace", 10));
-#endif
-#ifdef Q_OS_OSX
-    setFont(QFont("Courier", 10));  // TODO Check "Menlo"
-#endif
+    // Measured once for all the views, the font is set when the view is shown
+    _getDefaultCharSize(&g_nCharWidth, &g_nCharHeight);
 
     setContextMenuPolicy(Qt::CustomContextMenu);
 
@@ -58,25 +307,108 @@ QHexView::QHexView(QWidget *pParent) : QAbstractScrollArea(pParent)
 
     connect(this, SIGNAL(customContextMenuRequested(QPoint)), this, SLOT(_customContextMenu(QPoint)));
 
-    connect(&g_timerCursor, SIGNAL(timeout()), this, SLOT(updateBlink()));
+    // Bursts of appends are coalesced into one size check
+    g_timerFollowUpdate.setSingleShot(true);
+    g_timerFollowUpdate.setInterval(50);
+    connect(&g_timerFollowUpdate, SIGNAL(timeout()), this, SLOT(_followCheckSize()));
 
-    g_timerCursor.setInterval(500);
-    g_timerCursor.start();
+    // Only for paths that cannot be watched and for non-file devices
+    g_timerFollowPoll.setInterval(500);
+    connect(&g_timerFollowPoll, SIGNAL(timeout()), this, SLOT(_followChanged()));
+
+    connect(&g_timerRefresh, SIGNAL(timeout()), this, SLOT(_refresh()));
+
+    g_timerFetch.setSingleShot(true);
+    g_timerFetch.setInterval(N_FRAME_INTERVAL);
+    connect(&g_timerFetch, SIGNAL(timeout()), this, SLOT(_fetchWindow()));
+    connect(&g_watcherFetch, SIGNAL(finished()), this, SLOT(_fetchFinished()));
 }
 
-// QHexView::~QHexView()
-//{
+QHexView::~QHexView()
+{
+    if (g_pCursorView == this) {
+        g_pCursorView = nullptr;
+        _getCursorTimer()->stop();
+    }
+
+    // The worker reads the data source
+    _cancelFetch();
+    _releaseDataSource();
+}
+
+void QHexView::_releaseDataSource()
+{
+    if (g_pDataSource) {
+        disconnect(g_pDataSource, SIGNAL(dataChanged(qint64, qint64)), this, SLOT(_dataSourceChanged(qint64, qint64)));
+        disconnect(g_pDataSource, SIGNAL(dataReset()), this, SLOT(_dataSourceReset()));
+    }
+
+    if (g_bDataSourceOwned) {
+        QHexViewDataSourceRegistry::release(g_pDataSource);
+    } else if (g_pOverlay) {
+        delete g_pOverlay;
+    }
 
-//}
+    g_pDataSource = nullptr;
+    g_pOverlay = nullptr;
+    g_bDataSourceOwned = false;
+}
+
+bool QHexView::_isOverlay(QIODevice *pDevice, OPTIONS *pOptions)
+{
+    // A running process changes its memory itself, edits are written at once
+    return pOptions && pOptions->bOverlay && (!qobject_cast<ProcessMemoryDevice *>(pDevice));
+}
 
 QIODevice *QHexView::getDevice() const
 {
     return g_pDevice;
 }
 
+QHexViewDataSource *QHexView::getDataSource() const
+{
+    return g_pDataSource;
+}
+
 void QHexView::setData(QIODevice *pDevice, OPTIONS *pOptions)
 {
-    this->g_pDevice = pDevice;
+    // The other views of the device share the cache and the edits
+    _setDataSource(QHexViewDataSourceRegistry::acquire(pDevice, _isOverlay(pDevice, pOptions)), true, pOptions);
+}
+
+void QHexView::setDataSource(QHexViewDataSource *pDataSource, OPTIONS *pOptions)
+{
+    _setDataSource(pDataSource, false, pOptions);
+}
+
+void QHexView::_setDataSource(QHexViewDataSource *pDataSource, bool bOwned, OPTIONS *pOptions)
+{
+    _cancelFetch();
+    clearUndo();
+    _releaseDataSource();
+
+    this->g_pDataSource = pDataSource;
+    this->g_bDataSourceOwned = bOwned;
+
+    if (bOwned) {
+        // From the registry, the overlay is shared too
+        g_pOverlay = qobject_cast<QHexViewOverlayDataSource *>(pDataSource);
+    } else if (pDataSource && pDataSource->isWritable() && _isOverlay(pDataSource->getDevice(), pOptions)) {
+        // The file is written on save, in a few large writes
+        g_pOverlay = new QHexViewOverlayDataSource(pDataSource, this);
+        this->g_pDataSource = g_pOverlay;
+    }
+
+    this->g_pDevice = nullptr;
+
+    if (pDataSource) {
+        this->g_pDevice = pDataSource->getDevice();
+    }
+
+    if (g_pDataSource) {
+        connect(g_pDataSource, SIGNAL(dataChanged(qint64, qint64)), this, SLOT(_dataSourceChanged(qint64, qint64)));
+        connect(g_pDataSource, SIGNAL(dataReset()), this, SLOT(_dataSourceReset()));
+    }
 
     if (pOptions) {
         this->g_sBackupFileName = pOptions->sBackupFileName;
@@ -84,8 +416,7 @@ void QHexView::setData(QIODevice *pDevice, OPTIONS *pOptions)
     }
 
     if (this->g_memoryMap.listRecords.count() == 0) {
-        XBinary binary(pDevice);
-        this->g_memoryMap = binary.getMemoryMap();
+        this->g_memoryMap = getDefaultMemoryMap();
     }
 
     init();
@@ -93,6 +424,10 @@ void QHexView::setData(QIODevice *pDevice, OPTIONS *pOptions)
     adjust();
     viewport()->update();
 
+    if (g_bFollowMode) {
+        setFollowMode(true, g_bFollowPinToEnd);
+    }
+
     if (pOptions) {
         goToAddress(pOptions->nStartAddress);
 
@@ -134,6 +469,12 @@ void QHexView::paintEvent(QPaintEvent *pEvent)
         for (qint32 i = 0; i < g_nLinesProPage; i++) {
             qint64 nLineAddress = XBinary::offsetToAddress(&g_memoryMap, g_nStartOffset + i * g_nBytesProLine);
 
+            if ((i < g_baBookmarkLines.size()) && (g_baBookmarkLines.at(i))) {
+                // Bookmark mark left of the address
+                QRect rectMark(topLeftX + 2, topLeftY + i * g_nLineHeight + g_nLineDelta + 2, g_nCharWidth - 4, g_nLineHeight - 4);
+                painter.fillRect(rectMark, viewport()->palette().color(QPalette::Highlight));
+            }
+
             if (nLineAddress != -1) {
                 qint32 nLinePosition = topLeftY + (i + 1) * g_nLineHeight;
                 QString sLineAddress = QString("%1").arg(nLineAddress, g_nAddressWidthCount, 16, QChar('0'));
@@ -145,65 +486,170 @@ void QHexView::paintEvent(QPaintEvent *pEvent)
         painter.setBackgroundMode(Qt::TransparentMode);
 
         // HEX
-        bool bIsSelected = false;
-        QColor color = viewport()->palette().color(QPalette::Base);
+        QColor colorBase = viewport()->palette().color(QPalette::Base);
+        QColor colorHighlight = viewport()->palette().color(QPalette::Highlight);
 
         qint32 nDataBufferSize = g_baDataBuffer.size();
+        qint32 nUnitsProLine = g_nBytesProLine / g_nUnitSize;
+        qint32 nUnitWidth = (g_nUnitChars + 1) * g_nCharWidth;
+        bool bHeat = (g_nHeatStartOffset == g_nBufferOffset);
+
+        qint32 nNumberOfSpanBytes = g_listSpanIndex.size();
+        qint32 nNumberOfColorBytes = g_listAnnotationColors.size();
+
+        // While a fetch is in flight the last data is drawn where it overlaps, the other lines only have addresses
+        qint64 nShift = g_nStartOffset - g_nBufferOffset;
+
+        if ((nShift % g_nUnitSize) || (nShift > nDataBufferSize) || (nShift < -g_nDataBlockSize)) {
+            nShift = nDataBufferSize;
+        }
 
         for (qint32 i = 0; i < g_nLinesProPage; i++) {
             qint32 nLinePosition = topLeftY + (i + 1) * g_nLineHeight;
 
-            for (qint32 j = 0; j < g_nBytesProLine; j++) {
-                bool _bIsSelected = false;
-
-                qint32 nBytePositionHEX = topLeftX + g_nHexPosition + j * g_nCharWidth * 3;
-                qint32 nBytePositionANSI = topLeftX + g_nAnsiPosition + j * g_nCharWidth;
-                qint32 nIndex = (j + i * g_nBytesProLine);
-                QString sHex = g_baDataHexBuffer.mid(nIndex * 2, 2);
-                char ch = ' ';
+            // One cell per unit, the text is formatted in adjust()
+            for (qint32 j = 0; j < nUnitsProLine; j++) {
+                qint32 nIndex = i * g_nBytesProLine + j * g_nUnitSize;
+                qint32 nBufferIndex = nIndex + (qint32)nShift;
+                qint32 nUnitPositionHEX = topLeftX + g_nHexPosition + j * nUnitWidth;
+                QString sUnit;
 
-                if (nIndex < nDataBufferSize) {
-                    ch = g_baDataBuffer.at(nIndex);
-                    ch = convertANSI(ch);
+                if (nBufferIndex >= 0) {
+                    sUnit = g_baDataHexBuffer.mid((nBufferIndex / g_nUnitSize) * g_nUnitChars, g_nUnitChars);
                 }
 
-                ST st = getSelectType(g_nStartOffset + nIndex);
+                ST stFirst = getSelectType(g_nStartOffset + nIndex);
+                ST stLast = (g_nUnitSize == 1) ? stFirst : getSelectType(g_nStartOffset + nIndex + g_nUnitSize - 1);
+                bool bIsSelected = (stFirst != ST_NOTSELECTED) || (stLast != ST_NOTSELECTED);
 
-                _bIsSelected = !(st == ST_NOTSELECTED);
+                bool bIsDiff = false;
+                bool bIsHole = false;
+                bool bBold = false;
+                quint8 nHeat = 0;
 
-                if (bIsSelected != _bIsSelected) {
-                    bIsSelected = _bIsSelected;
+                for (qint32 k = qMax(nBufferIndex, 0); (k < nBufferIndex + g_nUnitSize) && (k < nDataBufferSize); k++) {
+                    bIsDiff |= ((k < g_baDiffMask.size()) && (g_baDiffMask.at(k)));
+                    bIsHole |= ((k < g_baHoleMask.size()) && (g_baHoleMask.at(k)));
+                    bBold |= ((g_baDataBuffer.at(k) != 0) || ((k < g_baUnreadableMask.size()) && (g_baUnreadableMask.at(k))));
 
-                    if (st == ST_NOTSELECTED) {
-                        color = viewport()->palette().color(QPalette::Base);
-                        //                        painter.setPen(viewport()->palette().color(QPalette::WindowText));
-                    } else {
-                        color = viewport()->palette().color(QPalette::Highlight);
-                        //                        painter.setPen(viewport()->palette().color(QPalette::WindowText));
+                    if (bHeat && (k < g_baHeat.size())) {
+                        nHeat = qMax(nHeat, (quint8)g_baHeat.at(k));
                     }
                 }
 
-                int nCount = 3;
+                qint32 nCount = g_nUnitChars + 1;
 
-                if ((st == ST_END) || (st == ST_ONEBYTE) || ((st != ST_NOTSELECTED) && (j == g_nBytesProLine - 1))) {
-                    nCount = 2;
+                if ((stLast == ST_END) || (stLast == ST_ONEBYTE) || (bIsSelected && (j == nUnitsProLine - 1))) {
+                    nCount = g_nUnitChars;
                 }
 
                 // TODO flag changed if selected
                 QRect rect;
-                rect.setRect(nBytePositionHEX, nLinePosition - g_nLineHeight + g_nLineDelta, g_nCharWidth * nCount, g_nLineHeight);  // mb TODO fix 3
-                painter.fillRect(rect, color);
+                rect.setRect(nUnitPositionHEX, nLinePosition - g_nLineHeight + g_nLineDelta, g_nCharWidth * nCount, g_nLineHeight);
+                painter.fillRect(rect, bIsSelected ? colorHighlight : colorBase);
+
+                if ((!bIsSelected) && (nIndex < nNumberOfColorBytes) && (g_listAnnotationColors.at(nIndex))) {
+                    painter.fillRect(rect, QColor::fromRgba(g_listAnnotationColors.at(nIndex)));
+                }
+
+                if ((!bIsSelected) && (nIndex < nNumberOfSpanBytes) && (g_listSpanIndex.at(nIndex) != -1)) {
+                    painter.fillRect(rect, getSpanColor(g_listSpans.at(g_listSpanIndex.at(nIndex))));
+                }
+
+                if (nHeat) {
+                    painter.fillRect(rect, QColor(255, 0, 0, nHeat / 2));
+                }
+
+                if (bIsHole) {
+                    painter.fillRect(rect, QBrush(viewport()->palette().color(QPalette::Mid), Qt::BDiagPattern));
+                }
+
+                if (bBold) {
+                    painter.setFont(fontBold);
+                }
+
+                if (bIsDiff) {
+                    painter.setPen(QPen(Qt::red));
+                } else if (bIsHole) {
+                    painter.setPen(viewport()->palette().color(QPalette::Disabled, QPalette::WindowText));
+                }
+
+                painter.drawText(nUnitPositionHEX, nLinePosition, sUnit);
+
+                if (bIsDiff || bIsHole) {
+                    painter.setPen(viewport()->palette().color(QPalette::WindowText));
+                }
+
+                if (bBold) {
+                    // Restore
+                    painter.setFont(fontNormal);
+                }
+            }
+
+            // ANSI, one cell per byte
+            for (qint32 j = 0; j < g_nBytesProLine; j++) {
+                qint32 nBytePositionANSI = topLeftX + g_nAnsiPosition + j * g_nCharWidth;
+                qint32 nIndex = (j + i * g_nBytesProLine);
+                qint32 nBufferIndex = nIndex + (qint32)nShift;
+                bool bIsData = (nBufferIndex >= 0) && (nBufferIndex < nDataBufferSize);
+                quint32 nGlyph = ' ';
+                bool bIsUnreadable = bIsData && (nBufferIndex < g_baUnreadableMask.size()) && (g_baUnreadableMask.at(nBufferIndex));
+
+                if (bIsData && (nBufferIndex < g_listGlyphs.size())) {
+                    nGlyph = g_listGlyphs.at(nBufferIndex);
+
+                    if (bIsUnreadable) {
+                        nGlyph = '?';
+                    }
+                }
+
+                bool bIsDiff = bIsData && (nBufferIndex < g_baDiffMask.size()) && (g_baDiffMask.at(nBufferIndex));
+                bool bIsHole = bIsData && (nBufferIndex < g_baHoleMask.size()) && (g_baHoleMask.at(nBufferIndex));
+                bool bIsSelected = (getSelectType(g_nStartOffset + nIndex) != ST_NOTSELECTED);
+
+                quint8 nHeat = 0;
+
+                if (bHeat && bIsData && (nBufferIndex < g_baHeat.size())) {
+                    nHeat = (quint8)g_baHeat.at(nBufferIndex);
+                }
+
+                QRect rect;
                 rect.setRect(nBytePositionANSI, nLinePosition - g_nLineHeight + g_nLineDelta, g_nCharWidth, g_nLineHeight);
-                painter.fillRect(rect, color);
+                painter.fillRect(rect, bIsSelected ? colorHighlight : colorBase);
+
+                if ((!bIsSelected) && (nIndex < nNumberOfColorBytes) && (g_listAnnotationColors.at(nIndex))) {
+                    painter.fillRect(rect, QColor::fromRgba(g_listAnnotationColors.at(nIndex)));
+                }
+
+                if ((!bIsSelected) && (nIndex < nNumberOfSpanBytes) && (g_listSpanIndex.at(nIndex) != -1)) {
+                    painter.fillRect(rect, getSpanColor(g_listSpans.at(g_listSpanIndex.at(nIndex))));
+                }
+
+                if (nHeat) {
+                    painter.fillRect(rect, QColor(255, 0, 0, nHeat / 2));
+                }
+
+                if (bIsHole) {
+                    painter.fillRect(rect, QBrush(viewport()->palette().color(QPalette::Mid), Qt::BDiagPattern));
+                }
 
-                bool bBold = (sHex != "00");
+                bool bBold = (!bIsData) || (g_baDataBuffer.at(nBufferIndex) != 0) || bIsUnreadable;
 
                 if (bBold) {
                     painter.setFont(fontBold);
                 }
 
-                painter.drawText(nBytePositionHEX, nLinePosition, sHex);
-                painter.drawText(nBytePositionANSI, nLinePosition, QChar(ch));
+                if (bIsDiff) {
+                    painter.setPen(QPen(Qt::red));
+                } else if (bIsHole) {
+                    painter.setPen(viewport()->palette().color(QPalette::Disabled, QPalette::WindowText));
+                }
+
+                painter.drawText(nBytePositionANSI, nLinePosition, QHexViewEncoding::glyphToString(nGlyph));
+
+                if (bIsDiff || bIsHole) {
+                    painter.setPen(viewport()->palette().color(QPalette::WindowText));
+                }
 
                 if (bBold) {
                     // Restore
@@ -225,21 +671,31 @@ void QHexView::paintEvent(QPaintEvent *pEvent)
             painter.fillRect(g_rectCursor, this->palette().color(QPalette::Base));
         }
 
-        qint32 nRelOffset = g_posInfo.cursorPosition.nOffset - g_nStartOffset;
+        qint32 nRelOffset = (qint32)qBound((qint64)-1, g_posInfo.cursorPosition.nOffset - g_nBufferOffset, (qint64)g_baDataBuffer.size());
+
+        if ((nRelOffset < 0) || (nRelOffset >= g_baDataBuffer.size())) {
+            // Not fetched yet
+        } else if (g_posInfo.cursorPosition.type == CT_ANSI) {
+            quint32 nGlyph = ' ';
+
+            if (nRelOffset < g_listGlyphs.size()) {
+                nGlyph = g_listGlyphs.at(nRelOffset);
+            }
+
+            painter.drawText(g_rectCursor.x(), g_rectCursor.y() + g_nLineHeight - g_nLineDelta, QHexViewEncoding::glyphToString(nGlyph));
+        } else if ((g_posInfo.cursorPosition.type == CT_HIWORD) || (g_posInfo.cursorPosition.type == CT_LOWORD)) {
+            qint32 nDigit = _nibbleToDigit(nRelOffset % g_nUnitSize, g_posInfo.cursorPosition.type);
 
-        if (g_posInfo.cursorPosition.type == CT_ANSI) {
-            char ch = ' ';
+            painter.drawText(g_rectCursor.x(), g_rectCursor.y() + g_nLineHeight - g_nLineDelta,
+                             g_baDataHexBuffer.mid((nRelOffset / g_nUnitSize) * g_nUnitChars + nDigit, 1));
+        } else if (g_posInfo.cursorPosition.type == CT_UNIT) {
+            QString sUnit = g_sUnitEdit;
 
-            if (nRelOffset < g_baDataBuffer.size()) {
-                ch = g_baDataBuffer.at(nRelOffset);
-                ch = convertANSI(ch);
+            if (sUnit.isEmpty()) {
+                sUnit = g_baDataHexBuffer.mid((nRelOffset / g_nUnitSize) * g_nUnitChars, g_nUnitChars);
             }
 
-            painter.drawText(g_rectCursor.x(), g_rectCursor.y() + g_nLineHeight - g_nLineDelta, QChar(ch));
-        } else if (g_posInfo.cursorPosition.type == CT_HIWORD) {
-            painter.drawText(g_rectCursor.x(), g_rectCursor.y() + g_nLineHeight - g_nLineDelta, g_baDataHexBuffer.mid(nRelOffset * 2, 1));
-        } else if (g_posInfo.cursorPosition.type == CT_LOWORD) {
-            painter.drawText(g_rectCursor.x(), g_rectCursor.y() + g_nLineHeight - g_nLineDelta, g_baDataHexBuffer.mid(nRelOffset * 2 + 1, 1));
+            painter.drawText(g_rectCursor.x(), g_rectCursor.y() + g_nLineHeight - g_nLineDelta, sUnit.rightJustified(g_nUnitChars, ' ', true));
         }
     }
 
@@ -251,10 +707,27 @@ void QHexView::mouseMoveEvent(QMouseEvent *pEvent)
     if (g_bMouseSelection) {
         viewport()->update();
 
-        int nPos = getCursorPosition(pEvent->pos()).nOffset;
+        CURSOR_POSITION cp = getCursorPosition(pEvent->pos());
+        qint64 nPos = cp.nOffset;
+        bool bUnits = (cp.type != CT_ANSI) && (g_nUnitSize > 1);
+
+        if ((nPos >= 0) && bUnits) {
+            // Whole units in the grouped modes
+            nPos = _getUnitOffset(nPos);
+
+            if (nPos >= g_posInfo.nSelectionInitOffset) {
+                nPos = qMin(nPos + g_nUnitSize - 1, g_nDataSize - 1);
+            }
+        }
 
         if (nPos >= 0) {
             _setSelection(nPos);
+
+            if (bUnits && (nPos < g_posInfo.nSelectionInitOffset)) {
+                // Backwards the unit the drag started in stays selected as a whole
+                g_posInfo.nSelectionEndOffset = qMin(g_posInfo.nSelectionInitOffset + g_nUnitSize - 1, g_nDataSize - 1);
+            }
+
             emit cursorPositionChanged();
             //        _rectCursor=QRect(0,0,100,100);
         }
@@ -269,9 +742,11 @@ void QHexView::mousePressEvent(QMouseEvent *pEvent)
         //        viewport()->update();
         CURSOR_POSITION cp = getCursorPosition(pEvent->pos());
 
+        g_sUnitEdit.clear();
+
         if (cp.nOffset >= 0) {
             g_posInfo.cursorPosition = cp;
-            _initSelection(cp.nOffset);
+            _initSelection(((cp.type != CT_ANSI) && (g_nUnitSize > 1)) ? _getUnitOffset(cp.nOffset) : cp.nOffset);
             //        _rectCursor=QRect(0,0,100,100);
             g_bMouseSelection = true;
         }
@@ -289,7 +764,9 @@ quint32 QHexView::getBytesProLine() const
 
 void QHexView::setBytesProLine(const quint32 nBytesProLine)
 {
-    g_nBytesProLine = nBytesProLine;
+    g_nBytesProLineRequested = (qint32)nBytesProLine;
+
+    _adjustBytesProLine();
 }
 
 // qint64 QHexView::getBaseAddress() const
@@ -299,10 +776,7 @@ void QHexView::setBytesProLine(const quint32 nBytesProLine)
 
 void QHexView::setFont(const QFont &font)
 {
-    const QFontMetricsF fm(font);
-    g_nCharWidth = fm.boundingRect('2').width();
-    g_nCharWidth = qMax(fm.boundingRect('W').width(), (qreal)g_nCharWidth);
-    g_nCharHeight = fm.height();
+    _getCharSize(font, &g_nCharWidth, &g_nCharHeight);
 
     QAbstractScrollArea::setFont(font);
 
@@ -362,8 +836,8 @@ bool QHexView::setReadonly(bool bState)
 {
     bool bResult = false;
 
-    if (g_pDevice) {
-        if ((bState) || ((!bState) && (g_pDevice->isWritable()))) {
+    if (g_pDataSource) {
+        if ((bState) || ((!bState) && (g_pDataSource->isWritable()))) {
             g_bReadonly = bState;
             bResult = true;
         }
@@ -372,17 +846,17 @@ bool QHexView::setReadonly(bool bState)
     return bResult;
 }
 
+bool QHexView::isReadonly()
+{
+    return g_bReadonly;
+}
+
 QByteArray QHexView::readArray(qint64 nOffset, qint64 nSize)
 {
     QByteArray baResult;
 
-    if (g_pDevice->seek(nOffset) && (nOffset + nSize <= g_pDevice->size())) {
-        baResult.resize((qint32)nSize);
-        qint64 _nSize = g_pDevice->read(baResult.data(), nSize);
-
-        if (_nSize != nSize) {
-            baResult.resize((qint32)_nSize);
-        }
+    if (g_pDataSource) {
+        baResult = g_pDataSource->read(nOffset, nSize);
     }
 
     return baResult;
@@ -403,260 +877,1612 @@ qint64 QHexView::getBaseAddress()
     return this->getMemoryMap()->nModuleAddress;
 }
 
-char QHexView::convertANSI(char cByte)
+void QHexView::setDiffRanges(const QVector<RANGE> &listDiffRanges)
 {
-    if ((cByte < 0x20) || (cByte > 0x7e)) {
-        cByte = '.';
-    }
+    g_listDiffRanges = listDiffRanges;
 
-    return cByte;
+    adjust();
+    viewport()->update();
 }
 
-QString QHexView::getFontName()
+qint64 QHexView::getNextDiffOffset(qint64 nOffset)
 {
-    QString sResult;
-#ifdef Q_OS_WIN
-    sResult = "Courier";
-#endif
-#ifdef Q_OS_LINUX
-    sResult = "Monospace";
-#endif
-#ifdef Q_OS_OSX
-    sResult = "Courier";  // TODO Check "Menlo"
-#endif
-    return sResult;
-}
+    qint64 nResult = -1;
 
-void QHexView::goToAddress(qint64 nAddress)
-{
-    if ((isAddressValid(nAddress)) && (g_nBytesProLine)) {
-        qint64 nOffset = addressToOffset(nAddress);
+    // Sorted, not overlapping
+    QVector<RANGE>::const_iterator iter =
+        std::upper_bound(g_listDiffRanges.constBegin(), g_listDiffRanges.constEnd(), nOffset, [](qint64 nValue, const RANGE &range) { return nValue < range.nOffset; });
 
-        goToOffset(nOffset);
+    if (iter != g_listDiffRanges.constEnd()) {
+        nResult = iter->nOffset;
     }
+
+    return nResult;
 }
 
-void QHexView::goToRelAddress(qint64 nRelAddress)
+qint64 QHexView::getNextDataOffset(qint64 nOffset)
 {
-    if ((isRelAddressValid(nRelAddress)) && (g_nBytesProLine)) {
-        qint64 nOffset = relAddressToOffset(nRelAddress);
+    qint64 nResult = -1;
 
-        goToOffset(nOffset);
+    if (g_pDataSource) {
+        // From data: skip the rest of the extent and the hole after it
+        nResult = g_pDataSource->getNextData(g_pDataSource->getNextHole(nOffset));
     }
+
+    return nResult;
 }
 
-void QHexView::goToOffset(qint64 nOffset)
+qint64 QHexView::getPrevDiffOffset(qint64 nOffset)
 {
-    if ((isOffsetValid(nOffset)) && (g_nBytesProLine)) {
-        verticalScrollBar()->setValue((nOffset) / g_nBytesProLine);  // TODO check for large files
-        g_nStartOffsetDelta = (nOffset) % g_nBytesProLine;
+    qint64 nResult = -1;
 
-        //        posInfo.cursorPosition.nOffset+=(addressToOffset(nAddress))%_nBytesProLine;
-        //        posInfo.cursorPosition.nOffset=addressToOffset(nAddress);
-        //        qDebug(QString::number(posInfo.cursorPosition.nOffset,16).toLatin1().data());
-        g_posInfo.cursorPosition.nOffset = nOffset;
-        g_posInfo.cursorPosition.type = CT_HIWORD;
-        //        qDebug(QString::number(posInfo.cursorPosition.nOffset,16).toLatin1().data());
+    QVector<RANGE>::const_iterator iter =
+        std::lower_bound(g_listDiffRanges.constBegin(), g_listDiffRanges.constEnd(), nOffset, [](const RANGE &range, qint64 nValue) { return range.nOffset < nValue; });
+
+    if (iter != g_listDiffRanges.constBegin()) {
+        iter--;
+        nResult = iter->nOffset;
     }
+
+    return nResult;
 }
 
-void QHexView::_goToOffset(qint64 nOffset)
+void QHexView::setFollowMode(bool bState, bool bPinToEnd)
 {
-    if ((isOffsetValid(nOffset)) && (g_nBytesProLine)) {
-        verticalScrollBar()->setValue((nOffset) / g_nBytesProLine);
-        g_nStartOffsetDelta = (nOffset) % g_nBytesProLine;
+    g_bFollowMode = bState;
+    g_bFollowPinToEnd = bPinToEnd;
+
+    if (g_pFollowWatcher) {
+        delete g_pFollowWatcher;
+        g_pFollowWatcher = nullptr;
+    }
+
+    g_timerFollowPoll.stop();
+    g_timerFollowUpdate.stop();
+
+    if (g_bFollowMode && g_pDevice) {
+        QFile *pFile = qobject_cast<QFile *>(g_pDevice);
+
+        if (pFile && (pFile->fileName() != "")) {
+            g_pFollowWatcher = new QFileSystemWatcher(this);
+
+            if (g_pFollowWatcher->addPath(pFile->fileName())) {
+                connect(g_pFollowWatcher, SIGNAL(fileChanged(QString)), this, SLOT(_followChanged()));
+            } else {
+                delete g_pFollowWatcher;
+                g_pFollowWatcher = nullptr;
+            }
+        }
+
+        if (!g_pFollowWatcher) {
+            g_timerFollowPoll.start();
+        }
+
+        _followCheckSize();
+    }
+}
+
+bool QHexView::isFollowMode()
+{
+    return g_bFollowMode;
+}
+
+void QHexView::setRefreshMode(bool bState, qint32 nInterval)
+{
+    g_bRefreshMode = bState;
+
+    g_baHeat.clear();
+
+    if (g_bRefreshMode) {
+        g_timerRefresh.start(nInterval);
+    } else {
+        g_timerRefresh.stop();
+        viewport()->update();
+    }
+}
+
+bool QHexView::isRefreshMode()
+{
+    return g_bRefreshMode;
+}
+
+bool QHexView::addWatchRange(qint64 nOffset, qint64 nSize)
+{
+    bool bResult = false;
+
+    if ((nSize > 0) && (nSize <= N_MAX_WATCH_SIZE)) {
+        WATCH_RANGE watchRange = {};
+        watchRange.nOffset = nOffset;
+        watchRange.nSize = nSize;
+        watchRange.baSnapshot = readArray(nOffset, nSize);
+
+        g_listWatchRanges.append(watchRange);
+
+        bResult = true;
+    }
+
+    return bResult;
+}
+
+void QHexView::clearWatchRanges()
+{
+    g_listWatchRanges.clear();
+}
+
+void QHexView::setEncoding(QHexViewEncoding::ENC encoding)
+{
+    g_encoding = encoding;
+
+    adjust();
+    viewport()->update();
+}
+
+QHexViewEncoding::ENC QHexView::getEncoding()
+{
+    return g_encoding;
+}
+
+void QHexView::setDisplayMode(DM displayMode, bool bIsBigEndian)
+{
+    g_displayMode = displayMode;
+    g_bIsBigEndian = bIsBigEndian;
+    g_sUnitEdit.clear();
+
+    _getUnitInfo(displayMode, &g_nUnitSize, &g_nUnitChars);
+
+    _adjustBytesProLine();
+
+    if (g_posInfo.cursorPosition.nOffset != -1) {
+        if (_isHexMode()) {
+            if (g_posInfo.cursorPosition.type == CT_UNIT) {
+                g_posInfo.cursorPosition.type = CT_HIWORD;
+            }
+        } else if ((g_posInfo.cursorPosition.type == CT_HIWORD) || (g_posInfo.cursorPosition.type == CT_LOWORD)) {
+            g_posInfo.cursorPosition.type = CT_UNIT;
+            g_posInfo.cursorPosition.nOffset = _getUnitOffset(g_posInfo.cursorPosition.nOffset);
+        }
+    }
+
+    adjust();
+    viewport()->update();
+}
+
+QHexView::DM QHexView::getDisplayMode()
+{
+    return g_displayMode;
+}
+
+bool QHexView::isBigEndian()
+{
+    return g_bIsBigEndian;
+}
+
+QList<QHexView::DM> QHexView::getDisplayModes()
+{
+    QList<DM> listResult;
+
+    listResult.append(DM_BYTE);
+    listResult.append(DM_WORD);
+    listResult.append(DM_DWORD);
+    listResult.append(DM_QWORD);
+    listResult.append(DM_INT16);
+    listResult.append(DM_INT32);
+    listResult.append(DM_INT64);
+    listResult.append(DM_UINT16);
+    listResult.append(DM_UINT32);
+    listResult.append(DM_UINT64);
+    listResult.append(DM_FLOAT);
+    listResult.append(DM_DOUBLE);
+
+    return listResult;
+}
+
+QString QHexView::displayModeToString(DM displayMode)
+{
+    QString sResult;
+
+    switch (displayMode) {
+        case DM_BYTE: sResult = QString("Byte"); break;
+        case DM_WORD: sResult = QString("Word"); break;
+        case DM_DWORD: sResult = QString("Dword"); break;
+        case DM_QWORD: sResult = QString("Qword"); break;
+        case DM_INT16: sResult = QString("Int16"); break;
+        case DM_INT32: sResult = QString("Int32"); break;
+        case DM_INT64: sResult = QString("Int64"); break;
+        case DM_UINT16: sResult = QString("UInt16"); break;
+        case DM_UINT32: sResult = QString("UInt32"); break;
+        case DM_UINT64: sResult = QString("UInt64"); break;
+        case DM_FLOAT: sResult = QString("Float"); break;
+        case DM_DOUBLE: sResult = QString("Double"); break;
+    }
+
+    return sResult;
+}
+
+bool QHexView::patch(PatchProcess::PO op, qint64 nOffset, qint64 nSize, const QByteArray &baPattern, QIODevice *pInput)
+{
+    bool bResult = false;
+
+    if (g_pDataSource && (!g_bReadonly) && (nSize > 0) && isOffsetValid(nOffset) && (nOffset + nSize <= g_nDataSize) && _saveBackup()) {
+        UNDO_RECORD record = {};
+        record.nOffset = nOffset;
+        record.pData = _createUndoDevice(nSize);
+
+        if (record.pData) {
+            PatchProcess patchProcess;
+            patchProcess.setData(g_pDataSource, nOffset, nSize, op, baPattern, pInput);
+            patchProcess.setUndoDevice(record.pData);
+
+            bResult = _runProcess(&patchProcess, nSize, tr("Patch"));
+
+            // A stopped patch is undone as far as it got
+            record.nSize = patchProcess.getWrittenSize();
+
+            if (record.nSize) {
+                _addRecord(&g_listUndo, record);
+                _clearRecords(&g_listRedo);
+
+                g_bIsEdited = true;
+
+                emit editState(g_bIsEdited);
+
+                adjust();
+                viewport()->update();
+            } else {
+                delete record.pData;
+            }
+        }
+    }
+
+    return bResult;
+}
+
+bool QHexView::paste(bool bHex)
+{
+    bool bResult = false;
+
+    const QMimeData *pMimeData = QApplication::clipboard()->mimeData();
+
+    if (pMimeData && (!g_bReadonly)) {
+        QByteArray baData;
+        bool bValid = false;
+
+        if (bHex) {
+            bValid = PatchProcess::hexToBytes(pMimeData->text().toLatin1(), &baData);
+        } else if (pMimeData->hasFormat("application/octet-stream")) {
+            baData = pMimeData->data("application/octet-stream");
+            bValid = !baData.isEmpty();
+        } else {
+            bValid = QHexViewEncoding::encodeString(g_encoding, pMimeData->text(), &baData);
+        }
+
+        if (bValid) {
+            STATE state = getState();
+
+            qint64 nOffset = state.nSelectionSize ? state.nSelectionOffset : state.nCursorOffset;
+            qint64 nSize = qMin((qint64)baData.size(), g_nDataSize - nOffset);
+
+            bResult = patch(PatchProcess::PO_WRITE, nOffset, nSize, baData);
+        } else if (pMimeData->hasText()) {
+            emit errorMessage(bHex ? tr("Invalid hex") : tr("Cannot encode the text"));
+        }
+    }
+
+    return bResult;
+}
+
+bool QHexView::replace(qint64 nOffset, qint64 nSize, const QByteArray &baFind, const QByteArray &baReplace, qint64 nLimit, qint64 *pnCount)
+{
+    bool bResult = false;
+    qint64 nCount = 0;
+
+    bool bResize = (baFind.size() != baReplace.size());
+
+    if (bResize && isModified()) {
+        emit errorMessage(tr("Save the changes first"));
+    } else if (g_pDataSource && (!g_bReadonly) && (nSize > 0) && (!baFind.isEmpty()) && _saveBackup()) {
+        // The size of the file is changed, the overlay is not used
+        QHexViewDataSource *pDataSource = (bResize && g_pOverlay) ? g_pOverlay->getSource() : g_pDataSource;
+
+        // Too many possible hits for a list of offsets: the old data is kept in a file from there
+        bool bUndoData = (!bResize) && (nSize / baFind.size() > ReplaceProcess::N_MAX_UNDO_OFFSETS);
+        QIODevice *pUndo = nullptr;
+
+        if (bUndoData) {
+            pUndo = _createUndoDevice(nSize);
+        }
+
+        if ((!bUndoData) || pUndo) {
+            ReplaceProcess replaceProcess;
+            replaceProcess.setData(pDataSource, nOffset, nSize, baFind, baReplace, bResize ? ReplaceProcess::RM_RESIZE : ReplaceProcess::RM_REPLACE, nLimit);
+            replaceProcess.setUndoDevice(pUndo);
+
+            bResult = _runProcess(&replaceProcess, nSize, tr("Replace"));
+
+            nCount = replaceProcess.getCount();
+
+            if (nCount) {
+                if (bResize) {
+                    // The data after the first hit moved, all views of it start over
+                    pDataSource->invalidate(0, -1);
+                    pDataSource->reset();
+                } else {
+                    QVector<qint64> listOffsets = replaceProcess.getOffsets();
+
+                    UNDO_RECORD record = {};
+
+                    if (listOffsets.isEmpty()) {
+                        record.nOffset = replaceProcess.getUndoOffset();
+                        record.nSize = replaceProcess.getUndoSize();
+                        record.pData = pUndo;
+
+                        pUndo = nullptr;
+                    } else {
+                        record.nOffset = listOffsets.first();
+                        record.nSize = listOffsets.last() + baFind.size() - record.nOffset;
+                        record.listOffsets = listOffsets;
+                        record.baData = baFind;
+                        record.baSwap = baReplace;
+                    }
+
+                    _addRecord(&g_listUndo, record);
+                    _clearRecords(&g_listRedo);
+                }
+
+                g_bIsEdited = true;
+
+                emit editState(g_bIsEdited);
+            }
+
+            adjust();
+            viewport()->update();
+        }
+
+        delete pUndo;
+    }
+
+    if (pnCount) {
+        *pnCount = nCount;
+    }
+
+    return bResult;
+}
+
+bool QHexView::canUndo()
+{
+    return !g_listUndo.isEmpty();
+}
+
+bool QHexView::canRedo()
+{
+    return !g_listRedo.isEmpty();
+}
+
+bool QHexView::undo()
+{
+    return _swapRecord(&g_listUndo, &g_listRedo, tr("Undo"));
+}
+
+bool QHexView::redo()
+{
+    return _swapRecord(&g_listRedo, &g_listUndo, tr("Redo"));
+}
+
+void QHexView::clearUndo()
+{
+    _clearRecords(&g_listUndo);
+    _clearRecords(&g_listRedo);
+}
+
+bool QHexView::isModified()
+{
+    bool bResult = false;
+
+    if (g_pOverlay) {
+        bResult = g_pOverlay->isModified();
+    }
+
+    return bResult;
+}
+
+bool QHexView::save()
+{
+    bool bResult = true;
+
+    if (isModified()) {
+        SaveProcess saveProcess;
+        saveProcess.setData(g_pOverlay);
+
+        bResult = _runProcess(&saveProcess, g_pOverlay->getModifiedSize(), tr("Save"));
+
+        if (bResult) {
+            g_bIsEdited = false;
+
+            emit editState(g_bIsEdited);
+        }
+
+        adjust();
+        viewport()->update();
+    }
+
+    return bResult;
+}
+
+bool QHexView::saveAs(QString sFileName)
+{
+    bool bResult = false;
+
+    if (g_pDataSource) {
+        // Written next to the file and renamed, the old file stays if it fails
+        FileDumpProcess fileDumpProcess;
+        fileDumpProcess.setData(g_pDataSource, 0, g_pDataSource->getSize(), sFileName);
+        fileDumpProcess.setAtomic(true);
+
+        bResult = _runProcess(&fileDumpProcess, g_pDataSource->getSize(), tr("Save as"));
+    }
+
+    return bResult;
+}
+
+void QHexView::discardChanges()
+{
+    if (g_pOverlay) {
+        // The views of the overlay are reset by it
+        g_pOverlay->clear();
+    }
+}
+
+void QHexView::addStructure(const QHexViewStructures::STRUCT &structure, qint64 nOffset, qint64 nCount)
+{
+    g_structures.addRecord(structure, nOffset, nCount);
+
+    _updateSpans();
+    viewport()->update();
+}
+
+void QHexView::clearStructures()
+{
+    g_structures.clear();
+
+    _updateSpans();
+    viewport()->update();
+}
+
+void QHexView::addAnnotation(qint64 nOffset, qint64 nSize, QColor color, QString sText, bool bBookmark)
+{
+    QHexViewAnnotations::ANNOTATION annotation = {};
+    annotation.nOffset = nOffset;
+    annotation.nSize = nSize;
+    annotation.nColor = color.rgba();
+    annotation.bBookmark = bBookmark;
+    annotation.sText = sText;
+
+    g_annotations.add(annotation);
+
+    _updateAnnotations();
+    viewport()->update();
+}
+
+void QHexView::appendAnnotations(const QVector<QHexViewAnnotations::ANNOTATION> &listAnnotations)
+{
+    g_annotations.append(listAnnotations);
+
+    _updateAnnotations();
+    viewport()->update();
+}
+
+qint32 QHexView::removeAnnotations(qint64 nOffset)
+{
+    qint32 nResult = g_annotations.remove(nOffset);
+
+    if (nResult) {
+        _updateAnnotations();
+        viewport()->update();
+    }
+
+    return nResult;
+}
+
+void QHexView::clearAnnotations()
+{
+    g_annotations.clear();
+
+    _updateAnnotations();
+    viewport()->update();
+}
+
+QVector<QHexViewAnnotations::ANNOTATION> QHexView::getAnnotations()
+{
+    return g_annotations.getAnnotations();
+}
+
+qint64 QHexView::getNextBookmark(qint64 nOffset)
+{
+    return g_annotations.getNextBookmark(nOffset);
+}
+
+qint64 QHexView::getPrevBookmark(qint64 nOffset)
+{
+    return g_annotations.getPrevBookmark(nOffset);
+}
+
+void QHexView::setMemoryMapColors(bool bState)
+{
+    g_bMemoryMapColors = bState;
+
+    _setMemoryMapAnnotations();
+    _updateAnnotations();
+    viewport()->update();
+}
+
+bool QHexView::isMemoryMapColors()
+{
+    return g_bMemoryMapColors;
+}
+
+void QHexView::_formatUnits()
+{
+    qint32 nCount = g_baDataBuffer.size();
+    qint32 nNumberOfUnits = nCount / g_nUnitSize;
+    qint32 nTailSize = nCount % g_nUnitSize;
+
+    g_baDataHexBuffer.resize((nNumberOfUnits + ((nTailSize) ? 1 : 0)) * g_nUnitChars);
+
+    _getFormatProc(g_displayMode, g_bIsBigEndian)(g_baDataBuffer.constData(), nNumberOfUnits, g_baDataHexBuffer.data());
+
+    if (nTailSize) {
+        // The last unit is cut by the end of the data, its bytes are shown as they are
+        char *pOut = g_baDataHexBuffer.data() + nNumberOfUnits * g_nUnitChars;
+
+        memset(pOut, ' ', g_nUnitChars);
+        _formatHex<quint8, false>(g_baDataBuffer.constData() + nNumberOfUnits * g_nUnitSize, nTailSize, pOut);
+    }
+
+    if (g_baUnreadableMask.size()) {
+        for (qint32 i = 0; i < nCount; i++) {
+            if (g_baUnreadableMask.at(i)) {
+                memset(g_baDataHexBuffer.data() + (i / g_nUnitSize) * g_nUnitChars, '?', g_nUnitChars);
+            }
+        }
+    }
+}
+
+bool QHexView::_isHexMode()
+{
+    return (g_displayMode == DM_BYTE) || (g_displayMode == DM_WORD) || (g_displayMode == DM_DWORD) || (g_displayMode == DM_QWORD);
+}
+
+void QHexView::_adjustBytesProLine()
+{
+    // Units never cross lines, the requested width comes back in the byte mode
+    g_nBytesProLine = qMax(g_nUnitSize, ((g_nBytesProLineRequested + g_nUnitSize - 1) / g_nUnitSize) * g_nUnitSize);
+    g_nTotalLineCount = g_nDataSize / g_nBytesProLine + 1;
+}
+
+qint64 QHexView::_getUnitOffset(qint64 nOffset)
+{
+    // Lines start at g_nStartOffsetDelta and hold whole units
+    qint64 nDelta = (nOffset - g_nStartOffsetDelta) % g_nUnitSize;
+
+    if (nDelta < 0) {
+        nDelta += g_nUnitSize;
+    }
+
+    return nOffset - nDelta;
+}
+
+qint32 QHexView::_nibbleToDigit(qint32 nByte, CURSOR_TYPE type)
+{
+    qint32 nIndex = g_bIsBigEndian ? nByte : (g_nUnitSize - 1 - nByte);
+
+    return nIndex * 2 + ((type == CT_LOWORD) ? 1 : 0);
+}
+
+void QHexView::_digitToNibble(qint32 nDigit, qint32 *pnByte, CURSOR_TYPE *pType)
+{
+    qint32 nIndex = nDigit / 2;
+
+    *pnByte = g_bIsBigEndian ? nIndex : (g_nUnitSize - 1 - nIndex);
+    *pType = (nDigit % 2) ? CT_LOWORD : CT_HIWORD;
+}
+
+void QHexView::_moveCursorDigit(bool bForward)
+{
+    // Digits follow the screen, in little endian units the bytes go right to left
+    qint64 nUnitOffset = _getUnitOffset(g_posInfo.cursorPosition.nOffset);
+    qint32 nDigit = _nibbleToDigit(g_posInfo.cursorPosition.nOffset - nUnitOffset, g_posInfo.cursorPosition.type);
+
+    if (bForward) {
+        nDigit++;
+
+        if (nDigit >= g_nUnitSize * 2) {
+            nUnitOffset += g_nUnitSize;
+            nDigit = 0;
+        }
+    } else {
+        nDigit--;
+
+        if (nDigit < 0) {
+            nUnitOffset -= g_nUnitSize;
+            nDigit = g_nUnitSize * 2 - 1;
+        }
+    }
+
+    qint32 nByte = 0;
+
+    _digitToNibble(nDigit, &nByte, &(g_posInfo.cursorPosition.type));
+
+    g_posInfo.cursorPosition.nOffset = nUnitOffset + nByte;
+}
+
+bool QHexView::_editUnit(QKeyEvent *pEvent, QByteArray *pbaUnit)
+{
+    bool bResult = false;
+
+    qint32 nKey = pEvent->key();
+    QString sText = pEvent->text();
+
+    if (nKey == Qt::Key_Escape) {
+        g_sUnitEdit.clear();
+    } else if (nKey == Qt::Key_Backspace) {
+        g_sUnitEdit.chop(1);
+    } else if ((nKey == Qt::Key_Return) || (nKey == Qt::Key_Enter)) {
+        PARSE_PROC pParse = _getParseProc(g_displayMode, g_bIsBigEndian);
+
+        if (pParse && (!g_sUnitEdit.isEmpty())) {
+            pbaUnit->resize(g_nUnitSize);
+
+            bResult = pParse(g_sUnitEdit.trimmed(), pbaUnit->data());
+
+            if (bResult) {
+                g_sUnitEdit.clear();
+            } else {
+                emit errorMessage(tr("Invalid value") + QString(": %1").arg(g_sUnitEdit));
+            }
+        }
+    } else if ((sText.size() == 1) && (QString("0123456789+-.eE").contains(sText)) && (g_sUnitEdit.size() < g_nUnitChars)) {
+        g_sUnitEdit.append(sText);
+    }
+
+    viewport()->update();
+
+    return bResult;
+}
+
+bool QHexView::_saveBackup()
+{
+    bool bResult = true;
+
+    if (!g_bIsEdited) {
+        // TODO Check
+        // Save backup
+        if (g_sBackupFileName != "") {
+            if (!QFile::exists(g_sBackupFileName)) {
+                if (g_pDevice && (g_pDevice->metaObject()->className() == QString("QFile"))) {
+                    QString sFileName = ((QFile *)g_pDevice)->fileName();
+
+                    if (!QFile::copy(sFileName, g_sBackupFileName)) {
+                        bResult = false;
+                        emit errorMessage(tr("Cannot save file") + QString(": %1").arg(g_sBackupFileName));
+                    }
+                }
+                // TODO if not file/ Create file/ Write data
+            }
+        }
+    }
+
+    return bResult;
+}
+
+QIODevice *QHexView::_createUndoDevice(qint64 nSize)
+{
+    QIODevice *pResult = nullptr;
+
+    if (nSize > N_UNDO_MEMORY_SIZE) {
+        pResult = new QTemporaryFile(this);
+    } else {
+        pResult = new QBuffer(this);
+    }
+
+    if (!pResult->open(QIODevice::ReadWrite)) {
+        emit errorMessage(tr("Cannot create undo data"));
+
+        delete pResult;
+        pResult = nullptr;
+    }
+
+    return pResult;
+}
+
+bool QHexView::_runProcess(HexProcess *pProcess, qint64 nSize, const QString &sTitle)
+{
+    // The view opens no dialogs, the widget around it shows the progress
+    if ((nSize > N_PATCH_DIALOG_SIZE) && receivers(SIGNAL(processRequested(HexProcess *, QString)))) {
+        emit processRequested(pProcess, sTitle);
+    } else {
+        connect(pProcess, SIGNAL(errorMessage(QString)), this, SIGNAL(errorMessage(QString)));
+
+        pProcess->process();
+    }
+
+    return pProcess->isSuccess();
+}
+
+bool QHexView::_swapRecord(QList<UNDO_RECORD> *pListFrom, QList<UNDO_RECORD> *pListTo, const QString &sTitle)
+{
+    bool bResult = false;
+
+    if (g_pDataSource && (!g_bReadonly) && (!pListFrom->isEmpty())) {
+        UNDO_RECORD record = pListFrom->last();
+
+        UNDO_RECORD recordSwap = {};
+        recordSwap.nOffset = record.nOffset;
+
+        if (record.listOffsets.count()) {
+            // Replaced occurrences: the other pattern is written back, nothing has to be read
+            ReplaceProcess replaceProcess;
+            replaceProcess.setData(g_pDataSource, 0, 0, QByteArray(), record.baData, ReplaceProcess::RM_RESTORE);
+            replaceProcess.setOffsets(record.listOffsets);
+
+            bResult = _runProcess(&replaceProcess, record.nSize, sTitle);
+
+            recordSwap.nSize = record.nSize;
+            recordSwap.listOffsets = record.listOffsets;
+            recordSwap.baData = record.baSwap;
+            recordSwap.baSwap = record.baData;
+        } else {
+            recordSwap.pData = _createUndoDevice(record.nSize);
+        }
+
+        if (recordSwap.pData && record.pData->seek(0)) {
+            // The current data of the range becomes the record for the other direction
+            PatchProcess patchProcess;
+            patchProcess.setData(g_pDataSource, record.nOffset, record.nSize, PatchProcess::PO_WRITE, QByteArray(), record.pData);
+            patchProcess.setUndoDevice(recordSwap.pData);
+
+            bResult = _runProcess(&patchProcess, record.nSize, sTitle);
+
+            recordSwap.nSize = patchProcess.getWrittenSize();
+        }
+
+        if (bResult) {
+            pListFrom->removeLast();
+            delete record.pData;
+
+            _addRecord(pListTo, recordSwap);
+
+            g_bIsEdited = true;
+
+            emit editState(g_bIsEdited);
+
+            if ((record.nOffset < g_nStartOffset) || (record.nOffset >= g_nStartOffset + g_nBytesProLine * g_nLinesProPage)) {
+                goToOffset(record.nOffset);
+            }
+
+            _initSelection(record.nOffset);
+            _setSelection(record.nOffset + record.nSize - 1);
+        } else {
+            // Partly written: the record stays, applying it again restores the whole range
+            delete recordSwap.pData;
+        }
+
+        adjust();
+        viewport()->update();
+    }
+
+    return bResult;
+}
+
+void QHexView::_addRecord(QList<UNDO_RECORD> *pList, UNDO_RECORD record)
+{
+    pList->append(record);
+
+    if (pList->count() > N_MAX_UNDO) {
+        delete pList->takeFirst().pData;
+    }
+}
+
+void QHexView::_clearRecords(QList<UNDO_RECORD> *pList)
+{
+    qint32 nNumberOfRecords = pList->count();
+
+    for (qint32 i = 0; i < nNumberOfRecords; i++) {
+        delete pList->at(i).pData;
+    }
+
+    pList->clear();
+}
+
+void QHexView::_decodeGlyphs(const QByteArray &baLeadIn, const QByteArray &baTail)
+{
+    qint32 nCount = g_baDataBuffer.size();
+
+    if (QHexViewEncoding::isMultiByte(g_encoding)) {
+        // Sequences may cross the borders of the window
+        qint32 nLeadIn = baLeadIn.size();
+
+        QByteArray baData = baLeadIn;
+        baData.append(g_baDataBuffer);
+        baData.append(baTail);
+
+        QHexViewEncoding::decode(g_encoding, baData.constData(), baData.size(), nLeadIn, nCount, g_nBufferOffset, &g_listGlyphs);
+    } else {
+        QHexViewEncoding::decode(g_encoding, g_baDataBuffer.constData(), nCount, 0, nCount, g_nBufferOffset, &g_listGlyphs);
+    }
+}
+
+QString QHexView::getFontName()
+{
+    QString sResult;
+#ifdef Q_OS_WIN
+    sResult = "Courier";
+#endif
+#ifdef Q_OS_LINUX
+    sResult = "Monospace";
+#endif
+#ifdef Q_OS_OSX
+    sResult = "Courier";  // TODO Check "Menlo"
+#endif
+    return sResult;
+}
+
+void QHexView::goToAddress(qint64 nAddress)
+{
+    if ((isAddressValid(nAddress)) && (g_nBytesProLine)) {
+        qint64 nOffset = addressToOffset(nAddress);
+
+        goToOffset(nOffset);
+    }
+}
+
+void QHexView::goToRelAddress(qint64 nRelAddress)
+{
+    if ((isRelAddressValid(nRelAddress)) && (g_nBytesProLine)) {
+        qint64 nOffset = relAddressToOffset(nRelAddress);
+
+        goToOffset(nOffset);
+    }
+}
+
+void QHexView::goToOffset(qint64 nOffset)
+{
+    if ((isOffsetValid(nOffset)) && (g_nBytesProLine)) {
+        verticalScrollBar()->setValue((nOffset) / g_nBytesProLine);  // TODO check for large files
+        g_nStartOffsetDelta = (nOffset) % g_nBytesProLine;
+
+        //        posInfo.cursorPosition.nOffset+=(addressToOffset(nAddress))%_nBytesProLine;
+        //        posInfo.cursorPosition.nOffset=addressToOffset(nAddress);
+        //        qDebug(QString::number(posInfo.cursorPosition.nOffset,16).toLatin1().data());
+        g_posInfo.cursorPosition.nOffset = nOffset;
+        g_posInfo.cursorPosition.type = CT_HIWORD;
+        //        qDebug(QString::number(posInfo.cursorPosition.nOffset,16).toLatin1().data());
+
+        // Also shown when the line does not change, without a synchronous reload
+        _adjustAsync();
+    }
+}
+
+void QHexView::_goToOffset(qint64 nOffset)
+{
+    if ((isOffsetValid(nOffset)) && (g_nBytesProLine)) {
+        verticalScrollBar()->setValue((nOffset) / g_nBytesProLine);
+        g_nStartOffsetDelta = (nOffset) % g_nBytesProLine;
+    }
+}
+
+void QHexView::setSelection(qint64 nAddress, qint64 nSize)
+{
+    if (nSize) {
+        if (isAddressValid(nAddress)) {
+            qint64 nOffset = addressToOffset(nAddress);
+            _initSelection(nOffset);
+            _setSelection(nOffset + nSize - 1);
+
+            viewport()->update();
+        }
+    }
+}
+
+void QHexView::selectAll()
+{
+    setSelection(g_memoryMap.nModuleAddress, g_nDataSize);
+}
+
+XBinary::_MEMORY_MAP *QHexView::getMemoryMap()
+{
+    return &g_memoryMap;
+}
+
+void QHexView::verticalScroll()
+{
+    //    _nStartOffsetDelta=0;
+    _adjustAsync();
+}
+
+void QHexView::horisontalScroll()
+{
+    _adjustAsync();
+}
+
+QHexView::ST QHexView::getSelectType(qint64 nOffset)
+{
+    ST result = ST_NOTSELECTED;
+
+    if (nOffset == g_posInfo.nSelectionStartOffset) {
+        if (nOffset == g_posInfo.nSelectionEndOffset) {
+            result = ST_ONEBYTE;
+        } else {
+            result = ST_BEGIN;
+        }
+    } else if (nOffset == g_posInfo.nSelectionEndOffset) {
+        result = ST_END;
+    } else if ((nOffset > g_posInfo.nSelectionStartOffset) && (nOffset < g_posInfo.nSelectionEndOffset)) {
+        result = ST_MID;
     }
+
+    return result;
 }
 
-void QHexView::setSelection(qint64 nAddress, qint64 nSize)
+qint64 QHexView::addressToOffset(qint64 nAddress)
 {
-    if (nSize) {
-        if (isAddressValid(nAddress)) {
-            qint64 nOffset = addressToOffset(nAddress);
-            _initSelection(nOffset);
-            _setSelection(nOffset + nSize - 1);
+    return XBinary::addressToOffset(&g_memoryMap, nAddress);
+}
+
+qint64 QHexView::relAddressToOffset(qint64 nRelAddress)
+{
+    return XBinary::relAddressToOffset(&g_memoryMap, nRelAddress);
+}
+
+qint64 QHexView::offsetToAddress(qint64 nOffset)
+{
+    //    qint64 nResult=-1;
+
+    //    if(nOffset!=-1)
+    //    {
+    //        nResult=nOffset+_nBaseAddress;
+    //    }
+
+    //    return nResult;
+    return XBinary::offsetToAddress(&g_memoryMap, nOffset);
+}
+
+QPoint QHexView::cursorToPoint(QHexView::CURSOR_POSITION cp)
+{
+    QPoint result;
 
+    qint64 nRelOffset = cp.nOffset - g_nStartOffset;
+
+    if (cp.type != CT_NONE) {
+        result.setY((nRelOffset / g_nBytesProLine) * g_nLineHeight);
+    }
+
+    qint64 nColumn = nRelOffset % g_nBytesProLine;
+    qint32 nUnitWidth = (g_nUnitChars + 1) * g_nCharWidth;
+
+    if (cp.type == CT_ANSI) {
+        result.setX(g_nAnsiPosition + nColumn * g_nCharWidth);
+    } else if ((cp.type == CT_HIWORD) || (cp.type == CT_LOWORD)) {
+        result.setX(g_nHexPosition + (nColumn / g_nUnitSize) * nUnitWidth + _nibbleToDigit(nColumn % g_nUnitSize, cp.type) * g_nCharWidth);
+    } else if (cp.type == CT_UNIT) {
+        result.setX(g_nHexPosition + (nColumn / g_nUnitSize) * nUnitWidth);
+    }
+
+    return result;
+}
+
+bool QHexView::readByte(qint64 nOffset, quint8 *pByte)
+{
+    return (g_pDataSource->readAt(nOffset, (char *)pByte, 1) == 1);
+}
+
+qint32 QHexView::readWindow(QHexViewDataSource *pDataSource, qint64 nDataSize, qint64 nOffset, char *pBuffer, qint32 nSize, QByteArray *pbaUnreadableMask, qint32 nId)
+{
+    // Called from the worker thread: only the arguments are used
+    qint32 nResult = 0;
+
+    while ((nResult < nSize) && (g_nFetchId.loadAcquire() == nId)) {
+        qint64 nCount = pDataSource->readAt(nOffset + nResult, pBuffer + nResult, nSize - nResult);
+
+        if (nCount > 0) {
+            nResult += (qint32)nCount;
+        } else if ((nCount == 0) || (nOffset + nResult >= nDataSize)) {
+            break;
+        } else {
+            // Unmapped or guard pages: skip to the next page and mark the bytes
+            qint32 nSkip = (qint32)qMin(N_PAGE_SIZE - ((nOffset + nResult) % N_PAGE_SIZE), (qint64)(nSize - nResult));
+            nSkip = (qint32)qMin((qint64)nSkip, nDataSize - (nOffset + nResult));
+
+            if (pbaUnreadableMask->isEmpty()) {
+                pbaUnreadableMask->fill(0, nSize);
+            }
+
+            memset(pBuffer + nResult, 0, nSkip);
+            memset(pbaUnreadableMask->data() + nResult, 1, nSkip);
+
+            nResult += nSkip;
+        }
+    }
+
+    return nResult;
+}
+
+XBinary::_MEMORY_MAP QHexView::getDefaultMemoryMap()
+{
+    XBinary::_MEMORY_MAP result = {};
+
+    ProcessMemoryDevice *pProcessMemoryDevice = qobject_cast<ProcessMemoryDevice *>(g_pDevice);
+
+    if (pProcessMemoryDevice) {
+        result = pProcessMemoryDevice->getMemoryMap();
+    } else if (g_pDataSource) {
+        QHexViewDataSourceDevice device(g_pDataSource);
+
+        XBinary binary(&device);
+        result = binary.getMemoryMap();
+    }
+
+    return result;
+}
+
+void QHexView::_customContextMenu(const QPoint &pos)
+{
+    // TODO
+    emit customContextMenu(mapToGlobal(pos));
+}
+
+void QHexView::_followChanged()
+{
+    if (g_pFollowWatcher && g_pFollowWatcher->files().isEmpty() && (!g_timerFollowPoll.isActive())) {
+        // Removed or replaced: watched again if the path is back, polled otherwise
+        QFile *pFile = qobject_cast<QFile *>(g_pDevice);
+
+        if (!(pFile && g_pFollowWatcher->addPath(pFile->fileName()))) {
+            g_timerFollowPoll.start();
+        }
+    }
+
+    if (!g_timerFollowUpdate.isActive()) {
+        g_timerFollowUpdate.start();
+    }
+}
+
+void QHexView::_followCheckSize()
+{
+    if (g_pDataSource) {
+        qint64 nOldSize = g_nDataSize;
+        qint64 nNewSize = g_pDataSource->getSize();
+
+        if (nNewSize < nOldSize) {
+            // Truncated, start over
+            g_pDataSource->invalidate(0, -1);
+
+            // The map of the host is kept, its records are cut at the new end of data
+            for (qint32 i = g_memoryMap.listRecords.count() - 1; i >= 0; i--) {
+                XBinary::_MEMORY_RECORD *pRecord = &(g_memoryMap.listRecords[i]);
+
+                if (pRecord->nOffset != -1) {
+                    if (pRecord->nOffset >= nNewSize) {
+                        g_memoryMap.listRecords.removeAt(i);
+                    } else if (pRecord->nOffset + pRecord->nSize > nNewSize) {
+                        pRecord->nSize = nNewSize - pRecord->nOffset;
+                    }
+                }
+            }
+
+            g_memoryMap.nBinarySize = nNewSize;
+
+            if (g_memoryMap.listRecords.count() == 0) {
+                g_memoryMap = getDefaultMemoryMap();
+            }
+
+            init();
+            adjust();
             viewport()->update();
+        } else if (nNewSize > nOldSize) {
+            bool bAtEnd = (verticalScrollBar()->value() >= verticalScrollBar()->maximum());
+
+            // The cached last page is shorter
+            g_pDataSource->invalidate(nOldSize, nNewSize - nOldSize);
+
+            // The record that ends at the old end of data grows with it
+            qint32 nNumberOfRecords = g_memoryMap.listRecords.count();
+
+            for (qint32 i = 0; i < nNumberOfRecords; i++) {
+                XBinary::_MEMORY_RECORD *pRecord = &(g_memoryMap.listRecords[i]);
+
+                if ((pRecord->nOffset != -1) && (pRecord->nOffset + pRecord->nSize == nOldSize)) {
+                    pRecord->nSize += (nNewSize - nOldSize);
+                    break;
+                }
+            }
+
+            g_memoryMap.nBinarySize = nNewSize;
+
+            _setMemoryMapAnnotations();
+
+            g_nDataSize = nNewSize;
+            g_nTotalLineCount = g_nDataSize / g_nBytesProLine + 1;
+
+            if (g_bFollowPinToEnd && bAtEnd) {
+                {
+                    const QSignalBlocker blocker(verticalScrollBar());
+                    verticalScrollBar()->setRange(0, g_nTotalLineCount - g_nLinesProPage);
+                    verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+                }
+
+                adjust();
+                viewport()->update();
+            } else if (g_nStartOffset + g_nDataBlockSize > nOldSize) {
+                // Only the tail of the window is new data
+                adjust();
+                viewport()->update();
+            } else {
+                verticalScrollBar()->setRange(0, g_nTotalLineCount - g_nLinesProPage);
+            }
+        }
+    }
+}
+
+void QHexView::_refresh()
+{
+    // Only the visible window and the watched ranges are read; the old buffer is where it was fetched
+    qint64 nOldStartOffset = g_nBufferOffset;
+    QByteArray baOld = g_baDataBuffer;
+
+    if (g_pDataSource) {
+        g_pDataSource->invalidate(g_nStartOffset, g_nDataBlockSize);
+
+        qint32 nNumberOfWatchRanges = g_listWatchRanges.count();
+
+        for (qint32 i = 0; i < nNumberOfWatchRanges; i++) {
+            g_pDataSource->invalidate(g_listWatchRanges.at(i).nOffset, g_listWatchRanges.at(i).nSize);
+        }
+    }
+
+    adjust();
+
+    qint32 nSize = g_baDataBuffer.size();
+
+    if ((nOldStartOffset != g_nStartOffset) || (baOld.size() != nSize) || (g_baHeat.size() != nSize)) {
+        g_baHeat.fill(0, nSize);
+    } else {
+        quint8 *pHeat = (quint8 *)g_baHeat.data();
+
+        for (qint32 i = 0; i < nSize; i++) {
+            pHeat[i] = (quint8)((pHeat[i] * 3) / 4);
+        }
+    }
+
+    g_nHeatStartOffset = g_nStartOffset;
+
+    if ((nOldStartOffset == g_nStartOffset) && (baOld.size() == nSize)) {
+        const char *pOld = baOld.constData();
+        const char *pNew = g_baDataBuffer.constData();
+        quint8 *pHeat = (quint8 *)g_baHeat.data();
+
+        qint32 nCurrent = 0;
+
+        while (nCurrent < nSize) {
+            nCurrent += QHexViewUtils::getEqualSize(pOld + nCurrent, pNew + nCurrent, nSize - nCurrent);
+
+            if (nCurrent < nSize) {
+                qint32 nDiffSize = QHexViewUtils::getDiffSize(pOld + nCurrent, pNew + nCurrent, nSize - nCurrent);
+
+                memset(pHeat + nCurrent, 0xFF, nDiffSize);
+
+                emit dataChanged(g_nStartOffset + nCurrent, nDiffSize);
+
+                nCurrent += nDiffSize;
+            }
+        }
+    }
+
+    qint32 nNumberOfWatchRanges = g_listWatchRanges.count();
+
+    for (qint32 i = 0; i < nNumberOfWatchRanges; i++) {
+        WATCH_RANGE *pWatchRange = &(g_listWatchRanges[i]);
+
+        QByteArray baNew = readArray(pWatchRange->nOffset, pWatchRange->nSize);
+
+        qint32 _nSize = qMin(baNew.size(), pWatchRange->baSnapshot.size());
+        qint32 nCurrent = 0;
+
+        while (nCurrent < _nSize) {
+            nCurrent += QHexViewUtils::getEqualSize(pWatchRange->baSnapshot.constData() + nCurrent, baNew.constData() + nCurrent, _nSize - nCurrent);
+
+            if (nCurrent < _nSize) {
+                qint32 nDiffSize = QHexViewUtils::getDiffSize(pWatchRange->baSnapshot.constData() + nCurrent, baNew.constData() + nCurrent, _nSize - nCurrent);
+
+                emit dataChanged(pWatchRange->nOffset + nCurrent, nDiffSize);
+
+                nCurrent += nDiffSize;
+            }
+        }
+
+        pWatchRange->baSnapshot = baNew;
+    }
+
+    viewport()->update();
+}
+
+void QHexView::adjust()
+{
+    _adjustLayout();
+
+    if (g_pDataSource && g_bInit) {
+        // Newer than a fetch in flight, which is dropped
+        qint32 nId = g_nFetchId.fetchAndAddOrdered(1) + 1;
+
+        _setWindow(_readWindow(g_pDataSource, g_nDataSize, g_nStartOffset, g_nDataBlockSize, nId));
+    } else {
+        g_baHoleMask.clear();
+        g_baDiffMask.clear();
+    }
+
+    _adjustCursor();
+}
+
+void QHexView::_adjustLayout()
+{
+    int nHeight = viewport()->height();
+    g_nLineHeight = g_nCharHeight + 5;
+    g_nLinesProPage = (nHeight) / g_nLineHeight;  // mb nHeight-4
+    g_nDataBlockSize = g_nLinesProPage * g_nBytesProLine;
+
+    g_nAddressPosition = g_nCharWidth;
+    g_nAddressWidthCount = 8;
+
+    if (g_pDataSource) {
+        if ((g_nDataSize + g_memoryMap.nModuleAddress) >= 0xFFFFFFFF) {
+            g_nAddressWidthCount = 16;
+        }
+    }
+
+    g_nAddressWidth = (g_nAddressWidthCount + 3) * g_nCharWidth;  // TODO set addresswidth
+    g_nHexPosition = g_nAddressPosition + g_nAddressWidth;
+    g_nHexWidth = ((g_nBytesProLine / g_nUnitSize) * (g_nUnitChars + 1) + 3) * g_nCharWidth;
+    g_nAnsiPosition = g_nHexPosition + g_nHexWidth;
+    g_nAnsiWidth = (g_nBytesProLine + 1) * g_nCharWidth;
+
+    horizontalScrollBar()->setRange(0, g_nAnsiPosition + g_nAnsiWidth - viewport()->width());
+    horizontalScrollBar()->setPageStep(viewport()->width());
+
+    verticalScrollBar()->setRange(0, g_nTotalLineCount - g_nLinesProPage);
+    verticalScrollBar()->setPageStep(g_nLinesProPage);
+
+    g_nStartOffset = verticalScrollBar()->value() * g_nBytesProLine + g_nStartOffsetDelta;
+    g_nXOffset = horizontalScrollBar()->value();
+
+    _updateSpans();
+    _updateAnnotations();
+}
+
+void QHexView::_updateAnnotations()
+{
+    g_listAnnotationColors.clear();
+    g_baBookmarkLines.clear();
+
+    if (((!g_annotations.isEmpty()) || (!g_memoryMapAnnotations.isEmpty())) && (g_nDataBlockSize > 0)) {
+        g_listAnnotationColors.fill(0, g_nDataBlockSize);
+        g_baBookmarkLines.fill(0, g_nLinesProPage);
+
+        // The memory map is under the annotations
+        QHexViewAnnotations *pLayers[2] = {&g_memoryMapAnnotations, &g_annotations};
+
+        for (qint32 i = 0; i < 2; i++) {
+            QVector<qint32> listIndexes = pLayers[i]->getOverlaps(g_nStartOffset, g_nDataBlockSize);
+            qint32 nNumberOfIndexes = listIndexes.count();
+
+            for (qint32 j = 0; j < nNumberOfIndexes; j++) {
+                QHexViewAnnotations::ANNOTATION annotation = pLayers[i]->getAnnotation(listIndexes.at(j));
+
+                QRgb nColor = annotation.nColor;
+
+                if (qAlpha(nColor) == 255) {
+                    // Opaque colours would hide the selection of the other column
+                    nColor = qRgba(qRed(nColor), qGreen(nColor), qBlue(nColor), 110);
+                }
+
+                qint64 nBegin = qMax(annotation.nOffset - g_nStartOffset, (qint64)0);
+                qint64 nEnd = qMin(annotation.nOffset + annotation.nSize - g_nStartOffset, (qint64)g_nDataBlockSize);
+
+                for (qint64 k = nBegin; k < nEnd; k++) {
+                    g_listAnnotationColors[(qint32)k] = nColor;
+                }
+
+                if (annotation.bBookmark && (annotation.nOffset >= g_nStartOffset)) {
+                    g_baBookmarkLines[(qint32)((annotation.nOffset - g_nStartOffset) / g_nBytesProLine)] = 1;
+                }
+            }
+        }
+    }
+}
+
+void QHexView::_setMemoryMapAnnotations()
+{
+    g_memoryMapAnnotations.clear();
+
+    if (g_bMemoryMapColors) {
+        QVector<QHexViewAnnotations::ANNOTATION> listAnnotations;
+        qint32 nNumberOfRecords = g_memoryMap.listRecords.count();
+
+        for (qint32 i = 0; i < nNumberOfRecords; i++) {
+            const XBinary::_MEMORY_RECORD *pRecord = &(g_memoryMap.listRecords.at(i));
+
+            if ((pRecord->nOffset != -1) && (pRecord->nSize > 0)) {
+                QHexViewAnnotations::ANNOTATION annotation = {};
+                annotation.nOffset = pRecord->nOffset;
+                annotation.nSize = pRecord->nSize;
+                annotation.nColor = QColor::fromHsv((i * 47) % 360, 50, 255, 70).rgba();
+                annotation.sText = pRecord->sName;
+
+                listAnnotations.append(annotation);
+            }
+        }
+
+        g_memoryMapAnnotations.append(listAnnotations);
+    }
+}
+
+void QHexView::_updateSpans()
+{
+    g_listSpans.clear();
+    g_listSpanIndex.clear();
+
+    // Only the fields of the visible lines are looked up
+    if ((!g_structures.isEmpty()) && (g_nDataBlockSize > 0)) {
+        g_listSpans = g_structures.getSpans(g_nStartOffset, g_nDataBlockSize);
+        g_listSpanIndex.fill(-1, g_nDataBlockSize);
+
+        qint32 nNumberOfSpans = g_listSpans.count();
+
+        for (qint32 i = 0; i < nNumberOfSpans; i++) {
+            qint64 nBegin = qMax(g_listSpans.at(i).nOffset - g_nStartOffset, (qint64)0);
+            qint64 nEnd = qMin(g_listSpans.at(i).nOffset + g_listSpans.at(i).nSize - g_nStartOffset, (qint64)g_nDataBlockSize);
+
+            for (qint64 j = nBegin; j < nEnd; j++) {
+                g_listSpanIndex[(qint32)j] = i;
+            }
         }
     }
 }
 
-void QHexView::selectAll()
+void QHexView::_adjustCursor()
 {
-    setSelection(g_memoryMap.nModuleAddress, g_nDataSize);
-}
+    qint64 nRelOffset = g_posInfo.cursorPosition.nOffset - g_nStartOffset;
 
-XBinary::_MEMORY_MAP *QHexView::getMemoryMap()
-{
-    return &g_memoryMap;
-}
+    if (nRelOffset < 0) {
+        nRelOffset = g_posInfo.cursorPosition.nOffset % g_nBytesProLine;
+        g_posInfo.cursorPosition.nOffset = g_nStartOffset + nRelOffset;
+    } else if (nRelOffset >= g_nBytesProLine * g_nLinesProPage) {
+        nRelOffset = g_posInfo.cursorPosition.nOffset % g_nBytesProLine;
+        g_posInfo.cursorPosition.nOffset = g_nStartOffset + g_nBytesProLine * (g_nLinesProPage - 1) + nRelOffset;
+    }
 
-void QHexView::verticalScroll()
-{
-    //    _nStartOffsetDelta=0;
-    adjust();
-}
+    if (g_posInfo.cursorPosition.nOffset > g_nDataSize - 1) {
+        g_posInfo.cursorPosition.nOffset = g_nDataSize - 1;
+    }
 
-void QHexView::horisontalScroll()
-{
-    adjust();
+    if ((g_posInfo.cursorPosition.nOffset != -1) && (g_posInfo.cursorPosition.type != CT_NONE)) {
+        QPoint point = cursorToPoint(g_posInfo.cursorPosition);
+        qint32 nCursorWidth = (g_posInfo.cursorPosition.type == CT_UNIT) ? (g_nCharWidth * g_nUnitChars) : g_nCharWidth;
+
+        g_rectCursor.setRect(point.x() - horizontalScrollBar()->value(), point.y() + g_nLineDelta, nCursorWidth, g_nLineHeight);
+    }
+
+    // Not on every refresh, only when the cursor or the selection moved
+    if ((g_posInfo.cursorPosition.nOffset != g_posInfoEmitted.cursorPosition.nOffset) ||
+        (g_posInfo.nSelectionStartOffset != g_posInfoEmitted.nSelectionStartOffset) || (g_posInfo.nSelectionEndOffset != g_posInfoEmitted.nSelectionEndOffset)) {
+        g_posInfoEmitted = g_posInfo;
+
+        emit cursorPositionChanged();
+    }
 }
 
-QHexView::ST QHexView::getSelectType(qint64 nOffset)
+void QHexView::_adjustAsync()
 {
-    ST result = ST_NOTSELECTED;
+    _adjustLayout();
+    _adjustCursor();
 
-    if (nOffset == g_posInfo.nSelectionStartOffset) {
-        if (nOffset == g_posInfo.nSelectionEndOffset) {
-            result = ST_ONEBYTE;
-        } else {
-            result = ST_BEGIN;
+    if (g_pDataSource && g_bInit && g_watcherFetch.isRunning() && ((g_nFetchOffset != g_nStartOffset) || (g_nFetchBlockSize != g_nDataBlockSize))) {
+        // A read for another position stops at its next request and is not shown, also when the window
+        // is back at the position that is already buffered. Cursor moves within the page keep it
+        g_nFetchId.fetchAndAddOrdered(1);
+    }
+
+    if (g_pDataSource && g_bInit && (!_isWindowValid())) {
+        if (!g_timerFetch.isActive()) {
+            g_timerFetch.start();
         }
-    } else if (nOffset == g_posInfo.nSelectionEndOffset) {
-        result = ST_END;
-    } else if ((nOffset > g_posInfo.nSelectionStartOffset) && (nOffset < g_posInfo.nSelectionEndOffset)) {
-        result = ST_MID;
     }
 
-    return result;
+    // The last data is shown where it overlaps the new lines
+    viewport()->update();
 }
 
-qint64 QHexView::addressToOffset(qint64 nAddress)
+bool QHexView::_isWindowValid()
 {
-    return XBinary::addressToOffset(&g_memoryMap, nAddress);
+    return (g_nBufferOffset == g_nStartOffset) && (g_nBufferBlockSize == g_nDataBlockSize);
 }
 
-qint64 QHexView::relAddressToOffset(qint64 nRelAddress)
+void QHexView::_cancelFetch()
 {
-    return XBinary::relAddressToOffset(&g_memoryMap, nRelAddress);
+    g_timerFetch.stop();
+    g_nFetchId.fetchAndAddOrdered(1);
+    g_watcherFetch.waitForFinished();
 }
 
-qint64 QHexView::offsetToAddress(qint64 nOffset)
+QHexView::WINDOW QHexView::_readWindow(QHexViewDataSource *pDataSource, qint64 nDataSize, qint64 nOffset, qint32 nBlockSize, qint32 nId)
 {
-    //    qint64 nResult=-1;
+    // Called from the worker thread: only the arguments are used
+    WINDOW result = {};
+    result.nId = nId;
+    result.nOffset = nOffset;
+    result.nBlockSize = nBlockSize;
 
-    //    if(nOffset!=-1)
-    //    {
-    //        nResult=nOffset+_nBaseAddress;
-    //    }
+    // The context of multibyte sequences is read with the window, one request
+    qint32 nLeadIn = (qint32)qMin((qint64)QHexViewEncoding::N_MAX_CONTEXT, nOffset);
+    qint32 nSize = nLeadIn + nBlockSize + QHexViewEncoding::N_MAX_CONTEXT;
 
-    //    return nResult;
-    return XBinary::offsetToAddress(&g_memoryMap, nOffset);
-}
+    QByteArray baBuffer(nSize, 0);
+    QByteArray baUnreadableMask;
 
-QPoint QHexView::cursorToPoint(QHexView::CURSOR_POSITION cp)
-{
-    QPoint result;
+    qint32 nCount = readWindow(pDataSource, nDataSize, nOffset - nLeadIn, baBuffer.data(), nSize, &baUnreadableMask, nId);
+    qint32 nDataCount = qBound(0, nCount - nLeadIn, nBlockSize);
+    qint32 nTailCount = nCount - nLeadIn - nDataCount;
 
-    qint64 nRelOffset = cp.nOffset - g_nStartOffset;
+    result.baData = baBuffer.mid(nLeadIn, nDataCount);
 
-    if (cp.type != CT_NONE) {
-        result.setY((nRelOffset / g_nBytesProLine) * g_nLineHeight);
+    if (!baUnreadableMask.isEmpty()) {
+        result.baUnreadableMask = baUnreadableMask.mid(nLeadIn, nDataCount);
+
+        if (!result.baUnreadableMask.contains((char)1)) {
+            result.baUnreadableMask.clear();
+        }
     }
 
-    if (cp.type == CT_ANSI) {
-        result.setX(g_nAnsiPosition + (nRelOffset % g_nBytesProLine) * g_nCharWidth);
-    } else if (cp.type == CT_HIWORD) {
-        result.setX(g_nHexPosition + (nRelOffset % g_nBytesProLine) * g_nCharWidth * 3);
-    } else if (cp.type == CT_LOWORD) {
-        result.setX(g_nHexPosition + (nRelOffset % g_nBytesProLine) * g_nCharWidth * 3 + g_nCharWidth);
+    if ((nCount >= nLeadIn) && (!baUnreadableMask.left(nLeadIn).contains((char)1))) {
+        result.baLeadIn = baBuffer.left(nLeadIn);
     }
 
-    return result;
-}
+    if ((nDataCount == nBlockSize) && (nTailCount > 0) && (!baUnreadableMask.mid(nLeadIn + nDataCount).contains((char)1))) {
+        result.baTail = baBuffer.mid(nLeadIn + nDataCount, nTailCount);
+    }
 
-bool QHexView::readByte(qint64 nOffset, quint8 *pByte)
-{
-    int nCount = 0;
+    if (pDataSource->isSparse() && (g_nFetchId.loadAcquire() == nId)) {
+        qint64 nEndOffset = nOffset + nDataCount;
+        qint64 nCurrent = nOffset;
+
+        while (nCurrent < nEndOffset) {
+            qint64 nDataOffset = pDataSource->getNextData(nCurrent);
+
+            if ((nDataOffset == -1) || (nDataOffset > nEndOffset)) {
+                nDataOffset = nEndOffset;
+            }
+
+            if (nDataOffset > nCurrent) {
+                if (result.baHoleMask.isEmpty()) {
+                    result.baHoleMask.fill(0, nDataCount);
+                }
+
+                memset(result.baHoleMask.data() + (nCurrent - nOffset), 1, (size_t)(nDataOffset - nCurrent));
+            }
+
+            if (nDataOffset >= nEndOffset) {
+                break;
+            }
 
-    if (g_pDevice->seek(nOffset)) {
-        nCount = (int)g_pDevice->read((char *)pByte, 1);
+            nCurrent = qMax(pDataSource->getNextHole(nDataOffset), nDataOffset + 1);
+        }
     }
 
-    return (nCount == 1);
+    return result;
 }
 
-bool QHexView::writeByte(qint64 nOffset, quint8 *pByte)
+void QHexView::_setWindow(const WINDOW &window)
 {
-    int nCount = 0;
+    g_nBufferOffset = window.nOffset;
+    g_nBufferBlockSize = window.nBlockSize;
+    g_baDataBuffer = window.baData;
+    g_baUnreadableMask = window.baUnreadableMask;
+    g_baHoleMask = window.baHoleMask;
 
-    if (g_pDevice->seek(nOffset)) {
-        nCount = (int)g_pDevice->write((char *)pByte, 1);
-    }
+    _formatUnits();
+    _decodeGlyphs(window.baLeadIn, window.baTail);
 
-    return (nCount == 1);
+    g_baDiffMask.clear();
+
+    if (g_listDiffRanges.count()) {
+        // Only the ranges of the visible window
+        qint64 nEndOffset = g_nBufferOffset + g_baDataBuffer.size();
+
+        QVector<RANGE>::const_iterator iter = std::lower_bound(g_listDiffRanges.constBegin(), g_listDiffRanges.constEnd(), g_nBufferOffset,
+                                                               [](const RANGE &range, qint64 nValue) { return range.nOffset + range.nSize <= nValue; });
+
+        for (; (iter != g_listDiffRanges.constEnd()) && (iter->nOffset < nEndOffset); iter++) {
+            if (g_baDiffMask.isEmpty()) {
+                g_baDiffMask.fill(0, g_baDataBuffer.size());
+            }
+
+            qint64 nStart = qMax(iter->nOffset, g_nBufferOffset) - g_nBufferOffset;
+            qint64 nEnd = qMin(iter->nOffset + iter->nSize, nEndOffset) - g_nBufferOffset;
+
+            for (qint64 i = nStart; i < nEnd; i++) {
+                g_baDiffMask[(qint32)i] = 1;
+            }
+        }
+    }
 }
 
-void QHexView::_customContextMenu(const QPoint &pos)
+void QHexView::_fetchWindow()
 {
-    // TODO
-    emit customContextMenu(mapToGlobal(pos));
+    // One read at a time, a newer position is fetched when it completes
+    if (g_pDataSource && (!g_watcherFetch.isRunning()) && (!_isWindowValid())) {
+        QHexViewDataSource *pDataSource = g_pDataSource;
+        qint64 nDataSize = g_nDataSize;
+        qint64 nOffset = g_nStartOffset;
+        qint32 nBlockSize = g_nDataBlockSize;
+        qint32 nId = g_nFetchId.loadAcquire();
+
+        g_nFetchOffset = nOffset;
+        g_nFetchBlockSize = nBlockSize;
+
+        g_watcherFetch.setFuture(QtConcurrent::run([=]() { return _readWindow(pDataSource, nDataSize, nOffset, nBlockSize, nId); }));
+    }
 }
 
-void QHexView::adjust()
+void QHexView::_fetchFinished()
 {
-    int nHeight = viewport()->height();
-    g_nLineHeight = g_nCharHeight + 5;
-    g_nLinesProPage = (nHeight) / g_nLineHeight;  // mb nHeight-4
-    g_nDataBlockSize = g_nLinesProPage * g_nBytesProLine;
+    WINDOW window = g_watcherFetch.result();
 
-    g_nAddressPosition = g_nCharWidth;
-    g_nAddressWidthCount = 8;
+    if ((window.nId == g_nFetchId.loadAcquire()) && (window.nOffset == g_nStartOffset) && (window.nBlockSize == g_nDataBlockSize)) {
+        _setWindow(window);
 
-    if (g_pDevice) {
-        if ((g_pDevice->size() + g_memoryMap.nModuleAddress) >= 0xFFFFFFFF) {
-            g_nAddressWidthCount = 16;
-        }
+        viewport()->update();
+    } else if (!g_timerFetch.isActive()) {
+        _fetchWindow();
     }
+}
 
-    g_nAddressWidth = (g_nAddressWidthCount + 3) * g_nCharWidth;  // TODO set addresswidth
-    g_nHexPosition = g_nAddressPosition + g_nAddressWidth;
-    g_nHexWidth = (g_nBytesProLine + 1) * g_nCharWidth * 3;
-    g_nAnsiPosition = g_nHexPosition + g_nHexWidth;
-    g_nAnsiWidth = (g_nBytesProLine + 1) * g_nCharWidth;
-
-    horizontalScrollBar()->setRange(0, g_nAnsiPosition + g_nAnsiWidth - viewport()->width());
-    horizontalScrollBar()->setPageStep(viewport()->width());
+void QHexView::_dataSourceChanged(qint64 nOffset, qint64 nSize)
+{
+    // Written by this or another view of the same data
+    bool bBuffer = (nOffset < g_nBufferOffset + g_baDataBuffer.size()) && (nOffset + nSize > g_nBufferOffset);
+    bool bFetch = g_watcherFetch.isRunning() && (nOffset < g_nFetchOffset + g_nFetchBlockSize) && (nOffset + nSize > g_nFetchOffset);
 
-    verticalScrollBar()->setRange(0, g_nTotalLineCount - g_nLinesProPage);
-    verticalScrollBar()->setPageStep(g_nLinesProPage);
+    if (bFetch) {
+        // The read in flight may have the old data, it is read again when it completes
+        g_nFetchId.fetchAndAddOrdered(1);
+    }
 
-    g_nStartOffset = verticalScrollBar()->value() * g_nBytesProLine + g_nStartOffsetDelta;
-    g_nXOffset = horizontalScrollBar()->value();
+    if (bBuffer) {
+        g_nBufferBlockSize = -1;  // fetched again with the next frame
+    }
 
-    // TODO update
-    if (g_pDevice) {
-        if (g_pDevice->seek(g_nStartOffset)) {
-            g_baDataBuffer.resize(g_nDataBlockSize);
-            int nCount = (int)g_pDevice->read(g_baDataBuffer.data(), g_nDataBlockSize);
-            g_baDataBuffer.resize(nCount);
-            g_baDataHexBuffer = QByteArray(g_baDataBuffer.toHex());
-        } else {
-            g_baDataBuffer.clear();
-            g_baDataHexBuffer.clear();
-        }
+    if (bBuffer || bFetch) {
+        _adjustAsync();
     }
+}
 
-    qint64 nRelOffset = g_posInfo.cursorPosition.nOffset - g_nStartOffset;
+void QHexView::_dataSourceReset()
+{
+    // Saved, discarded or resized by this or another view of the same data
+    clearUndo();
 
-    if (nRelOffset < 0) {
-        nRelOffset = g_posInfo.cursorPosition.nOffset % g_nBytesProLine;
-        g_posInfo.cursorPosition.nOffset = g_nStartOffset + nRelOffset;
-    } else if (nRelOffset >= g_nBytesProLine * g_nLinesProPage) {
-        nRelOffset = g_posInfo.cursorPosition.nOffset % g_nBytesProLine;
-        g_posInfo.cursorPosition.nOffset = g_nStartOffset + g_nBytesProLine * (g_nLinesProPage - 1) + nRelOffset;
-    }
+    g_bIsEdited = isModified();
 
-    if (g_posInfo.cursorPosition.nOffset > g_nDataSize - 1) {
-        g_posInfo.cursorPosition.nOffset = g_nDataSize - 1;
-    }
+    emit editState(g_bIsEdited);
 
-    if ((g_posInfo.cursorPosition.nOffset != -1) && (g_posInfo.cursorPosition.type != CT_NONE)) {
-        QPoint point = cursorToPoint(g_posInfo.cursorPosition);
-        g_rectCursor.setRect(point.x() - horizontalScrollBar()->value(), point.y() + g_nLineDelta, g_nCharWidth, g_nLineHeight);
+    if (g_pDataSource && (g_pDataSource->getSize() != g_nDataSize)) {
+        g_memoryMap = getDefaultMemoryMap();
+
+        init();
     }
 
-    emit cursorPositionChanged();
+    g_nBufferBlockSize = -1;  // fetched again with the next frame
+
+    adjust();
+    viewport()->update();
 }
 
 void QHexView::init()
@@ -665,12 +2491,14 @@ void QHexView::init()
     g_nStartOffsetDelta = 0;
     g_nDataSize = 0;
 
-    if (g_pDevice) {
-        g_nDataSize = g_pDevice->size();
+    if (g_pDataSource) {
+        g_nDataSize = g_pDataSource->getSize();
     }
 
     g_nTotalLineCount = g_nDataSize / g_nBytesProLine + 1;
     verticalScrollBar()->setValue(0);
+
+    _setMemoryMapAnnotations();
 }
 
 QHexView::CURSOR_POSITION QHexView::getCursorPosition(QPoint pos)
@@ -694,17 +2522,24 @@ QHexView::CURSOR_POSITION QHexView::getCursorPosition(QPoint pos)
 
         nRelOffset = nDeltaY * g_nBytesProLine + nDeltaX;
     } else if ((nX > g_nHexPosition) && (nX < g_nHexPosition + g_nHexWidth)) {
-        nDeltaX = (nX - g_nHexPosition) / (g_nCharWidth * 3);
+        qint32 nUnitWidth = (g_nUnitChars + 1) * g_nCharWidth;
+        qint32 nUnit = qMin((nX - g_nHexPosition) / nUnitWidth, g_nBytesProLine / g_nUnitSize - 1);
+        qint32 nDigit = qMin(((nX - g_nHexPosition) % nUnitWidth) / g_nCharWidth, g_nUnitChars - 1);
+
+        nDeltaX = nUnit * g_nUnitSize;
         nDeltaY = (nY - g_nLineDelta) / g_nLineHeight;
 
-        if ((nX - g_nHexPosition) % (g_nCharWidth * 3) <= g_nCharWidth) {
-            result.type = CT_HIWORD;
+        if (_isHexMode()) {
+            qint32 nByte = 0;
+
+            _digitToNibble(nDigit, &nByte, &(result.type));
+
+            nDeltaX += nByte;
         } else {
-            result.type = CT_LOWORD;
+            result.type = CT_UNIT;
         }
 
         nRelOffset = nDeltaY * g_nBytesProLine + nDeltaX;
-        // TODO !!!
     } else if ((nX > g_nAnsiPosition) && (nX < g_nAnsiPosition + g_nAnsiWidth)) {
         nDeltaX = (nX - g_nAnsiPosition) / g_nCharWidth;
         nDeltaY = (nY - g_nLineDelta) / g_nLineHeight;  // mb TODO LindeDelta
@@ -724,6 +2559,63 @@ QHexView::CURSOR_POSITION QHexView::getCursorPosition(QPoint pos)
     return result;
 }
 
+QTimer *QHexView::_getCursorTimer()
+{
+    // One timer for all the views, it runs while a view has the focus
+    static QTimer *pTimer = nullptr;
+
+    if (!pTimer) {
+        pTimer = new QTimer(qApp);
+        pTimer->setInterval(500);
+
+        QObject::connect(pTimer, &QTimer::timeout, []() {
+            if (g_pCursorView) {
+                g_pCursorView->updateBlink();
+            }
+        });
+    }
+
+    return pTimer;
+}
+
+void QHexView::_setBlink(bool bState)
+{
+    if (bState) {
+        g_pCursorView = this;
+        g_bBlink = true;
+
+        _getCursorTimer()->start();
+    } else if (g_pCursorView == this) {
+        g_pCursorView = nullptr;
+        g_bBlink = false;
+
+        _getCursorTimer()->stop();
+    }
+
+    viewport()->update(g_rectCursor);
+}
+
+void QHexView::_getCharSize(const QFont &font, qint32 *pnWidth, qint32 *pnHeight)
+{
+    const QFontMetricsF fm(font);
+    *pnWidth = fm.boundingRect('2').width();
+    *pnWidth = qMax(fm.boundingRect('W').width(), (qreal)*pnWidth);
+    *pnHeight = fm.height();
+}
+
+void QHexView::_getDefaultCharSize(qint32 *pnWidth, qint32 *pnHeight)
+{
+    static qint32 nWidth = 0;
+    static qint32 nHeight = 0;
+
+    if (!nHeight) {
+        _getCharSize(QFont(getFontName(), 10), &nWidth, &nHeight);
+    }
+
+    *pnWidth = nWidth;
+    *pnHeight = nHeight;
+}
+
 void QHexView::updateBlink()
 {
     g_bBlink = (bool)(!g_bBlink);
@@ -754,11 +2646,120 @@ void QHexView::_setSelection(qint64 nOffset)
     }
 }
 
+void QHexView::showEvent(QShowEvent *pEvent)
+{
+    if (!g_bInit) {
+        // Hidden views (other tabs) do not read data and do not allocate the buffers
+        g_bInit = true;
+
+        if (!testAttribute(Qt::WA_SetFont)) {
+            QAbstractScrollArea::setFont(QFont(getFontName(), 10));
+        }
+
+        adjust();
+    }
+
+    QAbstractScrollArea::showEvent(pEvent);
+}
+
+void QHexView::hideEvent(QHideEvent *pEvent)
+{
+    _setBlink(false);
+
+    QAbstractScrollArea::hideEvent(pEvent);
+}
+
+void QHexView::focusInEvent(QFocusEvent *pEvent)
+{
+    _setBlink(true);
+
+    QAbstractScrollArea::focusInEvent(pEvent);
+}
+
+void QHexView::focusOutEvent(QFocusEvent *pEvent)
+{
+    _setBlink(false);
+
+    QAbstractScrollArea::focusOutEvent(pEvent);
+}
+
+bool QHexView::viewportEvent(QEvent *pEvent)
+{
+    bool bResult = false;
+
+    if ((pEvent->type() == QEvent::ToolTip) && g_pDataSource &&
+        ((!g_structures.isEmpty()) || (!g_annotations.isEmpty()) || (!g_memoryMapAnnotations.isEmpty()))) {
+        QHelpEvent *pHelpEvent = static_cast<QHelpEvent *>(pEvent);
+
+        CURSOR_POSITION cursorPosition = getCursorPosition(pHelpEvent->pos());
+        QHexViewStructures::SPAN span = {};
+        QStringList listLines;
+
+        if ((cursorPosition.nOffset != -1) && (cursorPosition.type != CT_NONE)) {
+            QHexViewAnnotations *pLayers[2] = {&g_memoryMapAnnotations, &g_annotations};
+
+            for (qint32 i = 0; i < 2; i++) {
+                QVector<qint32> listIndexes = pLayers[i]->getOverlaps(cursorPosition.nOffset, 1);
+                // A few of the innermost
+                qint32 nNumberOfIndexes = listIndexes.count();
+
+                for (qint32 j = qMax(nNumberOfIndexes - 4, 0); j < nNumberOfIndexes; j++) {
+                    QHexViewAnnotations::ANNOTATION annotation = pLayers[i]->getAnnotation(listIndexes.at(j));
+
+                    listLines.append(QString("%1 0x%2-0x%3")
+                                         .arg(annotation.sText)
+                                         .arg(annotation.nOffset, 0, 16)
+                                         .arg(annotation.nOffset + annotation.nSize - 1, 0, 16)
+                                         .trimmed());
+                }
+            }
+        }
+
+        if ((cursorPosition.nOffset != -1) && (cursorPosition.type != CT_NONE) && g_structures.getSpan(cursorPosition.nOffset, &span)) {
+            QHexViewStructures::FIELD field = g_structures.getField(span);
+            // Only the field under the mouse is read
+            QByteArray baData = g_pDataSource->read(span.nOffset, qMin(span.nSize, (qint64)0x100));
+
+            QString sType = QHexViewStructures::typeToString(field.type);
+
+            if (field.nCount > 1) {
+                sType += QString("[%1]").arg(field.nCount);
+            }
+
+            QString sText = QString("%1\n%2 %3: 0x%4\n%5")
+                                .arg(g_structures.getSpanName(span), sType, tr("Offset"))
+                                .arg(span.nOffset, 0, 16)
+                                .arg(QHexViewStructures::valueToString(field, baData, g_bIsBigEndian));
+
+            listLines.append(sText);
+        }
+
+        if (listLines.count()) {
+            QToolTip::showText(pHelpEvent->globalPos(), listLines.join("\n"), viewport());
+        } else {
+            QToolTip::hideText();
+            pEvent->ignore();
+        }
+
+        bResult = true;
+    } else {
+        bResult = QAbstractScrollArea::viewportEvent(pEvent);
+    }
+
+    return bResult;
+}
+
+QColor QHexView::getSpanColor(const QHexViewStructures::SPAN &span)
+{
+    // Neighbouring fields get distant hues
+    return QColor::fromHsv((span.nField * 67 + span.nRecord * 31) % 360, 80, 255, 110);
+}
+
 void QHexView::resizeEvent(QResizeEvent *pEvent)
 {
     Q_UNUSED(pEvent)
 
-    adjust();
+    _adjustAsync();
 }
 
 void QHexView::keyPressEvent(QKeyEvent *pEvent)
@@ -768,6 +2769,8 @@ void QHexView::keyPressEvent(QKeyEvent *pEvent)
         pEvent->matches(QKeySequence::MoveToPreviousLine) || pEvent->matches(QKeySequence::MoveToStartOfLine) || pEvent->matches(QKeySequence::MoveToEndOfLine) ||
         pEvent->matches(QKeySequence::MoveToNextPage) || pEvent->matches(QKeySequence::MoveToPreviousPage) || pEvent->matches(QKeySequence::MoveToStartOfDocument) ||
         pEvent->matches(QKeySequence::MoveToEndOfDocument)) {
+        g_sUnitEdit.clear();
+
         if (pEvent->matches(QKeySequence::MoveToNextChar) || pEvent->matches(QKeySequence::MoveToPreviousChar)) {
             if (g_posInfo.cursorPosition.type == CT_ANSI) {
                 if (pEvent->matches(QKeySequence::MoveToNextChar)) {
@@ -775,19 +2778,13 @@ void QHexView::keyPressEvent(QKeyEvent *pEvent)
                 } else if (pEvent->matches(QKeySequence::MoveToPreviousChar)) {
                     g_posInfo.cursorPosition.nOffset--;
                 }
-            } else if (g_posInfo.cursorPosition.type == CT_HIWORD) {
-                if (pEvent->matches(QKeySequence::MoveToNextChar)) {
-                    g_posInfo.cursorPosition.type = CT_LOWORD;
-                } else if (pEvent->matches(QKeySequence::MoveToPreviousChar)) {
-                    g_posInfo.cursorPosition.nOffset--;
-                    g_posInfo.cursorPosition.type = CT_LOWORD;
-                }
-            } else if (g_posInfo.cursorPosition.type == CT_LOWORD) {
+            } else if ((g_posInfo.cursorPosition.type == CT_HIWORD) || (g_posInfo.cursorPosition.type == CT_LOWORD)) {
+                _moveCursorDigit(pEvent->matches(QKeySequence::MoveToNextChar));
+            } else if (g_posInfo.cursorPosition.type == CT_UNIT) {
                 if (pEvent->matches(QKeySequence::MoveToNextChar)) {
-                    g_posInfo.cursorPosition.nOffset++;
-                    g_posInfo.cursorPosition.type = CT_HIWORD;
+                    g_posInfo.cursorPosition.nOffset += g_nUnitSize;
                 } else if (pEvent->matches(QKeySequence::MoveToPreviousChar)) {
-                    g_posInfo.cursorPosition.type = CT_HIWORD;
+                    g_posInfo.cursorPosition.nOffset -= g_nUnitSize;
                 }
             }
         } else if (pEvent->matches(QKeySequence::MoveToNextLine) || pEvent->matches(QKeySequence::MoveToPreviousLine)) {
@@ -817,6 +2814,10 @@ void QHexView::keyPressEvent(QKeyEvent *pEvent)
             } else if (pEvent->matches(QKeySequence::MoveToEndOfDocument)) {
                 g_posInfo.cursorPosition.nOffset = g_nDataSize - 1;
             }
+
+            if (g_posInfo.cursorPosition.type == CT_UNIT) {
+                g_posInfo.cursorPosition.nOffset = _getUnitOffset(g_posInfo.cursorPosition.nOffset);
+            }
         }
 
         if (g_posInfo.cursorPosition.type != CT_NONE) {
@@ -826,15 +2827,17 @@ void QHexView::keyPressEvent(QKeyEvent *pEvent)
                     g_posInfo.cursorPosition.nOffset = 0;
                     g_nStartOffsetDelta = 0;
 
-                    if (g_posInfo.cursorPosition.type != CT_ANSI) {
+                    if ((g_posInfo.cursorPosition.type == CT_HIWORD) || (g_posInfo.cursorPosition.type == CT_LOWORD)) {
                         g_posInfo.cursorPosition.type = CT_HIWORD;
                     }
                 } else if (g_posInfo.cursorPosition.nOffset > g_nDataSize - 1) {
                     g_posInfo.cursorPosition.nOffset = g_nDataSize - 1;
                     g_nStartOffsetDelta = 0;
 
-                    if (g_posInfo.cursorPosition.type != CT_ANSI) {
+                    if ((g_posInfo.cursorPosition.type == CT_HIWORD) || (g_posInfo.cursorPosition.type == CT_LOWORD)) {
                         g_posInfo.cursorPosition.type = CT_LOWORD;
+                    } else if (g_posInfo.cursorPosition.type == CT_UNIT) {
+                        g_posInfo.cursorPosition.nOffset = _getUnitOffset(g_nDataSize - 1);
                     }
                 }
 
@@ -870,8 +2873,8 @@ void QHexView::keyPressEvent(QKeyEvent *pEvent)
                 _goToOffset(nEndPageOffset);
             }
 
-            adjust();
-            viewport()->update();
+            // Key repeat: the cursor moves at once, the data of the new lines comes with the next frame
+            _adjustAsync();
         }
     } else if (pEvent->matches(QKeySequence::SelectAll))  // TODO select chars
     {
@@ -880,19 +2883,39 @@ void QHexView::keyPressEvent(QKeyEvent *pEvent)
 
         adjust();
         viewport()->update();
+    } else if (pEvent->matches(QKeySequence::Undo)) {
+        undo();
+    } else if (pEvent->matches(QKeySequence::Redo)) {
+        redo();
+    } else if (pEvent->matches(QKeySequence::Paste)) {
+        paste(g_posInfo.cursorPosition.type != CT_ANSI);
+    } else if (pEvent->matches(QKeySequence::Save)) {
+        save();
     } else {
         if (!g_bReadonly) {
             if ((!(pEvent->modifiers() & Qt::AltModifier)) && (!(pEvent->modifiers() & Qt::ControlModifier)) && (!(pEvent->modifiers() & Qt::MetaModifier))) {
                 quint8 nByte = 0;
                 quint8 nChar = 0;
+                QByteArray baUnit;
+                qint64 nWriteOffset = g_posInfo.cursorPosition.nOffset;
                 int nKey = pEvent->key();
                 bool bSuccess = false;
 
-                if (readByte(g_posInfo.cursorPosition.nOffset, &nByte)) {
+                if (g_posInfo.cursorPosition.type == CT_UNIT) {
+                    // Decimal and float values are typed as text and written on Enter
+                    bSuccess = _editUnit(pEvent, &baUnit);
+                } else if (readByte(g_posInfo.cursorPosition.nOffset, &nByte)) {
                     if (g_posInfo.cursorPosition.type == CT_ANSI) {
-                        if ((nKey >= Qt::Key_Space) && (nKey <= Qt::Key_AsciiTilde)) {
-                            nChar = (quint8)((unsigned char *)(pEvent->text().toLatin1().data()))[0];
-                            bSuccess = true;
+                        QString sText = pEvent->text();
+
+                        if ((sText.size() == 1) && (sText.at(0).isPrint())) {
+                            // UTF-8 and UTF-16 write the whole sequence of the character
+                            bSuccess = QHexViewEncoding::encodeChar(g_encoding, sText.at(0), &baUnit);
+
+                            if ((g_encoding == QHexViewEncoding::ENC_UTF16LE) || (g_encoding == QHexViewEncoding::ENC_UTF16BE)) {
+                                // Code units start at even offsets
+                                nWriteOffset -= (nWriteOffset & 1);
+                            }
                         }
                     } else if ((g_posInfo.cursorPosition.type == CT_HIWORD) || (g_posInfo.cursorPosition.type == CT_LOWORD)) {
                         if ((nKey >= Qt::Key_0) && (nKey <= Qt::Key_9)) {
@@ -910,54 +2933,35 @@ void QHexView::keyPressEvent(QKeyEvent *pEvent)
                         } else if (g_posInfo.cursorPosition.type == CT_LOWORD) {
                             nChar = (nByte & 0xF0) + nChar;
                         }
+                    }
+                }
 
-                        bool bSave = true;
-
-                        if (!g_bIsEdited) {
-                            // TODO Check
-                            // Save backup
-                            if (g_sBackupFileName != "") {
-                                if (!QFile::exists(g_sBackupFileName)) {
-                                    if (g_pDevice->metaObject()->className() == QString("QFile")) {
-                                        QString sFileName = ((QFile *)g_pDevice)->fileName();
-
-                                        if (!QFile::copy(sFileName, g_sBackupFileName)) {
-                                            bSave = false;
-                                            emit errorMessage(tr("Cannot save file") + QString(": %1").arg(g_sBackupFileName));
-                                        }
-                                    }
-                                    // TODO if not file/ Create file/ Write data
-                                }
-                            }
-                        }
-
-                        if (bSave) {
-                            if (writeByte(g_posInfo.cursorPosition.nOffset, &nChar)) {
-                                g_bIsEdited = true;
-
-                                emit editState(g_bIsEdited);
-
-                                if (g_posInfo.cursorPosition.type == CT_ANSI) {
-                                    g_posInfo.cursorPosition.nOffset++;
-                                } else if (g_posInfo.cursorPosition.type == CT_HIWORD) {
-                                    g_posInfo.cursorPosition.type = CT_LOWORD;
-                                } else if (g_posInfo.cursorPosition.type == CT_LOWORD) {
-                                    g_posInfo.cursorPosition.nOffset++;
-                                    g_posInfo.cursorPosition.type = CT_HIWORD;
-                                }
+                if (bSuccess) {
+                    if ((g_posInfo.cursorPosition.type == CT_HIWORD) || (g_posInfo.cursorPosition.type == CT_LOWORD)) {
+                        baUnit = QByteArray(1, (char)nChar);
+                    }
 
-                                if (g_posInfo.cursorPosition.nOffset > g_nDataSize - 1) {
-                                    g_posInfo.cursorPosition.nOffset = g_nDataSize - 1;
+                    if (patch(PatchProcess::PO_WRITE, nWriteOffset, baUnit.size(), baUnit)) {
+                        if (g_posInfo.cursorPosition.type == CT_ANSI) {
+                            g_posInfo.cursorPosition.nOffset = nWriteOffset + baUnit.size();
+                        } else if ((g_posInfo.cursorPosition.type == CT_HIWORD) || (g_posInfo.cursorPosition.type == CT_LOWORD)) {
+                            _moveCursorDigit(true);
+                        } else if (g_posInfo.cursorPosition.type == CT_UNIT) {
+                            g_posInfo.cursorPosition.nOffset += g_nUnitSize;
+                        }
 
-                                    if (g_posInfo.cursorPosition.type != CT_ANSI) {
-                                        g_posInfo.cursorPosition.type = CT_LOWORD;
-                                    }
-                                }
+                        if (g_posInfo.cursorPosition.nOffset > g_nDataSize - 1) {
+                            g_posInfo.cursorPosition.nOffset = g_nDataSize - 1;
 
-                                adjust();
-                                viewport()->update();
+                            if ((g_posInfo.cursorPosition.type == CT_HIWORD) || (g_posInfo.cursorPosition.type == CT_LOWORD)) {
+                                g_posInfo.cursorPosition.type = CT_LOWORD;
+                            } else if (g_posInfo.cursorPosition.type == CT_UNIT) {
+                                g_posInfo.cursorPosition.nOffset = _getUnitOffset(g_nDataSize - 1);
                             }
                         }
+
+                        adjust();
+                        viewport()->update();
                     }
                 }
             }
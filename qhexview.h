@@ -25,13 +25,29 @@
 #include <QApplication>
 #include <QClipboard>
 #include <QElapsedTimer>
+#include <QFile>
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
 #include <QIODevice>
+#include <QMimeData>
 #include <QPaintEvent>
 #include <QPainter>
 #include <QScrollBar>
+#include <QTemporaryFile>
 #include <QTimer>
 #include <QWidget>
+#include <QtConcurrent>
 
+#include "patchprocess.h"
+#include "filedumpprocess.h"
+#include "qhexviewannotations.h"
+#include "qhexviewcachedatasource.h"
+#include "qhexviewdatasource.h"
+#include "qhexviewoverlaydatasource.h"
+#include "qhexviewstructures.h"
+#include "replaceprocess.h"
+#include "qhexviewencoding.h"
+#include "saveprocess.h"
 #include "xbinary.h"
 
 class QHexView : public QAbstractScrollArea {
@@ -44,13 +60,30 @@ public:
         qint64 nSizeOfSelection;
         QString sBackupFileName;
         XBinary::_MEMORY_MAP memoryMap;
+        bool bOverlay;  // edits are kept until save() instead of going to the source at once; never for process memory
     };
 
     enum CURSOR_TYPE {
         CT_NONE = 0,
         CT_HIWORD,
         CT_LOWORD,
-        CT_ANSI
+        CT_ANSI,
+        CT_UNIT  // whole value of a decimal or float display mode
+    };
+
+    enum DM {
+        DM_BYTE = 0,
+        DM_WORD,
+        DM_DWORD,
+        DM_QWORD,
+        DM_INT16,
+        DM_INT32,
+        DM_INT64,
+        DM_UINT16,
+        DM_UINT32,
+        DM_UINT64,
+        DM_FLOAT,
+        DM_DOUBLE
     };
 
     struct CURSOR_POSITION {
@@ -66,6 +99,11 @@ public:
         qint64 nSelectionSize;
     };
 
+    struct RANGE {
+        qint64 nOffset;
+        qint64 nSize;
+    };
+
     struct POS_INFO {
         qint64 nSelectionInitOffset;
         qint64 nSelectionStartOffset;
@@ -74,9 +112,11 @@ public:
     };
 
     QHexView(QWidget *pParent = nullptr);
-    //    ~QHexView();
+    ~QHexView();
     QIODevice *getDevice() const;
+    QHexViewDataSource *getDataSource() const;
     void setData(QIODevice *pDevice, OPTIONS *pOptions = nullptr);
+    void setDataSource(QHexViewDataSource *pDataSource, OPTIONS *pOptions = nullptr);
     void setBackupFileName(QString sBackupFileName);
     quint32 getBytesProLine() const;
     void setBytesProLine(const quint32 nBytesProLine);
@@ -88,12 +128,85 @@ public:
     void reload();
     STATE getState();
     bool setReadonly(bool bState);
+    bool isReadonly();
     QByteArray readArray(qint64 nOffset, qint64 nSize);
     bool isEdited();
     void setEdited(bool bState);
     qint64 getBaseAddress();
+    void setDiffRanges(const QVector<RANGE> &listDiffRanges);
+    qint64 getNextDiffOffset(qint64 nOffset);
+    qint64 getPrevDiffOffset(qint64 nOffset);
+    qint64 getNextDataOffset(qint64 nOffset);
+    void setFollowMode(bool bState, bool bPinToEnd = true);
+    bool isFollowMode();
+    void setRefreshMode(bool bState, qint32 nInterval = 1000);
+    bool isRefreshMode();
+    bool addWatchRange(qint64 nOffset, qint64 nSize);  // false for more than 16 MB
+    void clearWatchRanges();
+    void setEncoding(QHexViewEncoding::ENC encoding);
+    QHexViewEncoding::ENC getEncoding();
+    void setDisplayMode(DM displayMode, bool bIsBigEndian = false);
+    DM getDisplayMode();
+    bool isBigEndian();
+    static QList<DM> getDisplayModes();
+    static QString displayModeToString(DM displayMode);
+    // One undo step, the size of the data is not changed
+    bool patch(PatchProcess::PO op, qint64 nOffset, qint64 nSize, const QByteArray &baPattern, QIODevice *pInput = nullptr);
+    bool paste(bool bHex);  // over the selection or from the cursor
+    // Up to nLimit (-1 all) occurrences. Patterns of different size rewrite the file from the first hit and clear the undo steps
+    bool replace(qint64 nOffset, qint64 nSize, const QByteArray &baFind, const QByteArray &baReplace, qint64 nLimit = -1, qint64 *pnCount = nullptr);
+    bool canUndo();
+    bool canRedo();
+    bool undo();
+    bool redo();
+    void clearUndo();
+    bool isModified();  // edits not saved yet
+    bool save();
+    bool saveAs(QString sFileName);  // the source keeps its edits
+    void discardChanges();
+    // Fields are tinted and described in tool tips, nCount elements of an array
+    void addStructure(const QHexViewStructures::STRUCT &structure, qint64 nOffset, qint64 nCount = 1);
+    void clearStructures();
+    // Coloured ranges and bookmarks, only the visible ones are looked up
+    void addAnnotation(qint64 nOffset, qint64 nSize, QColor color, QString sText, bool bBookmark = false);
+    void appendAnnotations(const QVector<QHexViewAnnotations::ANNOTATION> &listAnnotations);
+    qint32 removeAnnotations(qint64 nOffset);
+    void clearAnnotations();
+    QVector<QHexViewAnnotations::ANNOTATION> getAnnotations();
+    qint64 getNextBookmark(qint64 nOffset);
+    qint64 getPrevBookmark(qint64 nOffset);
+    void setMemoryMapColors(bool bState);  // a colour for each record of the memory map
+    bool isMemoryMapColors();
 
 private:
+    struct WATCH_RANGE {
+        qint64 nOffset;
+        qint64 nSize;
+        QByteArray baSnapshot;
+    };
+
+    // The previous data of a range, in a temporary file if it is large
+    struct UNDO_RECORD {
+        qint64 nOffset;
+        qint64 nSize;
+        QIODevice *pData;
+        QVector<qint64> listOffsets;  // replace steps: baData is written there, baSwap is the data there now; pData is not used
+        QByteArray baData;
+        QByteArray baSwap;
+    };
+
+    // Data of the visible lines, read in a worker thread while scrolling
+    struct WINDOW {
+        qint32 nId;
+        qint64 nOffset;
+        qint32 nBlockSize;  // requested, the data is shorter at the end
+        QByteArray baData;
+        QByteArray baUnreadableMask;
+        QByteArray baHoleMask;
+        QByteArray baLeadIn;  // context of multibyte encodings
+        QByteArray baTail;
+    };
+
     enum ST {
         ST_NOTSELECTED = 0,
         ST_ONEBYTE,
@@ -102,8 +215,41 @@ private:
         ST_END
     };
 
-    static char convertANSI(char cByte);
+    void _setDataSource(QHexViewDataSource *pDataSource, bool bOwned, OPTIONS *pOptions);  // bOwned: from the registry
+    void _releaseDataSource();
+    static bool _isOverlay(QIODevice *pDevice, OPTIONS *pOptions);
+    XBinary::_MEMORY_MAP getDefaultMemoryMap();
+    void _decodeGlyphs(const QByteArray &baLeadIn, const QByteArray &baTail);
+    void _adjustLayout();
+    void _adjustCursor();
+    void _updateSpans();
+    static QColor getSpanColor(const QHexViewStructures::SPAN &span);
+    void _updateAnnotations();
+    void _setMemoryMapAnnotations();
+    void _adjustAsync();  // the data is fetched later, at most once per frame
+    bool _isWindowValid();
+    void _cancelFetch();
+    WINDOW _readWindow(QHexViewDataSource *pDataSource, qint64 nDataSize, qint64 nOffset, qint32 nBlockSize, qint32 nId);
+    void _setWindow(const WINDOW &window);
+    void _formatUnits();
+    bool _isHexMode();
+    void _adjustBytesProLine();
+    qint64 _getUnitOffset(qint64 nOffset);
+    qint32 _nibbleToDigit(qint32 nByte, CURSOR_TYPE type);
+    void _digitToNibble(qint32 nDigit, qint32 *pnByte, CURSOR_TYPE *pType);
+    void _moveCursorDigit(bool bForward);
+    bool _editUnit(QKeyEvent *pEvent, QByteArray *pbaUnit);
+    bool _saveBackup();
+    QIODevice *_createUndoDevice(qint64 nSize);
+    bool _runProcess(HexProcess *pProcess, qint64 nSize, const QString &sTitle);  // sTitle: of the progress dialog
+    bool _swapRecord(QList<UNDO_RECORD> *pListFrom, QList<UNDO_RECORD> *pListTo, const QString &sTitle);
+    void _addRecord(QList<UNDO_RECORD> *pList, UNDO_RECORD record);
+    void _clearRecords(QList<UNDO_RECORD> *pList);
     static QString getFontName();
+    static QTimer *_getCursorTimer();
+    void _setBlink(bool bState);
+    static void _getCharSize(const QFont &font, qint32 *pnWidth, qint32 *pnHeight);
+    static void _getDefaultCharSize(qint32 *pnWidth, qint32 *pnHeight);
 
 public slots:
     void goToAddress(qint64 nAddress);
@@ -137,14 +283,24 @@ private slots:
     qint64 offsetToAddress(qint64 nOffset);
     QPoint cursorToPoint(CURSOR_POSITION cp);
     bool readByte(qint64 nOffset, quint8 *pByte);
-    bool writeByte(qint64 nOffset, quint8 *pByte);
+    qint32 readWindow(QHexViewDataSource *pDataSource, qint64 nDataSize, qint64 nOffset, char *pBuffer, qint32 nSize, QByteArray *pbaUnreadableMask, qint32 nId);
     void _customContextMenu(const QPoint &pos);
+    void _followChanged();
+    void _followCheckSize();
+    void _refresh();
+    void _fetchWindow();
+    void _fetchFinished();
+    void _dataSourceChanged(qint64 nOffset, qint64 nSize);
+    void _dataSourceReset();
 
 signals:
     void cursorPositionChanged();
     void errorMessage(QString sText);
     void customContextMenu(const QPoint &pos);
     void editState(bool bState);
+    void dataChanged(qint64 nOffset, qint64 nSize);
+    // Large edits, for a progress dialog: connected directly, the process has run when it returns. Without a receiver it runs in place
+    void processRequested(HexProcess *pProcess, QString sTitle);
 
 protected:
     virtual void paintEvent(QPaintEvent *pEvent);
@@ -153,11 +309,22 @@ protected:
     virtual void resizeEvent(QResizeEvent *pEvent);
     virtual void keyPressEvent(QKeyEvent *pEvent);
     virtual void wheelEvent(QWheelEvent *pEvent);
+    virtual void showEvent(QShowEvent *pEvent);
+    virtual void hideEvent(QHideEvent *pEvent);
+    virtual void focusInEvent(QFocusEvent *pEvent);
+    virtual void focusOutEvent(QFocusEvent *pEvent);
+    virtual bool viewportEvent(QEvent *pEvent);
 
 private:
+    const qint64 N_PAGE_SIZE = 0x1000;
+
     QIODevice *g_pDevice;
+    QHexViewDataSource *g_pDataSource;
+    QHexViewOverlayDataSource *g_pOverlay;  // over the writable sources, g_pDataSource
+    bool g_bDataSourceOwned;
     qint32 g_nXOffset;
     qint32 g_nBytesProLine;
+    qint32 g_nBytesProLineRequested;  // by setBytesProLine, g_nBytesProLine is rounded up to whole units
     qint32 g_nCharWidth;
     qint32 g_nCharHeight;
     qint32 g_nLinesProPage;
@@ -175,17 +342,65 @@ private:
     qint32 g_nTotalLineCount;
     qint64 g_nDataSize;
     QByteArray g_baDataBuffer;
+    qint64 g_nBufferOffset;     // of g_baDataBuffer, differs from g_nStartOffset while a fetch is in flight
+    qint32 g_nBufferBlockSize;
     QByteArray g_baDataHexBuffer;
+    QByteArray g_baDiffMask;
+    QByteArray g_baUnreadableMask;
+    QByteArray g_baHoleMask;
+    QVector<RANGE> g_listDiffRanges;
     qint32 g_nLineDelta;
     bool g_bBlink;
-    QTimer g_timerCursor;
+    bool g_bInit;  // shown once: the font is set and the data is read
     QRect g_rectCursor;
     POS_INFO g_posInfo;
+    POS_INFO g_posInfoEmitted;  // at the last cursorPositionChanged() of adjust
     bool g_bMouseSelection;
     bool g_bReadonly;
     bool g_bIsEdited;
     QString g_sBackupFileName;
     XBinary::_MEMORY_MAP g_memoryMap;
+    bool g_bFollowMode;
+    bool g_bFollowPinToEnd;
+    QFileSystemWatcher *g_pFollowWatcher;
+    QTimer g_timerFollowPoll;
+    QTimer g_timerFollowUpdate;
+    bool g_bRefreshMode;
+    QTimer g_timerRefresh;
+    QByteArray g_baHeat;
+    qint64 g_nHeatStartOffset;
+    QList<WATCH_RANGE> g_listWatchRanges;
+    QHexViewEncoding::ENC g_encoding;
+    QVector<quint32> g_listGlyphs;  // text column of the window
+    DM g_displayMode;
+    bool g_bIsBigEndian;
+    qint32 g_nUnitSize;     // bytes
+    qint32 g_nUnitChars;    // characters of a formatted unit
+    QString g_sUnitEdit;    // value being typed in a CT_UNIT cell
+    QList<UNDO_RECORD> g_listUndo;
+    QList<UNDO_RECORD> g_listRedo;
+    QHexViewStructures g_structures;
+    QVector<QHexViewStructures::SPAN> g_listSpans;  // of the visible lines
+    QVector<qint32> g_listSpanIndex;                // per byte from g_nStartOffset, -1 if there is no field
+    QHexViewAnnotations g_annotations;
+    QHexViewAnnotations g_memoryMapAnnotations;
+    bool g_bMemoryMapColors;
+    QVector<QRgb> g_listAnnotationColors;  // per byte from g_nStartOffset, 0 if there is no annotation
+    QByteArray g_baBookmarkLines;          // visible lines with the start of a bookmark
+
+    const qint64 N_UNDO_MEMORY_SIZE = 0x1000000;   // larger undo data goes to a temporary file
+    const qint64 N_PATCH_DIALOG_SIZE = 0x1000000;  // larger patches show progress
+    const qint32 N_MAX_UNDO = 1000;
+    const qint32 N_FRAME_INTERVAL = 16;  // msec, scroll and key events are coalesced to one fetch per frame
+    const qint64 N_MAX_WATCH_SIZE = 0x1000000;  // watched ranges are read again on every refresh
+
+    QTimer g_timerFetch;
+    QFutureWatcher<WINDOW> g_watcherFetch;
+    QAtomicInt g_nFetchId;  // the latest request, older reads stop and are dropped
+    qint64 g_nFetchOffset;  // of the read in flight
+    qint32 g_nFetchBlockSize;
+
+    static QHexView *g_pCursorView;  // the focused view, the only one that blinks
 };
 
 #endif  // QHEXVIEW_H
@@ -1,18 +1,92 @@
 INCLUDEPATH += $$PWD
 DEPENDPATH += $$PWD
 
+QT += concurrent network
+
+LIBS += -lz
+
+# Optional decoders for the decompressed view
+contains(DEFINES, QHEXVIEW_ZSTD) {
+    LIBS += -lzstd
+}
+
+contains(DEFINES, QHEXVIEW_XZ) {
+    LIBS += -llzma
+}
+
 HEADERS += \
+    $$PWD/annotationprocess.h \
+    $$PWD/compareprocess.h \
+    $$PWD/compressedindexprocess.h \
     $$PWD/dialoghex.h \
+    $$PWD/dialoghexcompare.h \
+    $$PWD/dialoghexprocess.h \
+    $$PWD/exportprocess.h \
+    $$PWD/filedumpprocess.h \
+    $$PWD/hashprocess.h \
+    $$PWD/hexprocess.h \
+    $$PWD/patchprocess.h \
+    $$PWD/processmemorydevice.h \
     $$PWD/qhexview.h \
-    $$PWD/qhexviewwidget.h
+    $$PWD/qhexviewannotations.h \
+    $$PWD/qhexviewcachedatasource.h \
+    $$PWD/qhexviewcompresseddatasource.h \
+    $$PWD/qhexviewdatasource.h \
+    $$PWD/qhexviewencoding.h \
+    $$PWD/qhexviewoverlaydatasource.h \
+    $$PWD/qhexviewremotedatasource.h \
+    $$PWD/qhexviewsession.h \
+    $$PWD/qhexviewstringsmodel.h \
+    $$PWD/qhexviewstringswidget.h \
+    $$PWD/qhexviewstructures.h \
+    $$PWD/qhexviewtransformdatasource.h \
+    $$PWD/qhexviewutils.h \
+    $$PWD/qhexviewwidget.h \
+    $$PWD/replaceprocess.h \
+    $$PWD/saveprocess.h \
+    $$PWD/stringsindex.h \
+    $$PWD/stringsprocess.h \
+    $$PWD/transformindexprocess.h
 
 SOURCES += \
+    $$PWD/annotationprocess.cpp \
+    $$PWD/compareprocess.cpp \
+    $$PWD/compressedindexprocess.cpp \
     $$PWD/dialoghex.cpp \
+    $$PWD/dialoghexcompare.cpp \
+    $$PWD/dialoghexprocess.cpp \
+    $$PWD/exportprocess.cpp \
+    $$PWD/filedumpprocess.cpp \
+    $$PWD/hashprocess.cpp \
+    $$PWD/hexprocess.cpp \
+    $$PWD/patchprocess.cpp \
+    $$PWD/processmemorydevice.cpp \
     $$PWD/qhexview.cpp \
-    $$PWD/qhexviewwidget.cpp
+    $$PWD/qhexviewannotations.cpp \
+    $$PWD/qhexviewcachedatasource.cpp \
+    $$PWD/qhexviewcompresseddatasource.cpp \
+    $$PWD/qhexviewdatasource.cpp \
+    $$PWD/qhexviewencoding.cpp \
+    $$PWD/qhexviewoverlaydatasource.cpp \
+    $$PWD/qhexviewremotedatasource.cpp \
+    $$PWD/qhexviewsession.cpp \
+    $$PWD/qhexviewstringsmodel.cpp \
+    $$PWD/qhexviewstringswidget.cpp \
+    $$PWD/qhexviewstructures.cpp \
+    $$PWD/qhexviewtransformdatasource.cpp \
+    $$PWD/qhexviewutils.cpp \
+    $$PWD/qhexviewwidget.cpp \
+    $$PWD/replaceprocess.cpp \
+    $$PWD/saveprocess.cpp \
+    $$PWD/stringsindex.cpp \
+    $$PWD/stringsprocess.cpp \
+    $$PWD/transformindexprocess.cpp
 
 FORMS += \
     $$PWD/dialoghex.ui \
+    $$PWD/dialoghexcompare.ui \
+    $$PWD/dialoghexprocess.ui \
+    $$PWD/qhexviewstringswidget.ui \
     $$PWD/qhexviewwidget.ui
 
 !contains(XCONFIG, xlineedithex) {
@@ -0,0 +1,323 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "qhexviewannotations.h"
+
+#include <algorithm>
+#include <limits>
+
+QHexViewAnnotations::QHexViewAnnotations(QObject *pParent) : QObject(pParent)
+{
+    g_nMaxLevel = -1;
+    g_bIndexed = true;
+}
+
+void QHexViewAnnotations::add(const ANNOTATION &annotation)
+{
+    ANNOTATION record = annotation;
+    record.nSize = qMax(record.nSize, (qint64)1);
+
+    // The end must fit in qint64, the queries compare with it
+    if ((record.nOffset >= 0) && (record.nSize > std::numeric_limits<qint64>::max() - record.nOffset)) {
+        record.nSize = std::numeric_limits<qint64>::max() - record.nOffset;
+    }
+
+    g_listAnnotations.append(record);
+    g_bIndexed = false;
+}
+
+void QHexViewAnnotations::append(const QVector<ANNOTATION> &listAnnotations)
+{
+    // Indexed once, on the next query
+    qint32 nNumberOfAnnotations = listAnnotations.count();
+
+    g_listAnnotations.reserve(g_listAnnotations.count() + nNumberOfAnnotations);
+
+    for (qint32 i = 0; i < nNumberOfAnnotations; i++) {
+        add(listAnnotations.at(i));
+    }
+}
+
+qint32 QHexViewAnnotations::remove(qint64 nOffset)
+{
+    QVector<qint32> listIndexes = getOverlaps(nOffset, 1);
+    qint32 nResult = listIndexes.count();
+
+    for (qint32 i = nResult - 1; i >= 0; i--) {
+        g_listAnnotations.remove(listIndexes.at(i));
+    }
+
+    if (nResult) {
+        g_bIndexed = false;
+    }
+
+    return nResult;
+}
+
+void QHexViewAnnotations::clear()
+{
+    g_listAnnotations.clear();
+    g_listMaxEnds.clear();
+    g_nMaxLevel = -1;
+    g_bIndexed = true;
+}
+
+bool QHexViewAnnotations::isEmpty()
+{
+    return g_listAnnotations.isEmpty();
+}
+
+qint32 QHexViewAnnotations::getCount()
+{
+    return g_listAnnotations.count();
+}
+
+QVector<QHexViewAnnotations::ANNOTATION> QHexViewAnnotations::getAnnotations()
+{
+    _index();
+
+    return g_listAnnotations;
+}
+
+QHexViewAnnotations::ANNOTATION QHexViewAnnotations::getAnnotation(qint32 nIndex)
+{
+    ANNOTATION result = {};
+
+    _index();
+
+    if ((nIndex >= 0) && (nIndex < g_listAnnotations.count())) {
+        result = g_listAnnotations.at(nIndex);
+    }
+
+    return result;
+}
+
+QVector<qint32> QHexViewAnnotations::getOverlaps(qint64 nOffset, qint64 nSize)
+{
+    QVector<qint32> listResult;
+
+    _index();
+
+    qint32 nNumberOfAnnotations = g_listAnnotations.count();
+
+    if (nNumberOfAnnotations && (nSize > 0)) {
+        struct NODE {
+            qint32 nIndex;
+            qint32 nLevel;
+            bool bLeftDone;
+        };
+
+        qint64 nEnd = nOffset + nSize;
+        const ANNOTATION *pAnnotations = g_listAnnotations.constData();
+        const qint64 *pMaxEnds = g_listMaxEnds.constData();
+
+        NODE stack[64];
+        qint32 nTop = 0;
+
+        stack[nTop++] = {(qint32)((1LL << g_nMaxLevel) - 1), g_nMaxLevel, false};
+
+        // In order: left subtree, node, right subtree; a subtree is skipped if it ends before nOffset
+        while (nTop) {
+            NODE node = stack[--nTop];
+
+            if (node.nLevel <= N_SCAN_LEVEL) {
+                qint64 nFirst = ((qint64)node.nIndex >> node.nLevel) << node.nLevel;
+                qint64 nLast = qMin(nFirst + (1LL << (node.nLevel + 1)) - 1, (qint64)nNumberOfAnnotations);
+
+                for (qint64 i = nFirst; (i < nLast) && (pAnnotations[i].nOffset < nEnd); i++) {
+                    if (nOffset < pAnnotations[i].nOffset + pAnnotations[i].nSize) {
+                        listResult.append((qint32)i);
+                    }
+                }
+            } else if (!node.bLeftDone) {
+                qint64 nLeft = (qint64)node.nIndex - (1LL << (node.nLevel - 1));
+
+                stack[nTop++] = {node.nIndex, node.nLevel, true};
+
+                if ((nLeft >= nNumberOfAnnotations) || (pMaxEnds[nLeft] > nOffset)) {
+                    stack[nTop++] = {(qint32)nLeft, node.nLevel - 1, false};
+                }
+            } else if ((node.nIndex < nNumberOfAnnotations) && (pAnnotations[node.nIndex].nOffset < nEnd)) {
+                if (nOffset < pAnnotations[node.nIndex].nOffset + pAnnotations[node.nIndex].nSize) {
+                    listResult.append(node.nIndex);
+                }
+
+                stack[nTop++] = {(qint32)(node.nIndex + (1LL << (node.nLevel - 1))), node.nLevel - 1, false};
+            }
+        }
+    }
+
+    return listResult;
+}
+
+qint64 QHexViewAnnotations::getNextBookmark(qint64 nOffset)
+{
+    qint64 nResult = -1;
+
+    _index();
+
+    QVector<ANNOTATION>::const_iterator iter = std::upper_bound(g_listAnnotations.constBegin(), g_listAnnotations.constEnd(), nOffset,
+                                                                [](qint64 nValue, const ANNOTATION &annotation) { return nValue < annotation.nOffset; });
+
+    for (; iter != g_listAnnotations.constEnd(); ++iter) {
+        if (iter->bBookmark) {
+            nResult = iter->nOffset;
+            break;
+        }
+    }
+
+    return nResult;
+}
+
+qint64 QHexViewAnnotations::getPrevBookmark(qint64 nOffset)
+{
+    qint64 nResult = -1;
+
+    _index();
+
+    QVector<ANNOTATION>::const_iterator iter = std::lower_bound(g_listAnnotations.constBegin(), g_listAnnotations.constEnd(), nOffset,
+                                                                [](const ANNOTATION &annotation, qint64 nValue) { return annotation.nOffset < nValue; });
+
+    while (iter != g_listAnnotations.constBegin()) {
+        --iter;
+
+        if (iter->bBookmark) {
+            nResult = iter->nOffset;
+            break;
+        }
+    }
+
+    return nResult;
+}
+
+bool QHexViewAnnotations::lineToAnnotation(const QByteArray &baLine, ANNOTATION *pAnnotation)
+{
+    bool bResult = false;
+
+    QByteArray baRecord = baLine.trimmed();
+
+    if ((!baRecord.isEmpty()) && (baRecord.at(0) != ';')) {
+        QList<QByteArray> listColumns = baRecord.split('\t');
+
+        if (listColumns.count() >= 2) {
+            bool bOffset = false;
+            bool bSize = false;
+
+            ANNOTATION annotation = {};
+            annotation.nOffset = listColumns.at(0).trimmed().toLongLong(&bOffset, 0);
+            annotation.nSize = listColumns.at(1).trimmed().toLongLong(&bSize, 0);
+            annotation.nColor = qRgba(255, 255, 0, 110);
+
+            if (listColumns.count() >= 3) {
+                QColor color(QString::fromLatin1(listColumns.at(2).trimmed()));
+
+                if (color.isValid()) {
+                    annotation.nColor = color.rgba();
+                }
+            }
+
+            if (listColumns.count() >= 4) {
+                annotation.bBookmark = (listColumns.at(3).trimmed() == "bookmark");
+            }
+
+            if (listColumns.count() >= 5) {
+                // The text may have tabs
+                annotation.sText = QString::fromUtf8(listColumns.mid(4).join('\t'));
+            }
+
+            if (bOffset && bSize && (annotation.nOffset >= 0) && (annotation.nSize >= 0) &&
+                (annotation.nSize <= std::numeric_limits<qint64>::max() - annotation.nOffset)) {
+                *pAnnotation = annotation;
+                bResult = true;
+            }
+        }
+    }
+
+    return bResult;
+}
+
+QByteArray QHexViewAnnotations::annotationToLine(const ANNOTATION &annotation)
+{
+    QByteArray baResult;
+
+    baResult += "0x" + QByteArray::number(annotation.nOffset, 16) + '\t';
+    baResult += "0x" + QByteArray::number(annotation.nSize, 16) + '\t';
+    baResult += QColor::fromRgba(annotation.nColor).name(QColor::HexArgb).toLatin1() + '\t';
+    baResult += annotation.bBookmark ? QByteArray("bookmark") : QByteArray("annotation");
+    baResult += '\t';
+    baResult += annotation.sText.toUtf8().replace('\n', ' ');
+    baResult += '\n';
+
+    return baResult;
+}
+
+void QHexViewAnnotations::_index()
+{
+    if (!g_bIndexed) {
+        // Stable: of the records at one offset the last added is drawn on top
+        std::stable_sort(g_listAnnotations.begin(), g_listAnnotations.end(),
+                         [](const ANNOTATION &annotation1, const ANNOTATION &annotation2) { return annotation1.nOffset < annotation2.nOffset; });
+
+        qint32 nNumberOfAnnotations = g_listAnnotations.count();
+
+        g_listMaxEnds.resize(nNumberOfAnnotations);
+        g_nMaxLevel = -1;
+
+        if (nNumberOfAnnotations) {
+            const ANNOTATION *pAnnotations = g_listAnnotations.constData();
+            qint64 *pMaxEnds = g_listMaxEnds.data();
+
+            qint64 nLastIndex = 0;
+            qint64 nLastEnd = 0;
+
+            // Leaves are the even indexes, a node at level k is the middle of 2^(k+1) - 1 records
+            for (qint64 i = 0; i < nNumberOfAnnotations; i += 2) {
+                nLastIndex = i;
+                nLastEnd = pAnnotations[i].nOffset + pAnnotations[i].nSize;
+                pMaxEnds[i] = nLastEnd;
+            }
+
+            qint32 nLevel = 1;
+
+            for (; (1LL << nLevel) <= nNumberOfAnnotations; nLevel++) {
+                qint64 nHalf = 1LL << (nLevel - 1);
+                qint64 nStep = nHalf << 2;
+
+                for (qint64 i = (nHalf << 1) - 1; i < nNumberOfAnnotations; i += nStep) {
+                    qint64 nLeftEnd = pMaxEnds[i - nHalf];
+                    // Nodes past the end stand for the last subtree
+                    qint64 nRightEnd = (i + nHalf < nNumberOfAnnotations) ? pMaxEnds[i + nHalf] : nLastEnd;
+
+                    pMaxEnds[i] = qMax(pAnnotations[i].nOffset + pAnnotations[i].nSize, qMax(nLeftEnd, nRightEnd));
+                }
+
+                nLastIndex = ((nLastIndex >> nLevel) & 1) ? (nLastIndex - nHalf) : (nLastIndex + nHalf);
+
+                if ((nLastIndex < nNumberOfAnnotations) && (pMaxEnds[nLastIndex] > nLastEnd)) {
+                    nLastEnd = pMaxEnds[nLastIndex];
+                }
+            }
+
+            g_nMaxLevel = nLevel - 1;
+        }
+
+        g_bIndexed = true;
+    }
+}
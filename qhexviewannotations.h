@@ -0,0 +1,73 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef QHEXVIEWANNOTATIONS_H
+#define QHEXVIEWANNOTATIONS_H
+
+#include <QColor>
+#include <QObject>
+#include <QVector>
+
+// Coloured ranges and bookmarks. The records are kept sorted by offset with the largest end of each subtree
+// (an implicit interval tree), so a query costs O(log n + hits) for any number of records
+class QHexViewAnnotations : public QObject {
+    Q_OBJECT
+
+public:
+    struct ANNOTATION {
+        qint64 nOffset;
+        qint64 nSize;
+        QRgb nColor;
+        bool bBookmark;
+        QString sText;
+    };
+
+    explicit QHexViewAnnotations(QObject *pParent = nullptr);
+
+    void add(const ANNOTATION &annotation);
+    void append(const QVector<ANNOTATION> &listAnnotations);
+    qint32 remove(qint64 nOffset);  // the records over nOffset
+    void clear();
+    bool isEmpty();
+    qint32 getCount();
+    QVector<ANNOTATION> getAnnotations();  // ordered by offset, shared with the list here
+    ANNOTATION getAnnotation(qint32 nIndex);
+    QVector<qint32> getOverlaps(qint64 nOffset, qint64 nSize);  // indexes, ordered by offset
+    qint64 getNextBookmark(qint64 nOffset);                     // -1 if there is none
+    qint64 getPrevBookmark(qint64 nOffset);
+
+    // offset<TAB>size<TAB>#color<TAB>annotation|bookmark<TAB>text, one record per line
+    static bool lineToAnnotation(const QByteArray &baLine, ANNOTATION *pAnnotation);
+    static QByteArray annotationToLine(const ANNOTATION &annotation);
+
+private:
+    void _index();
+
+    enum {
+        N_SCAN_LEVEL = 3  // subtrees up to this level are scanned
+    };
+
+    QVector<ANNOTATION> g_listAnnotations;
+    QVector<qint64> g_listMaxEnds;  // of the subtree rooted at the index
+    qint32 g_nMaxLevel;
+    bool g_bIndexed;
+};
+
+#endif  // QHEXVIEWANNOTATIONS_H
@@ -0,0 +1,275 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "qhexviewcachedatasource.h"
+
+#include "processmemorydevice.h"
+
+QMutex QHexViewDataSourceRegistry::g_mutex;
+QMap<QIODevice *, QHexViewDataSourceRegistry::ENTRY> QHexViewDataSourceRegistry::g_mapEntries;
+
+QHexViewCacheDataSource::QHexViewCacheDataSource(QHexViewDataSource *pSource, QObject *pParent) : QHexViewDataSource(pParent)
+{
+    g_pSource = pSource;
+    g_cache.setMaxCost(N_MAX_CACHE_SIZE);
+    g_nGeneration = 0;
+
+    connect(g_pSource, SIGNAL(dataChanged(qint64, qint64)), this, SIGNAL(dataChanged(qint64, qint64)));
+    connect(g_pSource, SIGNAL(dataReset()), this, SIGNAL(dataReset()));
+}
+
+qint64 QHexViewCacheDataSource::getSize()
+{
+    return g_pSource->getSize();
+}
+
+qint64 QHexViewCacheDataSource::readAt(qint64 nOffset, char *pBuffer, qint64 nSize)
+{
+    qint64 nResult = 0;
+
+    if ((nSize > N_MAX_READ_SIZE) || (nOffset < 0)) {
+        // Scans of the workers would only push the pages of the views out
+        nResult = g_pSource->readAt(nOffset, pBuffer, nSize);
+    } else {
+        while (nResult < nSize) {
+            qint64 nCurrent = nOffset + nResult;
+            qint64 nPageOffset = nCurrent % N_PAGE_SIZE;
+
+            QByteArray baPage;
+            qint64 nAvailable = 0;
+
+            if (_getPage(nCurrent / N_PAGE_SIZE, &baPage)) {
+                nAvailable = baPage.size() - nPageOffset;
+            }
+
+            if (nAvailable <= 0) {
+                // Unreadable pages and the end of the data: the source gives the result
+                qint64 nCount = g_pSource->readAt(nCurrent, pBuffer + nResult, nSize - nResult);
+
+                if (nCount > 0) {
+                    nResult += nCount;
+                } else if (nResult == 0) {
+                    nResult = nCount;
+                }
+
+                break;
+            }
+
+            qint64 nCount = qMin(nAvailable, nSize - nResult);
+
+            memcpy(pBuffer + nResult, baPage.constData() + nPageOffset, (size_t)nCount);
+
+            nResult += nCount;
+
+            if (baPage.size() < N_PAGE_SIZE) {
+                break;
+            }
+        }
+    }
+
+    return nResult;
+}
+
+qint64 QHexViewCacheDataSource::writeAt(qint64 nOffset, const char *pBuffer, qint64 nSize)
+{
+    qint64 nResult = g_pSource->writeAt(nOffset, pBuffer, nSize);
+
+    if (nResult > 0) {
+        invalidate(nOffset, nResult);
+
+        emit dataChanged(nOffset, nResult);
+    }
+
+    return nResult;
+}
+
+bool QHexViewCacheDataSource::isWritable()
+{
+    return g_pSource->isWritable();
+}
+
+QIODevice *QHexViewCacheDataSource::getDevice()
+{
+    return g_pSource->getDevice();
+}
+
+bool QHexViewCacheDataSource::isSparse()
+{
+    return g_pSource->isSparse();
+}
+
+qint64 QHexViewCacheDataSource::getNextData(qint64 nOffset)
+{
+    return g_pSource->getNextData(nOffset);
+}
+
+qint64 QHexViewCacheDataSource::getNextHole(qint64 nOffset)
+{
+    return g_pSource->getNextHole(nOffset);
+}
+
+int QHexViewCacheDataSource::getHandle()
+{
+    return g_pSource->getHandle();
+}
+
+void QHexViewCacheDataSource::invalidate(qint64 nOffset, qint64 nSize)
+{
+    {
+        QMutexLocker locker(&g_mutex);
+
+        g_nGeneration++;
+
+        if (nSize == -1) {
+            g_cache.clear();
+        } else if (nSize > 0) {
+            qint64 nFirstPage = nOffset / N_PAGE_SIZE;
+            qint64 nLastPage = (nOffset + nSize - 1) / N_PAGE_SIZE;
+
+            for (qint64 i = nFirstPage; i <= nLastPage; i++) {
+                g_cache.remove(i);
+            }
+        }
+    }
+
+    // The source can have state of its own, as the extent map of a file
+    g_pSource->invalidate(nOffset, nSize);
+}
+
+QHexViewDataSource *QHexViewCacheDataSource::getSource()
+{
+    return g_pSource;
+}
+
+bool QHexViewCacheDataSource::_getPage(qint64 nPage, QByteArray *pbaPage)
+{
+    bool bResult = false;
+    quint32 nGeneration = 0;
+
+    {
+        QMutexLocker locker(&g_mutex);
+
+        QByteArray *pbaCached = g_cache.object(nPage);
+
+        if (pbaCached) {
+            *pbaPage = *pbaCached;
+            bResult = true;
+        }
+
+        nGeneration = g_nGeneration;
+    }
+
+    if (!bResult) {
+        // Read without the lock, the views and the workers read in parallel
+        pbaPage->resize((qint32)N_PAGE_SIZE);
+
+        qint64 nCount = g_pSource->readAt(nPage * N_PAGE_SIZE, pbaPage->data(), N_PAGE_SIZE);
+
+        if (nCount > 0) {
+            pbaPage->resize((qint32)nCount);
+            bResult = true;
+
+            QMutexLocker locker(&g_mutex);
+
+            if (nGeneration == g_nGeneration) {
+                g_cache.insert(nPage, new QByteArray(*pbaPage), (qint32)nCount);
+            }
+        }
+    }
+
+    return bResult;
+}
+
+QHexViewDataSource *QHexViewDataSourceRegistry::acquire(QIODevice *pDevice, bool bOverlay)
+{
+    QHexViewDataSource *pResult = nullptr;
+
+    if (pDevice) {
+        QMutexLocker locker(&g_mutex);
+
+        if (!g_mapEntries.contains(pDevice)) {
+            ENTRY entry = {};
+            entry.pSource = QHexViewDataSource::create(pDevice);
+
+            if (!_isVolatile(pDevice)) {
+                QHexViewCacheDataSource *pCache = new QHexViewCacheDataSource(entry.pSource);
+                entry.pSource->setParent(pCache);
+                entry.pSource = pCache;
+            }
+
+            g_mapEntries.insert(pDevice, entry);
+        }
+
+        ENTRY *pEntry = &(g_mapEntries[pDevice]);
+        pEntry->nCount++;
+
+        pResult = pEntry->pSource;
+
+        if (bOverlay && pEntry->pSource->isWritable()) {
+            // The edits are kept until a save, for all the views with an overlay
+            if (!pEntry->pOverlay) {
+                pEntry->pOverlay = new QHexViewOverlayDataSource(pEntry->pSource);
+            }
+
+            pEntry->nOverlayCount++;
+
+            pResult = pEntry->pOverlay;
+        }
+    }
+
+    return pResult;
+}
+
+void QHexViewDataSourceRegistry::release(QHexViewDataSource *pDataSource)
+{
+    QMutexLocker locker(&g_mutex);
+
+    for (QMap<QIODevice *, ENTRY>::iterator it = g_mapEntries.begin(); it != g_mapEntries.end(); it++) {
+        ENTRY *pEntry = &(it.value());
+
+        if (pDataSource && ((pEntry->pSource == pDataSource) || (pEntry->pOverlay == pDataSource))) {
+            if (pEntry->pOverlay == pDataSource) {
+                pEntry->nOverlayCount--;
+
+                if (pEntry->nOverlayCount == 0) {
+                    delete pEntry->pOverlay;
+                    pEntry->pOverlay = nullptr;
+                }
+            }
+
+            pEntry->nCount--;
+
+            if (pEntry->nCount == 0) {
+                // The device source is a child of the cache
+                delete pEntry->pSource;
+
+                g_mapEntries.erase(it);
+            }
+
+            break;
+        }
+    }
+}
+
+bool QHexViewDataSourceRegistry::_isVolatile(QIODevice *pDevice)
+{
+    // A running process changes its memory itself, every read must reach it
+    return qobject_cast<ProcessMemoryDevice *>(pDevice) != nullptr;
+}
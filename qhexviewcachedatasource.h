@@ -0,0 +1,85 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef QHEXVIEWCACHEDATASOURCE_H
+#define QHEXVIEWCACHEDATASOURCE_H
+
+#include <QCache>
+#include <QMap>
+#include <QMutex>
+
+#include "qhexviewdatasource.h"
+#include "qhexviewoverlaydatasource.h"
+
+// Pages of a source kept in memory for all the views of it. Large reads of the workers are not cached
+class QHexViewCacheDataSource : public QHexViewDataSource {
+    Q_OBJECT
+
+public:
+    explicit QHexViewCacheDataSource(QHexViewDataSource *pSource, QObject *pParent = nullptr);
+
+    qint64 getSize() override;
+    qint64 readAt(qint64 nOffset, char *pBuffer, qint64 nSize) override;
+    qint64 writeAt(qint64 nOffset, const char *pBuffer, qint64 nSize) override;
+    bool isWritable() override;
+    QIODevice *getDevice() override;
+    bool isSparse() override;
+    qint64 getNextData(qint64 nOffset) override;
+    qint64 getNextHole(qint64 nOffset) override;
+    int getHandle() override;
+    void invalidate(qint64 nOffset, qint64 nSize) override;
+
+    QHexViewDataSource *getSource();
+
+private:
+    bool _getPage(qint64 nPage, QByteArray *pbaPage);
+
+    const qint64 N_PAGE_SIZE = 0x10000;
+    const qint64 N_MAX_READ_SIZE = 0x40000;  // larger reads go to the source
+    const qint32 N_MAX_CACHE_SIZE = 0x1000000;
+
+    QHexViewDataSource *g_pSource;
+    QMutex g_mutex;
+    QCache<qint64, QByteArray> g_cache;  // page -> data, shorter at the end of the data
+    quint32 g_nGeneration;               // pages read before a write are not cached
+};
+
+// One stack of sources per device, shared by its views: the same cache, the same unsaved edits.
+// The views with an overlay share one over the source of the others, so writes of any view reach all of them
+class QHexViewDataSourceRegistry {
+public:
+    static QHexViewDataSource *acquire(QIODevice *pDevice, bool bOverlay);
+    static void release(QHexViewDataSource *pDataSource);
+
+private:
+    struct ENTRY {
+        QHexViewDataSource *pSource;  // the cache, the device source for volatile devices
+        QHexViewOverlayDataSource *pOverlay;
+        qint32 nCount;                // views of the device
+        qint32 nOverlayCount;         // of them, views of the overlay
+    };
+
+    static bool _isVolatile(QIODevice *pDevice);
+
+    static QMutex g_mutex;
+    static QMap<QIODevice *, ENTRY> g_mapEntries;
+};
+
+#endif  // QHEXVIEWCACHEDATASOURCE_H
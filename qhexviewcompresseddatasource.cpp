@@ -0,0 +1,512 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "qhexviewcompresseddatasource.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+
+#ifdef QHEXVIEW_ZSTD
+#include <zstd.h>
+#endif
+#ifdef QHEXVIEW_XZ
+#include <lzma.h>
+#endif
+
+QHexViewCompressedDataSource::QHexViewCompressedDataSource(QHexViewDataSource *pSource, QObject *pParent) : QHexViewDataSource(pParent)
+{
+    g_pSource = pSource;
+    g_index = {};
+    g_cacheBlocks.setMaxCost(N_CACHE_SIZE);
+}
+
+void QHexViewCompressedDataSource::setIndex(const INDEX &index)
+{
+    QMutexLocker locker(&g_mutex);
+
+    g_index = index;
+    g_cacheBlocks.clear();
+}
+
+QHexViewCompressedDataSource::INDEX QHexViewCompressedDataSource::getIndex()
+{
+    QMutexLocker locker(&g_mutex);
+
+    return g_index;
+}
+
+QHexViewDataSource *QHexViewCompressedDataSource::getSource()
+{
+    return g_pSource;
+}
+
+qint64 QHexViewCompressedDataSource::getSize()
+{
+    QMutexLocker locker(&g_mutex);
+
+    return g_index.nUncompressedSize;
+}
+
+qint64 QHexViewCompressedDataSource::readAt(qint64 nOffset, char *pBuffer, qint64 nSize)
+{
+    QMutexLocker locker(&g_mutex);
+
+    qint64 nResult = -1;
+
+    if (nOffset >= 0) {
+        nResult = 0;
+
+        while ((nSize > 0) && (nOffset < g_index.nUncompressedSize)) {
+            QVector<POINT>::const_iterator iter = std::upper_bound(g_index.listPoints.constBegin(), g_index.listPoints.constEnd(), nOffset,
+                                                                   [](qint64 nValue, const POINT &point) { return nValue < point.nOutOffset; });
+
+            qint32 nPointIndex = (qint32)(iter - g_index.listPoints.constBegin()) - 1;
+
+            if (nPointIndex < 0) {
+                break;
+            }
+
+            const POINT &point = g_index.listPoints.at(nPointIndex);
+
+            // Blocks are aligned to the seek point, so every block starts from a known decoder state
+            qint64 nBlockOffset = point.nOutOffset + ((nOffset - point.nOutOffset) / N_BLOCK_SIZE) * N_BLOCK_SIZE;
+
+            QByteArray *pBlock = g_cacheBlocks.object(nBlockOffset);
+
+            if (!pBlock) {
+                qint64 nPointEnd = g_index.nUncompressedSize;
+
+                if (nPointIndex + 1 < g_index.listPoints.count()) {
+                    nPointEnd = g_index.listPoints.at(nPointIndex + 1).nOutOffset;
+                }
+
+                qint64 nBlockSize = qMin(N_BLOCK_SIZE, nPointEnd - nBlockOffset);
+
+                QByteArray baBlock = decompress(nPointIndex, nBlockOffset - point.nOutOffset, nBlockSize);
+
+                if (baBlock.size() != nBlockSize) {
+                    break;
+                }
+
+                pBlock = new QByteArray(baBlock);
+                g_cacheBlocks.insert(nBlockOffset, pBlock, (qint32)(nBlockSize / 1024) + 1);
+            }
+
+            qint64 nDelta = nOffset - nBlockOffset;
+            qint64 nCopySize = qMin(nSize, pBlock->size() - nDelta);
+
+            if (nCopySize <= 0) {
+                break;
+            }
+
+            memcpy(pBuffer + nResult, pBlock->constData() + nDelta, (size_t)nCopySize);
+
+            nResult += nCopySize;
+            nOffset += nCopySize;
+            nSize -= nCopySize;
+        }
+    }
+
+    return nResult;
+}
+
+QHexViewCompressedDataSource::CF QHexViewCompressedDataSource::detectFormat(QHexViewDataSource *pSource)
+{
+    CF result = CF_UNKNOWN;
+
+    if (pSource) {
+        QByteArray baHeader = pSource->read(0, 6);
+
+        if (baHeader.startsWith(QByteArray("\x1F\x8B", 2))) {
+            result = CF_GZIP;
+        } else if (baHeader.startsWith(QByteArray("\x28\xB5\x2F\xFD", 4))) {
+            result = CF_ZSTD;
+        } else if (baHeader.startsWith(QByteArray("\xFD\x37\x7A\x58\x5A\x00", 6))) {
+            result = CF_XZ;
+        }
+    }
+
+    return result;
+}
+
+bool QHexViewCompressedDataSource::isFormatSupported(CF format)
+{
+    bool bResult = false;
+
+    if ((format == CF_GZIP) || (format == CF_DEFLATE)) {
+        bResult = true;
+    }
+#ifdef QHEXVIEW_ZSTD
+    else if (format == CF_ZSTD) {
+        bResult = true;
+    }
+#endif
+#ifdef QHEXVIEW_XZ
+    else if (format == CF_XZ) {
+        bResult = true;
+    }
+#endif
+
+    return bResult;
+}
+
+QString QHexViewCompressedDataSource::formatToString(CF format)
+{
+    QString sResult = tr("Unknown");
+
+    switch (format) {
+        case CF_GZIP: sResult = QString("gzip"); break;
+        case CF_ZSTD: sResult = QString("zstd"); break;
+        case CF_XZ: sResult = QString("xz"); break;
+        case CF_DEFLATE: sResult = QString("deflate"); break;
+        default: break;
+    }
+
+    return sResult;
+}
+
+QString QHexViewCompressedDataSource::getIndexFileName(QString sFileName)
+{
+    return sFileName + QString(".qhvidx");
+}
+
+bool QHexViewCompressedDataSource::saveIndex(const INDEX &index, QString sFileName, const QHexViewSession::KEY &key)
+{
+    bool bResult = false;
+
+    // A partly written index does not replace the old one
+    QSaveFile file(sFileName);
+
+    if (file.open(QIODevice::WriteOnly)) {
+        QDataStream stream(&file);
+        stream.setVersion(QDataStream::Qt_5_0);
+
+        stream << (quint32)N_INDEX_MAGIC;
+        stream << (quint32)N_INDEX_VERSION;
+        stream << key.nSize << key.nModified << key.nSampleHash;
+        stream << (quint32)index.format;
+        stream << index.nCompressedSize;
+        stream << index.nUncompressedSize;
+        stream << (qint32)index.listPoints.count();
+
+        for (qint32 i = 0; i < index.listPoints.count(); i++) {
+            const POINT &point = index.listPoints.at(i);
+
+            stream << point.nOutOffset << point.nInOffset << point.nInSize << point.nBits << point.baWindow;
+        }
+
+        if (stream.status() == QDataStream::Ok) {
+            bResult = file.commit();
+        } else {
+            file.cancelWriting();
+        }
+    }
+
+    return bResult;
+}
+
+bool QHexViewCompressedDataSource::loadIndex(INDEX *pIndex, QString sFileName, const QHexViewSession::KEY &key)
+{
+    bool bResult = false;
+
+    QFile file(sFileName);
+
+    if (file.open(QIODevice::ReadOnly)) {
+        QDataStream stream(&file);
+        stream.setVersion(QDataStream::Qt_5_0);
+
+        quint32 nMagic = 0;
+        quint32 nVersion = 0;
+        QHexViewSession::KEY fileKey = {};
+        quint32 nFormat = 0;
+        qint32 nCount = 0;
+
+        stream >> nMagic >> nVersion;
+
+        if ((nMagic == N_INDEX_MAGIC) && (nVersion == N_INDEX_VERSION)) {
+            stream >> fileKey.nSize >> fileKey.nModified >> fileKey.nSampleHash;
+            stream >> nFormat >> pIndex->nCompressedSize >> pIndex->nUncompressedSize >> nCount;
+        }
+
+        bool bKey = (fileKey.nSize == key.nSize) && (fileKey.nModified == key.nModified) && (fileKey.nSampleHash == key.nSampleHash);
+
+        // A damaged count must not reserve more than the file can hold
+        if (bKey && (nCount >= 0) && ((qint64)nCount <= (file.size() - file.pos()) / N_INDEX_POINT_SIZE) && (stream.status() == QDataStream::Ok)) {
+            pIndex->format = (CF)nFormat;
+            pIndex->listPoints.clear();
+            pIndex->listPoints.reserve(nCount);
+
+            for (qint32 i = 0; (i < nCount) && (stream.status() == QDataStream::Ok); i++) {
+                POINT point = {};
+
+                stream >> point.nOutOffset >> point.nInOffset >> point.nInSize >> point.nBits >> point.baWindow;
+
+                pIndex->listPoints.append(point);
+            }
+
+            bResult = (stream.status() == QDataStream::Ok);
+        }
+
+        file.close();
+    }
+
+    return bResult;
+}
+
+QByteArray QHexViewCompressedDataSource::decompress(qint32 nPointIndex, qint64 nSkip, qint64 nSize)
+{
+    QByteArray baResult;
+
+    const POINT &point = g_index.listPoints.at(nPointIndex);
+
+    if ((g_index.format == CF_GZIP) || (g_index.format == CF_DEFLATE)) {
+        baResult = _decompressGzip(point, nSkip, nSize);
+    } else if (g_index.format == CF_ZSTD) {
+        baResult = _decompressZstd(point, nSkip, nSize);
+    } else if (g_index.format == CF_XZ) {
+        baResult = _decompressXz(point, nSkip, nSize);
+    }
+
+    return baResult;
+}
+
+QByteArray QHexViewCompressedDataSource::_decompressGzip(const POINT &point, qint64 nSkip, qint64 nSize)
+{
+    QByteArray baResult;
+
+    z_stream strm = {};
+
+    if (inflateInit2(&strm, -15) == Z_OK) {
+        bool bValid = true;
+        qint64 nInOffset = point.nInOffset;
+
+        if (point.nBits) {
+            quint8 nByte = 0;
+
+            if (g_pSource->readAt(nInOffset - 1, (char *)&nByte, 1) == 1) {
+                inflatePrime(&strm, point.nBits, nByte >> (8 - point.nBits));
+            } else {
+                bValid = false;
+            }
+        }
+
+        if (bValid) {
+            QByteArray baWindow = qUncompress(point.baWindow);
+
+            inflateSetDictionary(&strm, (const Bytef *)baWindow.constData(), (uInt)baWindow.size());
+        }
+
+        QByteArray baInput(N_READ_SIZE, 0);
+        QByteArray baDiscard(N_READ_SIZE, 0);
+
+        baResult.resize((qint32)nSize);
+
+        qint64 nOut = 0;
+        int nRet = Z_OK;
+
+        while (bValid && (nOut < nSkip + nSize) && (nRet != Z_STREAM_END)) {
+            if (strm.avail_in == 0) {
+                qint64 nRead = g_pSource->readAt(nInOffset, baInput.data(), N_READ_SIZE);
+
+                if (nRead <= 0) {
+                    break;
+                }
+
+                nInOffset += nRead;
+                strm.next_in = (Bytef *)baInput.data();
+                strm.avail_in = (uInt)nRead;
+            }
+
+            if (nOut < nSkip) {
+                strm.next_out = (Bytef *)baDiscard.data();
+                strm.avail_out = (uInt)qMin(N_READ_SIZE, nSkip - nOut);
+            } else {
+                strm.next_out = (Bytef *)baResult.data() + (nOut - nSkip);
+                strm.avail_out = (uInt)(nSkip + nSize - nOut);
+            }
+
+            uInt nAvailable = strm.avail_out;
+
+            nRet = inflate(&strm, Z_NO_FLUSH);
+
+            nOut += nAvailable - strm.avail_out;
+
+            if ((nRet == Z_NEED_DICT) || (nRet == Z_DATA_ERROR) || (nRet == Z_MEM_ERROR)) {
+                bValid = false;
+            }
+        }
+
+        inflateEnd(&strm);
+
+        baResult.resize((qint32)qMax(nOut - nSkip, (qint64)0));
+    }
+
+    return baResult;
+}
+
+QByteArray QHexViewCompressedDataSource::_decompressZstd(const POINT &point, qint64 nSkip, qint64 nSize)
+{
+    QByteArray baResult;
+
+#ifdef QHEXVIEW_ZSTD
+    ZSTD_DCtx *pContext = ZSTD_createDCtx();
+
+    if (pContext) {
+        QByteArray baInput(N_READ_SIZE, 0);
+        QByteArray baDiscard(N_READ_SIZE, 0);
+
+        baResult.resize((qint32)nSize);
+
+        qint64 nInOffset = point.nInOffset;
+        qint64 nInEnd = point.nInOffset + point.nInSize;
+        qint64 nOut = 0;
+        size_t nRet = 1;
+
+        ZSTD_inBuffer input = {baInput.data(), 0, 0};
+
+        while ((nOut < nSkip + nSize) && (nRet != 0)) {
+            if (input.pos == input.size) {
+                qint64 nRead = g_pSource->readAt(nInOffset, baInput.data(), qMin(N_READ_SIZE, nInEnd - nInOffset));
+
+                if (nRead <= 0) {
+                    break;
+                }
+
+                nInOffset += nRead;
+                input.size = (size_t)nRead;
+                input.pos = 0;
+            }
+
+            ZSTD_outBuffer output = {};
+
+            if (nOut < nSkip) {
+                output.dst = baDiscard.data();
+                output.size = (size_t)qMin(N_READ_SIZE, nSkip - nOut);
+            } else {
+                output.dst = baResult.data() + (nOut - nSkip);
+                output.size = (size_t)(nSkip + nSize - nOut);
+            }
+
+            nRet = ZSTD_decompressStream(pContext, &output, &input);
+
+            if (ZSTD_isError(nRet)) {
+                break;
+            }
+
+            nOut += output.pos;
+        }
+
+        ZSTD_freeDCtx(pContext);
+
+        baResult.resize((qint32)qMax(nOut - nSkip, (qint64)0));
+    }
+#else
+    Q_UNUSED(point)
+    Q_UNUSED(nSkip)
+    Q_UNUSED(nSize)
+#endif
+
+    return baResult;
+}
+
+QByteArray QHexViewCompressedDataSource::_decompressXz(const POINT &point, qint64 nSkip, qint64 nSize)
+{
+    QByteArray baResult;
+
+#ifdef QHEXVIEW_XZ
+    lzma_filter filters[LZMA_FILTERS_MAX + 1];
+    lzma_block block = {};
+    block.version = 1;
+    block.check = (lzma_check)point.nBits;
+    block.filters = filters;
+
+    quint8 header[LZMA_BLOCK_HEADER_SIZE_MAX];
+
+    bool bHeader = false;
+
+    if (g_pSource->readAt(point.nInOffset, (char *)header, 1) == 1) {
+        block.header_size = lzma_block_header_size_decode(header[0]);
+
+        if ((g_pSource->readAt(point.nInOffset, (char *)header, block.header_size) == block.header_size) &&
+            (lzma_block_header_decode(&block, nullptr, header) == LZMA_OK)) {
+            bHeader = true;
+        }
+    }
+
+    if (bHeader) {
+        lzma_stream strm = LZMA_STREAM_INIT;
+
+        if (lzma_block_decoder(&strm, &block) == LZMA_OK) {
+            QByteArray baInput(N_READ_SIZE, 0);
+            QByteArray baDiscard(N_READ_SIZE, 0);
+
+            baResult.resize((qint32)nSize);
+
+            qint64 nInOffset = point.nInOffset + block.header_size;
+            qint64 nInEnd = point.nInOffset + point.nInSize;
+            qint64 nOut = 0;
+            lzma_ret ret = LZMA_OK;
+
+            while ((nOut < nSkip + nSize) && (ret == LZMA_OK)) {
+                if (strm.avail_in == 0) {
+                    qint64 nRead = g_pSource->readAt(nInOffset, baInput.data(), qMin(N_READ_SIZE, nInEnd - nInOffset));
+
+                    if (nRead <= 0) {
+                        break;
+                    }
+
+                    nInOffset += nRead;
+                    strm.next_in = (const uint8_t *)baInput.constData();
+                    strm.avail_in = (size_t)nRead;
+                }
+
+                if (nOut < nSkip) {
+                    strm.next_out = (uint8_t *)baDiscard.data();
+                    strm.avail_out = (size_t)qMin(N_READ_SIZE, nSkip - nOut);
+                } else {
+                    strm.next_out = (uint8_t *)baResult.data() + (nOut - nSkip);
+                    strm.avail_out = (size_t)(nSkip + nSize - nOut);
+                }
+
+                size_t nAvailable = strm.avail_out;
+
+                ret = lzma_code(&strm, LZMA_RUN);
+
+                nOut += nAvailable - strm.avail_out;
+            }
+
+            lzma_end(&strm);
+
+            baResult.resize((qint32)qMax(nOut - nSkip, (qint64)0));
+        }
+
+        for (qint32 i = 0; filters[i].id != LZMA_VLI_UNKNOWN; i++) {
+            free(filters[i].options);
+        }
+    }
+#else
+    Q_UNUSED(point)
+    Q_UNUSED(nSkip)
+    Q_UNUSED(nSize)
+#endif
+
+    return baResult;
+}
@@ -0,0 +1,100 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef QHEXVIEWCOMPRESSEDDATASOURCE_H
+#define QHEXVIEWCOMPRESSEDDATASOURCE_H
+
+#include <QCache>
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+#include <QVector>
+
+#include "qhexviewdatasource.h"
+#include "qhexviewsession.h"
+
+// Decompressed view of a gzip/zstd/xz stream, blocks are decompressed on demand from the seek points of the index
+class QHexViewCompressedDataSource : public QHexViewDataSource {
+    Q_OBJECT
+
+public:
+    enum CF {
+        CF_UNKNOWN = 0,
+        CF_GZIP,
+        CF_ZSTD,
+        CF_XZ,
+        CF_DEFLATE  // raw, no header
+    };
+
+    struct POINT {
+        qint64 nOutOffset;
+        qint64 nInOffset;
+        qint64 nInSize;       // zstd frame, xz block
+        qint32 nBits;         // gzip/deflate: bits of the byte before nInOffset; xz: check type
+        QByteArray baWindow;  // gzip/deflate: deflated 32 KiB dictionary
+    };
+
+    struct INDEX {
+        CF format;
+        qint64 nCompressedSize;
+        qint64 nUncompressedSize;
+        QVector<POINT> listPoints;
+    };
+
+    explicit QHexViewCompressedDataSource(QHexViewDataSource *pSource, QObject *pParent = nullptr);
+
+    void setIndex(const INDEX &index);
+    INDEX getIndex();
+    QHexViewDataSource *getSource();
+
+    qint64 getSize() override;
+    qint64 readAt(qint64 nOffset, char *pBuffer, qint64 nSize) override;
+
+    static CF detectFormat(QHexViewDataSource *pSource);
+    static bool isFormatSupported(CF format);
+    static QString formatToString(CF format);
+    static QString getIndexFileName(QString sFileName);
+    // The key of the compressed file is stored, an index of another version of the file is not loaded
+    static bool saveIndex(const INDEX &index, QString sFileName, const QHexViewSession::KEY &key);
+    static bool loadIndex(INDEX *pIndex, QString sFileName, const QHexViewSession::KEY &key);
+
+private:
+    QByteArray decompress(qint32 nPointIndex, qint64 nSkip, qint64 nSize);
+    QByteArray _decompressGzip(const POINT &point, qint64 nSkip, qint64 nSize);
+    QByteArray _decompressZstd(const POINT &point, qint64 nSkip, qint64 nSize);
+    QByteArray _decompressXz(const POINT &point, qint64 nSkip, qint64 nSize);
+
+    enum {
+        N_INDEX_MAGIC = 0x51485649,  // QHVI
+        N_INDEX_VERSION = 2,
+        N_INDEX_POINT_SIZE = 32  // the smallest point in the file
+    };
+
+    const qint64 N_BLOCK_SIZE = 0x400000;
+    const qint32 N_CACHE_SIZE = 0x10000;  // KiB
+    const qint64 N_READ_SIZE = 0x10000;
+
+    QHexViewDataSource *g_pSource;
+    INDEX g_index;
+    QMutex g_mutex;
+    QCache<qint64, QByteArray> g_cacheBlocks;
+};
+
+#endif  // QHEXVIEWCOMPRESSEDDATASOURCE_H
@@ -0,0 +1,520 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "qhexviewdatasource.h"
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#ifdef Q_OS_WIN
+#include <io.h>
+#include <windows.h>
+#endif
+
+QHexViewDataSource::QHexViewDataSource(QObject *pParent) : QObject(pParent)
+{
+}
+
+qint64 QHexViewDataSource::writeAt(qint64 nOffset, const char *pBuffer, qint64 nSize)
+{
+    Q_UNUSED(nOffset)
+    Q_UNUSED(pBuffer)
+    Q_UNUSED(nSize)
+
+    return -1;
+}
+
+bool QHexViewDataSource::isWritable()
+{
+    return false;
+}
+
+QIODevice *QHexViewDataSource::getDevice()
+{
+    return nullptr;
+}
+
+bool QHexViewDataSource::isSparse()
+{
+    return false;
+}
+
+qint64 QHexViewDataSource::getNextData(qint64 nOffset)
+{
+    qint64 nResult = -1;
+
+    if (nOffset < getSize()) {
+        nResult = nOffset;
+    }
+
+    return nResult;
+}
+
+qint64 QHexViewDataSource::getNextHole(qint64 nOffset)
+{
+    Q_UNUSED(nOffset)
+
+    return getSize();
+}
+
+int QHexViewDataSource::getHandle()
+{
+    return -1;
+}
+
+void QHexViewDataSource::invalidate(qint64 nOffset, qint64 nSize)
+{
+    Q_UNUSED(nOffset)
+    Q_UNUSED(nSize)
+}
+
+void QHexViewDataSource::reset()
+{
+    emit dataReset();
+}
+
+QByteArray QHexViewDataSource::read(qint64 nOffset, qint64 nSize)
+{
+    QByteArray baResult;
+
+    if ((nOffset >= 0) && (nSize > 0) && (nSize < 0x7FFFF000) && (nOffset + nSize <= getSize())) {
+        baResult.resize((qint32)nSize);
+
+        qint64 _nSize = readAt(nOffset, baResult.data(), nSize);
+
+        if (_nSize != nSize) {
+            baResult.resize((qint32)qMax(_nSize, (qint64)0));
+        }
+    }
+
+    return baResult;
+}
+
+QHexViewDataSource *QHexViewDataSource::create(QIODevice *pDevice, QObject *pParent)
+{
+    QHexViewDataSource *pResult = nullptr;
+
+    QFile *pFile = qobject_cast<QFile *>(pDevice);
+    QBuffer *pBuffer = qobject_cast<QBuffer *>(pDevice);
+
+    if (pFile && (pFile->handle() != -1)) {
+        pResult = new QHexViewFileDataSource(pFile, pParent);
+    } else if (pBuffer) {
+        pResult = new QHexViewBufferDataSource(pBuffer, pParent);
+    } else if (pDevice) {
+        pResult = new QHexViewDeviceDataSource(pDevice, pParent);
+    }
+
+    return pResult;
+}
+
+QHexViewFileDataSource::QHexViewFileDataSource(QFile *pFile, QObject *pParent) : QHexViewDataSource(pParent)
+{
+    g_pFile = pFile;
+    g_nHandle = pFile->handle();
+    g_nExtentHandle = -1;
+    g_pPositionalHandle = nullptr;
+    g_nIsSparse = 0;
+
+    // Pending buffered writes must reach the file before positional reads
+    g_pFile->flush();
+
+#ifdef Q_OS_WIN
+    // Synchronous ReadFile/WriteFile with OVERLAPPED still move the file pointer that QFile uses
+    DWORD nAccess = GENERIC_READ | (pFile->isWritable() ? GENERIC_WRITE : 0);
+    HANDLE hFile = ReOpenFile((HANDLE)_get_osfhandle(g_nHandle), nAccess, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, 0);
+
+    if (hFile != INVALID_HANDLE_VALUE) {
+        g_pPositionalHandle = hFile;
+    }
+#endif
+
+    _checkSparse();
+}
+
+QHexViewFileDataSource::~QHexViewFileDataSource()
+{
+#ifdef Q_OS_UNIX
+    if (g_nExtentHandle != -1) {
+        ::close(g_nExtentHandle);
+    }
+#endif
+#ifdef Q_OS_WIN
+    if (g_pPositionalHandle) {
+        CloseHandle((HANDLE)g_pPositionalHandle);
+    }
+#endif
+}
+
+qint64 QHexViewFileDataSource::getSize()
+{
+    return g_pFile->size();
+}
+
+qint64 QHexViewFileDataSource::readAt(qint64 nOffset, char *pBuffer, qint64 nSize)
+{
+    qint64 nResult = -1;
+
+    if (g_nIsSparse.loadAcquire() && (nSize >= N_SPARSE_READ_SIZE)) {
+        // Holes are filled here, only the data extents are read
+        qint64 nEnd = qMin(nOffset + nSize, getSize());
+
+        nResult = 0;
+
+        while (nOffset + nResult < nEnd) {
+            qint64 nCurrent = nOffset + nResult;
+            qint64 nDataOffset = getNextData(nCurrent);
+
+            if ((nDataOffset == -1) || (nDataOffset > nEnd)) {
+                nDataOffset = nEnd;
+            }
+
+            if (nDataOffset > nCurrent) {
+                memset(pBuffer + nResult, 0, (size_t)(nDataOffset - nCurrent));
+                nResult += nDataOffset - nCurrent;
+            } else {
+                qint64 nHoleOffset = qMin(getNextHole(nCurrent), nEnd);
+                qint64 nRead = _pread(nCurrent, pBuffer + nResult, nHoleOffset - nCurrent);
+
+                if (nRead <= 0) {
+                    break;
+                }
+
+                nResult += nRead;
+            }
+        }
+    } else {
+        nResult = _pread(nOffset, pBuffer, nSize);
+    }
+
+    return nResult;
+}
+
+bool QHexViewFileDataSource::isSparse()
+{
+    return g_nIsSparse.loadAcquire() != 0;
+}
+
+qint64 QHexViewFileDataSource::getNextData(qint64 nOffset)
+{
+    qint64 nResult = QHexViewDataSource::getNextData(nOffset);
+
+#if defined(Q_OS_UNIX) && defined(SEEK_DATA)
+    if (g_nIsSparse.loadAcquire() && (nResult != -1)) {
+        // ENXIO: only a hole up to the end of the file
+        nResult = (qint64)::lseek(g_nExtentHandle, (off_t)nOffset, SEEK_DATA);
+    }
+#endif
+
+    return nResult;
+}
+
+qint64 QHexViewFileDataSource::getNextHole(qint64 nOffset)
+{
+    qint64 nResult = QHexViewDataSource::getNextHole(nOffset);
+
+#if defined(Q_OS_UNIX) && defined(SEEK_DATA)
+    if (g_nIsSparse.loadAcquire()) {
+        qint64 nHoleOffset = (qint64)::lseek(g_nExtentHandle, (off_t)nOffset, SEEK_HOLE);
+
+        if (nHoleOffset != -1) {
+            nResult = qMin(nHoleOffset, nResult);
+        }
+    }
+#endif
+
+    return nResult;
+}
+
+int QHexViewFileDataSource::getHandle()
+{
+    return g_nHandle;
+}
+
+void QHexViewFileDataSource::invalidate(qint64 nOffset, qint64 nSize)
+{
+    Q_UNUSED(nOffset)
+    Q_UNUSED(nSize)
+
+    _checkSparse();
+}
+
+void QHexViewFileDataSource::_checkSparse()
+{
+#if defined(Q_OS_UNIX) && defined(SEEK_DATA)
+    struct stat st = {};
+
+    bool bIsSparse = (fstat(g_nHandle, &st) == 0) && ((qint64)st.st_blocks * 512 < (qint64)st.st_size);
+
+    // invalidate() may be called from any thread
+    QMutexLocker locker(&g_mutexExtent);
+
+    if (bIsSparse && (g_nExtentHandle == -1)) {
+        // lseek would move the offset of the QFile handle, a dup() shares it. The path may name another file
+        // after a rename, only a handle of the same inode is used
+        QList<QByteArray> listPaths;
+        listPaths.append(QByteArray("/proc/self/fd/") + QByteArray::number(g_nHandle));
+
+        if (g_pFile->fileName() != "") {
+            listPaths.append(QFile::encodeName(g_pFile->fileName()));
+        }
+
+        for (qint32 i = 0; (i < listPaths.count()) && (g_nExtentHandle == -1); i++) {
+            int nHandle = ::open(listPaths.at(i).constData(), O_RDONLY);
+
+            if (nHandle != -1) {
+                struct stat stExtent = {};
+
+                if ((fstat(nHandle, &stExtent) == 0) && (stExtent.st_dev == st.st_dev) && (stExtent.st_ino == st.st_ino)) {
+                    g_nExtentHandle = nHandle;
+                } else {
+                    ::close(nHandle);
+                }
+            }
+        }
+    }
+
+    g_nIsSparse.storeRelease(bIsSparse && (g_nExtentHandle != -1));
+#endif
+}
+
+qint64 QHexViewFileDataSource::_pread(qint64 nOffset, char *pBuffer, qint64 nSize)
+{
+    qint64 nResult = -1;
+
+#if defined(Q_OS_UNIX)
+    nResult = ::pread(g_nHandle, pBuffer, (size_t)nSize, (off_t)nOffset);
+#elif defined(Q_OS_WIN)
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = (DWORD)(nOffset & 0xFFFFFFFF);
+    overlapped.OffsetHigh = (DWORD)(nOffset >> 32);
+
+    DWORD nRead = 0;
+    HANDLE hFile = (HANDLE)g_pPositionalHandle;
+    LARGE_INTEGER nPosition = {};
+    bool bRestore = false;
+
+    if (!hFile) {
+        // Shared handle: the position of the QFile is put back
+        hFile = (HANDLE)_get_osfhandle(g_nHandle);
+        bRestore = (SetFilePointerEx(hFile, LARGE_INTEGER(), &nPosition, FILE_CURRENT) != FALSE);
+    }
+
+    if (ReadFile(hFile, pBuffer, (DWORD)nSize, &nRead, &overlapped)) {
+        nResult = nRead;
+    } else if (GetLastError() == ERROR_HANDLE_EOF) {
+        nResult = 0;
+    }
+
+    if (bRestore) {
+        SetFilePointerEx(hFile, nPosition, nullptr, FILE_BEGIN);
+    }
+#endif
+
+    return nResult;
+}
+
+qint64 QHexViewFileDataSource::writeAt(qint64 nOffset, const char *pBuffer, qint64 nSize)
+{
+    qint64 nResult = -1;
+
+#if defined(Q_OS_UNIX)
+    nResult = ::pwrite(g_nHandle, pBuffer, (size_t)nSize, (off_t)nOffset);
+#elif defined(Q_OS_WIN)
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = (DWORD)(nOffset & 0xFFFFFFFF);
+    overlapped.OffsetHigh = (DWORD)(nOffset >> 32);
+
+    DWORD nWritten = 0;
+    HANDLE hFile = (HANDLE)g_pPositionalHandle;
+    LARGE_INTEGER nPosition = {};
+    bool bRestore = false;
+
+    if (!hFile) {
+        hFile = (HANDLE)_get_osfhandle(g_nHandle);
+        bRestore = (SetFilePointerEx(hFile, LARGE_INTEGER(), &nPosition, FILE_CURRENT) != FALSE);
+    }
+
+    if (WriteFile(hFile, pBuffer, (DWORD)nSize, &nWritten, &overlapped)) {
+        nResult = nWritten;
+    }
+
+    if (bRestore) {
+        SetFilePointerEx(hFile, nPosition, nullptr, FILE_BEGIN);
+    }
+#endif
+
+    return nResult;
+}
+
+bool QHexViewFileDataSource::isWritable()
+{
+    return g_pFile->isWritable();
+}
+
+QIODevice *QHexViewFileDataSource::getDevice()
+{
+    return g_pFile;
+}
+
+QHexViewBufferDataSource::QHexViewBufferDataSource(QBuffer *pBuffer, QObject *pParent) : QHexViewDataSource(pParent)
+{
+    g_pBuffer = pBuffer;
+}
+
+qint64 QHexViewBufferDataSource::getSize()
+{
+    QReadLocker locker(&g_lock);
+
+    return g_pBuffer->data().size();
+}
+
+qint64 QHexViewBufferDataSource::readAt(qint64 nOffset, char *pBuffer, qint64 nSize)
+{
+    QReadLocker locker(&g_lock);
+
+    qint64 nResult = -1;
+
+    const QByteArray &baData = g_pBuffer->data();
+
+    if ((nOffset >= 0) && (nOffset <= baData.size())) {
+        nResult = qMin(nSize, baData.size() - nOffset);
+
+        memcpy(pBuffer, baData.constData() + nOffset, (size_t)nResult);
+    }
+
+    return nResult;
+}
+
+qint64 QHexViewBufferDataSource::writeAt(qint64 nOffset, const char *pBuffer, qint64 nSize)
+{
+    QWriteLocker locker(&g_lock);
+
+    qint64 nResult = -1;
+
+    QByteArray &baData = g_pBuffer->buffer();
+
+    if (g_pBuffer->isWritable() && (nOffset >= 0) && (nOffset <= baData.size())) {
+        nResult = qMin(nSize, baData.size() - nOffset);
+
+        memcpy(baData.data() + nOffset, pBuffer, (size_t)nResult);
+    }
+
+    return nResult;
+}
+
+bool QHexViewBufferDataSource::isWritable()
+{
+    return g_pBuffer->isWritable();
+}
+
+QIODevice *QHexViewBufferDataSource::getDevice()
+{
+    return g_pBuffer;
+}
+
+QHexViewDeviceDataSource::QHexViewDeviceDataSource(QIODevice *pDevice, QObject *pParent) : QHexViewDataSource(pParent)
+{
+    g_pDevice = pDevice;
+}
+
+qint64 QHexViewDeviceDataSource::getSize()
+{
+    QMutexLocker locker(&g_mutex);
+
+    return g_pDevice->size();
+}
+
+qint64 QHexViewDeviceDataSource::readAt(qint64 nOffset, char *pBuffer, qint64 nSize)
+{
+    QMutexLocker locker(&g_mutex);
+
+    qint64 nResult = -1;
+
+    if (g_pDevice->seek(nOffset)) {
+        nResult = g_pDevice->read(pBuffer, nSize);
+    }
+
+    return nResult;
+}
+
+qint64 QHexViewDeviceDataSource::writeAt(qint64 nOffset, const char *pBuffer, qint64 nSize)
+{
+    QMutexLocker locker(&g_mutex);
+
+    qint64 nResult = -1;
+
+    if (g_pDevice->seek(nOffset)) {
+        nResult = g_pDevice->write(pBuffer, nSize);
+    }
+
+    return nResult;
+}
+
+bool QHexViewDeviceDataSource::isWritable()
+{
+    return g_pDevice->isWritable();
+}
+
+QIODevice *QHexViewDeviceDataSource::getDevice()
+{
+    return g_pDevice;
+}
+
+QHexViewDataSourceDevice::QHexViewDataSourceDevice(QHexViewDataSource *pDataSource, QObject *pParent) : QIODevice(pParent)
+{
+    g_pDataSource = pDataSource;
+
+    OpenMode mode = QIODevice::ReadOnly;
+
+    if (pDataSource->isWritable()) {
+        mode = QIODevice::ReadWrite;
+    }
+
+    open(mode | QIODevice::Unbuffered);
+}
+
+bool QHexViewDataSourceDevice::isSequential() const
+{
+    return false;
+}
+
+qint64 QHexViewDataSourceDevice::size() const
+{
+    return g_pDataSource->getSize();
+}
+
+qint64 QHexViewDataSourceDevice::readData(char *pData, qint64 nMaxSize)
+{
+    qint64 nResult = g_pDataSource->readAt(pos(), pData, nMaxSize);
+
+    if ((nResult == 0) && (pos() < size())) {
+        nResult = -1;
+    }
+
+    return nResult;
+}
+
+qint64 QHexViewDataSourceDevice::writeData(const char *pData, qint64 nMaxSize)
+{
+    return g_pDataSource->writeAt(pos(), pData, nMaxSize);
+}
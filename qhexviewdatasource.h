@@ -0,0 +1,148 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef QHEXVIEWDATASOURCE_H
+#define QHEXVIEWDATASOURCE_H
+
+#include <QAtomicInt>
+#include <QBuffer>
+#include <QFile>
+#include <QIODevice>
+#include <QMutex>
+#include <QObject>
+#include <QReadWriteLock>
+
+// Random access to the data, readAt/writeAt do not share a position and may be called from any thread
+class QHexViewDataSource : public QObject {
+    Q_OBJECT
+
+public:
+    explicit QHexViewDataSource(QObject *pParent = nullptr);
+
+    virtual qint64 getSize() = 0;
+    virtual qint64 readAt(qint64 nOffset, char *pBuffer, qint64 nSize) = 0;
+    virtual qint64 writeAt(qint64 nOffset, const char *pBuffer, qint64 nSize);
+    virtual bool isWritable();
+    virtual QIODevice *getDevice();
+    // Extent map of sparse files, holes read as zeros
+    virtual bool isSparse();
+    virtual qint64 getNextData(qint64 nOffset);  // -1 if there is no data after nOffset
+    virtual qint64 getNextHole(qint64 nOffset);
+    // File descriptor for in-kernel copies, -1 if the data is not a local file
+    virtual int getHandle();
+    // The data was changed from outside, cached copies are dropped. nSize -1: to the end
+    virtual void invalidate(qint64 nOffset, qint64 nSize);
+    // The data was replaced as a whole (saved, discarded or resized), all views are told with dataReset()
+    void reset();
+
+    QByteArray read(qint64 nOffset, qint64 nSize);  // empty for 2 GB and more, a QByteArray cannot hold it
+
+    static QHexViewDataSource *create(QIODevice *pDevice, QObject *pParent = nullptr);
+
+signals:
+    void dataChanged(qint64 nOffset, qint64 nSize);  // written, by any view of the data; may be emitted from a worker thread
+    void dataReset();  // the undo records of the views do not match the data anymore; may be emitted from a worker thread
+};
+
+class QHexViewFileDataSource : public QHexViewDataSource {
+    Q_OBJECT
+
+public:
+    explicit QHexViewFileDataSource(QFile *pFile, QObject *pParent = nullptr);
+    ~QHexViewFileDataSource();
+
+    qint64 getSize() override;
+    qint64 readAt(qint64 nOffset, char *pBuffer, qint64 nSize) override;
+    qint64 writeAt(qint64 nOffset, const char *pBuffer, qint64 nSize) override;
+    bool isWritable() override;
+    QIODevice *getDevice() override;
+    bool isSparse() override;
+    qint64 getNextData(qint64 nOffset) override;
+    qint64 getNextHole(qint64 nOffset) override;
+    int getHandle() override;
+    void invalidate(qint64 nOffset, qint64 nSize) override;  // holes can be punched or filled from outside
+
+private:
+    qint64 _pread(qint64 nOffset, char *pBuffer, qint64 nSize);
+    void _checkSparse();
+
+    const qint64 N_SPARSE_READ_SIZE = 0x10000;  // smaller reads do not query the extents
+
+    QFile *g_pFile;
+    int g_nHandle;
+    int g_nExtentHandle;  // own file offset for SEEK_DATA/SEEK_HOLE, opened once
+    QMutex g_mutexExtent;
+    void *g_pPositionalHandle;  // Windows: own file pointer for the OVERLAPPED reads and writes, nullptr if it cannot be opened
+    QAtomicInt g_nIsSparse;  // checked again on invalidate(), read by workers
+};
+
+class QHexViewBufferDataSource : public QHexViewDataSource {
+    Q_OBJECT
+
+public:
+    explicit QHexViewBufferDataSource(QBuffer *pBuffer, QObject *pParent = nullptr);
+
+    qint64 getSize() override;
+    qint64 readAt(qint64 nOffset, char *pBuffer, qint64 nSize) override;
+    qint64 writeAt(qint64 nOffset, const char *pBuffer, qint64 nSize) override;
+    bool isWritable() override;
+    QIODevice *getDevice() override;
+
+private:
+    QBuffer *g_pBuffer;
+    QReadWriteLock g_lock;
+};
+
+class QHexViewDeviceDataSource : public QHexViewDataSource {
+    Q_OBJECT
+
+public:
+    explicit QHexViewDeviceDataSource(QIODevice *pDevice, QObject *pParent = nullptr);
+
+    qint64 getSize() override;
+    qint64 readAt(qint64 nOffset, char *pBuffer, qint64 nSize) override;
+    qint64 writeAt(qint64 nOffset, const char *pBuffer, qint64 nSize) override;
+    bool isWritable() override;
+    QIODevice *getDevice() override;
+
+private:
+    QIODevice *g_pDevice;
+    QMutex g_mutex;
+};
+
+// A QIODevice with its own position on top of a data source, for code that needs a device
+class QHexViewDataSourceDevice : public QIODevice {
+    Q_OBJECT
+
+public:
+    explicit QHexViewDataSourceDevice(QHexViewDataSource *pDataSource, QObject *pParent = nullptr);
+
+    bool isSequential() const override;
+    qint64 size() const override;
+
+protected:
+    qint64 readData(char *pData, qint64 nMaxSize) override;
+    qint64 writeData(const char *pData, qint64 nMaxSize) override;
+
+private:
+    QHexViewDataSource *g_pDataSource;
+};
+
+#endif  // QHEXVIEWDATASOURCE_H
@@ -0,0 +1,485 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "qhexviewencoding.h"
+
+#ifdef Q_PROCESSOR_X86_64
+#include <emmintrin.h>
+#endif
+
+// Upper halves of the single-byte code pages, 0x2E where the code page has no character
+static const quint16 _cp1251[128] = {
+    0x0402, 0x0403, 0x201A, 0x0453, 0x201E, 0x2026, 0x2020, 0x2021, 0x20AC, 0x2030, 0x0409, 0x2039, 0x040A, 0x040C, 0x040B, 0x040F,
+    0x0452, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014, 0x002E, 0x2122, 0x0459, 0x203A, 0x045A, 0x045C, 0x045B, 0x045F,
+    0x00A0, 0x040E, 0x045E, 0x0408, 0x00A4, 0x0490, 0x00A6, 0x00A7, 0x0401, 0x00A9, 0x0404, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x0407,
+    0x00B0, 0x00B1, 0x0406, 0x0456, 0x0491, 0x00B5, 0x00B6, 0x00B7, 0x0451, 0x2116, 0x0454, 0x00BB, 0x0458, 0x0405, 0x0455, 0x0457,
+    0x0410, 0x0411, 0x0412, 0x0413, 0x0414, 0x0415, 0x0416, 0x0417, 0x0418, 0x0419, 0x041A, 0x041B, 0x041C, 0x041D, 0x041E, 0x041F,
+    0x0420, 0x0421, 0x0422, 0x0423, 0x0424, 0x0425, 0x0426, 0x0427, 0x0428, 0x0429, 0x042A, 0x042B, 0x042C, 0x042D, 0x042E, 0x042F,
+    0x0430, 0x0431, 0x0432, 0x0433, 0x0434, 0x0435, 0x0436, 0x0437, 0x0438, 0x0439, 0x043A, 0x043B, 0x043C, 0x043D, 0x043E, 0x043F,
+    0x0440, 0x0441, 0x0442, 0x0443, 0x0444, 0x0445, 0x0446, 0x0447, 0x0448, 0x0449, 0x044A, 0x044B, 0x044C, 0x044D, 0x044E, 0x044F};
+
+static const quint16 _cp866[128] = {
+    0x0410, 0x0411, 0x0412, 0x0413, 0x0414, 0x0415, 0x0416, 0x0417, 0x0418, 0x0419, 0x041A, 0x041B, 0x041C, 0x041D, 0x041E, 0x041F,
+    0x0420, 0x0421, 0x0422, 0x0423, 0x0424, 0x0425, 0x0426, 0x0427, 0x0428, 0x0429, 0x042A, 0x042B, 0x042C, 0x042D, 0x042E, 0x042F,
+    0x0430, 0x0431, 0x0432, 0x0433, 0x0434, 0x0435, 0x0436, 0x0437, 0x0438, 0x0439, 0x043A, 0x043B, 0x043C, 0x043D, 0x043E, 0x043F,
+    0x2591, 0x2592, 0x2593, 0x2502, 0x2524, 0x2561, 0x2562, 0x2556, 0x2555, 0x2563, 0x2551, 0x2557, 0x255D, 0x255C, 0x255B, 0x2510,
+    0x2514, 0x2534, 0x252C, 0x251C, 0x2500, 0x253C, 0x255E, 0x255F, 0x255A, 0x2554, 0x2569, 0x2566, 0x2560, 0x2550, 0x256C, 0x2567,
+    0x2568, 0x2564, 0x2565, 0x2559, 0x2558, 0x2552, 0x2553, 0x256B, 0x256A, 0x2518, 0x250C, 0x2588, 0x2584, 0x258C, 0x2590, 0x2580,
+    0x0440, 0x0441, 0x0442, 0x0443, 0x0444, 0x0445, 0x0446, 0x0447, 0x0448, 0x0449, 0x044A, 0x044B, 0x044C, 0x044D, 0x044E, 0x044F,
+    0x0401, 0x0451, 0x0404, 0x0454, 0x0407, 0x0457, 0x040E, 0x045E, 0x00B0, 0x2219, 0x00B7, 0x221A, 0x2116, 0x00A4, 0x25A0, 0x00A0};
+
+static const quint16 _ebcdic[256] = {
+    0x0000, 0x0001, 0x0002, 0x0003, 0x009C, 0x0009, 0x0086, 0x007F, 0x0097, 0x008D, 0x008E, 0x000B, 0x000C, 0x000D, 0x000E, 0x000F,
+    0x0010, 0x0011, 0x0012, 0x0013, 0x009D, 0x0085, 0x0008, 0x0087, 0x0018, 0x0019, 0x0092, 0x008F, 0x001C, 0x001D, 0x001E, 0x001F,
+    0x0080, 0x0081, 0x0082, 0x0083, 0x0084, 0x000A, 0x0017, 0x001B, 0x0088, 0x0089, 0x008A, 0x008B, 0x008C, 0x0005, 0x0006, 0x0007,
+    0x0090, 0x0091, 0x0016, 0x0093, 0x0094, 0x0095, 0x0096, 0x0004, 0x0098, 0x0099, 0x009A, 0x009B, 0x0014, 0x0015, 0x009E, 0x001A,
+    0x0020, 0x00A0, 0x00E2, 0x00E4, 0x00E0, 0x00E1, 0x00E3, 0x00E5, 0x00E7, 0x00F1, 0x00A2, 0x002E, 0x003C, 0x0028, 0x002B, 0x007C,
+    0x0026, 0x00E9, 0x00EA, 0x00EB, 0x00E8, 0x00ED, 0x00EE, 0x00EF, 0x00EC, 0x00DF, 0x0021, 0x0024, 0x002A, 0x0029, 0x003B, 0x00AC,
+    0x002D, 0x002F, 0x00C2, 0x00C4, 0x00C0, 0x00C1, 0x00C3, 0x00C5, 0x00C7, 0x00D1, 0x00A6, 0x002C, 0x0025, 0x005F, 0x003E, 0x003F,
+    0x00F8, 0x00C9, 0x00CA, 0x00CB, 0x00C8, 0x00CD, 0x00CE, 0x00CF, 0x00CC, 0x0060, 0x003A, 0x0023, 0x0040, 0x0027, 0x003D, 0x0022,
+    0x00D8, 0x0061, 0x0062, 0x0063, 0x0064, 0x0065, 0x0066, 0x0067, 0x0068, 0x0069, 0x00AB, 0x00BB, 0x00F0, 0x00FD, 0x00FE, 0x00B1,
+    0x00B0, 0x006A, 0x006B, 0x006C, 0x006D, 0x006E, 0x006F, 0x0070, 0x0071, 0x0072, 0x00AA, 0x00BA, 0x00E6, 0x00B8, 0x00C6, 0x00A4,
+    0x00B5, 0x007E, 0x0073, 0x0074, 0x0075, 0x0076, 0x0077, 0x0078, 0x0079, 0x007A, 0x00A1, 0x00BF, 0x00D0, 0x00DD, 0x00DE, 0x00AE,
+    0x005E, 0x00A3, 0x00A5, 0x00B7, 0x00A9, 0x00A7, 0x00B6, 0x00BC, 0x00BD, 0x00BE, 0x005B, 0x005D, 0x00AF, 0x00A8, 0x00B4, 0x00D7,
+    0x007B, 0x0041, 0x0042, 0x0043, 0x0044, 0x0045, 0x0046, 0x0047, 0x0048, 0x0049, 0x00AD, 0x00F4, 0x00F6, 0x00F2, 0x00F3, 0x00F5,
+    0x007D, 0x004A, 0x004B, 0x004C, 0x004D, 0x004E, 0x004F, 0x0050, 0x0051, 0x0052, 0x00B9, 0x00FB, 0x00FC, 0x00F9, 0x00FA, 0x00FF,
+    0x005C, 0x00F7, 0x0053, 0x0054, 0x0055, 0x0056, 0x0057, 0x0058, 0x0059, 0x005A, 0x00B2, 0x00D4, 0x00D6, 0x00D2, 0x00D3, 0x00D5,
+    0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036, 0x0037, 0x0038, 0x0039, 0x00B3, 0x00DB, 0x00DC, 0x00D9, 0x00DA, 0x009F};
+
+QList<QHexViewEncoding::ENC> QHexViewEncoding::getEncodings()
+{
+    QList<ENC> listResult;
+
+    listResult.append(ENC_ASCII);
+    listResult.append(ENC_LATIN1);
+    listResult.append(ENC_CP1251);
+    listResult.append(ENC_CP866);
+    listResult.append(ENC_EBCDIC);
+    listResult.append(ENC_UTF8);
+    listResult.append(ENC_UTF16LE);
+    listResult.append(ENC_UTF16BE);
+
+    return listResult;
+}
+
+QString QHexViewEncoding::encodingToString(ENC encoding)
+{
+    QString sResult;
+
+    switch (encoding) {
+        case ENC_ASCII: sResult = QString("ASCII"); break;
+        case ENC_LATIN1: sResult = QString("Latin-1"); break;
+        case ENC_CP1251: sResult = QString("CP1251"); break;
+        case ENC_CP866: sResult = QString("CP866"); break;
+        case ENC_EBCDIC: sResult = QString("EBCDIC (CP037)"); break;
+        case ENC_UTF8: sResult = QString("UTF-8"); break;
+        case ENC_UTF16LE: sResult = QString("UTF-16LE"); break;
+        case ENC_UTF16BE: sResult = QString("UTF-16BE"); break;
+    }
+
+    return sResult;
+}
+
+bool QHexViewEncoding::isMultiByte(ENC encoding)
+{
+    return (encoding == ENC_UTF8) || (encoding == ENC_UTF16LE) || (encoding == ENC_UTF16BE);
+}
+
+void QHexViewEncoding::decode(ENC encoding, const char *pData, qint32 nDataSize, qint32 nLeadIn, qint32 nCount, qint64 nOffset, QVector<quint32> *pListGlyphs)
+{
+    pListGlyphs->resize(nCount);
+
+    if (nCount > 0) {
+        const quint8 *pBytes = (const quint8 *)pData;
+        quint32 *pGlyphs = pListGlyphs->data();
+
+        if (!isMultiByte(encoding)) {
+            _decodeTable(_getTable(encoding), pBytes + nLeadIn, nCount, pGlyphs);
+        } else {
+            QVector<quint32> listCells(nDataSize);
+
+            if (encoding == ENC_UTF8) {
+                _decodeUtf8(pBytes, nDataSize, listCells.data());
+            } else {
+                // Code units start at even offsets
+                qint32 nStart = (qint32)((nOffset - nLeadIn) & 1);
+
+                _decodeUtf16(pBytes, nDataSize, nStart, (encoding == ENC_UTF16BE), listCells.data());
+            }
+
+            for (qint32 i = 0; i < nCount; i++) {
+                quint32 nGlyph = listCells.at(nLeadIn + i);
+
+                if (nGlyph & N_CONTINUATION) {
+                    if (i == 0) {
+                        // The sequence starts above the window, show it in the first cell
+                        nGlyph &= ~N_CONTINUATION;
+                    } else {
+                        nGlyph = ' ';
+                    }
+                }
+
+                pGlyphs[i] = nGlyph;
+            }
+        }
+    }
+}
+
+QString QHexViewEncoding::glyphToString(quint32 nGlyph)
+{
+    QString sResult;
+
+    if (QChar::requiresSurrogates(nGlyph)) {
+        sResult.append(QChar(QChar::highSurrogate(nGlyph)));
+        sResult.append(QChar(QChar::lowSurrogate(nGlyph)));
+    } else {
+        sResult = QChar((ushort)nGlyph);
+    }
+
+    return sResult;
+}
+
+bool QHexViewEncoding::encodeChar(ENC encoding, QChar cChar, QByteArray *pbaResult)
+{
+    bool bResult = false;
+
+    ushort nCodePoint = cChar.unicode();
+
+    pbaResult->clear();
+
+    if (!isMultiByte(encoding)) {
+        const quint32 *pTable = _getTable(encoding);
+
+        // '.' also stands for non-printable bytes, the real one is the only byte mapped to itself in the printable range
+        for (qint32 i = 0; i < 256; i++) {
+            if ((pTable[i] == nCodePoint) && ((nCodePoint != '.') || (i == ((encoding == ENC_EBCDIC) ? 0x4B : 0x2E)))) {
+                pbaResult->append((char)i);
+                bResult = true;
+                break;
+            }
+        }
+    } else if (!cChar.isSurrogate()) {
+        // A half of a surrogate pair has no byte sequence of its own
+        bResult = encodeString(encoding, QString(cChar), pbaResult);
+    }
+
+    return bResult;
+}
+
+bool QHexViewEncoding::encodeString(ENC encoding, const QString &sText, QByteArray *pbaResult)
+{
+    bool bResult = true;
+
+    if (encoding == ENC_UTF8) {
+        *pbaResult = sText.toUtf8();
+    } else if ((encoding == ENC_UTF16LE) || (encoding == ENC_UTF16BE)) {
+        qint32 nSize = sText.size();
+        const ushort *pText = sText.utf16();
+
+        pbaResult->resize(nSize * 2);
+        char *pResult = pbaResult->data();
+
+        for (qint32 i = 0; i < nSize; i++) {
+            quint8 nLow = (quint8)pText[i];
+            quint8 nHigh = (quint8)(pText[i] >> 8);
+
+            pResult[i * 2] = (char)((encoding == ENC_UTF16LE) ? nLow : nHigh);
+            pResult[i * 2 + 1] = (char)((encoding == ENC_UTF16LE) ? nHigh : nLow);
+        }
+    } else {
+        // Reverse table, control characters are not in the tables but are kept as they are
+        const quint32 *pTable = _getTable(encoding);
+        QVector<qint16> listBytes(0x10000, -1);
+
+        for (qint32 i = 255; i >= 0; i--) {
+            if ((pTable[i] != '.') || (i == ((encoding == ENC_EBCDIC) ? 0x4B : 0x2E))) {
+                listBytes[pTable[i] & 0xFFFF] = (qint16)i;
+            }
+        }
+
+        if (encoding != ENC_EBCDIC) {
+            for (qint32 i = 0; i < 0x20; i++) {
+                listBytes[i] = (qint16)i;
+            }
+        }
+
+        qint32 nSize = sText.size();
+        const ushort *pText = sText.utf16();
+
+        pbaResult->resize(nSize);
+        char *pResult = pbaResult->data();
+
+        for (qint32 i = 0; i < nSize; i++) {
+            qint16 nByte = listBytes.at(pText[i]);
+
+            if (nByte == -1) {
+                bResult = false;
+                break;
+            }
+
+            pResult[i] = (char)nByte;
+        }
+    }
+
+    if (!bResult) {
+        pbaResult->clear();
+    }
+
+    return bResult;
+}
+
+const quint32 *QHexViewEncoding::_getTable(ENC encoding)
+{
+    static const QVector<quint32> listAscii = []() {
+        QVector<quint32> listResult(256);
+
+        for (qint32 i = 0; i < 256; i++) {
+            listResult[i] = ((i >= 0x20) && (i < 0x7F)) ? i : '.';
+        }
+
+        return listResult;
+    }();
+
+    static const QVector<quint32> listLatin1 = []() {
+        QVector<quint32> listResult(256);
+
+        for (qint32 i = 0; i < 256; i++) {
+            listResult[i] = _toGlyph(i);
+        }
+
+        return listResult;
+    }();
+
+    static const QVector<quint32> listCP1251 = []() {
+        QVector<quint32> listResult(listAscii);
+
+        for (qint32 i = 0; i < 128; i++) {
+            listResult[0x80 + i] = _toGlyph(_cp1251[i]);
+        }
+
+        return listResult;
+    }();
+
+    static const QVector<quint32> listCP866 = []() {
+        QVector<quint32> listResult(listAscii);
+
+        for (qint32 i = 0; i < 128; i++) {
+            listResult[0x80 + i] = _toGlyph(_cp866[i]);
+        }
+
+        return listResult;
+    }();
+
+    static const QVector<quint32> listEBCDIC = []() {
+        QVector<quint32> listResult(256);
+
+        for (qint32 i = 0; i < 256; i++) {
+            listResult[i] = _toGlyph(_ebcdic[i]);
+        }
+
+        return listResult;
+    }();
+
+    const quint32 *pResult = listAscii.constData();
+
+    if (encoding == ENC_LATIN1) {
+        pResult = listLatin1.constData();
+    } else if (encoding == ENC_CP1251) {
+        pResult = listCP1251.constData();
+    } else if (encoding == ENC_CP866) {
+        pResult = listCP866.constData();
+    } else if (encoding == ENC_EBCDIC) {
+        pResult = listEBCDIC.constData();
+    }
+
+    return pResult;
+}
+
+void QHexViewEncoding::_decodeTable(const quint32 *pTable, const quint8 *pData, qint32 nSize, quint32 *pGlyphs)
+{
+    qint32 i = 0;
+
+    for (; i + 4 <= nSize; i += 4) {
+        pGlyphs[i] = pTable[pData[i]];
+        pGlyphs[i + 1] = pTable[pData[i + 1]];
+        pGlyphs[i + 2] = pTable[pData[i + 2]];
+        pGlyphs[i + 3] = pTable[pData[i + 3]];
+    }
+
+    for (; i < nSize; i++) {
+        pGlyphs[i] = pTable[pData[i]];
+    }
+}
+
+void QHexViewEncoding::_decodeUtf8(const quint8 *pData, qint32 nSize, quint32 *pGlyphs)
+{
+    const quint32 *pAscii = _getTable(ENC_ASCII);
+
+    qint32 i = 0;
+
+    while (i < nSize) {
+        qint32 nAsciiSize = 0;
+
+#ifdef Q_PROCESSOR_X86_64
+        // ASCII runs go through the table 16 bytes at a time
+        while ((i + nAsciiSize + 16 <= nSize) && (_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)(pData + i + nAsciiSize))) == 0)) {
+            nAsciiSize += 16;
+        }
+#endif
+        if (nAsciiSize) {
+            _decodeTable(pAscii, pData + i, nAsciiSize, pGlyphs + i);
+            i += nAsciiSize;
+        } else {
+            quint8 nByte = pData[i];
+            qint32 nLength = 0;
+            quint32 nCodePoint = 0;
+            quint8 nMin = 0x80;
+            quint8 nMax = 0xBF;
+
+            if (nByte < 0x80) {
+                nLength = 1;
+                nCodePoint = nByte;
+            } else if ((nByte >= 0xC2) && (nByte <= 0xDF)) {
+                nLength = 2;
+                nCodePoint = nByte & 0x1F;
+            } else if ((nByte >= 0xE0) && (nByte <= 0xEF)) {
+                nLength = 3;
+                nCodePoint = nByte & 0x0F;
+                // No overlongs and no surrogates
+                nMin = (nByte == 0xE0) ? 0xA0 : 0x80;
+                nMax = (nByte == 0xED) ? 0x9F : 0xBF;
+            } else if ((nByte >= 0xF0) && (nByte <= 0xF4)) {
+                nLength = 4;
+                nCodePoint = nByte & 0x07;
+                nMin = (nByte == 0xF0) ? 0x90 : 0x80;
+                nMax = (nByte == 0xF4) ? 0x8F : 0xBF;
+            }
+
+            bool bValid = (nLength > 0) && (i + nLength <= nSize);
+
+            for (qint32 j = 1; (j < nLength) && bValid; j++) {
+                quint8 nContinuation = pData[i + j];
+
+                if ((nContinuation < ((j == 1) ? nMin : 0x80)) || (nContinuation > ((j == 1) ? nMax : 0xBF))) {
+                    bValid = false;
+                } else {
+                    nCodePoint = (nCodePoint << 6) | (nContinuation & 0x3F);
+                }
+            }
+
+            if (bValid) {
+                pGlyphs[i] = (nLength == 1) ? pAscii[nByte] : _toGlyph(nCodePoint);
+
+                for (qint32 j = 1; j < nLength; j++) {
+                    pGlyphs[i + j] = N_CONTINUATION | pGlyphs[i];
+                }
+
+                i += nLength;
+            } else {
+                pGlyphs[i] = '.';
+                i++;
+            }
+        }
+    }
+}
+
+void QHexViewEncoding::_decodeUtf16(const quint8 *pData, qint32 nSize, qint32 nStart, bool bIsBigEndian, quint32 *pGlyphs)
+{
+    const quint32 *pAscii = _getTable(ENC_ASCII);
+
+    qint32 nLow = bIsBigEndian ? 1 : 0;
+    qint32 nHigh = bIsBigEndian ? 0 : 1;
+
+    for (qint32 i = 0; (i < nStart) && (i < nSize); i++) {
+        pGlyphs[i] = '.';
+    }
+
+    qint32 i = nStart;
+
+#ifdef Q_PROCESSOR_X86_64
+    // Code units below 0x80, in memory order
+    __m128i mask = _mm_set1_epi16(bIsBigEndian ? (short)0x80FF : (short)0xFF80);
+    __m128i zero = _mm_setzero_si128();
+#endif
+
+    while (i + 1 < nSize) {
+        bool bAscii = false;
+
+#ifdef Q_PROCESSOR_X86_64
+        if (i + 16 <= nSize) {
+            __m128i value = _mm_loadu_si128((const __m128i *)(pData + i));
+
+            bAscii = (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(value, mask), zero)) == 0xFFFF);
+        }
+#endif
+        if (bAscii) {
+            for (qint32 j = 0; j < 16; j += 2) {
+                pGlyphs[i + j] = pAscii[pData[i + j + nLow]];
+                pGlyphs[i + j + 1] = N_CONTINUATION | pGlyphs[i + j];
+            }
+
+            i += 16;
+        } else {
+            quint32 nUnit = (pData[i + nHigh] << 8) | pData[i + nLow];
+            quint32 nCodePoint = nUnit;
+            qint32 nLength = 2;
+
+            if ((nUnit >= 0xD800) && (nUnit <= 0xDFFF)) {
+                quint32 nNextUnit = 0;
+
+                if (i + 3 < nSize) {
+                    nNextUnit = (pData[i + 2 + nHigh] << 8) | pData[i + 2 + nLow];
+                }
+
+                if ((nUnit <= 0xDBFF) && (nNextUnit >= 0xDC00) && (nNextUnit <= 0xDFFF)) {
+                    nCodePoint = 0x10000 + ((nUnit - 0xD800) << 10) + (nNextUnit - 0xDC00);
+                    nLength = 4;
+                } else {
+                    // Unpaired surrogate
+                    nCodePoint = 0;
+                }
+            }
+
+            pGlyphs[i] = _toGlyph(nCodePoint);
+
+            for (qint32 j = 1; j < nLength; j++) {
+                pGlyphs[i + j] = N_CONTINUATION | pGlyphs[i];
+            }
+
+            i += nLength;
+        }
+    }
+
+    for (; i < nSize; i++) {
+        pGlyphs[i] = '.';
+    }
+}
+
+quint32 QHexViewEncoding::_toGlyph(quint32 nCodePoint)
+{
+    quint32 nResult = nCodePoint;
+
+    // Controls, C1 controls and BOM
+    if ((nCodePoint < 0x20) || ((nCodePoint >= 0x7F) && (nCodePoint <= 0x9F)) || (nCodePoint == 0xFEFF)) {
+        nResult = '.';
+    }
+
+    return nResult;
+}
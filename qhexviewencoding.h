@@ -0,0 +1,63 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef QHEXVIEWENCODING_H
+#define QHEXVIEWENCODING_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QVector>
+
+// Glyphs for the text column, one per byte
+class QHexViewEncoding {
+public:
+    enum ENC {
+        ENC_ASCII = 0,
+        ENC_LATIN1,
+        ENC_CP1251,
+        ENC_CP866,
+        ENC_EBCDIC,
+        ENC_UTF8,
+        ENC_UTF16LE,
+        ENC_UTF16BE
+    };
+
+    static const quint32 N_CONTINUATION = 0x80000000;  // cell inside a multibyte sequence
+    static const qint32 N_MAX_CONTEXT = 3;              // bytes needed around a window for multibyte sequences
+
+    static QList<ENC> getEncodings();
+    static QString encodingToString(ENC encoding);
+    static bool isMultiByte(ENC encoding);
+    // pData holds nLeadIn bytes before the window, nCount window bytes and optional trailing bytes, nOffset is the offset of the window
+    static void decode(ENC encoding, const char *pData, qint32 nDataSize, qint32 nLeadIn, qint32 nCount, qint64 nOffset, QVector<quint32> *pListGlyphs);
+    static QString glyphToString(quint32 nGlyph);
+    static bool encodeChar(ENC encoding, QChar cChar, QByteArray *pbaResult);  // the bytes of one typed character, 2 for UTF-16
+    static bool encodeString(ENC encoding, const QString &sText, QByteArray *pbaResult);  // false if a character has no byte sequence
+
+private:
+    static const quint32 *_getTable(ENC encoding);
+    static void _decodeTable(const quint32 *pTable, const quint8 *pData, qint32 nSize, quint32 *pGlyphs);
+    static void _decodeUtf8(const quint8 *pData, qint32 nSize, quint32 *pGlyphs);
+    static void _decodeUtf16(const quint8 *pData, qint32 nSize, qint32 nStart, bool bIsBigEndian, quint32 *pGlyphs);
+    static quint32 _toGlyph(quint32 nCodePoint);
+};
+
+#endif  // QHEXVIEWENCODING_H
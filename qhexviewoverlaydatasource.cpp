@@ -0,0 +1,279 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "qhexviewoverlaydatasource.h"
+
+QHexViewOverlayDataSource::QHexViewOverlayDataSource(QHexViewDataSource *pSource, QObject *pParent) : QHexViewDataSource(pParent)
+{
+    g_pSource = pSource;
+
+    // Saves and the other views of a shared source
+    connect(g_pSource, SIGNAL(dataChanged(qint64, qint64)), this, SIGNAL(dataChanged(qint64, qint64)));
+    connect(g_pSource, SIGNAL(dataReset()), this, SIGNAL(dataReset()));
+}
+
+qint64 QHexViewOverlayDataSource::getSize()
+{
+    return g_pSource->getSize();
+}
+
+qint64 QHexViewOverlayDataSource::readAt(qint64 nOffset, char *pBuffer, qint64 nSize)
+{
+    qint64 nResult = g_pSource->readAt(nOffset, pBuffer, nSize);
+
+    if (nResult > 0) {
+        QReadLocker locker(&g_lock);
+
+        qint64 nEnd = nOffset + nResult;
+
+        // The extent that starts before nOffset can reach into the range
+        QMap<qint64, QByteArray>::const_iterator it = g_mapExtents.upperBound(nOffset);
+
+        if (it != g_mapExtents.constBegin()) {
+            it--;
+        }
+
+        for (; (it != g_mapExtents.constEnd()) && (it.key() < nEnd); it++) {
+            qint64 nStart = qMax(it.key(), nOffset);
+            qint64 nStop = qMin(it.key() + it.value().size(), nEnd);
+
+            if (nStart < nStop) {
+                memcpy(pBuffer + (nStart - nOffset), it.value().constData() + (nStart - it.key()), (size_t)(nStop - nStart));
+            }
+        }
+    }
+
+    return nResult;
+}
+
+qint64 QHexViewOverlayDataSource::writeAt(qint64 nOffset, const char *pBuffer, qint64 nSize)
+{
+    qint64 nResult = -1;
+
+    qint64 nDataSize = getSize();
+
+    if ((nOffset >= 0) && (nOffset <= nDataSize)) {
+        nSize = qMin(nSize, nDataSize - nOffset);
+
+        QWriteLocker locker(&g_lock);
+
+        qint64 nEnd = nOffset + nSize;
+        qint64 nCurrent = nOffset;
+
+        // Parts over existing extents are copied into them, the gaps are appended to the extent before or become new extents
+        QMap<qint64, QByteArray>::iterator it = g_mapExtents.upperBound(nOffset);
+        QMap<qint64, QByteArray>::iterator itPrev = g_mapExtents.end();
+
+        if (it != g_mapExtents.begin()) {
+            itPrev = it;
+            itPrev--;
+
+            if (itPrev.key() + itPrev.value().size() > nOffset) {
+                it = itPrev;
+                itPrev = g_mapExtents.end();
+            }
+        }
+
+        while (nCurrent < nEnd) {
+            if ((it != g_mapExtents.end()) && (it.key() <= nCurrent)) {
+                qint64 nStop = qMin(it.key() + it.value().size(), nEnd);
+
+                memcpy(it.value().data() + (nCurrent - it.key()), pBuffer + (nCurrent - nOffset), (size_t)(nStop - nCurrent));
+
+                nCurrent = nStop;
+                itPrev = it;
+                it++;
+            } else {
+                qint64 nStop = nEnd;
+
+                if (it != g_mapExtents.end()) {
+                    nStop = qMin(it.key(), nEnd);
+                }
+
+                const char *pData = pBuffer + (nCurrent - nOffset);
+                qint32 nGapSize = (qint32)(nStop - nCurrent);
+
+                if ((itPrev != g_mapExtents.end()) && (itPrev.key() + itPrev.value().size() == nCurrent) &&
+                    (itPrev.value().size() + nGapSize <= N_MAX_EXTENT_SIZE)) {
+                    itPrev.value().append(pData, nGapSize);
+                } else {
+                    itPrev = g_mapExtents.insert(nCurrent, QByteArray(pData, nGapSize));
+                }
+
+                nCurrent = nStop;
+            }
+        }
+
+        nResult = nSize;
+    }
+
+    if (nResult > 0) {
+        emit dataChanged(nOffset, nResult);
+    }
+
+    return nResult;
+}
+
+bool QHexViewOverlayDataSource::isWritable()
+{
+    return g_pSource->isWritable();
+}
+
+QIODevice *QHexViewOverlayDataSource::getDevice()
+{
+    return g_pSource->getDevice();
+}
+
+bool QHexViewOverlayDataSource::isSparse()
+{
+    return g_pSource->isSparse();
+}
+
+qint64 QHexViewOverlayDataSource::getNextData(qint64 nOffset)
+{
+    qint64 nResult = g_pSource->getNextData(nOffset);
+
+    QReadLocker locker(&g_lock);
+
+    QMap<qint64, QByteArray>::const_iterator it = g_mapExtents.upperBound(nOffset);
+
+    if (it != g_mapExtents.constBegin()) {
+        QMap<qint64, QByteArray>::const_iterator itPrev = it;
+        itPrev--;
+
+        if (itPrev.key() + itPrev.value().size() > nOffset) {
+            it = itPrev;
+        }
+    }
+
+    if (it != g_mapExtents.constEnd()) {
+        qint64 nExtentData = qMax(it.key(), nOffset);
+
+        if ((nResult == -1) || (nExtentData < nResult)) {
+            nResult = nExtentData;
+        }
+    }
+
+    return nResult;
+}
+
+qint64 QHexViewOverlayDataSource::getNextHole(qint64 nOffset)
+{
+    qint64 nResult = g_pSource->getNextHole(nOffset);
+    qint64 nDataSize = getSize();
+
+    QReadLocker locker(&g_lock);
+
+    // A hole of the file that was written to is data now
+    while (nResult < nDataSize) {
+        QMap<qint64, QByteArray>::const_iterator it = g_mapExtents.upperBound(nResult);
+
+        if (it == g_mapExtents.constBegin()) {
+            break;
+        }
+
+        it--;
+
+        qint64 nExtentEnd = it.key() + it.value().size();
+
+        if (nExtentEnd <= nResult) {
+            break;
+        }
+
+        nResult = g_pSource->getNextHole(nExtentEnd);
+    }
+
+    return nResult;
+}
+
+void QHexViewOverlayDataSource::invalidate(qint64 nOffset, qint64 nSize)
+{
+    g_pSource->invalidate(nOffset, nSize);
+}
+
+int QHexViewOverlayDataSource::getHandle()
+{
+    int nResult = -1;
+
+    if (!isModified()) {
+        nResult = g_pSource->getHandle();
+    }
+
+    return nResult;
+}
+
+QHexViewDataSource *QHexViewOverlayDataSource::getSource()
+{
+    return g_pSource;
+}
+
+bool QHexViewOverlayDataSource::isModified()
+{
+    QReadLocker locker(&g_lock);
+
+    return !g_mapExtents.isEmpty();
+}
+
+qint64 QHexViewOverlayDataSource::getModifiedSize()
+{
+    QReadLocker locker(&g_lock);
+
+    qint64 nResult = 0;
+
+    for (QMap<qint64, QByteArray>::const_iterator it = g_mapExtents.constBegin(); it != g_mapExtents.constEnd(); it++) {
+        nResult += it.value().size();
+    }
+
+    return nResult;
+}
+
+QMap<qint64, QByteArray> QHexViewOverlayDataSource::getExtents()
+{
+    QReadLocker locker(&g_lock);
+
+    return g_mapExtents;
+}
+
+void QHexViewOverlayDataSource::clear()
+{
+    qint64 nOffset = 0;
+    qint64 nSize = 0;
+
+    {
+        QWriteLocker locker(&g_lock);
+
+        if (!g_mapExtents.isEmpty()) {
+            QMap<qint64, QByteArray>::const_iterator itLast = g_mapExtents.constEnd();
+            itLast--;
+
+            nOffset = g_mapExtents.constBegin().key();
+            nSize = itLast.key() + itLast.value().size() - nOffset;
+        }
+
+        g_mapExtents.clear();
+    }
+
+    if (nSize) {
+        emit dataChanged(nOffset, nSize);
+    }
+
+    // Saved or discarded, for every view of the overlay
+    reset();
+}
@@ -0,0 +1,61 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef QHEXVIEWOVERLAYDATASOURCE_H
+#define QHEXVIEWOVERLAYDATASOURCE_H
+
+#include <QMap>
+#include <QReadWriteLock>
+
+#include "qhexviewdatasource.h"
+
+// Edits kept in memory over a source until they are saved. The size of the data is not changed
+class QHexViewOverlayDataSource : public QHexViewDataSource {
+    Q_OBJECT
+
+public:
+    explicit QHexViewOverlayDataSource(QHexViewDataSource *pSource, QObject *pParent = nullptr);
+
+    qint64 getSize() override;
+    qint64 readAt(qint64 nOffset, char *pBuffer, qint64 nSize) override;
+    qint64 writeAt(qint64 nOffset, const char *pBuffer, qint64 nSize) override;
+    bool isWritable() override;
+    QIODevice *getDevice() override;
+    bool isSparse() override;
+    qint64 getNextData(qint64 nOffset) override;
+    qint64 getNextHole(qint64 nOffset) override;
+    int getHandle() override;  // -1 while there are edits, the file does not have them
+    void invalidate(qint64 nOffset, qint64 nSize) override;
+
+    QHexViewDataSource *getSource();
+    bool isModified();
+    qint64 getModifiedSize();
+    QMap<qint64, QByteArray> getExtents();  // offset -> data, not overlapping
+    void clear();  // also emits dataReset()
+
+private:
+    const qint32 N_MAX_EXTENT_SIZE = 0x4000000;  // writes next to a larger extent start a new one
+
+    QHexViewDataSource *g_pSource;
+    QMap<qint64, QByteArray> g_mapExtents;
+    QReadWriteLock g_lock;
+};
+
+#endif  // QHEXVIEWOVERLAYDATASOURCE_H
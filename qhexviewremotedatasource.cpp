@@ -0,0 +1,585 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "qhexviewremotedatasource.h"
+
+#include <QCoreApplication>
+
+#include <algorithm>
+
+QHexViewRemoteDataSource::QHexViewRemoteDataSource(QObject *pParent) : QHexViewDataSource(pParent)
+{
+    g_bIsConnected = false;
+    g_nSize = 0;
+    g_nFlags = 0;
+    g_nNextId = 1;
+    g_nLastBlock = 0;
+    g_cacheBlocks.setMaxCost(N_CACHE_SIZE);
+    g_timerRequests.start();
+
+    // The socket runs its own event loop, readAt only waits for the blocks it needs
+    g_pConnection = new QHexViewRemoteConnection(this);
+    g_pConnection->moveToThread(&g_thread);
+
+    g_thread.start();
+}
+
+QHexViewRemoteDataSource::~QHexViewRemoteDataSource()
+{
+    disconnectFromHost();
+
+    g_thread.quit();
+    g_thread.wait();
+
+    delete g_pConnection;
+}
+
+bool QHexViewRemoteDataSource::connectToHost(QString sHost, quint16 nPort)
+{
+    return _connect(sHost, nPort, false);
+}
+
+bool QHexViewRemoteDataSource::connectToServer(QString sServerName)
+{
+    return _connect(sServerName, 0, true);
+}
+
+void QHexViewRemoteDataSource::disconnectFromHost()
+{
+    QMetaObject::invokeMethod(g_pConnection, "close", Qt::BlockingQueuedConnection);
+
+    _onDisconnected();
+}
+
+bool QHexViewRemoteDataSource::isConnected()
+{
+    QMutexLocker locker(&g_mutex);
+
+    return g_bIsConnected;
+}
+
+void QHexViewRemoteDataSource::clearCache()
+{
+    QMutexLocker locker(&g_mutex);
+
+    g_cacheBlocks.clear();
+    g_setFailedBlocks.clear();
+    g_setLateBlocks.clear();
+}
+
+qint64 QHexViewRemoteDataSource::getSize()
+{
+    QMutexLocker locker(&g_mutex);
+
+    return g_nSize;
+}
+
+qint64 QHexViewRemoteDataSource::readAt(qint64 nOffset, char *pBuffer, qint64 nSize)
+{
+    QMutexLocker locker(&g_mutex);
+
+    qint64 nResult = -1;
+
+    if (g_bIsConnected && (nOffset >= 0) && (nOffset <= g_nSize)) {
+        nSize = qMin(nSize, g_nSize - nOffset);
+        nResult = 0;
+
+        if (nSize > 0) {
+            qint64 nFirstBlock = nOffset / N_BLOCK_SIZE;
+            qint64 nLastBlock = (nOffset + nSize - 1) / N_BLOCK_SIZE;
+
+            // The GUI thread is not blocked for long: the view shows the data with the next fetch
+            QCoreApplication *pApplication = QCoreApplication::instance();
+            qint64 nTimeout = (pApplication && (QThread::currentThread() == pApplication->thread())) ? N_GUI_TIMEOUT : N_TIMEOUT;
+
+            QElapsedTimer timer;
+            timer.start();
+
+            bool bComplete = _requestMissing(nFirstBlock, nLastBlock);
+
+            // Sent after the blocks of this read, so they do not delay it
+            _prefetch(nFirstBlock, nLastBlock);
+
+            while ((!bComplete) && g_bIsConnected && (timer.elapsed() < nTimeout)) {
+                // Woken up at least when a request expires
+                g_waitCondition.wait(&g_mutex, (unsigned long)qMin(nTimeout - timer.elapsed(), (qint64)N_REQUEST_TIMEOUT));
+
+                bComplete = _requestMissing(nFirstBlock, nLastBlock);
+            }
+
+            if (!bComplete) {
+                for (qint64 i = nFirstBlock; i <= nLastBlock; i++) {
+                    if ((!g_cacheBlocks.contains(i)) && (!g_setFailedBlocks.contains(i))) {
+                        g_setLateBlocks.insert(i);
+                    }
+                }
+            }
+
+            for (qint64 i = nFirstBlock; i <= nLastBlock; i++) {
+                QByteArray *pBlock = g_cacheBlocks.object(i);
+
+                if (!pBlock) {
+                    break;
+                }
+
+                qint64 nDelta = nOffset + nResult - i * N_BLOCK_SIZE;
+                qint64 nCopySize = qMin(nSize - nResult, pBlock->size() - nDelta);
+
+                if (nCopySize <= 0) {
+                    break;
+                }
+
+                memcpy(pBuffer + nResult, pBlock->constData() + nDelta, (size_t)nCopySize);
+
+                nResult += nCopySize;
+            }
+
+            if (nResult == 0) {
+                nResult = -1;
+            }
+        }
+    }
+
+    return nResult;
+}
+
+qint64 QHexViewRemoteDataSource::writeAt(qint64 nOffset, const char *pBuffer, qint64 nSize)
+{
+    QMutexLocker locker(&g_mutex);
+
+    qint64 nResult = -1;
+
+    if (g_bIsConnected && (g_nFlags & RF_WRITABLE) && (nOffset >= 0) && (nSize > 0) && (nSize <= 0x7FFFFFFF)) {
+        quint32 nId = _sendRequest(CMD_WRITE, nOffset, nSize, pBuffer);
+
+        QElapsedTimer timer;
+        timer.start();
+
+        while ((!g_mapResults.contains(nId)) && g_bIsConnected && (timer.elapsed() < N_TIMEOUT)) {
+            g_waitCondition.wait(&g_mutex, (unsigned long)(N_TIMEOUT - timer.elapsed()));
+        }
+
+        if (g_mapResults.value(nId, 0xFF) == 0) {
+            nResult = nSize;
+        }
+
+        g_mapResults.remove(nId);
+
+        for (qint64 i = nOffset / N_BLOCK_SIZE; i <= (nOffset + nSize - 1) / N_BLOCK_SIZE; i++) {
+            g_cacheBlocks.remove(i);
+            g_setFailedBlocks.remove(i);
+        }
+    }
+
+    return nResult;
+}
+
+bool QHexViewRemoteDataSource::isWritable()
+{
+    QMutexLocker locker(&g_mutex);
+
+    return (g_nFlags & RF_WRITABLE);
+}
+
+bool QHexViewRemoteDataSource::_connect(QString sName, quint16 nPort, bool bLocal)
+{
+    bool bResult = false;
+
+    disconnectFromHost();
+
+    bool bOpened = false;
+
+    QMetaObject::invokeMethod(g_pConnection, "open", Qt::BlockingQueuedConnection, Q_RETURN_ARG(bool, bOpened), Q_ARG(QString, sName), Q_ARG(quint16, nPort),
+                              Q_ARG(bool, bLocal));
+
+    if (bOpened) {
+        QMutexLocker locker(&g_mutex);
+
+        g_bIsConnected = true;
+        g_nSize = 0;
+        g_nFlags = 0;
+        g_nLastBlock = 0;
+        g_cacheBlocks.clear();
+        g_setFailedBlocks.clear();
+        g_setLateBlocks.clear();
+
+        quint32 nId = _sendRequest(CMD_INFO, 0, 0);
+
+        QElapsedTimer timer;
+        timer.start();
+
+        while ((!g_mapResults.contains(nId)) && g_bIsConnected && (timer.elapsed() < N_TIMEOUT)) {
+            g_waitCondition.wait(&g_mutex, (unsigned long)(N_TIMEOUT - timer.elapsed()));
+        }
+
+        bResult = (g_mapResults.value(nId, 0xFF) == 0);
+
+        g_mapResults.remove(nId);
+    }
+
+    if (!bResult) {
+        emit errorMessage(QString("%1: %2").arg(tr("Cannot connect"), sName));
+
+        disconnectFromHost();
+    }
+
+    return bResult;
+}
+
+quint32 QHexViewRemoteDataSource::_sendRequest(CMD cmd, qint64 nOffset, qint64 nLength, const char *pData)
+{
+    quint32 nId = g_nNextId++;
+
+    QByteArray baFrame(21 + (pData ? (qint32)nLength : 0), 0);
+    char *pFrame = baFrame.data();
+
+    qToLittleEndian<quint32>((quint32)(baFrame.size() - 4), pFrame);
+    pFrame[4] = (char)cmd;
+    qToLittleEndian<quint32>(nId, pFrame + 5);
+    qToLittleEndian<quint64>((quint64)nOffset, pFrame + 9);
+    qToLittleEndian<quint32>((quint32)nLength, pFrame + 17);
+
+    if (pData) {
+        memcpy(pFrame + 21, pData, (size_t)nLength);
+    }
+
+    // Not waiting for the answer: any number of requests can be in flight
+    QMetaObject::invokeMethod(g_pConnection, "send", Qt::QueuedConnection, Q_ARG(QByteArray, baFrame));
+
+    return nId;
+}
+
+void QHexViewRemoteDataSource::_requestBlocks(qint64 nBlock, qint64 nCount)
+{
+    for (qint64 i = 0; i < nCount; i++) {
+        g_setPendingBlocks.insert(nBlock + i);
+    }
+
+    qint64 nOffset = nBlock * N_BLOCK_SIZE;
+    qint64 nLength = qMin(nCount * N_BLOCK_SIZE, g_nSize - nOffset);
+
+    REQUEST request = {};
+    request.nBlock = nBlock;
+    request.nCount = nCount;
+    request.nTime = g_timerRequests.elapsed();
+
+    g_mapRequests.insert(_sendRequest(CMD_READ, nOffset, nLength), request);
+}
+
+void QHexViewRemoteDataSource::_expireRequests()
+{
+    qint64 nTime = g_timerRequests.elapsed();
+
+    QMutableMapIterator<quint32, REQUEST> iter(g_mapRequests);
+
+    while (iter.hasNext()) {
+        iter.next();
+
+        if (nTime - iter.value().nTime >= N_REQUEST_TIMEOUT) {
+            // Lost: the blocks are requested again, a late answer is still cached
+            for (qint64 i = 0; i < iter.value().nCount; i++) {
+                g_setPendingBlocks.remove(iter.value().nBlock + i);
+            }
+
+            iter.remove();
+        }
+    }
+}
+
+void QHexViewRemoteDataSource::_retryLateBlocks()
+{
+    QMutexLocker locker(&g_mutex);
+
+    if (g_bIsConnected && (!g_setLateBlocks.isEmpty())) {
+        // Nobody reads them again until the view is told, so the lost ones are requested from here
+        QList<qint64> listBlocks = g_setLateBlocks.values();
+        std::sort(listBlocks.begin(), listBlocks.end());
+
+        qint32 nNumberOfBlocks = listBlocks.count();
+
+        for (qint32 i = 0; i < nNumberOfBlocks; i++) {
+            _requestMissing(listBlocks.at(i), listBlocks.at(i));
+        }
+    }
+}
+
+bool QHexViewRemoteDataSource::_requestMissing(qint64 nFirstBlock, qint64 nLastBlock)
+{
+    bool bResult = true;
+
+    _expireRequests();
+
+    qint64 nRunStart = -1;
+
+    for (qint64 i = nFirstBlock; i <= nLastBlock; i++) {
+        bool bMissing = (!g_cacheBlocks.contains(i)) && (!g_setFailedBlocks.contains(i));
+
+        if (bMissing) {
+            bResult = false;
+        }
+
+        // Adjacent blocks go in one request
+        if (bMissing && (!g_setPendingBlocks.contains(i))) {
+            if (nRunStart == -1) {
+                nRunStart = i;
+            }
+
+            if (i - nRunStart + 1 == N_MAX_REQUEST_BLOCKS) {
+                _requestBlocks(nRunStart, i - nRunStart + 1);
+                nRunStart = -1;
+            }
+        } else if (nRunStart != -1) {
+            _requestBlocks(nRunStart, i - nRunStart);
+            nRunStart = -1;
+        }
+    }
+
+    if (nRunStart != -1) {
+        _requestBlocks(nRunStart, nLastBlock - nRunStart + 1);
+    }
+
+    return bResult;
+}
+
+void QHexViewRemoteDataSource::_prefetch(qint64 nFirstBlock, qint64 nLastBlock)
+{
+    qint64 nNumberOfBlocks = (g_nSize + N_BLOCK_SIZE - 1) / N_BLOCK_SIZE;
+
+    qint64 nStart = 0;
+    qint64 nEnd = 0;
+
+    if (nFirstBlock >= g_nLastBlock) {
+        nStart = nLastBlock + 1;
+        nEnd = qMin(nLastBlock + N_PREFETCH_BLOCKS, nNumberOfBlocks - 1);
+    } else {
+        nStart = qMax(nFirstBlock - N_PREFETCH_BLOCKS, (qint64)0);
+        nEnd = nFirstBlock - 1;
+    }
+
+    if (nStart <= nEnd) {
+        _requestMissing(nStart, nEnd);
+    }
+
+    g_nLastBlock = nFirstBlock;
+}
+
+void QHexViewRemoteDataSource::_onResponse(quint8 nCommand, quint32 nId, quint8 nStatus, qint64 nOffset, qint64 nLength, const QByteArray &baData)
+{
+    QMutexLocker locker(&g_mutex);
+
+    qint64 nChangedStart = -1;
+    qint64 nChangedEnd = -1;
+
+    if (nCommand == CMD_READ) {
+        // All the blocks of the request, the answer can cover less
+        REQUEST request = {};
+
+        if (g_mapRequests.contains(nId)) {
+            request = g_mapRequests.take(nId);
+
+            for (qint64 i = 0; i < request.nCount; i++) {
+                g_setPendingBlocks.remove(request.nBlock + i);
+            }
+        }
+
+        qint64 nBlock = nOffset / N_BLOCK_SIZE;
+        qint64 nCount = (nLength + N_BLOCK_SIZE - 1) / N_BLOCK_SIZE;
+
+        for (qint64 i = 0; i < nCount; i++) {
+            qint64 nDelta = i * N_BLOCK_SIZE;
+
+            if ((nStatus == 0) && (nDelta < baData.size())) {
+                g_cacheBlocks.insert(nBlock + i, new QByteArray(baData.mid((qint32)nDelta, (qint32)N_BLOCK_SIZE)));
+            } else {
+                g_setFailedBlocks.insert(nBlock + i);
+            }
+
+            if (g_setLateBlocks.remove(nBlock + i)) {
+                if (nChangedStart == -1) {
+                    nChangedStart = nBlock + i;
+                }
+
+                nChangedEnd = nBlock + i + 1;
+            }
+        }
+
+        // A short answer: what a view still waits for is requested again
+        for (qint64 i = 0; i < request.nCount; i++) {
+            qint64 nLateBlock = request.nBlock + i;
+
+            if (g_setLateBlocks.contains(nLateBlock) && (!g_cacheBlocks.contains(nLateBlock)) && (!g_setFailedBlocks.contains(nLateBlock))) {
+                _requestMissing(nLateBlock, nLateBlock);
+            }
+        }
+    } else {
+        if ((nCommand == CMD_INFO) && (nStatus == 0)) {
+            g_nSize = nOffset;
+            g_nFlags = (quint32)nLength;
+        }
+
+        g_mapResults.insert(nId, nStatus);
+    }
+
+    g_waitCondition.wakeAll();
+
+    locker.unlock();
+
+    if (nChangedStart != -1) {
+        // The views fetch again what they could not show
+        emit dataChanged(nChangedStart * N_BLOCK_SIZE, (nChangedEnd - nChangedStart) * N_BLOCK_SIZE);
+    }
+}
+
+void QHexViewRemoteDataSource::_onDisconnected()
+{
+    QMutexLocker locker(&g_mutex);
+
+    g_bIsConnected = false;
+    g_setPendingBlocks.clear();
+    g_mapRequests.clear();
+
+    g_waitCondition.wakeAll();
+}
+
+QHexViewRemoteConnection::QHexViewRemoteConnection(QHexViewRemoteDataSource *pDataSource) : QObject(nullptr)
+{
+    g_pDataSource = pDataSource;
+    g_pSocket = nullptr;
+    g_pTimerRetry = nullptr;
+}
+
+bool QHexViewRemoteConnection::open(QString sName, quint16 nPort, bool bLocal)
+{
+    bool bResult = false;
+
+    close();
+
+    if (bLocal) {
+        QLocalSocket *pSocket = new QLocalSocket(this);
+        pSocket->connectToServer(sName);
+
+        bResult = pSocket->waitForConnected(N_TIMEOUT);
+
+        connect(pSocket, SIGNAL(disconnected()), this, SLOT(_disconnected()));
+
+        g_pSocket = pSocket;
+    } else {
+        QTcpSocket *pSocket = new QTcpSocket(this);
+        pSocket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        pSocket->connectToHost(sName, nPort);
+
+        bResult = pSocket->waitForConnected(N_TIMEOUT);
+
+        connect(pSocket, SIGNAL(disconnected()), this, SLOT(_disconnected()));
+
+        g_pSocket = pSocket;
+    }
+
+    connect(g_pSocket, SIGNAL(readyRead()), this, SLOT(_readyRead()));
+
+    if (bResult) {
+        g_pTimerRetry = new QTimer(this);
+
+        connect(g_pTimerRetry, SIGNAL(timeout()), this, SLOT(_retry()));
+
+        g_pTimerRetry->start(N_RETRY_INTERVAL);
+    } else {
+        close();
+    }
+
+    return bResult;
+}
+
+void QHexViewRemoteConnection::close()
+{
+    if (g_pSocket) {
+        g_pSocket->disconnect(this);
+        g_pSocket->close();
+
+        delete g_pSocket;
+        g_pSocket = nullptr;
+    }
+
+    if (g_pTimerRetry) {
+        delete g_pTimerRetry;
+        g_pTimerRetry = nullptr;
+    }
+
+    g_baReceived.clear();
+}
+
+void QHexViewRemoteConnection::send(QByteArray baFrame)
+{
+    if (g_pSocket) {
+        g_pSocket->write(baFrame);
+    }
+}
+
+void QHexViewRemoteConnection::_readyRead()
+{
+    g_baReceived.append(g_pSocket->readAll());
+
+    qint32 nPosition = 0;
+    bool bValid = true;
+
+    while (bValid && (g_baReceived.size() - nPosition >= 4)) {
+        const char *pData = g_baReceived.constData() + nPosition;
+        quint32 nFrameSize = qFromLittleEndian<quint32>(pData);
+
+        if (nFrameSize < (quint32)N_HEADER_SIZE) {
+            bValid = false;
+        } else if ((quint32)(g_baReceived.size() - nPosition - 4) < nFrameSize) {
+            break;
+        } else {
+            const char *pFrame = pData + 4;
+
+            quint8 nCommand = (quint8)pFrame[0];
+            quint32 nId = qFromLittleEndian<quint32>(pFrame + 1);
+            quint8 nStatus = (quint8)pFrame[5];
+            qint64 nOffset = (qint64)qFromLittleEndian<quint64>(pFrame + 6);
+            qint64 nLength = qFromLittleEndian<quint32>(pFrame + 14);
+
+            QByteArray baData(pFrame + N_HEADER_SIZE, (qint32)(nFrameSize - N_HEADER_SIZE));
+
+            g_pDataSource->_onResponse(nCommand, nId, nStatus, nOffset, nLength, baData);
+
+            nPosition += 4 + (qint32)nFrameSize;
+        }
+    }
+
+    if (bValid) {
+        g_baReceived.remove(0, nPosition);
+    } else {
+        // Protocol error, the stream can not be resynchronized
+        close();
+
+        g_pDataSource->_onDisconnected();
+    }
+}
+
+void QHexViewRemoteConnection::_disconnected()
+{
+    g_pDataSource->_onDisconnected();
+}
+
+void QHexViewRemoteConnection::_retry()
+{
+    g_pDataSource->_retryLateBlocks();
+}
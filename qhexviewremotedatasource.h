@@ -0,0 +1,148 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef QHEXVIEWREMOTEDATASOURCE_H
+#define QHEXVIEWREMOTEDATASOURCE_H
+
+#include <QCache>
+#include <QElapsedTimer>
+#include <QLocalSocket>
+#include <QMap>
+#include <QSet>
+#include <QTcpSocket>
+#include <QThread>
+#include <QTimer>
+#include <QWaitCondition>
+#include <QtEndian>
+
+#include "qhexviewdatasource.h"
+
+class QHexViewRemoteConnection;
+
+// Data on another machine or in a debug agent, over TCP or a local socket.
+// Frames are little-endian:
+//   request:  u32 size of the rest, u8 command, u32 id, u64 offset, u32 length, [length bytes for CMD_WRITE]
+//   response: u32 size of the rest, u8 command, u32 id, u8 status, u64 offset, u32 length, [length bytes for CMD_READ]
+// CMD_INFO returns the size of the data in offset and the RF_ flags in length.
+class QHexViewRemoteDataSource : public QHexViewDataSource {
+    Q_OBJECT
+
+public:
+    enum CMD {
+        CMD_INFO = 0,
+        CMD_READ,
+        CMD_WRITE
+    };
+
+    enum RF {
+        RF_WRITABLE = 0x01
+    };
+
+    explicit QHexViewRemoteDataSource(QObject *pParent = nullptr);
+    ~QHexViewRemoteDataSource();
+
+    bool connectToHost(QString sHost, quint16 nPort);
+    bool connectToServer(QString sServerName);
+    void disconnectFromHost();
+    bool isConnected();
+    void clearCache();
+
+    qint64 getSize() override;
+    qint64 readAt(qint64 nOffset, char *pBuffer, qint64 nSize) override;
+    qint64 writeAt(qint64 nOffset, const char *pBuffer, qint64 nSize) override;
+    bool isWritable() override;
+
+signals:
+    void errorMessage(QString sText);
+
+private:
+    friend class QHexViewRemoteConnection;
+
+    struct REQUEST {
+        qint64 nBlock;
+        qint64 nCount;
+        qint64 nTime;  // ms of g_timerRequests
+    };
+
+    bool _connect(QString sName, quint16 nPort, bool bLocal);
+    quint32 _sendRequest(CMD cmd, qint64 nOffset, qint64 nLength, const char *pData = nullptr);
+    void _requestBlocks(qint64 nBlock, qint64 nCount);
+    void _expireRequests();
+    void _retryLateBlocks();
+    bool _requestMissing(qint64 nFirstBlock, qint64 nLastBlock);
+    void _prefetch(qint64 nFirstBlock, qint64 nLastBlock);
+    void _onResponse(quint8 nCommand, quint32 nId, quint8 nStatus, qint64 nOffset, qint64 nLength, const QByteArray &baData);
+    void _onDisconnected();
+
+    const qint64 N_BLOCK_SIZE = 0x10000;
+    const qint64 N_MAX_REQUEST_BLOCKS = 16;  // coalesced blocks per request
+    const qint64 N_PREFETCH_BLOCKS = 8;
+    const qint32 N_CACHE_SIZE = 0x400;  // blocks
+    const qint32 N_TIMEOUT = 10000;      // ms
+    const qint32 N_GUI_TIMEOUT = 100;    // ms, the GUI thread gets what has arrived, the rest is signalled with dataChanged
+    const qint32 N_REQUEST_TIMEOUT = 3000;  // ms, the blocks of a lost or partly answered request are requested again
+
+    QThread g_thread;
+    QHexViewRemoteConnection *g_pConnection;
+    QMutex g_mutex;
+    QWaitCondition g_waitCondition;
+    bool g_bIsConnected;
+    qint64 g_nSize;
+    quint32 g_nFlags;
+    quint32 g_nNextId;
+    qint64 g_nLastBlock;  // first block of the previous read, for the prefetch direction
+    QCache<qint64, QByteArray> g_cacheBlocks;
+    QSet<qint64> g_setPendingBlocks;
+    QSet<qint64> g_setFailedBlocks;
+    QSet<qint64> g_setLateBlocks;  // not there when a read returned, dataChanged when they arrive
+    QMap<quint32, REQUEST> g_mapRequests;  // READ requests in flight by id
+    QElapsedTimer g_timerRequests;
+    QMap<quint32, quint8> g_mapResults;  // INFO/WRITE responses by id
+};
+
+// Lives in the I/O thread of the data source
+class QHexViewRemoteConnection : public QObject {
+    Q_OBJECT
+
+public:
+    explicit QHexViewRemoteConnection(QHexViewRemoteDataSource *pDataSource);
+
+public slots:
+    bool open(QString sName, quint16 nPort, bool bLocal);
+    void close();
+    void send(QByteArray baFrame);
+
+private slots:
+    void _readyRead();
+    void _disconnected();
+    void _retry();
+
+private:
+    const qint32 N_HEADER_SIZE = 18;  // response without the size field and the data
+    const qint32 N_TIMEOUT = 10000;    // ms
+    const qint32 N_RETRY_INTERVAL = 1000;  // ms
+
+    QHexViewRemoteDataSource *g_pDataSource;
+    QIODevice *g_pSocket;
+    QTimer *g_pTimerRetry;
+    QByteArray g_baReceived;
+};
+
+#endif  // QHEXVIEWREMOTEDATASOURCE_H
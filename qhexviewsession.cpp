@@ -0,0 +1,443 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "qhexviewsession.h"
+
+#include <QDateTime>
+#include <QFileInfo>
+
+#include "hashprocess.h"
+
+QHexViewSession::QHexViewSession()
+{
+    g_pMap = nullptr;
+    g_nMapSize = 0;
+    g_pSaveFile = nullptr;
+    g_header = {};
+    g_entry = {};
+    g_bWriteError = false;
+}
+
+QHexViewSession::~QHexViewSession()
+{
+    close();
+
+    delete g_pSaveFile;
+}
+
+bool QHexViewSession::open(QString sFileName, const KEY &key)
+{
+    bool bResult = false;
+
+    close();
+
+    g_file.setFileName(sFileName);
+
+    if (g_file.open(QIODevice::ReadOnly)) {
+        g_nMapSize = g_file.size();
+
+        if (g_nMapSize >= (qint64)sizeof(HEADER)) {
+            g_pMap = g_file.map(0, g_nMapSize);
+        }
+
+        if (g_pMap) {
+            HEADER header = {};
+            memcpy(&header, g_pMap, sizeof(HEADER));
+
+            bResult = (header.nMagic == N_MAGIC) && (header.nVersion == N_VERSION) && isKeyEqual(header.key, key) && (header.nTableOffset >= (qint64)sizeof(HEADER)) &&
+                      (header.nTableOffset + (qint64)header.nNumberOfSections * (qint64)sizeof(ENTRY) <= g_nMapSize);
+
+            if (bResult) {
+                g_listEntries.resize(header.nNumberOfSections);
+
+                if (header.nNumberOfSections) {
+                    memcpy(g_listEntries.data(), g_pMap + header.nTableOffset, header.nNumberOfSections * sizeof(ENTRY));
+                }
+
+                for (qint32 i = 0; i < g_listEntries.count(); i++) {
+                    const ENTRY &entry = g_listEntries.at(i);
+
+                    if ((entry.nOffset < (qint64)sizeof(HEADER)) || (entry.nSize < 0) || (entry.nOffset + entry.nSize > header.nTableOffset)) {
+                        bResult = false;
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (!bResult) {
+            close();
+        }
+    }
+
+    return bResult;
+}
+
+void QHexViewSession::close()
+{
+    if (g_pMap) {
+        g_file.unmap(g_pMap);
+        g_pMap = nullptr;
+    }
+
+    if (g_file.isOpen()) {
+        g_file.close();
+    }
+
+    g_nMapSize = 0;
+    g_listEntries.clear();
+}
+
+bool QHexViewSession::isOpen()
+{
+    return (g_pMap != nullptr);
+}
+
+bool QHexViewSession::getSection(SECTION section, const char **ppData, qint64 *pnSize)
+{
+    bool bResult = false;
+
+    if (g_pMap) {
+        qint32 nNumberOfEntries = g_listEntries.count();
+
+        for (qint32 i = 0; i < nNumberOfEntries; i++) {
+            if (g_listEntries.at(i).nSection == (quint32)section) {
+                *ppData = (const char *)(g_pMap + g_listEntries.at(i).nOffset);
+                *pnSize = g_listEntries.at(i).nSize;
+                bResult = true;
+                break;
+            }
+        }
+    }
+
+    return bResult;
+}
+
+bool QHexViewSession::create(QString sFileName, const KEY &key)
+{
+    bool bResult = false;
+
+    // One session is either read or written
+    close();
+
+    delete g_pSaveFile;
+
+    g_pSaveFile = new QSaveFile(sFileName);
+    g_bWriteError = false;
+
+    g_header = {};
+    g_header.nMagic = N_MAGIC;
+    g_header.nVersion = N_VERSION;
+    g_header.key = key;
+
+    if (g_pSaveFile->open(QIODevice::WriteOnly)) {
+        // The header is written again with the table offset on commit()
+        bResult = (g_pSaveFile->write((const char *)&g_header, sizeof(HEADER)) == sizeof(HEADER));
+    }
+
+    if (!bResult) {
+        delete g_pSaveFile;
+        g_pSaveFile = nullptr;
+    }
+
+    return bResult;
+}
+
+bool QHexViewSession::addSection(SECTION section, const QByteArray &baData)
+{
+    bool bResult = false;
+
+    QIODevice *pDevice = beginSection(section);
+
+    if (pDevice) {
+        pDevice->write(baData);
+
+        bResult = endSection();
+    }
+
+    return bResult;
+}
+
+QIODevice *QHexViewSession::beginSection(SECTION section)
+{
+    QIODevice *pResult = nullptr;
+
+    if (g_pSaveFile && _align()) {
+        g_entry = {};
+        g_entry.nSection = section;
+        g_entry.nOffset = g_pSaveFile->pos();
+
+        pResult = g_pSaveFile;
+    }
+
+    return pResult;
+}
+
+bool QHexViewSession::endSection()
+{
+    bool bResult = false;
+
+    if (g_pSaveFile) {
+        g_entry.nSize = g_pSaveFile->pos() - g_entry.nOffset;
+
+        // A section that could not be written is left out, the space stays unused
+        if (g_pSaveFile->error() == QFileDevice::NoError) {
+            g_listEntries.append(g_entry);
+            bResult = true;
+        } else {
+            g_bWriteError = true;
+        }
+    }
+
+    return bResult;
+}
+
+bool QHexViewSession::commit()
+{
+    bool bResult = false;
+
+    if (g_pSaveFile && (!g_bWriteError) && _align()) {
+        g_header.nTableOffset = g_pSaveFile->pos();
+        g_header.nNumberOfSections = g_listEntries.count();
+
+        qint64 nTableSize = g_listEntries.count() * (qint64)sizeof(ENTRY);
+
+        bResult = (g_pSaveFile->write((const char *)g_listEntries.constData(), nTableSize) == nTableSize) && g_pSaveFile->seek(0) &&
+                  (g_pSaveFile->write((const char *)&g_header, sizeof(HEADER)) == sizeof(HEADER));
+
+        if (bResult) {
+            bResult = g_pSaveFile->commit();
+        }
+    }
+
+    delete g_pSaveFile;
+    g_pSaveFile = nullptr;
+
+    g_listEntries.clear();
+
+    return bResult;
+}
+
+QString QHexViewSession::getSessionFileName(QString sFileName)
+{
+    return sFileName + QString(".qhvs");
+}
+
+QHexViewSession::KEY QHexViewSession::getKey(QString sFileName)
+{
+    KEY result = {};
+
+    QFileInfo fileInfo(sFileName);
+
+    result.nSize = fileInfo.size();
+    result.nModified = fileInfo.lastModified().toMSecsSinceEpoch();
+
+    // Own handle, the device of the view is read from other threads
+    QFile file(sFileName);
+
+    if (file.open(QIODevice::ReadOnly)) {
+        HashProcess::XXH64_STATE state = {};
+        HashProcess::xxh64Init(&state);
+        HashProcess::xxh64Update(&state, (const char *)&result.nSize, sizeof(result.nSize));
+
+        QByteArray baSample(N_SAMPLE_SIZE, 0);
+
+        // Evenly spread, the first and the last block included
+        for (qint32 i = 0; i < N_NUMBER_OF_SAMPLES; i++) {
+            qint64 nOffset = (qMax(result.nSize - (qint64)N_SAMPLE_SIZE, (qint64)0) / (N_NUMBER_OF_SAMPLES - 1)) * i;
+
+            if (file.seek(nOffset)) {
+                qint64 nRead = file.read(baSample.data(), N_SAMPLE_SIZE);
+
+                if (nRead > 0) {
+                    HashProcess::xxh64Update(&state, baSample.constData(), nRead);
+                }
+            }
+        }
+
+        result.nSampleHash = HashProcess::xxh64Digest(&state);
+
+        file.close();
+    }
+
+    return result;
+}
+
+bool QHexViewSession::isKeyEqual(const KEY &key1, const KEY &key2)
+{
+    return (key1.nSize == key2.nSize) && (key1.nModified == key2.nModified) && (key1.nSampleHash == key2.nSampleHash);
+}
+
+QByteArray QHexViewSession::stateToData(const STATE &state)
+{
+    return QByteArray((const char *)&state, sizeof(STATE));
+}
+
+bool QHexViewSession::dataToState(const char *pData, qint64 nSize, STATE *pState)
+{
+    bool bResult = false;
+
+    if (nSize == (qint64)sizeof(STATE)) {
+        memcpy(pState, pData, sizeof(STATE));
+        bResult = true;
+    }
+
+    return bResult;
+}
+
+QByteArray QHexViewSession::annotationsToData(const QVector<QHexViewAnnotations::ANNOTATION> &listAnnotations)
+{
+    QByteArray baResult;
+
+    QDataStream stream(&baResult, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_0);  // the same format with every Qt version
+
+    qint32 nNumberOfAnnotations = listAnnotations.count();
+
+    stream << nNumberOfAnnotations;
+
+    for (qint32 i = 0; i < nNumberOfAnnotations; i++) {
+        const QHexViewAnnotations::ANNOTATION &annotation = listAnnotations.at(i);
+
+        stream << annotation.nOffset << annotation.nSize << (quint32)annotation.nColor << annotation.bBookmark << annotation.sText;
+    }
+
+    return baResult;
+}
+
+QVector<QHexViewAnnotations::ANNOTATION> QHexViewSession::dataToAnnotations(const char *pData, qint64 nSize)
+{
+    QVector<QHexViewAnnotations::ANNOTATION> listResult;
+
+    QByteArray baData = QByteArray::fromRawData(pData, (qint32)nSize);
+    QDataStream stream(baData);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    qint32 nNumberOfAnnotations = 0;
+
+    stream >> nNumberOfAnnotations;
+
+    if ((stream.status() == QDataStream::Ok) && (nNumberOfAnnotations > 0)) {
+        // Each record takes at least 25 bytes
+        listResult.reserve((qint32)qMin((qint64)nNumberOfAnnotations, nSize / 25));
+
+        for (qint32 i = 0; (i < nNumberOfAnnotations) && (stream.status() == QDataStream::Ok); i++) {
+            QHexViewAnnotations::ANNOTATION annotation = {};
+            quint32 nColor = 0;
+
+            stream >> annotation.nOffset >> annotation.nSize >> nColor >> annotation.bBookmark >> annotation.sText;
+
+            annotation.nColor = nColor;
+
+            if (stream.status() == QDataStream::Ok) {
+                listResult.append(annotation);
+            }
+        }
+    }
+
+    return listResult;
+}
+
+QByteArray QHexViewSession::memoryMapToData(const XBinary::_MEMORY_MAP &memoryMap)
+{
+    QByteArray baResult;
+
+    QDataStream stream(&baResult, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    qint32 nNumberOfRecords = memoryMap.listRecords.count();
+
+    stream << (qint64)memoryMap.nModuleAddress << (qint64)memoryMap.nBinarySize << (qint64)memoryMap.nImageSize << nNumberOfRecords;
+
+    for (qint32 i = 0; i < nNumberOfRecords; i++) {
+        const XBinary::_MEMORY_RECORD &record = memoryMap.listRecords.at(i);
+
+        stream << (qint64)record.nOffset << (qint64)record.nAddress << (qint64)record.nSize << (qint32)record.type << (qint32)record.nIndex << record.sName;
+    }
+
+    return baResult;
+}
+
+bool QHexViewSession::dataToMemoryMap(const char *pData, qint64 nSize, XBinary::_MEMORY_MAP *pMemoryMap)
+{
+    bool bResult = false;
+
+    QByteArray baData = QByteArray::fromRawData(pData, (qint32)nSize);
+    QDataStream stream(baData);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    XBinary::_MEMORY_MAP memoryMap = {};
+    qint64 nModuleAddress = 0;
+    qint64 nBinarySize = 0;
+    qint64 nImageSize = 0;
+    qint32 nNumberOfRecords = 0;
+
+    stream >> nModuleAddress >> nBinarySize >> nImageSize >> nNumberOfRecords;
+
+    memoryMap.nModuleAddress = nModuleAddress;
+    memoryMap.nBinarySize = nBinarySize;
+    memoryMap.nImageSize = nImageSize;
+
+    // An empty map is not stored: the default one is built again
+    if ((stream.status() == QDataStream::Ok) && (nNumberOfRecords > 0)) {
+        for (qint32 i = 0; (i < nNumberOfRecords) && (stream.status() == QDataStream::Ok); i++) {
+            XBinary::_MEMORY_RECORD record = {};
+            qint64 nRecordOffset = 0;
+            qint64 nRecordAddress = 0;
+            qint64 nRecordSize = 0;
+            qint32 nType = 0;
+            qint32 nIndex = 0;
+
+            stream >> nRecordOffset >> nRecordAddress >> nRecordSize >> nType >> nIndex >> record.sName;
+
+            record.nOffset = nRecordOffset;
+            record.nAddress = nRecordAddress;
+            record.nSize = nRecordSize;
+            record.type = (XBinary::MMT)nType;
+            record.nIndex = nIndex;
+
+            if (stream.status() == QDataStream::Ok) {
+                memoryMap.listRecords.append(record);
+            }
+        }
+
+        // A truncated section is not used at all
+        bResult = (memoryMap.listRecords.count() == nNumberOfRecords);
+    }
+
+    if (bResult) {
+        *pMemoryMap = memoryMap;
+    }
+
+    return bResult;
+}
+
+bool QHexViewSession::_align()
+{
+    bool bResult = true;
+
+    qint64 nPadding = (8 - (g_pSaveFile->pos() % 8)) % 8;
+
+    if (nPadding) {
+        bResult = (g_pSaveFile->write(QByteArray((qint32)nPadding, 0)) == nPadding);
+    }
+
+    return bResult;
+}
@@ -0,0 +1,122 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef QHEXVIEWSESSION_H
+#define QHEXVIEWSESSION_H
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+#include <QVector>
+
+#include "qhexviewannotations.h"
+#include "xbinary.h"
+
+// Sidecar file of a view: state, annotations and indexes that are expensive to build.
+// Sections are stored as is and 8-aligned; the file is mapped and a section is only touched when it is used.
+// The key (size, modification time and a hash of samples) must match the data, otherwise the file is ignored
+class QHexViewSession {
+public:
+    enum SECTION {
+        SECTION_STATE = 1,
+        SECTION_ANNOTATIONS,
+        SECTION_STRINGS,    // StringsIndex::RECORD array
+        SECTION_MEMORY_MAP  // parsed once, the view does not read the headers again
+    };
+
+    struct KEY {
+        qint64 nSize;
+        qint64 nModified;  // msecs since epoch
+        quint64 nSampleHash;
+    };
+
+    struct STATE {
+        qint64 nCursorOffset;
+        qint64 nSelectionOffset;
+        qint64 nSelectionSize;
+        qint32 nDisplayMode;
+        qint32 nEncoding;
+        qint32 nIsBigEndian;
+        qint32 nReserved;
+    };
+
+    QHexViewSession();
+    ~QHexViewSession();
+
+    bool open(QString sFileName, const KEY &key);  // false if the file is missing or stale
+    void close();
+    bool isOpen();
+    bool getSection(SECTION section, const char **ppData, qint64 *pnSize);  // valid until close()
+
+    // Written to a temporary file, replaces the old one on commit()
+    bool create(QString sFileName, const KEY &key);
+    bool addSection(SECTION section, const QByteArray &baData);
+    QIODevice *beginSection(SECTION section);  // the data is written to the device
+    bool endSection();
+    bool commit();
+
+    static QString getSessionFileName(QString sFileName);
+    static KEY getKey(QString sFileName);
+    static bool isKeyEqual(const KEY &key1, const KEY &key2);
+    static QByteArray stateToData(const STATE &state);
+    static bool dataToState(const char *pData, qint64 nSize, STATE *pState);
+    static QByteArray annotationsToData(const QVector<QHexViewAnnotations::ANNOTATION> &listAnnotations);
+    static QVector<QHexViewAnnotations::ANNOTATION> dataToAnnotations(const char *pData, qint64 nSize);
+    static QByteArray memoryMapToData(const XBinary::_MEMORY_MAP &memoryMap);  // only the fields the view uses
+    static bool dataToMemoryMap(const char *pData, qint64 nSize, XBinary::_MEMORY_MAP *pMemoryMap);
+
+private:
+    struct HEADER {
+        quint32 nMagic;
+        quint32 nVersion;
+        KEY key;
+        qint64 nTableOffset;
+        quint32 nNumberOfSections;
+        quint32 nReserved;
+    };
+
+    struct ENTRY {
+        quint32 nSection;
+        quint32 nReserved;
+        qint64 nOffset;
+        qint64 nSize;
+    };
+
+    bool _align();
+
+    enum {
+        N_MAGIC = 0x51485653,  // QHVS
+        N_VERSION = 1,
+        N_NUMBER_OF_SAMPLES = 16,
+        N_SAMPLE_SIZE = 0x1000
+    };
+
+    QFile g_file;
+    uchar *g_pMap;
+    qint64 g_nMapSize;
+    QVector<ENTRY> g_listEntries;
+
+    QSaveFile *g_pSaveFile;
+    HEADER g_header;
+    ENTRY g_entry;  // the section being written
+    bool g_bWriteError;
+};
+
+#endif  // QHEXVIEWSESSION_H
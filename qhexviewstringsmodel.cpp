@@ -0,0 +1,257 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "qhexviewstringsmodel.h"
+
+QHexViewStringsModel::QHexViewStringsModel(StringsIndex *pIndex, QHexViewDataSource *pDataSource, QObject *pParent) : QAbstractTableModel(pParent)
+{
+    g_pIndex = pIndex;
+    g_pDataSource = pDataSource;
+    g_nRowCount = 0;
+    g_nFilterPosition = 0;
+
+    connect(&g_timerFilter, SIGNAL(timeout()), this, SLOT(filterTimer()));
+}
+
+void QHexViewStringsModel::reset()
+{
+    beginResetModel();
+
+    g_timerFilter.stop();
+    g_nRowCount = 0;
+    g_listFiltered.clear();
+    g_nFilterPosition = 0;
+
+    endResetModel();
+
+    updateCount();
+}
+
+void QHexViewStringsModel::updateCount()
+{
+    if (g_sFilter != "") {
+        if ((g_nFilterPosition < g_pIndex->getCount()) && (!g_timerFilter.isActive())) {
+            g_timerFilter.start(0);
+        }
+    }
+
+    // Only the first page is inserted here, the view pulls the rest with fetchMore
+    if ((g_nRowCount < N_FETCH_SIZE) && (g_nRowCount < getNumberOfAvailable())) {
+        fetchMore(QModelIndex());
+    }
+}
+
+void QHexViewStringsModel::setFilter(QString sFilter)
+{
+    g_sFilter = sFilter;
+
+    reset();
+}
+
+StringsIndex::RECORD QHexViewStringsModel::getRecord(qint32 nRow)
+{
+    return g_pIndex->getRecord(rowToRecord(nRow));
+}
+
+QString QHexViewStringsModel::getString(StringsIndex::RECORD record, qint32 nMaxLength)
+{
+    QString sResult;
+
+    if (g_pDataSource && (record.nOffset != -1)) {
+        qint64 nSize = record.nSize;
+
+        if (record.nType == StringsIndex::ST_ANSI) {
+            nSize = qMin(nSize, (qint64)nMaxLength);
+        } else {
+            nSize = qMin(nSize, (qint64)nMaxLength * 2);
+        }
+
+        QByteArray baData = g_pDataSource->read(record.nOffset, nSize);
+
+        if (record.nType == StringsIndex::ST_ANSI) {
+            sResult = QString::fromLatin1(baData);
+        } else {
+            qint32 nNumberOfChars = baData.size() / 2;
+            const quint8 *pData = (const quint8 *)baData.constData();
+
+            sResult.reserve(nNumberOfChars);
+
+            for (qint32 i = 0; i < nNumberOfChars; i++) {
+                if (record.nType == StringsIndex::ST_UTF16LE) {
+                    sResult.append(QChar(pData[i * 2]));
+                } else {
+                    sResult.append(QChar(pData[i * 2 + 1]));
+                }
+            }
+        }
+    }
+
+    return sResult;
+}
+
+qint64 QHexViewStringsModel::getNumberOfRecords()
+{
+    return getNumberOfAvailable();
+}
+
+int QHexViewStringsModel::rowCount(const QModelIndex &parent) const
+{
+    int nResult = 0;
+
+    if (!parent.isValid()) {
+        nResult = g_nRowCount;
+    }
+
+    return nResult;
+}
+
+int QHexViewStringsModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent)
+
+    return __COLUMN_SIZE;
+}
+
+QVariant QHexViewStringsModel::data(const QModelIndex &index, int nRole) const
+{
+    QVariant result;
+
+    if (index.isValid() && (nRole == Qt::DisplayRole)) {
+        QHexViewStringsModel *_this = const_cast<QHexViewStringsModel *>(this);
+
+        StringsIndex::RECORD record = _this->getRecord(index.row());
+
+        if (record.nOffset != -1) {
+            qint32 nColumn = index.column();
+
+            if (nColumn == COLUMN_OFFSET) {
+                result = QString("%1").arg(record.nOffset, 8, 16, QChar('0'));
+            } else if (nColumn == COLUMN_SIZE) {
+                result = QString("%1").arg(record.nSize, 0, 16);
+            } else if (nColumn == COLUMN_TYPE) {
+                if (record.nType == StringsIndex::ST_ANSI) {
+                    result = QString("A");
+                } else if (record.nType == StringsIndex::ST_UTF16LE) {
+                    result = QString("U");
+                } else if (record.nType == StringsIndex::ST_UTF16BE) {
+                    result = QString("UBE");
+                }
+            } else if (nColumn == COLUMN_STRING) {
+                result = _this->getString(record, N_MAX_LENGTH);
+            }
+        }
+    }
+
+    return result;
+}
+
+QVariant QHexViewStringsModel::headerData(int nSection, Qt::Orientation orientation, int nRole) const
+{
+    QVariant result;
+
+    if ((orientation == Qt::Horizontal) && (nRole == Qt::DisplayRole)) {
+        if (nSection == COLUMN_OFFSET) {
+            result = tr("Offset");
+        } else if (nSection == COLUMN_SIZE) {
+            result = tr("Size");
+        } else if (nSection == COLUMN_TYPE) {
+            result = tr("Type");
+        } else if (nSection == COLUMN_STRING) {
+            result = tr("String");
+        }
+    }
+
+    return result;
+}
+
+bool QHexViewStringsModel::canFetchMore(const QModelIndex &parent) const
+{
+    bool bResult = false;
+
+    if (!parent.isValid()) {
+        bResult = (g_nRowCount < getNumberOfAvailable());
+    }
+
+    return bResult;
+}
+
+void QHexViewStringsModel::fetchMore(const QModelIndex &parent)
+{
+    if (!parent.isValid()) {
+        qint64 nAvailable = qMin(getNumberOfAvailable(), (qint64)INT_MAX);
+        qint32 nCount = (qint32)qMin(nAvailable - g_nRowCount, (qint64)N_FETCH_SIZE);
+
+        if (nCount > 0) {
+            beginInsertRows(QModelIndex(), g_nRowCount, g_nRowCount + nCount - 1);
+            g_nRowCount += nCount;
+            endInsertRows();
+        }
+    }
+}
+
+void QHexViewStringsModel::filterTimer()
+{
+    // The filter runs in slices on the GUI thread, so the device is never read from two threads
+    qint64 nCount = qMin(g_pIndex->getCount(), g_nFilterPosition + N_FILTER_SIZE);
+
+    for (; g_nFilterPosition < nCount; g_nFilterPosition++) {
+        StringsIndex::RECORD record = g_pIndex->getRecord(g_nFilterPosition);
+
+        if (getString(record, record.nSize).contains(g_sFilter, Qt::CaseInsensitive)) {
+            g_listFiltered.append(g_nFilterPosition);
+        }
+    }
+
+    if (g_nFilterPosition >= g_pIndex->getCount()) {
+        g_timerFilter.stop();
+    }
+
+    if ((g_nRowCount < N_FETCH_SIZE) && (g_nRowCount < getNumberOfAvailable())) {
+        fetchMore(QModelIndex());
+    }
+}
+
+qint64 QHexViewStringsModel::getNumberOfAvailable() const
+{
+    qint64 nResult = 0;
+
+    if (g_sFilter != "") {
+        nResult = g_listFiltered.count();
+    } else {
+        nResult = g_pIndex->getCount();
+    }
+
+    return nResult;
+}
+
+qint64 QHexViewStringsModel::rowToRecord(qint32 nRow) const
+{
+    qint64 nResult = nRow;
+
+    if (g_sFilter != "") {
+        nResult = -1;
+
+        if (nRow < g_listFiltered.count()) {
+            nResult = g_listFiltered.at(nRow);
+        }
+    }
+
+    return nResult;
+}
@@ -0,0 +1,77 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef QHEXVIEWSTRINGSMODEL_H
+#define QHEXVIEWSTRINGSMODEL_H
+
+#include <QAbstractTableModel>
+#include <QTimer>
+
+#include "qhexviewdatasource.h"
+#include "stringsindex.h"
+
+class QHexViewStringsModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    enum COLUMN {
+        COLUMN_OFFSET = 0,
+        COLUMN_SIZE,
+        COLUMN_TYPE,
+        COLUMN_STRING,
+        __COLUMN_SIZE
+    };
+
+    explicit QHexViewStringsModel(StringsIndex *pIndex, QHexViewDataSource *pDataSource, QObject *pParent = nullptr);
+    void reset();
+    void updateCount();
+    void setFilter(QString sFilter);
+    StringsIndex::RECORD getRecord(qint32 nRow);
+    QString getString(StringsIndex::RECORD record, qint32 nMaxLength);
+    qint64 getNumberOfRecords();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int nRole = Qt::DisplayRole) const override;
+    QVariant headerData(int nSection, Qt::Orientation orientation, int nRole = Qt::DisplayRole) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+private slots:
+    void filterTimer();
+
+private:
+    qint64 getNumberOfAvailable() const;
+    qint64 rowToRecord(qint32 nRow) const;
+
+    const qint32 N_FETCH_SIZE = 10000;
+    const qint32 N_FILTER_SIZE = 5000;
+    const qint32 N_MAX_LENGTH = 256;
+
+    StringsIndex *g_pIndex;
+    QHexViewDataSource *g_pDataSource;
+    qint32 g_nRowCount;
+    QString g_sFilter;
+    QVector<qint64> g_listFiltered;
+    qint64 g_nFilterPosition;
+    QTimer g_timerFilter;
+};
+
+#endif  // QHEXVIEWSTRINGSMODEL_H
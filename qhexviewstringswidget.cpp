@@ -0,0 +1,212 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "qhexviewstringswidget.h"
+
+#include "ui_qhexviewstringswidget.h"
+
+QHexViewStringsWidget::QHexViewStringsWidget(QWidget *pParent) : QWidget(pParent), ui(new Ui::QHexViewStringsWidget)
+{
+    ui->setupUi(this);
+
+    g_pDataSource = nullptr;
+    g_pModel = nullptr;
+    g_pProcess = nullptr;
+    g_pThread = nullptr;
+    g_bIndexComplete = false;
+    g_bDataChanged = false;
+    g_nIndexSize = 0;
+
+    ui->tableViewStrings->horizontalHeader()->setStretchLastSection(true);
+    ui->tableViewStrings->verticalHeader()->setVisible(false);
+
+    connect(&g_timer, SIGNAL(timeout()), this, SLOT(timerSlot()));
+}
+
+QHexViewStringsWidget::~QHexViewStringsWidget()
+{
+    stop();
+
+    delete ui;
+}
+
+void QHexViewStringsWidget::setData(QHexViewDataSource *pDataSource)
+{
+    stop();
+
+    if (g_pDataSource) {
+        disconnect(g_pDataSource, SIGNAL(dataChanged(qint64, qint64)), this, SLOT(_dataChanged()));
+        disconnect(g_pDataSource, SIGNAL(dataReset()), this, SLOT(_dataChanged()));
+    }
+
+    g_pDataSource = pDataSource;
+
+    if (g_pDataSource) {
+        connect(g_pDataSource, SIGNAL(dataChanged(qint64, qint64)), this, SLOT(_dataChanged()));
+        connect(g_pDataSource, SIGNAL(dataReset()), this, SLOT(_dataChanged()));
+    }
+
+    QHexViewStringsModel *pOldModel = g_pModel;
+
+    g_index.close();
+    g_bIndexComplete = false;
+    g_pModel = new QHexViewStringsModel(&g_index, pDataSource, this);
+    g_pModel->setFilter(ui->lineEditFilter->text());
+
+    ui->tableViewStrings->setModel(g_pModel);
+
+    delete pOldModel;
+}
+
+void QHexViewStringsWidget::stop()
+{
+    if (g_pThread) {
+        g_pProcess->stop();
+
+        g_pThread->quit();
+        g_pThread->wait();
+
+        delete g_pThread;
+        delete g_pProcess;
+
+        g_pThread = nullptr;
+        g_pProcess = nullptr;
+    }
+
+    g_timer.stop();
+
+    ui->pushButtonScan->setText(tr("Scan"));
+}
+
+bool QHexViewStringsWidget::isIndexComplete()
+{
+    // Grown in follow mode: no signal, the size tells
+    return g_bIndexComplete && (!g_bDataChanged) && g_pDataSource && (g_pDataSource->getSize() == g_nIndexSize);
+}
+
+void QHexViewStringsWidget::setIndexData(const char *pData, qint64 nSize)
+{
+    if (g_pModel && (!g_pThread)) {
+        g_index.setData((const StringsIndex::RECORD *)pData, nSize / (qint64)sizeof(StringsIndex::RECORD));
+        g_bIndexComplete = true;
+        g_bDataChanged = false;
+        g_nIndexSize = g_pDataSource ? g_pDataSource->getSize() : 0;
+
+        g_pModel->reset();
+
+        timerSlot();
+    }
+}
+
+bool QHexViewStringsWidget::saveIndex(QIODevice *pDevice)
+{
+    bool bResult = false;
+
+    if (isIndexComplete()) {
+        bResult = g_index.save(pDevice);
+    }
+
+    return bResult;
+}
+
+void QHexViewStringsWidget::on_pushButtonScan_clicked()
+{
+    if (g_pThread) {
+        stop();
+    } else if (g_pDataSource && g_pModel) {
+        g_index.clear();
+        g_bIndexComplete = false;
+        g_bDataChanged = false;
+        g_nIndexSize = g_pDataSource->getSize();
+        g_pModel->reset();
+
+        StringsProcess::OPTIONS options = {};
+        options.nMinLength = ui->spinBoxMinLength->value();
+        options.bAnsi = ui->checkBoxAnsi->isChecked();
+        options.bUTF16LE = ui->checkBoxUTF16LE->isChecked();
+        options.bUTF16BE = ui->checkBoxUTF16BE->isChecked();
+
+        g_pProcess = new StringsProcess;
+        g_pProcess->setData(g_pDataSource, options, &g_index);
+
+        g_pThread = new QThread;
+        g_pProcess->moveToThread(g_pThread);
+
+        connect(g_pThread, SIGNAL(started()), g_pProcess, SLOT(process()));
+        connect(g_pProcess, SIGNAL(completed(qint64)), this, SLOT(onCompleted(qint64)));
+
+        ui->pushButtonScan->setText(tr("Stop"));
+
+        g_pThread->start();
+        g_timer.start(N_REFRESH_INTERVAL);
+    }
+}
+
+void QHexViewStringsWidget::on_lineEditFilter_textChanged(const QString &sText)
+{
+    if (g_pModel) {
+        g_pModel->setFilter(sText);
+    }
+}
+
+void QHexViewStringsWidget::on_tableViewStrings_clicked(const QModelIndex &index)
+{
+    if (g_pModel && index.isValid()) {
+        StringsIndex::RECORD record = g_pModel->getRecord(index.row());
+
+        if (record.nOffset != -1) {
+            emit selectionRequested(record.nOffset, record.nSize);
+        }
+    }
+}
+
+void QHexViewStringsWidget::onCompleted(qint64 nElapsed)
+{
+    Q_UNUSED(nElapsed)
+
+    g_bIndexComplete = g_pProcess && g_pProcess->isSuccess() && (!g_pProcess->isStopped());
+
+    timerSlot();
+    stop();
+}
+
+void QHexViewStringsWidget::_dataChanged()
+{
+    g_bDataChanged = true;
+}
+
+void QHexViewStringsWidget::timerSlot()
+{
+    if (g_pModel) {
+        g_pModel->updateCount();
+
+        QString sStatus = QString("%1").arg(g_index.getCount());
+
+        if (g_pProcess) {
+            HexProcess::STATS stats = g_pProcess->getCurrentStats();
+
+            if (stats.nTotal) {
+                sStatus += QString(" (%1%)").arg((stats.nCurrent * 100) / stats.nTotal);
+            }
+        }
+
+        ui->labelStatus->setText(sStatus);
+    }
+}
@@ -0,0 +1,74 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef QHEXVIEWSTRINGSWIDGET_H
+#define QHEXVIEWSTRINGSWIDGET_H
+
+#include <QHeaderView>
+#include <QThread>
+#include <QTimer>
+#include <QWidget>
+
+#include "qhexviewstringsmodel.h"
+#include "stringsprocess.h"
+
+namespace Ui {
+class QHexViewStringsWidget;
+}
+
+class QHexViewStringsWidget : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit QHexViewStringsWidget(QWidget *pParent = nullptr);
+    ~QHexViewStringsWidget();
+    void setData(QHexViewDataSource *pDataSource);
+    void stop();
+    bool isIndexComplete();  // a scan ran to the end and the data did not change after it
+    void setIndexData(const char *pData, qint64 nSize);  // records of a session, kept by the caller
+    bool saveIndex(QIODevice *pDevice);
+
+signals:
+    void selectionRequested(qint64 nOffset, qint64 nSize);
+
+private slots:
+    void on_pushButtonScan_clicked();
+    void on_lineEditFilter_textChanged(const QString &sText);
+    void on_tableViewStrings_clicked(const QModelIndex &index);
+    void onCompleted(qint64 nElapsed);
+    void timerSlot();
+    void _dataChanged();
+
+private:
+    const qint32 N_REFRESH_INTERVAL = 300;  // ms between the updates of the list while scanning
+
+    Ui::QHexViewStringsWidget *ui;
+    QHexViewDataSource *g_pDataSource;
+    StringsIndex g_index;
+    bool g_bIndexComplete;
+    bool g_bDataChanged;  // written or reset since the scan started
+    qint64 g_nIndexSize;  // of the data the index was built for
+    QHexViewStringsModel *g_pModel;
+    StringsProcess *g_pProcess;
+    QThread *g_pThread;
+    QTimer g_timer;
+};
+
+#endif  // QHEXVIEWSTRINGSWIDGET_H
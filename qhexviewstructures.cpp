@@ -0,0 +1,440 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "qhexviewstructures.h"
+
+#include <QRegularExpression>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+QHexViewStructures::QHexViewStructures(QObject *pParent) : QObject(pParent)
+{
+}
+
+bool QHexViewStructures::parseTemplates(const QString &sText, QList<STRUCT> *pListStructs, QString *psError)
+{
+    bool bResult = true;
+    QString sError;
+
+    QString sSource = sText;
+    sSource.remove(QRegularExpression("/\\*.*?\\*/", QRegularExpression::DotMatchesEverythingOption));
+    sSource.remove(QRegularExpression("//[^\\n]*"));
+
+    QRegularExpression reStruct("struct\\s+(\\w+)\\s*\\{([^}]*)\\}\\s*;");
+    QRegularExpression reDeclaration("^(.+?)\\s+(\\w+)\\s*(?:\\[\\s*(\\w+)\\s*\\])?$");
+
+    QRegularExpressionMatchIterator iter = reStruct.globalMatch(sSource);
+
+    while (bResult && iter.hasNext()) {
+        QRegularExpressionMatch matchStruct = iter.next();
+
+        STRUCT structure = {};
+        structure.sName = matchStruct.captured(1);
+
+        QStringList listDeclarations = matchStruct.captured(2).split(";");
+        qint32 nNumberOfDeclarations = listDeclarations.count();
+
+        for (qint32 i = 0; bResult && (i < nNumberOfDeclarations); i++) {
+            QString sDeclaration = listDeclarations.at(i).simplified();
+
+            if (sDeclaration.isEmpty()) {
+                continue;
+            }
+
+            QRegularExpressionMatch match = reDeclaration.match(sDeclaration);
+
+            if (!match.hasMatch()) {
+                sError = QString("%1: %2").arg(tr("Invalid declaration"), sDeclaration);
+                bResult = false;
+                break;
+            }
+
+            QString sType = match.captured(1);
+            QString sName = match.captured(2);
+            qint32 nCount = 1;
+
+            if (match.captured(3) != "") {
+                bool bOK = false;
+                nCount = match.captured(3).toInt(&bOK, 0);
+
+                if ((!bOK) || (nCount <= 0)) {
+                    sError = QString("%1: %2").arg(tr("Invalid array size"), sDeclaration);
+                    bResult = false;
+                    break;
+                }
+            }
+
+            FT type = FT_CHAR;
+
+            if (_getType(sType, &type)) {
+                if ((qint64)structure.nSize + (qint64)getTypeSize(type) * nCount > N_MAX_STRUCT_SIZE) {
+                    sError = QString("%1: %2").arg(tr("Structure is too large"), sDeclaration);
+                    bResult = false;
+                    break;
+                }
+
+                FIELD field = {};
+                field.sName = sName;
+                field.type = type;
+                field.nOffset = structure.nSize;
+                field.nCount = nCount;
+
+                structure.listFields.append(field);
+                structure.nSize += (qint32)(getTypeSize(type) * nCount);
+            } else {
+                // A structure defined before, its fields are copied with the name as prefix
+                const STRUCT *pNested = nullptr;
+                qint32 nNumberOfStructs = pListStructs->count();
+
+                for (qint32 j = 0; j < nNumberOfStructs; j++) {
+                    if (pListStructs->at(j).sName == sType) {
+                        pNested = &(pListStructs->at(j));
+                        break;
+                    }
+                }
+
+                if (!pNested) {
+                    sError = QString("%1: %2").arg(tr("Unknown type"), sType);
+                    bResult = false;
+                    break;
+                }
+
+                qint32 nNumberOfFields = pNested->listFields.count();
+
+                if ((qint64)nNumberOfFields * nCount > 0x10000) {
+                    sError = QString("%1: %2").arg(tr("Too many fields"), sDeclaration);
+                    bResult = false;
+                    break;
+                }
+
+                if ((qint64)structure.nSize + (qint64)pNested->nSize * nCount > N_MAX_STRUCT_SIZE) {
+                    sError = QString("%1: %2").arg(tr("Structure is too large"), sDeclaration);
+                    bResult = false;
+                    break;
+                }
+
+                for (qint32 j = 0; j < nCount; j++) {
+                    QString sPrefix = (nCount > 1) ? QString("%1[%2].").arg(sName).arg(j) : QString("%1.").arg(sName);
+
+                    for (qint32 k = 0; k < nNumberOfFields; k++) {
+                        FIELD field = pNested->listFields.at(k);
+                        field.sName = sPrefix + field.sName;
+                        field.nOffset += structure.nSize;
+
+                        structure.listFields.append(field);
+                    }
+
+                    structure.nSize += pNested->nSize;
+                }
+            }
+        }
+
+        if (bResult) {
+            pListStructs->append(structure);
+        }
+    }
+
+    if (bResult && pListStructs->isEmpty()) {
+        sError = tr("No structures");
+        bResult = false;
+    }
+
+    if (psError) {
+        *psError = sError;
+    }
+
+    return bResult;
+}
+
+qint32 QHexViewStructures::getTypeSize(FT type)
+{
+    qint32 nResult = 1;
+
+    switch (type) {
+        case FT_CHAR:
+        case FT_INT8:
+        case FT_UINT8: nResult = 1; break;
+        case FT_INT16:
+        case FT_UINT16: nResult = 2; break;
+        case FT_INT32:
+        case FT_UINT32:
+        case FT_FLOAT: nResult = 4; break;
+        case FT_INT64:
+        case FT_UINT64:
+        case FT_DOUBLE: nResult = 8; break;
+    }
+
+    return nResult;
+}
+
+QString QHexViewStructures::typeToString(FT type)
+{
+    QString sResult;
+
+    switch (type) {
+        case FT_CHAR: sResult = QString("char"); break;
+        case FT_INT8: sResult = QString("int8"); break;
+        case FT_UINT8: sResult = QString("uint8"); break;
+        case FT_INT16: sResult = QString("int16"); break;
+        case FT_UINT16: sResult = QString("uint16"); break;
+        case FT_INT32: sResult = QString("int32"); break;
+        case FT_UINT32: sResult = QString("uint32"); break;
+        case FT_INT64: sResult = QString("int64"); break;
+        case FT_UINT64: sResult = QString("uint64"); break;
+        case FT_FLOAT: sResult = QString("float"); break;
+        case FT_DOUBLE: sResult = QString("double"); break;
+    }
+
+    return sResult;
+}
+
+template <typename T>
+static T _readValue(const char *pData, bool bIsBigEndian)
+{
+    return bIsBigEndian ? qFromBigEndian<T>(pData) : qFromLittleEndian<T>(pData);
+}
+
+QString QHexViewStructures::valueToString(const FIELD &field, const QByteArray &baData, bool bIsBigEndian)
+{
+    QString sResult;
+
+    if (field.type == FT_CHAR) {
+        for (qint32 i = 0; i < baData.size(); i++) {
+            char cChar = baData.at(i);
+
+            if (cChar == 0) {
+                break;
+            }
+
+            sResult += ((cChar >= 0x20) && (cChar < 0x7F)) ? QChar(cChar) : QChar('.');
+        }
+
+        sResult = QString("\"%1\"").arg(sResult);
+    } else {
+        qint32 nTypeSize = getTypeSize(field.type);
+        qint32 nNumberOfValues = qMin(baData.size() / nTypeSize, 8);
+        QStringList listValues;
+
+        for (qint32 i = 0; i < nNumberOfValues; i++) {
+            const char *pData = baData.constData() + i * nTypeSize;
+            QString sValue;
+
+            switch (field.type) {
+                case FT_INT8: sValue = QString::number((qint8)pData[0]); break;
+                case FT_UINT8: sValue = QString("%1 (0x%2)").arg((quint8)pData[0]).arg((quint8)pData[0], 2, 16, QChar('0')); break;
+                case FT_INT16: sValue = QString::number(_readValue<qint16>(pData, bIsBigEndian)); break;
+                case FT_UINT16: {
+                    quint16 nValue = _readValue<quint16>(pData, bIsBigEndian);
+                    sValue = QString("%1 (0x%2)").arg(nValue).arg(nValue, 4, 16, QChar('0'));
+                    break;
+                }
+                case FT_INT32: sValue = QString::number(_readValue<qint32>(pData, bIsBigEndian)); break;
+                case FT_UINT32: {
+                    quint32 nValue = _readValue<quint32>(pData, bIsBigEndian);
+                    sValue = QString("%1 (0x%2)").arg(nValue).arg(nValue, 8, 16, QChar('0'));
+                    break;
+                }
+                case FT_INT64: sValue = QString::number(_readValue<qint64>(pData, bIsBigEndian)); break;
+                case FT_UINT64: {
+                    quint64 nValue = _readValue<quint64>(pData, bIsBigEndian);
+                    sValue = QString("%1 (0x%2)").arg(nValue).arg(nValue, 16, 16, QChar('0'));
+                    break;
+                }
+                case FT_FLOAT: {
+                    quint32 nValue = _readValue<quint32>(pData, bIsBigEndian);
+                    float fValue = 0;
+                    memcpy(&fValue, &nValue, sizeof(fValue));
+                    sValue = QString::number(fValue);
+                    break;
+                }
+                case FT_DOUBLE: {
+                    quint64 nValue = _readValue<quint64>(pData, bIsBigEndian);
+                    double dValue = 0;
+                    memcpy(&dValue, &nValue, sizeof(dValue));
+                    sValue = QString::number(dValue);
+                    break;
+                }
+                default: break;
+            }
+
+            listValues.append(sValue);
+        }
+
+        sResult = listValues.join(", ");
+
+        if (field.nCount > nNumberOfValues) {
+            sResult += ", ...";
+        }
+    }
+
+    return sResult;
+}
+
+void QHexViewStructures::addRecord(const STRUCT &structure, qint64 nOffset, qint64 nCount)
+{
+    // The end of the last element must fit in qint64
+    if ((structure.nSize > 0) && (nOffset >= 0) && (nCount > 0) && (nCount <= (std::numeric_limits<qint64>::max() - nOffset) / structure.nSize)) {
+        RECORD record = {};
+        record.nOffset = nOffset;
+        record.nCount = nCount;
+        record.structure = structure;
+
+        QVector<RECORD>::iterator iter =
+            std::upper_bound(g_listRecords.begin(), g_listRecords.end(), nOffset, [](qint64 nValue, const RECORD &record) { return nValue < record.nOffset; });
+
+        g_listRecords.insert(iter, record);
+    }
+}
+
+void QHexViewStructures::clear()
+{
+    g_listRecords.clear();
+}
+
+bool QHexViewStructures::isEmpty()
+{
+    return g_listRecords.isEmpty();
+}
+
+QVector<QHexViewStructures::SPAN> QHexViewStructures::getSpans(qint64 nOffset, qint64 nSize)
+{
+    QVector<SPAN> listResult;
+
+    qint64 nEnd = nOffset + nSize;
+    qint32 nNumberOfRecords = g_listRecords.count();
+
+    // Ordered by offset, the records after the range are not looked at
+    for (qint32 i = 0; (i < nNumberOfRecords) && (g_listRecords.at(i).nOffset < nEnd); i++) {
+        const RECORD *pRecord = &(g_listRecords.at(i));
+        qint64 nStructSize = pRecord->structure.nSize;
+
+        if (pRecord->nOffset + pRecord->nCount * nStructSize <= nOffset) {
+            continue;
+        }
+
+        // Only the elements in the range
+        qint64 nFirst = qMax((qint64)0, (nOffset - pRecord->nOffset) / nStructSize);
+        qint64 nLast = qMin(pRecord->nCount - 1, (nEnd - 1 - pRecord->nOffset) / nStructSize);
+        qint32 nNumberOfFields = pRecord->structure.listFields.count();
+
+        for (qint64 j = nFirst; j <= nLast; j++) {
+            qint64 nBase = pRecord->nOffset + j * nStructSize;
+
+            for (qint32 k = 0; k < nNumberOfFields; k++) {
+                const FIELD *pField = &(pRecord->structure.listFields.at(k));
+
+                SPAN span = {};
+                span.nOffset = nBase + pField->nOffset;
+                span.nSize = (qint64)getTypeSize(pField->type) * pField->nCount;
+                span.nRecord = i;
+                span.nIndex = j;
+                span.nField = k;
+
+                if ((span.nOffset < nEnd) && (span.nOffset + span.nSize > nOffset)) {
+                    listResult.append(span);
+                }
+            }
+        }
+    }
+
+    return listResult;
+}
+
+bool QHexViewStructures::getSpan(qint64 nOffset, SPAN *pSpan)
+{
+    bool bResult = false;
+
+    QVector<SPAN> listSpans = getSpans(nOffset, 1);
+
+    if (listSpans.count()) {
+        // The last attached record is on top
+        *pSpan = listSpans.last();
+        bResult = true;
+    }
+
+    return bResult;
+}
+
+QString QHexViewStructures::getSpanName(const SPAN &span)
+{
+    QString sResult;
+
+    if ((span.nRecord >= 0) && (span.nRecord < g_listRecords.count())) {
+        const RECORD *pRecord = &(g_listRecords.at(span.nRecord));
+
+        sResult = pRecord->structure.sName;
+
+        if (pRecord->nCount > 1) {
+            sResult += QString("[%1]").arg(span.nIndex);
+        }
+
+        sResult += QString(".%1").arg(pRecord->structure.listFields.at(span.nField).sName);
+    }
+
+    return sResult;
+}
+
+QHexViewStructures::FIELD QHexViewStructures::getField(const SPAN &span)
+{
+    FIELD result = {};
+
+    if ((span.nRecord >= 0) && (span.nRecord < g_listRecords.count())) {
+        result = g_listRecords.at(span.nRecord).structure.listFields.at(span.nField);
+    }
+
+    return result;
+}
+
+bool QHexViewStructures::_getType(const QString &sType, FT *pType)
+{
+    bool bResult = true;
+
+    if ((sType == "char") || (sType == "CHAR")) {
+        *pType = FT_CHAR;
+    } else if ((sType == "int8") || (sType == "int8_t") || (sType == "signed char")) {
+        *pType = FT_INT8;
+    } else if ((sType == "uint8") || (sType == "uint8_t") || (sType == "unsigned char") || (sType == "BYTE")) {
+        *pType = FT_UINT8;
+    } else if ((sType == "int16") || (sType == "int16_t") || (sType == "short") || (sType == "SHORT")) {
+        *pType = FT_INT16;
+    } else if ((sType == "uint16") || (sType == "uint16_t") || (sType == "unsigned short") || (sType == "WORD") || (sType == "USHORT")) {
+        *pType = FT_UINT16;
+    } else if ((sType == "int32") || (sType == "int32_t") || (sType == "int") || (sType == "LONG") || (sType == "INT")) {
+        *pType = FT_INT32;
+    } else if ((sType == "uint32") || (sType == "uint32_t") || (sType == "unsigned int") || (sType == "unsigned") || (sType == "DWORD") ||
+               (sType == "ULONG") || (sType == "UINT")) {
+        *pType = FT_UINT32;
+    } else if ((sType == "int64") || (sType == "int64_t") || (sType == "long long") || (sType == "LONGLONG")) {
+        *pType = FT_INT64;
+    } else if ((sType == "uint64") || (sType == "uint64_t") || (sType == "unsigned long long") || (sType == "QWORD") || (sType == "ULONGLONG")) {
+        *pType = FT_UINT64;
+    } else if (sType == "float") {
+        *pType = FT_FLOAT;
+    } else if (sType == "double") {
+        *pType = FT_DOUBLE;
+    } else {
+        bResult = false;
+    }
+
+    return bResult;
+}
@@ -0,0 +1,102 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef QHEXVIEWSTRUCTURES_H
+#define QHEXVIEWSTRUCTURES_H
+
+#include <QList>
+#include <QObject>
+#include <QVector>
+
+// Structures attached at offsets. Nothing is decoded until a range is asked for: arrays are not expanded,
+// the elements in the range are found by their index
+class QHexViewStructures : public QObject {
+    Q_OBJECT
+
+public:
+    enum FT {
+        FT_CHAR = 0,
+        FT_INT8,
+        FT_UINT8,
+        FT_INT16,
+        FT_UINT16,
+        FT_INT32,
+        FT_UINT32,
+        FT_INT64,
+        FT_UINT64,
+        FT_FLOAT,
+        FT_DOUBLE
+    };
+
+    struct FIELD {
+        QString sName;  // "a.b" for the fields of nested structures
+        FT type;
+        qint32 nOffset;
+        qint32 nCount;  // array elements
+    };
+
+    // Packed, as in file formats
+    struct STRUCT {
+        QString sName;
+        qint32 nSize;
+        QList<FIELD> listFields;  // ordered by offset
+    };
+
+    struct SPAN {
+        qint64 nOffset;
+        qint64 nSize;
+        qint32 nRecord;
+        qint64 nIndex;  // element of an array
+        qint32 nField;
+    };
+
+    explicit QHexViewStructures(QObject *pParent = nullptr);
+
+    // struct NAME { TYPE name; TYPE name[N]; OTHERSTRUCT name; }; with C comments
+    static bool parseTemplates(const QString &sText, QList<STRUCT> *pListStructs, QString *psError = nullptr);
+    static qint32 getTypeSize(FT type);
+    static QString typeToString(FT type);
+    static QString valueToString(const FIELD &field, const QByteArray &baData, bool bIsBigEndian);
+
+    void addRecord(const STRUCT &structure, qint64 nOffset, qint64 nCount = 1);
+    void clear();
+    bool isEmpty();
+    QVector<SPAN> getSpans(qint64 nOffset, qint64 nSize);
+    bool getSpan(qint64 nOffset, SPAN *pSpan);
+    QString getSpanName(const SPAN &span);
+    FIELD getField(const SPAN &span);
+
+private:
+    enum {
+        N_MAX_STRUCT_SIZE = 0x10000000  // larger templates are rejected, the sizes and offsets stay in qint32
+    };
+
+    struct RECORD {
+        qint64 nOffset;
+        qint64 nCount;
+        STRUCT structure;
+    };
+
+    static bool _getType(const QString &sType, FT *pType);
+
+    QVector<RECORD> g_listRecords;  // ordered by offset
+};
+
+#endif  // QHEXVIEWSTRUCTURES_H
@@ -0,0 +1,432 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "qhexviewtransformdatasource.h"
+
+#include <algorithm>
+
+#ifdef Q_PROCESSOR_X86_64
+#include <emmintrin.h>
+#endif
+
+static const qint8 *_getDecodeTable(QHexViewTransformDataSource::TT type)
+{
+    // -1 for characters that are skipped: whitespace, line breaks, padding
+    static const QVector<qint8> listBase64 = []() {
+        QVector<qint8> listResult(256, -1);
+        const char *pszAlphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+        for (qint32 i = 0; i < 64; i++) {
+            listResult[(quint8)pszAlphabet[i]] = (qint8)i;
+        }
+
+        // URL-safe variant
+        listResult['-'] = 62;
+        listResult['_'] = 63;
+
+        return listResult;
+    }();
+
+    static const QVector<qint8> listHex = []() {
+        QVector<qint8> listResult(256, -1);
+
+        for (qint32 i = 0; i < 10; i++) {
+            listResult['0' + i] = (qint8)i;
+        }
+
+        for (qint32 i = 0; i < 6; i++) {
+            listResult['a' + i] = (qint8)(10 + i);
+            listResult['A' + i] = (qint8)(10 + i);
+        }
+
+        return listResult;
+    }();
+
+    return (type == QHexViewTransformDataSource::TT_BASE64) ? listBase64.constData() : listHex.constData();
+}
+
+QHexViewTransformDataSource::QHexViewTransformDataSource(QHexViewDataSource *pSource, qint64 nOffset, qint64 nSize, const TRANSFORM &transform, QObject *pParent)
+    : QHexViewDataSource(pParent)
+{
+    g_pSource = pSource;
+    g_nOffset = nOffset;
+    g_nSize = nSize;
+    g_nOutSize = nSize;
+    g_transform = transform;
+    g_cacheBlocks.setMaxCost(N_CACHE_SIZE);
+
+    // The input is not scanned here, the size is known with the index
+    if (isDecode(g_transform.type)) {
+        g_nOutSize = 0;
+    }
+}
+
+qint64 QHexViewTransformDataSource::getSize()
+{
+    QMutexLocker locker(&g_mutex);
+
+    return g_nOutSize;
+}
+
+void QHexViewTransformDataSource::setIndex(const QVector<qint64> &listChunkChars)
+{
+    QMutexLocker locker(&g_mutex);
+
+    if (isDecode(g_transform.type) && listChunkChars.count()) {
+        g_listChunkChars = listChunkChars;
+        g_cacheBlocks.clear();
+
+        qint64 nNumberOfChars = g_listChunkChars.last();
+
+        if (g_transform.type == TT_BASE64) {
+            g_nOutSize = (nNumberOfChars * 3) / 4;
+        } else {
+            g_nOutSize = nNumberOfChars / 2;
+        }
+    }
+}
+
+qint64 QHexViewTransformDataSource::readAt(qint64 nOffset, char *pBuffer, qint64 nSize)
+{
+    QMutexLocker locker(&g_mutex);
+
+    qint64 nResult = -1;
+
+    if ((nOffset >= 0) && (nOffset <= g_nOutSize)) {
+        nResult = 0;
+        nSize = qMin(nSize, g_nOutSize - nOffset);
+
+        while (nResult < nSize) {
+            qint64 nCurrent = nOffset + nResult;
+            qint64 nBlockOffset = (nCurrent / N_BLOCK_SIZE) * N_BLOCK_SIZE;
+
+            QByteArray *pBlock = g_cacheBlocks.object(nBlockOffset);
+
+            if (!pBlock) {
+                qint64 nBlockSize = qMin(N_BLOCK_SIZE, g_nOutSize - nBlockOffset);
+
+                QByteArray baBlock;
+
+                if (isDecode(g_transform.type)) {
+                    baBlock = _decodeBlock(nBlockOffset, nBlockSize);
+                } else {
+                    baBlock = _transformBlock(nBlockOffset, nBlockSize);
+                }
+
+                if (baBlock.size() != nBlockSize) {
+                    break;
+                }
+
+                pBlock = new QByteArray(baBlock);
+                g_cacheBlocks.insert(nBlockOffset, pBlock);
+            }
+
+            qint64 nDelta = nCurrent - nBlockOffset;
+            qint64 nCopySize = qMin(nSize - nResult, pBlock->size() - nDelta);
+
+            memcpy(pBuffer + nResult, pBlock->constData() + nDelta, (size_t)nCopySize);
+
+            nResult += nCopySize;
+        }
+
+        if ((nResult == 0) && (nSize > 0)) {
+            nResult = -1;
+        }
+    }
+
+    return nResult;
+}
+
+bool QHexViewTransformDataSource::isDecode(TT type)
+{
+    return (type == TT_BASE64) || (type == TT_HEX);
+}
+
+qint64 QHexViewTransformDataSource::countChars(const char *pData, qint64 nSize, TT type)
+{
+    qint64 nResult = 0;
+
+    const qint8 *pTable = _getDecodeTable(type);
+
+    for (qint64 i = 0; i < nSize; i++) {
+        if (pTable[(quint8)pData[i]] != -1) {
+            nResult++;
+        }
+    }
+
+    return nResult;
+}
+
+bool QHexViewTransformDataSource::isFullRange(QHexViewDataSource *pSource, qint64 nOffset, qint64 nSize)
+{
+    return (nOffset == 0) && (nSize == pSource->getSize());
+}
+
+bool QHexViewTransformDataSource::parseTransforms(QString sText, QList<TRANSFORM> *pListTransforms)
+{
+    bool bResult = true;
+
+    pListTransforms->clear();
+
+    // xor:4142 xor:"key" add:n sub:n rol:n ror:n base64 hex inflate, separated by commas
+    QStringList listItems = sText.split(",");
+
+    for (qint32 i = 0; (i < listItems.count()) && bResult; i++) {
+        QString sItem = listItems.at(i).trimmed();
+
+        if (sItem == "") {
+            continue;
+        }
+
+        QString sName = sItem.section(":", 0, 0).trimmed().toLower();
+        QString sArgument = sItem.section(":", 1).trimmed();
+
+        TRANSFORM transform = {};
+        bool bValid = true;
+
+        if (sName == "xor") {
+            transform.type = TT_XOR;
+
+            if ((sArgument.size() >= 2) && sArgument.startsWith("\"") && sArgument.endsWith("\"")) {
+                transform.baKey = sArgument.mid(1, sArgument.size() - 2).toUtf8();
+            } else {
+                transform.baKey = QByteArray::fromHex(sArgument.toLatin1());
+            }
+
+            bValid = (transform.baKey.size() > 0);
+        } else if ((sName == "add") || (sName == "sub")) {
+            transform.type = TT_ADD;
+            transform.nValue = sArgument.toInt(&bValid, 0);
+
+            if (sName == "sub") {
+                transform.nValue = -transform.nValue;
+            }
+
+            transform.nValue &= 0xFF;
+        } else if ((sName == "rol") || (sName == "ror")) {
+            transform.type = TT_ROL;
+            transform.nValue = sArgument.toInt(&bValid, 0) & 7;
+
+            if (sName == "ror") {
+                transform.nValue = (8 - transform.nValue) & 7;
+            }
+        } else if (sName == "base64") {
+            transform.type = TT_BASE64;
+        } else if (sName == "hex") {
+            transform.type = TT_HEX;
+        } else if (sName == "inflate") {
+            transform.type = TT_INFLATE;
+        } else {
+            bValid = false;
+        }
+
+        if (bValid) {
+            pListTransforms->append(transform);
+        } else {
+            bResult = false;
+        }
+    }
+
+    return bResult && pListTransforms->count();
+}
+
+void QHexViewTransformDataSource::xorKey(char *pData, qint64 nSize, const char *pKey, qint32 nKeySize, qint64 nPhase)
+{
+    qint64 i = 0;
+
+#ifdef Q_PROCESSOR_X86_64
+    if ((nSize >= 64) && (nKeySize <= 0x1000)) {
+        // The key repeated 16 times: a whole number of keys and of vectors
+        qint32 nPatternSize = nKeySize * 16;
+        QByteArray baPattern(nPatternSize, 0);
+
+        for (qint32 j = 0; j < nPatternSize; j++) {
+            baPattern[j] = pKey[(nPhase + j) % nKeySize];
+        }
+
+        const char *pPattern = baPattern.constData();
+
+        for (; i + 16 <= nSize; i += 16) {
+            __m128i data = _mm_loadu_si128((const __m128i *)(pData + i));
+            __m128i key = _mm_loadu_si128((const __m128i *)(pPattern + (i % nPatternSize)));
+
+            _mm_storeu_si128((__m128i *)(pData + i), _mm_xor_si128(data, key));
+        }
+    }
+#endif
+
+    for (; i < nSize; i++) {
+        pData[i] ^= pKey[(nPhase + i) % nKeySize];
+    }
+}
+
+void QHexViewTransformDataSource::addValue(char *pData, qint64 nSize, quint8 nValue)
+{
+    qint64 i = 0;
+
+#ifdef Q_PROCESSOR_X86_64
+    __m128i value = _mm_set1_epi8((char)nValue);
+
+    for (; i + 16 <= nSize; i += 16) {
+        __m128i data = _mm_loadu_si128((const __m128i *)(pData + i));
+
+        _mm_storeu_si128((__m128i *)(pData + i), _mm_add_epi8(data, value));
+    }
+#endif
+
+    for (; i < nSize; i++) {
+        pData[i] = (char)((quint8)pData[i] + nValue);
+    }
+}
+
+void QHexViewTransformDataSource::rotateLeft(char *pData, qint64 nSize, qint32 nBits)
+{
+    nBits &= 7;
+
+    if (nBits) {
+        qint64 i = 0;
+
+#ifdef Q_PROCESSOR_X86_64
+        // No 8-bit shifts: shift 16-bit lanes and mask off the bits from the neighbour byte
+        __m128i shiftLeft = _mm_cvtsi32_si128(nBits);
+        __m128i shiftRight = _mm_cvtsi32_si128(8 - nBits);
+        __m128i maskLeft = _mm_set1_epi8((char)((0xFF << nBits) & 0xFF));
+        __m128i maskRight = _mm_set1_epi8((char)(0xFF >> (8 - nBits)));
+
+        for (; i + 16 <= nSize; i += 16) {
+            __m128i data = _mm_loadu_si128((const __m128i *)(pData + i));
+            __m128i left = _mm_and_si128(_mm_sll_epi16(data, shiftLeft), maskLeft);
+            __m128i right = _mm_and_si128(_mm_srl_epi16(data, shiftRight), maskRight);
+
+            _mm_storeu_si128((__m128i *)(pData + i), _mm_or_si128(left, right));
+        }
+#endif
+
+        for (; i < nSize; i++) {
+            quint8 nByte = (quint8)pData[i];
+            pData[i] = (char)((quint8)(nByte << nBits) | (nByte >> (8 - nBits)));
+        }
+    }
+}
+
+QByteArray QHexViewTransformDataSource::_transformBlock(qint64 nBlockOffset, qint64 nBlockSize)
+{
+    QByteArray baResult(nBlockSize, 0);
+
+    qint64 nRead = g_pSource->readAt(g_nOffset + nBlockOffset, baResult.data(), nBlockSize);
+
+    if (nRead == nBlockSize) {
+        if (g_transform.type == TT_XOR) {
+            xorKey(baResult.data(), nBlockSize, g_transform.baKey.constData(), g_transform.baKey.size(), nBlockOffset);
+        } else if (g_transform.type == TT_ADD) {
+            addValue(baResult.data(), nBlockSize, (quint8)g_transform.nValue);
+        } else if (g_transform.type == TT_ROL) {
+            rotateLeft(baResult.data(), nBlockSize, g_transform.nValue);
+        }
+    } else {
+        baResult.clear();
+    }
+
+    return baResult;
+}
+
+QByteArray QHexViewTransformDataSource::_decodeBlock(qint64 nBlockOffset, qint64 nBlockSize)
+{
+    QByteArray baResult;
+
+    const qint8 *pTable = _getDecodeTable(g_transform.type);
+
+    qint64 nCharOffset = 0;
+    qint64 nNumberOfChars = 0;
+
+    // Blocks are a multiple of 3 bytes, so they start on a base64 group
+    if (g_transform.type == TT_BASE64) {
+        nCharOffset = (nBlockOffset / 3) * 4;
+        nNumberOfChars = ((nBlockSize + 2) / 3) * 4;
+    } else {
+        nCharOffset = nBlockOffset * 2;
+        nNumberOfChars = nBlockSize * 2;
+    }
+
+    nNumberOfChars = qMin(nNumberOfChars, g_listChunkChars.last() - nCharOffset);
+
+    QVector<qint64>::const_iterator iter = std::upper_bound(g_listChunkChars.constBegin(), g_listChunkChars.constEnd() - 1, nCharOffset);
+
+    qint64 nChunk = (iter - g_listChunkChars.constBegin()) - 1;
+    qint64 nCharIndex = g_listChunkChars.at((qint32)nChunk);
+
+    QByteArray baValues(nNumberOfChars, 0);
+    QByteArray baChunk(N_INDEX_CHUNK_SIZE, 0);
+    qint64 nValues = 0;
+
+    for (qint64 nCurrent = nChunk * N_INDEX_CHUNK_SIZE; (nCurrent < g_nSize) && (nValues < nNumberOfChars); nCurrent += N_INDEX_CHUNK_SIZE) {
+        qint64 nChunkSize = qMin((qint64)N_INDEX_CHUNK_SIZE, g_nSize - nCurrent);
+        qint64 nRead = g_pSource->readAt(g_nOffset + nCurrent, baChunk.data(), nChunkSize);
+
+        if (nRead != nChunkSize) {
+            break;
+        }
+
+        for (qint64 i = 0; (i < nRead) && (nValues < nNumberOfChars); i++) {
+            qint8 nValue = pTable[(quint8)baChunk.at((qint32)i)];
+
+            if (nValue != -1) {
+                if (nCharIndex >= nCharOffset) {
+                    baValues[(qint32)nValues] = nValue;
+                    nValues++;
+                }
+
+                nCharIndex++;
+            }
+        }
+    }
+
+    if (nValues == nNumberOfChars) {
+        const quint8 *pValues = (const quint8 *)baValues.constData();
+
+        baResult.resize(nBlockSize);
+
+        char *pOut = baResult.data();
+        qint64 nOut = 0;
+
+        if (g_transform.type == TT_BASE64) {
+            for (qint64 i = 0; (i < nValues) && (nOut < nBlockSize); i += 4) {
+                quint32 nGroup = 0;
+                qint32 nCount = (qint32)qMin((qint64)4, nValues - i);
+
+                for (qint32 j = 0; j < 4; j++) {
+                    nGroup = (nGroup << 6) | ((j < nCount) ? pValues[i + j] : 0);
+                }
+
+                for (qint32 j = 0; (j < nCount - 1) && (nOut < nBlockSize); j++) {
+                    pOut[nOut++] = (char)(nGroup >> (16 - j * 8));
+                }
+            }
+        } else {
+            for (qint64 i = 0; (i + 1 < nValues) && (nOut < nBlockSize); i += 2) {
+                pOut[nOut++] = (char)((pValues[i] << 4) | pValues[i + 1]);
+            }
+        }
+
+        baResult.resize(nOut);
+    }
+
+    return baResult;
+}
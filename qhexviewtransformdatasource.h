@@ -0,0 +1,87 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef QHEXVIEWTRANSFORMDATASOURCE_H
+#define QHEXVIEWTRANSFORMDATASOURCE_H
+
+#include <QCache>
+#include <QVector>
+
+#include "qhexviewdatasource.h"
+
+// One step of a transform chain over a range of a source, blocks are transformed on demand.
+// Inflate steps are QHexViewCompressedDataSource with CF_DEFLATE or CF_GZIP.
+// base64 and hex have no data until setIndex() with the result of TransformIndexProcess.
+class QHexViewTransformDataSource : public QHexViewDataSource {
+    Q_OBJECT
+
+public:
+    enum TT {
+        TT_NONE = 0,  // only the range
+        TT_XOR,
+        TT_ADD,
+        TT_ROL,
+        TT_BASE64,
+        TT_HEX,
+        TT_INFLATE
+    };
+
+    struct TRANSFORM {
+        TT type;
+        QByteArray baKey;  // TT_XOR
+        qint32 nValue;     // TT_ADD, TT_ROL
+    };
+
+    enum {
+        N_INDEX_CHUNK_SIZE = 0x10000  // input bytes per entry of the decode index
+    };
+
+    explicit QHexViewTransformDataSource(QHexViewDataSource *pSource, qint64 nOffset, qint64 nSize, const TRANSFORM &transform, QObject *pParent = nullptr);
+
+    qint64 getSize() override;
+    qint64 readAt(qint64 nOffset, char *pBuffer, qint64 nSize) override;
+    void setIndex(const QVector<qint64> &listChunkChars);  // alphabet characters before each input chunk, and the total
+
+    static bool isDecode(TT type);
+    static qint64 countChars(const char *pData, qint64 nSize, TT type);
+    static bool isFullRange(QHexViewDataSource *pSource, qint64 nOffset, qint64 nSize);
+    static bool parseTransforms(QString sText, QList<TRANSFORM> *pListTransforms);
+    static void xorKey(char *pData, qint64 nSize, const char *pKey, qint32 nKeySize, qint64 nPhase);
+    static void addValue(char *pData, qint64 nSize, quint8 nValue);
+    static void rotateLeft(char *pData, qint64 nSize, qint32 nBits);
+
+private:
+    QByteArray _transformBlock(qint64 nBlockOffset, qint64 nBlockSize);
+    QByteArray _decodeBlock(qint64 nBlockOffset, qint64 nBlockSize);
+
+    const qint64 N_BLOCK_SIZE = 0xC000;  // multiple of 3 for base64 groups
+    const qint32 N_CACHE_SIZE = 0x400;  // blocks
+
+    QHexViewDataSource *g_pSource;
+    qint64 g_nOffset;
+    qint64 g_nSize;
+    qint64 g_nOutSize;
+    TRANSFORM g_transform;
+    QVector<qint64> g_listChunkChars;  // decode: alphabet characters before each input chunk
+    QMutex g_mutex;
+    QCache<qint64, QByteArray> g_cacheBlocks;
+};
+
+#endif  // QHEXVIEWTRANSFORMDATASOURCE_H
@@ -0,0 +1,98 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "qhexviewutils.h"
+
+#include <QtAlgorithms>
+
+#ifdef Q_PROCESSOR_X86_64
+#include <emmintrin.h>
+#endif
+
+qint32 QHexViewUtils::getEqualSize(const char *pData1, const char *pData2, qint32 nSize)
+{
+    qint32 nResult = 0;
+    bool bFound = false;
+
+#ifdef Q_PROCESSOR_X86_64
+    while (nResult + 64 <= nSize) {
+        __m128i x0 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(pData1 + nResult)), _mm_loadu_si128((const __m128i *)(pData2 + nResult)));
+        __m128i x1 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(pData1 + nResult + 16)), _mm_loadu_si128((const __m128i *)(pData2 + nResult + 16)));
+        __m128i x2 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(pData1 + nResult + 32)), _mm_loadu_si128((const __m128i *)(pData2 + nResult + 32)));
+        __m128i x3 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(pData1 + nResult + 48)), _mm_loadu_si128((const __m128i *)(pData2 + nResult + 48)));
+
+        if (_mm_movemask_epi8(_mm_and_si128(_mm_and_si128(x0, x1), _mm_and_si128(x2, x3))) != 0xFFFF) {
+            break;
+        }
+
+        nResult += 64;
+    }
+
+    while (nResult + 16 <= nSize) {
+        quint32 nMask =
+            (quint32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(pData1 + nResult)), _mm_loadu_si128((const __m128i *)(pData2 + nResult))));
+
+        if (nMask != 0xFFFF) {
+            nResult += qCountTrailingZeroBits(~nMask);
+            bFound = true;
+            break;
+        }
+
+        nResult += 16;
+    }
+#endif
+
+    if (!bFound) {
+        while ((nResult < nSize) && (pData1[nResult] == pData2[nResult])) {
+            nResult++;
+        }
+    }
+
+    return nResult;
+}
+
+qint32 QHexViewUtils::getDiffSize(const char *pData1, const char *pData2, qint32 nSize)
+{
+    qint32 nResult = 0;
+    bool bFound = false;
+
+#ifdef Q_PROCESSOR_X86_64
+    while (nResult + 16 <= nSize) {
+        quint32 nMask =
+            (quint32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(pData1 + nResult)), _mm_loadu_si128((const __m128i *)(pData2 + nResult))));
+
+        if (nMask) {
+            nResult += qCountTrailingZeroBits(nMask);
+            bFound = true;
+            break;
+        }
+
+        nResult += 16;
+    }
+#endif
+
+    if (!bFound) {
+        while ((nResult < nSize) && (pData1[nResult] != pData2[nResult])) {
+            nResult++;
+        }
+    }
+
+    return nResult;
+}
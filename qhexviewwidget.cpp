@@ -36,6 +36,8 @@ QHexViewWidget::QHexViewWidget(QWidget *pParent) : QWidget(pParent), ui(new Ui::
     connect(ui->scrollAreaHex, SIGNAL(errorMessage(QString)), this, SLOT(_errorMessage(QString)));
     connect(ui->scrollAreaHex, SIGNAL(customContextMenu(const QPoint &)), this, SLOT(_customContextMenu(const QPoint &)));
     connect(ui->scrollAreaHex, SIGNAL(editState(bool)), this, SIGNAL(editState(bool)));
+    // Direct: the view continues with the result of the process
+    connect(ui->scrollAreaHex, SIGNAL(processRequested(HexProcess *, QString)), this, SLOT(_processRequested(HexProcess *, QString)), Qt::DirectConnection);
 
     g_scGoToAddress = nullptr;
     g_scDumpToFile = nullptr;
@@ -45,6 +47,15 @@ QHexViewWidget::QHexViewWidget(QWidget *pParent) : QWidget(pParent), ui(new Ui::
     g_scFindNext = nullptr;
     g_scSignature = nullptr;
 
+    g_pStringsWidget = nullptr;
+    g_pDevice = nullptr;
+    g_pDataSource = nullptr;
+    g_options = {};
+    g_pCompressedDataSource = nullptr;
+    g_bSession = false;
+    g_sessionKey = {};
+    g_bSessionMemoryMap = false;
+
     ui->scrollAreaHex->setFocus();
 
     g_searchData = {};
@@ -53,14 +64,41 @@ QHexViewWidget::QHexViewWidget(QWidget *pParent) : QWidget(pParent), ui(new Ui::
 
 QHexViewWidget::~QHexViewWidget()
 {
+    _closeSession();
+
     delete ui;
 }
 
 void QHexViewWidget::setData(QIODevice *pDevice, QHexView::OPTIONS *pOptions)
 {
-    ui->scrollAreaHex->setData(pDevice, pOptions);
-    ui->checkBoxReadonly->setChecked(true);
-    ui->checkBoxReadonly->setEnabled(pDevice->isWritable());
+    _closeSession();
+
+    g_pDevice = pDevice;
+    g_pDataSource = nullptr;
+    g_options = {};
+
+    if (pOptions) {
+        g_options = *pOptions;
+    }
+
+    _openSession();
+    _reloadData();
+    _loadSession();
+}
+
+void QHexViewWidget::setDataSource(QHexViewDataSource *pDataSource, QHexView::OPTIONS *pOptions)
+{
+    _closeSession();
+
+    g_pDevice = nullptr;
+    g_pDataSource = pDataSource;
+    g_options = {};
+
+    if (pOptions) {
+        g_options = *pOptions;
+    }
+
+    _reloadData();
 }
 
 void QHexViewWidget::setBackupFileName(QString sBackupFileName)
@@ -91,6 +129,11 @@ void QHexViewWidget::enableReadOnly(bool bState)
     }
 }
 
+void QHexViewWidget::enableSession(bool bState)
+{
+    g_bSession = bState;
+}
+
 bool QHexViewWidget::setReadonly(bool bState)
 {
     return ui->scrollAreaHex->setReadonly(bState);
@@ -188,9 +231,12 @@ void QHexViewWidget::_dumpToFile()
     if (!sFileName.isEmpty()) {
         QHexView::STATE state = ui->scrollAreaHex->getState();
 
-        DialogDumpProcess dd(this, ui->scrollAreaHex->getDevice(), state.nSelectionOffset, state.nSelectionSize, sFileName, DumpProcess::DT_OFFSET);
+        FileDumpProcess dumpProcess;
+        dumpProcess.setData(ui->scrollAreaHex->getDataSource(), state.nSelectionOffset, state.nSelectionSize, sFileName);
 
-        dd.exec();
+        DialogHexProcess dhp(this, &dumpProcess, tr("Dump to file"));
+
+        dhp.exec();
     }
 }
 
@@ -204,7 +250,9 @@ void QHexViewWidget::_find()
 
     DialogSearch::OPTIONS options = {};
 
-    DialogSearch dialogSearch(this, ui->scrollAreaHex->getDevice(), &g_searchData, DialogSearch::SEARCHMODE_SIGNATURE, options);
+    QHexViewDataSourceDevice device(ui->scrollAreaHex->getDataSource());
+
+    DialogSearch dialogSearch(this, &device, &g_searchData, DialogSearch::SEARCHMODE_SIGNATURE, options);
 
     if (dialogSearch.exec() == QDialog::Accepted) {
         ui->scrollAreaHex->goToOffset(g_searchData.nResultOffset);
@@ -219,7 +267,9 @@ void QHexViewWidget::_findNext()
         g_searchData.nCurrentOffset = g_searchData.nResultOffset + 1;
         g_searchData.startFrom = XBinary::SF_CURRENTOFFSET;
 
-        DialogSearchProcess dialogSearch(this, ui->scrollAreaHex->getDevice(), &g_searchData);
+        QHexViewDataSourceDevice device(ui->scrollAreaHex->getDataSource());
+
+        DialogSearchProcess dialogSearch(this, &device, &g_searchData);
 
         if (dialogSearch.exec() == QDialog::Accepted) {
             ui->scrollAreaHex->goToOffset(g_searchData.nResultOffset);
@@ -229,6 +279,23 @@ void QHexViewWidget::_findNext()
     }
 }
 
+void QHexViewWidget::_processRequested(HexProcess *pProcess, QString sTitle)
+{
+    DialogHexProcess dhp(this, pProcess, sTitle);
+
+    dhp.exec();
+}
+
+void QHexViewWidget::_replace()
+{
+    _replaceData(false);
+}
+
+void QHexViewWidget::_replaceAll()
+{
+    _replaceData(true);
+}
+
 void QHexViewWidget::_selectAll()
 {
     ui->scrollAreaHex->selectAll();
@@ -236,81 +303,901 @@ void QHexViewWidget::_selectAll()
 }
 
 void QHexViewWidget::_copyAsHex()
+{
+    _export(ExportProcess::EF_HEX, true);
+}
+
+void QHexViewWidget::_copyAs(QAction *pAction)
+{
+    _export((ExportProcess::EF)pAction->data().toInt(), true);
+}
+
+void QHexViewWidget::_exportAs(QAction *pAction)
+{
+    _export((ExportProcess::EF)pAction->data().toInt(), false);
+}
+
+void QHexViewWidget::_undo()
+{
+    ui->scrollAreaHex->undo();
+}
+
+void QHexViewWidget::_redo()
+{
+    ui->scrollAreaHex->redo();
+}
+
+void QHexViewWidget::_pasteHex()
+{
+    ui->scrollAreaHex->paste(true);
+}
+
+void QHexViewWidget::_pasteBytes()
+{
+    ui->scrollAreaHex->paste(false);
+}
+
+void QHexViewWidget::_fill()
+{
+    _patchSelection(PatchProcess::PO_FILL, tr("Fill"));
+}
+
+void QHexViewWidget::_increment()
 {
     QHexView::STATE state = ui->scrollAreaHex->getState();
 
-    qint64 nSize = qMin(state.nSelectionSize, (qint64)0x10000);
+    bool bOK = false;
+    qint32 nValue = QInputDialog::getInt(this, tr("Increment"), tr("Value"), 1, -255, 255, 1, &bOK);
+
+    if (bOK && nValue) {
+        ui->scrollAreaHex->patch(PatchProcess::PO_ADD, state.nSelectionOffset, state.nSelectionSize, QByteArray(1, (char)nValue));
+    }
+}
+
+void QHexViewWidget::_xor()
+{
+    _patchSelection(PatchProcess::PO_XOR, tr("XOR"));
+}
+
+void QHexViewWidget::_save()
+{
+    ui->scrollAreaHex->save();
+}
 
-    QByteArray baData = ui->scrollAreaHex->readArray(state.nSelectionOffset, nSize);
+void QHexViewWidget::_saveAs()
+{
+    QString sFilter;
+    sFilter += QString("%1 (*)").arg(tr("All files"));
+    QString sFileName = QFileDialog::getSaveFileName(this, tr("Save as"), getDumpName(), sFilter);
 
-    QApplication::clipboard()->setText(baData.toHex());
+    if (!sFileName.isEmpty()) {
+        ui->scrollAreaHex->saveAs(sFileName);
+    }
+}
+
+void QHexViewWidget::_discardChanges()
+{
+    ui->scrollAreaHex->discardChanges();
 }
 
 void QHexViewWidget::_signature()
 {
     QHexView::STATE state = ui->scrollAreaHex->getState();
 
-    DialogHexSignature dsh(this, ui->scrollAreaHex->getDevice(), state.nSelectionOffset, state.nSelectionSize);
+    QHexViewDataSourceDevice device(ui->scrollAreaHex->getDataSource());
+
+    DialogHexSignature dsh(this, &device, state.nSelectionOffset, state.nSelectionSize);
 
     dsh.exec();
 }
 
+void QHexViewWidget::_hash()
+{
+    QHexView::STATE state = ui->scrollAreaHex->getState();
+
+    qint64 nOffset = state.nSelectionOffset;
+    qint64 nSize = state.nSelectionSize;
+
+    if (nSize == 0) {
+        nOffset = 0;
+        nSize = ui->scrollAreaHex->getDataSource()->getSize();
+    }
+
+    HashProcess hashProcess;
+    hashProcess.setData(ui->scrollAreaHex->getDataSource(), nOffset, nSize, HashProcess::HASH_ALL);
+
+    DialogHexProcess dhp(this, &hashProcess, tr("Hash"));
+
+    if (dhp.exec() == QDialog::Accepted) {
+        QList<HashProcess::RECORD> listResult = hashProcess.getResult();
+
+        QString sText;
+
+        for (qint32 i = 0; i < listResult.count(); i++) {
+            sText += QString("%1: %2\n").arg(HashProcess::hashIdToString(listResult.at(i).hash), listResult.at(i).sValue);
+        }
+
+        QMessageBox messageBox(QMessageBox::Information, tr("Hash"), sText, QMessageBox::Ok, this);
+        messageBox.setTextInteractionFlags(Qt::TextSelectableByMouse);
+        messageBox.exec();
+    }
+}
+
+void QHexViewWidget::_strings()
+{
+    if (!g_pStringsWidget) {
+        g_pStringsWidget = new QHexViewStringsWidget(this);
+        g_pStringsWidget->setData(ui->scrollAreaHex->getDataSource());
+
+        connect(g_pStringsWidget, SIGNAL(selectionRequested(qint64, qint64)), this, SLOT(_selectOffsetRange(qint64, qint64)));
+
+        _loadSessionStrings();
+
+        ui->verticalLayout->addWidget(g_pStringsWidget);
+    } else if (g_pStringsWidget->isVisible()) {
+        g_pStringsWidget->stop();
+        g_pStringsWidget->hide();
+    } else {
+        g_pStringsWidget->show();
+    }
+}
+
+void QHexViewWidget::_compare()
+{
+    QString sFileName = QFileDialog::getOpenFileName(this, tr("Compare with"), g_sSaveDirectory);
+
+    if (!sFileName.isEmpty()) {
+        QFile file(sFileName);
+
+        if (file.open(QIODevice::ReadOnly)) {
+            // The data as it is shown, with the edits that are not saved
+            DialogHexCompare dialogCompare(this, ui->scrollAreaHex->getDataSource(), &file);
+
+            dialogCompare.exec();
+        } else {
+            _errorMessage(QString("%1: %2").arg(tr("Cannot open file"), sFileName));
+        }
+    }
+}
+
+void QHexViewWidget::_selectOffsetRange(qint64 nOffset, qint64 nSize)
+{
+    qint64 nAddress = XBinary::offsetToAddress(ui->scrollAreaHex->getMemoryMap(), nOffset);
+
+    if (nAddress != -1) {
+        ui->scrollAreaHex->goToOffset(nOffset);
+        ui->scrollAreaHex->setSelection(nAddress, nSize);
+        ui->scrollAreaHex->reload();
+    }
+}
+
+void QHexViewWidget::_follow(bool bState)
+{
+    ui->scrollAreaHex->setFollowMode(bState, true);
+}
+
+void QHexViewWidget::_refresh(bool bState)
+{
+    ui->scrollAreaHex->setRefreshMode(bState);
+}
+
+void QHexViewWidget::_nextDataExtent()
+{
+    QHexView::STATE state = ui->scrollAreaHex->getState();
+
+    qint64 nOffset = ui->scrollAreaHex->getNextDataOffset(state.nCursorOffset);
+
+    if (nOffset != -1) {
+        goToOffset(nOffset);
+    }
+}
+
+void QHexViewWidget::_transform()
+{
+    QHexView::STATE state = ui->scrollAreaHex->getState();
+    QHexViewDataSource *pDataSource = ui->scrollAreaHex->getDataSource();
+
+    qint64 nOffset = state.nSelectionOffset;
+    qint64 nSize = state.nSelectionSize;
+
+    if (nSize == 0) {
+        nOffset = 0;
+        nSize = pDataSource->getSize();
+    }
+
+    bool bOk = false;
+    QString sText = QInputDialog::getText(this, tr("Transform"), QString("%1 (xor:4142, xor:\"key\", add:1, sub:1, rol:1, ror:1, base64, hex, inflate)").arg(tr("Transforms")),
+                                          QLineEdit::Normal, g_sTransforms, &bOk);
+
+    if (bOk) {
+        QList<QHexViewTransformDataSource::TRANSFORM> listTransforms;
+
+        if (QHexViewTransformDataSource::parseTransforms(sText, &listTransforms)) {
+            g_sTransforms = sText;
+
+            // Every step reads the previous one, nothing is evaluated before the view asks for it
+            QList<QHexViewDataSource *> listStages;
+            QHexViewDataSource *pStage = pDataSource;
+            bool bValid = true;
+
+            for (qint32 i = 0; (i < listTransforms.count()) && bValid; i++) {
+                QHexViewTransformDataSource::TRANSFORM transform = listTransforms.at(i);
+
+                qint64 nStageOffset = (i == 0) ? nOffset : 0;
+                qint64 nStageSize = (i == 0) ? nSize : pStage->getSize();
+
+                if (transform.type == QHexViewTransformDataSource::TT_INFLATE) {
+                    if (!QHexViewTransformDataSource::isFullRange(pStage, nStageOffset, nStageSize)) {
+                        QHexViewTransformDataSource::TRANSFORM range = {};
+                        range.type = QHexViewTransformDataSource::TT_NONE;
+
+                        pStage = new QHexViewTransformDataSource(pStage, nStageOffset, nStageSize, range);
+                        listStages.append(pStage);
+                    }
+
+                    // zlib headers are handled by the gzip path
+                    QHexViewCompressedDataSource::CF format = QHexViewCompressedDataSource::CF_DEFLATE;
+                    QByteArray baHeader = pStage->read(0, 2);
+
+                    if (QHexViewCompressedDataSource::detectFormat(pStage) == QHexViewCompressedDataSource::CF_GZIP) {
+                        format = QHexViewCompressedDataSource::CF_GZIP;
+                    } else if ((baHeader.size() == 2) && ((baHeader.at(0) & 0x0F) == 8) && ((((quint8)baHeader.at(0) << 8) | (quint8)baHeader.at(1)) % 31 == 0)) {
+                        format = QHexViewCompressedDataSource::CF_GZIP;
+                    }
+
+                    CompressedIndexProcess indexProcess;
+                    indexProcess.setData(pStage, format);
+
+                    DialogHexProcess dhp(this, &indexProcess, tr("Inflate"));
+
+                    if (dhp.exec() == QDialog::Accepted) {
+                        QHexViewCompressedDataSource *pCompressedDataSource = new QHexViewCompressedDataSource(pStage);
+                        pCompressedDataSource->setIndex(indexProcess.getResult());
+
+                        pStage = pCompressedDataSource;
+                        listStages.append(pStage);
+                    } else {
+                        bValid = false;
+                    }
+                } else {
+                    QHexViewTransformDataSource *pTransformDataSource = new QHexViewTransformDataSource(pStage, nStageOffset, nStageSize, transform);
+                    listStages.append(pTransformDataSource);
+
+                    if (QHexViewTransformDataSource::isDecode(transform.type)) {
+                        // The output size depends on every character of the input
+                        TransformIndexProcess indexProcess;
+                        indexProcess.setData(pStage, nStageOffset, nStageSize, transform.type);
+
+                        DialogHexProcess dhp(this, &indexProcess, tr("Decode"));
+
+                        if (dhp.exec() == QDialog::Accepted) {
+                            pTransformDataSource->setIndex(indexProcess.getResult());
+                        } else {
+                            bValid = false;
+                        }
+                    }
+
+                    pStage = pTransformDataSource;
+                }
+            }
+
+            if (bValid) {
+                DialogHex dialogHex(this, pStage);
+
+                dialogHex.exec();
+            }
+
+            qDeleteAll(listStages);
+        } else {
+            QMessageBox::critical(this, tr("Error"), QString("%1: %2").arg(tr("Invalid transforms"), sText));
+        }
+    }
+}
+
+void QHexViewWidget::_loadTemplates()
+{
+    QString sFilter;
+    sFilter += QString("%1 (*.h *.txt);;%2 (*)").arg(tr("Templates"), tr("All files"));
+    QString sFileName = QFileDialog::getOpenFileName(this, tr("Load templates"), g_sSaveDirectory, sFilter);
+
+    if (!sFileName.isEmpty()) {
+        QFile file(sFileName);
+
+        if (file.open(QIODevice::ReadOnly)) {
+            QList<QHexViewStructures::STRUCT> listStructs;
+            QString sError;
+
+            if (QHexViewStructures::parseTemplates(QString::fromUtf8(file.readAll()), &listStructs, &sError)) {
+                g_listStructs = listStructs;
+            } else {
+                _errorMessage(sError);
+            }
+
+            file.close();
+        } else {
+            _errorMessage(QString("%1: %2").arg(tr("Cannot open file"), sFileName));
+        }
+    }
+}
+
+void QHexViewWidget::_addStructure()
+{
+    QHexView::STATE state = ui->scrollAreaHex->getState();
+
+    QStringList listNames;
+    qint32 nNumberOfStructs = g_listStructs.count();
+
+    for (qint32 i = 0; i < nNumberOfStructs; i++) {
+        listNames.append(g_listStructs.at(i).sName);
+    }
+
+    bool bOK = false;
+    QString sName = QInputDialog::getItem(this, tr("Add structure"), tr("Structure"), listNames, 0, false, &bOK);
+
+    if (bOK) {
+        qint32 nCount = QInputDialog::getInt(this, tr("Add structure"), tr("Count"), 1, 1, 0x7FFFFFFF, 1, &bOK);
+
+        if (bOK) {
+            ui->scrollAreaHex->addStructure(g_listStructs.at(listNames.indexOf(sName)), state.nSelectionOffset, nCount);
+        }
+    }
+}
+
+void QHexViewWidget::_clearStructures()
+{
+    ui->scrollAreaHex->clearStructures();
+}
+
+void QHexViewWidget::_addBookmark()
+{
+    QHexView::STATE state = ui->scrollAreaHex->getState();
+
+    bool bOK = false;
+    QString sText = QInputDialog::getText(this, tr("Add bookmark"), tr("Name"), QLineEdit::Normal, QString(), &bOK);
+
+    if (bOK) {
+        ui->scrollAreaHex->addAnnotation(state.nSelectionOffset, qMax(state.nSelectionSize, (qint64)1), QColor(255, 255, 0, 110), sText, true);
+    }
+}
+
+void QHexViewWidget::_addAnnotation()
+{
+    QHexView::STATE state = ui->scrollAreaHex->getState();
+
+    bool bOK = false;
+    QString sText = QInputDialog::getText(this, tr("Add annotation"), tr("Text"), QLineEdit::Normal, QString(), &bOK);
+
+    if (bOK) {
+        QColor color = QColorDialog::getColor(QColor(0, 255, 255, 110), this, tr("Color"), QColorDialog::ShowAlphaChannel);
+
+        if (color.isValid()) {
+            ui->scrollAreaHex->addAnnotation(state.nSelectionOffset, qMax(state.nSelectionSize, (qint64)1), color, sText);
+        }
+    }
+}
+
+void QHexViewWidget::_removeAnnotations()
+{
+    QHexView::STATE state = ui->scrollAreaHex->getState();
+
+    ui->scrollAreaHex->removeAnnotations(state.nCursorOffset);
+}
+
+void QHexViewWidget::_clearAnnotations()
+{
+    ui->scrollAreaHex->clearAnnotations();
+}
+
+void QHexViewWidget::_nextBookmark()
+{
+    QHexView::STATE state = ui->scrollAreaHex->getState();
+
+    qint64 nOffset = ui->scrollAreaHex->getNextBookmark(state.nCursorOffset);
+
+    if (nOffset != -1) {
+        goToOffset(nOffset);
+    }
+}
+
+void QHexViewWidget::_prevBookmark()
+{
+    QHexView::STATE state = ui->scrollAreaHex->getState();
+
+    qint64 nOffset = ui->scrollAreaHex->getPrevBookmark(state.nCursorOffset);
+
+    if (nOffset != -1) {
+        goToOffset(nOffset);
+    }
+}
+
+void QHexViewWidget::_importAnnotations()
+{
+    QString sFilter;
+    sFilter += QString("%1 (*.txt *.tsv);;%2 (*)").arg(tr("Annotations"), tr("All files"));
+    QString sFileName = QFileDialog::getOpenFileName(this, tr("Import annotations"), g_sSaveDirectory, sFilter);
+
+    if (!sFileName.isEmpty()) {
+        QFile file(sFileName);
+
+        if (file.open(QIODevice::ReadOnly)) {
+            AnnotationProcess annotationProcess;
+            annotationProcess.setData(AnnotationProcess::MODE_IMPORT, &file);
+
+            DialogHexProcess dhp(this, &annotationProcess, tr("Import annotations"));
+
+            if (dhp.exec() == QDialog::Accepted) {
+                // Indexed once for the whole list
+                ui->scrollAreaHex->appendAnnotations(annotationProcess.getResult());
+
+                if (annotationProcess.getInvalidCount()) {
+                    _errorMessage(QString("%1: %2").arg(tr("Invalid lines")).arg(annotationProcess.getInvalidCount()));
+                }
+            }
+
+            file.close();
+        } else {
+            _errorMessage(QString("%1: %2").arg(tr("Cannot open file"), sFileName));
+        }
+    }
+}
+
+void QHexViewWidget::_exportAnnotations()
+{
+    QString sFilter;
+    sFilter += QString("%1 (*.txt)").arg(tr("Annotations"));
+    QString sSaveFileName = getDumpName();
+    sSaveFileName = sSaveFileName.left(sSaveFileName.lastIndexOf(".") + 1) + "txt";
+
+    QString sFileName = QFileDialog::getSaveFileName(this, tr("Export annotations"), sSaveFileName, sFilter);
+
+    if (!sFileName.isEmpty()) {
+        // An existing file is replaced only by a complete export
+        QSaveFile file(sFileName);
+
+        if (file.open(QIODevice::WriteOnly)) {
+            AnnotationProcess annotationProcess;
+            annotationProcess.setData(AnnotationProcess::MODE_EXPORT, &file, ui->scrollAreaHex->getAnnotations());
+
+            DialogHexProcess dhp(this, &annotationProcess, tr("Export annotations"));
+
+            if (dhp.exec() == QDialog::Accepted) {
+                if (!file.commit()) {
+                    _errorMessage(QString("%1: %2").arg(tr("Cannot save file"), sFileName));
+                }
+            } else {
+                file.cancelWriting();
+            }
+        } else {
+            _errorMessage(QString("%1: %2").arg(tr("Cannot open file"), sFileName));
+        }
+    }
+}
+
+void QHexViewWidget::_memoryMapColors(bool bState)
+{
+    ui->scrollAreaHex->setMemoryMapColors(bState);
+}
+
+void QHexViewWidget::_encoding(QAction *pAction)
+{
+    ui->scrollAreaHex->setEncoding((QHexViewEncoding::ENC)pAction->data().toInt());
+}
+
+void QHexViewWidget::_displayMode(QAction *pAction)
+{
+    ui->scrollAreaHex->setDisplayMode((QHexView::DM)pAction->data().toInt(), ui->scrollAreaHex->isBigEndian());
+}
+
+void QHexViewWidget::_bigEndian(bool bState)
+{
+    ui->scrollAreaHex->setDisplayMode(ui->scrollAreaHex->getDisplayMode(), bState);
+}
+
+void QHexViewWidget::_watchSelection()
+{
+    QHexView::STATE state = ui->scrollAreaHex->getState();
+
+    if (!ui->scrollAreaHex->addWatchRange(state.nSelectionOffset, state.nSelectionSize)) {
+        _errorMessage(tr("The selection is too large to watch"));
+    }
+}
+
+void QHexViewWidget::_decompressed(bool bState)
+{
+    if (bState && (!g_pCompressedDataSource)) {
+        QHexViewDataSource *pSource = g_pDataSource;
+        bool bOwnSource = false;
+
+        if (!pSource) {
+            pSource = QHexViewDataSource::create(g_pDevice);
+            bOwnSource = true;
+        }
+
+        QHexViewCompressedDataSource::CF format = QHexViewCompressedDataSource::detectFormat(pSource);
+
+        if (QHexViewCompressedDataSource::isFormatSupported(format)) {
+            QHexViewCompressedDataSource::INDEX index = {};
+            bool bIndex = false;
+
+            // With sessions enabled the index is kept next to the file, so the next open does not need the pass
+            QString sIndexFileName;
+            QHexViewSession::KEY key = {};
+            QFile *pFile = qobject_cast<QFile *>(g_pDevice);
+
+            if (g_bSession && pFile && (pFile->fileName() != "")) {
+                sIndexFileName = QHexViewCompressedDataSource::getIndexFileName(pFile->fileName());
+                key = QHexViewSession::getKey(pFile->fileName());
+
+                bIndex = QHexViewCompressedDataSource::loadIndex(&index, sIndexFileName, key) && (index.format == format) &&
+                         (index.nCompressedSize == pSource->getSize());
+            }
+
+            if (!bIndex) {
+                CompressedIndexProcess indexProcess;
+                indexProcess.setData(pSource, format);
+
+                DialogHexProcess dhp(this, &indexProcess, tr("Index"));
+
+                if (dhp.exec() == QDialog::Accepted) {
+                    index = indexProcess.getResult();
+                    bIndex = true;
+
+                    if (sIndexFileName != "") {
+                        QHexViewCompressedDataSource::saveIndex(index, sIndexFileName, key);
+                    }
+                }
+            }
+
+            if (bIndex) {
+                g_pCompressedDataSource = new QHexViewCompressedDataSource(pSource, this);
+                g_pCompressedDataSource->setIndex(index);
+
+                if (bOwnSource) {
+                    pSource->setParent(g_pCompressedDataSource);
+                    bOwnSource = false;
+                }
+
+                QHexView::OPTIONS options = {};
+
+                ui->scrollAreaHex->setDataSource(g_pCompressedDataSource, &options);
+                ui->checkBoxReadonly->setChecked(true);
+                ui->checkBoxReadonly->setEnabled(false);
+
+                if (g_pStringsWidget) {
+                    g_pStringsWidget->setData(g_pCompressedDataSource);
+                }
+            }
+        } else {
+            QMessageBox::critical(this, tr("Error"), QString("%1: %2").arg(tr("Unsupported format"), QHexViewCompressedDataSource::formatToString(format)));
+        }
+
+        if (bOwnSource) {
+            delete pSource;
+        }
+    } else if ((!bState) && g_pCompressedDataSource) {
+        _reloadData();
+    }
+}
+
+void QHexViewWidget::_reloadData()
+{
+    if (g_pDevice) {
+        ui->scrollAreaHex->setData(g_pDevice, &g_options);
+    } else {
+        ui->scrollAreaHex->setDataSource(g_pDataSource, &g_options);
+    }
+
+    QHexViewDataSource *pDataSource = ui->scrollAreaHex->getDataSource();
+
+    ui->checkBoxReadonly->setChecked(true);
+    ui->checkBoxReadonly->setEnabled(pDataSource && pDataSource->isWritable());
+
+    if (g_pStringsWidget) {
+        g_pStringsWidget->setData(pDataSource);
+    }
+
+    if (g_pCompressedDataSource) {
+        delete g_pCompressedDataSource;
+        g_pCompressedDataSource = nullptr;
+    }
+}
+
 void QHexViewWidget::_customContextMenu(const QPoint &pos)
 {
-    //    QHexView::STATE state=ui->scrollAreaHex->getState();
+    QHexView::STATE state = ui->scrollAreaHex->getState();
 
-    //    QMenu contextMenu(this);
+    QMenu contextMenu(this);
 
-    //    QAction actionGoToAddress(tr("Go to address"),this);
-    //    actionGoToAddress.setShortcut(QKeySequence(XShortcuts::GOTOADDRESS));
-    //    connect(&actionGoToAddress,SIGNAL(triggered()),this,SLOT(_goToAddress()));
-    //    contextMenu.addAction(&actionGoToAddress);
+    QAction actionGoToAddress(tr("Go to address"), this);
+    connect(&actionGoToAddress, SIGNAL(triggered()), this, SLOT(_goToAddress()));
+    contextMenu.addAction(&actionGoToAddress);
 
-    //    QAction actionDumpToFile(tr("Dump to file"),this);
-    //    actionDumpToFile.setShortcut(QKeySequence(XShortcuts::DUMPTOFILE));
-    //    connect(&actionDumpToFile,SIGNAL(triggered()),this,SLOT(_dumpToFile()));
+    QAction actionDumpToFile(tr("Dump to file"), this);
+    connect(&actionDumpToFile, SIGNAL(triggered()), this, SLOT(_dumpToFile()));
 
-    //    QAction actionSignature(tr("Signature"),this);
-    //    actionSignature.setShortcut(QKeySequence(XShortcuts::HEXSIGNATURE));
-    //    connect(&actionSignature,SIGNAL(triggered()),this,SLOT(_signature()));
+    QAction actionSignature(tr("Signature"), this);
+    connect(&actionSignature, SIGNAL(triggered()), this, SLOT(_signature()));
 
-    //    if(state.nSelectionSize)
-    //    {
-    //        contextMenu.addAction(&actionDumpToFile);
-    //        contextMenu.addAction(&actionSignature);
-    //    }
+    if (state.nSelectionSize) {
+        contextMenu.addAction(&actionDumpToFile);
+        contextMenu.addAction(&actionSignature);
+    }
+
+    QAction actionHash(tr("Hash"), this);
+    connect(&actionHash, SIGNAL(triggered()), this, SLOT(_hash()));
+    contextMenu.addAction(&actionHash);
+
+    QAction actionStrings(tr("Strings"), this);
+    connect(&actionStrings, SIGNAL(triggered()), this, SLOT(_strings()));
+    contextMenu.addAction(&actionStrings);
+
+    QAction actionCompare(tr("Compare with file"), this);
+    connect(&actionCompare, SIGNAL(triggered()), this, SLOT(_compare()));
+
+    if (ui->scrollAreaHex->getDataSource()) {
+        contextMenu.addAction(&actionCompare);
+    }
+
+    QAction actionFind(tr("Find"), this);
+    connect(&actionFind, SIGNAL(triggered()), this, SLOT(_find()));
+    contextMenu.addAction(&actionFind);
+
+    QAction actionFindNext(tr("Find next"), this);
+    connect(&actionFindNext, SIGNAL(triggered()), this, SLOT(_findNext()));
+    contextMenu.addAction(&actionFindNext);
+
+    QAction actionReplace(tr("Replace"), this);
+    connect(&actionReplace, SIGNAL(triggered()), this, SLOT(_replace()));
+
+    QAction actionReplaceAll(tr("Replace all"), this);
+    connect(&actionReplaceAll, SIGNAL(triggered()), this, SLOT(_replaceAll()));
+
+    if (!ui->scrollAreaHex->isReadonly()) {
+        contextMenu.addAction(&actionReplace);
+        contextMenu.addAction(&actionReplaceAll);
+    }
+
+    QMenu menuSelect(tr("Select"), this);
+
+    QAction actionSelectAll(tr("Select all"), this);
+    connect(&actionSelectAll, SIGNAL(triggered()), this, SLOT(_selectAll()));
+
+    menuSelect.addAction(&actionSelectAll);
+    contextMenu.addMenu(&menuSelect);
+
+    QMenu menuCopy(tr("Copy"), this);
+
+    QAction actionCopyAsHex(tr("Copy as hex"), this);
+    connect(&actionCopyAsHex, SIGNAL(triggered()), this, SLOT(_copyAsHex()));
+
+    menuCopy.addAction(&actionCopyAsHex);
+
+    QMenu menuCopyAs(tr("Copy as"), this);
+    QMenu menuExport(tr("Export"), this);
+
+    QList<ExportProcess::EF> listFormats = ExportProcess::getFormats();
+    qint32 nNumberOfFormats = listFormats.count();
+
+    for (qint32 i = 0; i < nNumberOfFormats; i++) {
+        QString sFormat = ExportProcess::formatToString(listFormats.at(i));
+
+        menuCopyAs.addAction(sFormat)->setData((qint32)listFormats.at(i));
+        menuExport.addAction(sFormat)->setData((qint32)listFormats.at(i));
+    }
+
+    connect(&menuCopyAs, SIGNAL(triggered(QAction *)), this, SLOT(_copyAs(QAction *)));
+    connect(&menuExport, SIGNAL(triggered(QAction *)), this, SLOT(_exportAs(QAction *)));
+
+    menuCopy.addMenu(&menuCopyAs);
+    contextMenu.addMenu(&menuCopy);
+
+    QMenu menuEdit(tr("Edit"), this);
+
+    QAction actionUndo(tr("Undo"), this);
+    actionUndo.setEnabled(ui->scrollAreaHex->canUndo());
+    connect(&actionUndo, SIGNAL(triggered()), this, SLOT(_undo()));
+    menuEdit.addAction(&actionUndo);
+
+    QAction actionRedo(tr("Redo"), this);
+    actionRedo.setEnabled(ui->scrollAreaHex->canRedo());
+    connect(&actionRedo, SIGNAL(triggered()), this, SLOT(_redo()));
+    menuEdit.addAction(&actionRedo);
+
+    menuEdit.addSeparator();
+
+    QAction actionPasteHex(tr("Paste hex"), this);
+    connect(&actionPasteHex, SIGNAL(triggered()), this, SLOT(_pasteHex()));
+    menuEdit.addAction(&actionPasteHex);
+
+    QAction actionPasteBytes(tr("Paste text"), this);
+    connect(&actionPasteBytes, SIGNAL(triggered()), this, SLOT(_pasteBytes()));
+    menuEdit.addAction(&actionPasteBytes);
+
+    QAction actionFill(tr("Fill"), this);
+    connect(&actionFill, SIGNAL(triggered()), this, SLOT(_fill()));
+
+    QAction actionIncrement(tr("Increment"), this);
+    connect(&actionIncrement, SIGNAL(triggered()), this, SLOT(_increment()));
+
+    QAction actionXor(tr("XOR"), this);
+    connect(&actionXor, SIGNAL(triggered()), this, SLOT(_xor()));
+
+    if (state.nSelectionSize) {
+        menuEdit.addAction(&actionFill);
+        menuEdit.addAction(&actionIncrement);
+        menuEdit.addAction(&actionXor);
+    }
+
+    menuEdit.addSeparator();
+
+    QAction actionSave(tr("Save"), this);
+    actionSave.setEnabled(ui->scrollAreaHex->isModified());
+    connect(&actionSave, SIGNAL(triggered()), this, SLOT(_save()));
+    menuEdit.addAction(&actionSave);
+
+    QAction actionSaveAs(tr("Save as"), this);
+    connect(&actionSaveAs, SIGNAL(triggered()), this, SLOT(_saveAs()));
+    menuEdit.addAction(&actionSaveAs);
+
+    QAction actionDiscardChanges(tr("Discard changes"), this);
+    actionDiscardChanges.setEnabled(ui->scrollAreaHex->isModified());
+    connect(&actionDiscardChanges, SIGNAL(triggered()), this, SLOT(_discardChanges()));
+    menuEdit.addAction(&actionDiscardChanges);
+
+    if (!ui->scrollAreaHex->isReadonly()) {
+        contextMenu.addMenu(&menuEdit);
+    }
+
+    contextMenu.addMenu(&menuExport);
+
+    QMenu menuEncoding(tr("Encoding"), this);
+    QActionGroup actionGroupEncoding(this);
+
+    QList<QHexViewEncoding::ENC> listEncodings = QHexViewEncoding::getEncodings();
+    qint32 nNumberOfEncodings = listEncodings.count();
+
+    for (qint32 i = 0; i < nNumberOfEncodings; i++) {
+        QAction *pAction = menuEncoding.addAction(QHexViewEncoding::encodingToString(listEncodings.at(i)));
+        pAction->setCheckable(true);
+        pAction->setChecked(listEncodings.at(i) == ui->scrollAreaHex->getEncoding());
+        pAction->setData((qint32)listEncodings.at(i));
+        actionGroupEncoding.addAction(pAction);
+    }
+
+    connect(&actionGroupEncoding, SIGNAL(triggered(QAction *)), this, SLOT(_encoding(QAction *)));
+    contextMenu.addMenu(&menuEncoding);
+
+    QMenu menuDisplay(tr("Display"), this);
+    QActionGroup actionGroupDisplay(this);
+
+    QList<QHexView::DM> listDisplayModes = QHexView::getDisplayModes();
+    qint32 nNumberOfDisplayModes = listDisplayModes.count();
+
+    for (qint32 i = 0; i < nNumberOfDisplayModes; i++) {
+        QAction *pAction = menuDisplay.addAction(QHexView::displayModeToString(listDisplayModes.at(i)));
+        pAction->setCheckable(true);
+        pAction->setChecked(listDisplayModes.at(i) == ui->scrollAreaHex->getDisplayMode());
+        pAction->setData((qint32)listDisplayModes.at(i));
+        actionGroupDisplay.addAction(pAction);
+    }
+
+    connect(&actionGroupDisplay, SIGNAL(triggered(QAction *)), this, SLOT(_displayMode(QAction *)));
 
-    //    QAction actionFind(tr("Find"),this);
-    //    actionFind.setShortcut(QKeySequence(XShortcuts::FIND));
-    //    connect(&actionFind,SIGNAL(triggered()),this,SLOT(_find()));
-    //    contextMenu.addAction(&actionFind);
+    menuDisplay.addSeparator();
 
-    //    QAction actionFindNext(tr("Find next"),this);
-    //    actionFindNext.setShortcut(QKeySequence(XShortcuts::FINDNEXT));
-    //    connect(&actionFindNext,SIGNAL(triggered()),this,SLOT(_findNext()));
-    //    contextMenu.addAction(&actionFindNext);
+    QAction actionBigEndian(tr("Big endian"), this);
+    actionBigEndian.setCheckable(true);
+    actionBigEndian.setChecked(ui->scrollAreaHex->isBigEndian());
+    connect(&actionBigEndian, SIGNAL(toggled(bool)), this, SLOT(_bigEndian(bool)));
+    menuDisplay.addAction(&actionBigEndian);
 
-    //    QMenu menuSelect(tr("Select"),this);
+    contextMenu.addMenu(&menuDisplay);
 
-    //    QAction actionSelectAll(tr("Select all"),this);
-    //    actionSelectAll.setShortcut(QKeySequence(XShortcuts::SELECTALL));
-    //    connect(&actionSelectAll,SIGNAL(triggered()),this,SLOT(_selectAll()));
+    QMenu menuStructures(tr("Structures"), this);
 
-    //    menuSelect.addAction(&actionSelectAll);
-    //    contextMenu.addMenu(&menuSelect);
+    QAction actionLoadTemplates(tr("Load templates"), this);
+    connect(&actionLoadTemplates, SIGNAL(triggered()), this, SLOT(_loadTemplates()));
+    menuStructures.addAction(&actionLoadTemplates);
 
-    //    QMenu menuCopy(tr("Copy"),this);
+    QAction actionAddStructure(tr("Add structure"), this);
+    actionAddStructure.setEnabled(!g_listStructs.isEmpty());
+    connect(&actionAddStructure, SIGNAL(triggered()), this, SLOT(_addStructure()));
+    menuStructures.addAction(&actionAddStructure);
 
-    //    QAction actionCopyAsHex(tr("Copy as hex"),this);
-    //    actionCopyAsHex.setShortcut(QKeySequence(XShortcuts::COPYASHEX));
-    //    connect(&actionCopyAsHex,SIGNAL(triggered()),this,SLOT(_copyAsHex()));
+    QAction actionClearStructures(tr("Clear structures"), this);
+    connect(&actionClearStructures, SIGNAL(triggered()), this, SLOT(_clearStructures()));
+    menuStructures.addAction(&actionClearStructures);
 
-    //    menuCopy.addAction(&actionCopyAsHex);
-    //    contextMenu.addMenu(&menuCopy);
+    contextMenu.addMenu(&menuStructures);
 
-    //    // TODO reset select
+    QMenu menuAnnotations(tr("Annotations"), this);
 
-    //    contextMenu.exec(pos);
+    QAction actionAddBookmark(tr("Add bookmark"), this);
+    connect(&actionAddBookmark, SIGNAL(triggered()), this, SLOT(_addBookmark()));
+    menuAnnotations.addAction(&actionAddBookmark);
+
+    QAction actionAddAnnotation(tr("Add annotation"), this);
+    connect(&actionAddAnnotation, SIGNAL(triggered()), this, SLOT(_addAnnotation()));
+    menuAnnotations.addAction(&actionAddAnnotation);
+
+    QAction actionRemoveAnnotations(tr("Remove"), this);
+    connect(&actionRemoveAnnotations, SIGNAL(triggered()), this, SLOT(_removeAnnotations()));
+    menuAnnotations.addAction(&actionRemoveAnnotations);
+
+    QAction actionClearAnnotations(tr("Clear"), this);
+    connect(&actionClearAnnotations, SIGNAL(triggered()), this, SLOT(_clearAnnotations()));
+    menuAnnotations.addAction(&actionClearAnnotations);
+
+    menuAnnotations.addSeparator();
+
+    QAction actionNextBookmark(tr("Next bookmark"), this);
+    connect(&actionNextBookmark, SIGNAL(triggered()), this, SLOT(_nextBookmark()));
+    menuAnnotations.addAction(&actionNextBookmark);
+
+    QAction actionPrevBookmark(tr("Previous bookmark"), this);
+    connect(&actionPrevBookmark, SIGNAL(triggered()), this, SLOT(_prevBookmark()));
+    menuAnnotations.addAction(&actionPrevBookmark);
+
+    menuAnnotations.addSeparator();
+
+    QAction actionImportAnnotations(tr("Import"), this);
+    connect(&actionImportAnnotations, SIGNAL(triggered()), this, SLOT(_importAnnotations()));
+    menuAnnotations.addAction(&actionImportAnnotations);
+
+    QAction actionExportAnnotations(tr("Export"), this);
+    connect(&actionExportAnnotations, SIGNAL(triggered()), this, SLOT(_exportAnnotations()));
+    menuAnnotations.addAction(&actionExportAnnotations);
+
+    menuAnnotations.addSeparator();
+
+    QAction actionMemoryMapColors(tr("Memory map colors"), this);
+    actionMemoryMapColors.setCheckable(true);
+    actionMemoryMapColors.setChecked(ui->scrollAreaHex->isMemoryMapColors());
+    connect(&actionMemoryMapColors, SIGNAL(toggled(bool)), this, SLOT(_memoryMapColors(bool)));
+    menuAnnotations.addAction(&actionMemoryMapColors);
+
+    contextMenu.addMenu(&menuAnnotations);
+
+    QAction actionFollow(tr("Follow"), this);
+    actionFollow.setCheckable(true);
+    actionFollow.setChecked(ui->scrollAreaHex->isFollowMode());
+    connect(&actionFollow, SIGNAL(toggled(bool)), this, SLOT(_follow(bool)));
+    contextMenu.addAction(&actionFollow);
+
+    QAction actionRefresh(tr("Live refresh"), this);
+    actionRefresh.setCheckable(true);
+    actionRefresh.setChecked(ui->scrollAreaHex->isRefreshMode());
+    connect(&actionRefresh, SIGNAL(toggled(bool)), this, SLOT(_refresh(bool)));
+    contextMenu.addAction(&actionRefresh);
+
+    QAction actionWatchSelection(tr("Watch selection"), this);
+    connect(&actionWatchSelection, SIGNAL(triggered()), this, SLOT(_watchSelection()));
+
+    if (state.nSelectionSize) {
+        contextMenu.addAction(&actionWatchSelection);
+    }
+
+    QAction actionTransform(tr("Transform"), this);
+    connect(&actionTransform, SIGNAL(triggered()), this, SLOT(_transform()));
+    contextMenu.addAction(&actionTransform);
+
+    QAction actionNextDataExtent(tr("Next data extent"), this);
+    connect(&actionNextDataExtent, SIGNAL(triggered()), this, SLOT(_nextDataExtent()));
+
+    if (ui->scrollAreaHex->getDataSource() && ui->scrollAreaHex->getDataSource()->isSparse()) {
+        contextMenu.addAction(&actionNextDataExtent);
+    }
+
+    QAction actionDecompressed(tr("Decompressed"), this);
+    actionDecompressed.setCheckable(true);
+    actionDecompressed.setChecked(g_pCompressedDataSource);
+    connect(&actionDecompressed, SIGNAL(toggled(bool)), this, SLOT(_decompressed(bool)));
+
+    if (g_pCompressedDataSource || QHexViewCompressedDataSource::detectFormat(ui->scrollAreaHex->getDataSource())) {
+        contextMenu.addAction(&actionDecompressed);
+    }
+
+    contextMenu.exec(pos);
 }
 
 void QHexViewWidget::_errorMessage(QString sText)
@@ -318,6 +1205,130 @@ void QHexViewWidget::_errorMessage(QString sText)
     QMessageBox::critical(this, tr("Error"), sText);
 }
 
+void QHexViewWidget::_patchSelection(PatchProcess::PO op, QString sTitle)
+{
+    QHexView::STATE state = ui->scrollAreaHex->getState();
+
+    bool bOK = false;
+    QString sPattern = QInputDialog::getText(this, sTitle, tr("Pattern (hex)"), QLineEdit::Normal, QString("00"), &bOK);
+
+    if (bOK) {
+        QByteArray baPattern;
+
+        if (PatchProcess::hexToBytes(sPattern.toLatin1(), &baPattern)) {
+            ui->scrollAreaHex->patch(op, state.nSelectionOffset, state.nSelectionSize, baPattern);
+        } else {
+            _errorMessage(tr("Invalid hex"));
+        }
+    }
+}
+
+void QHexViewWidget::_replaceData(bool bAll)
+{
+    QHexView::STATE state = ui->scrollAreaHex->getState();
+    QHexViewDataSource *pDataSource = ui->scrollAreaHex->getDataSource();
+
+    QString sTitle = bAll ? tr("Replace all") : tr("Replace");
+
+    bool bOK = false;
+    QString sFind = QInputDialog::getText(this, sTitle, tr("Find (hex)"), QLineEdit::Normal, g_sReplaceFind, &bOK);
+    QString sReplace;
+
+    if (bOK) {
+        sReplace = QInputDialog::getText(this, sTitle, tr("Replace with (hex, empty to delete)"), QLineEdit::Normal, g_sReplaceWith, &bOK);
+    }
+
+    if (bOK && pDataSource) {
+        g_sReplaceFind = sFind;
+        g_sReplaceWith = sReplace;
+
+        QByteArray baFind;
+        QByteArray baReplace;
+
+        bool bFind = PatchProcess::hexToBytes(sFind.toLatin1(), &baFind);
+        // Empty: the occurrences are deleted, a resize like any pattern of another size
+        bool bReplace = sReplace.trimmed().isEmpty() || PatchProcess::hexToBytes(sReplace.toLatin1(), &baReplace);
+
+        if (!bFind) {
+            _errorMessage(QString("%1: %2").arg(tr("Invalid hex"), tr("Find")));
+        } else if (!bReplace) {
+            _errorMessage(QString("%1: %2").arg(tr("Invalid hex"), tr("Replace with")));
+        } else {
+            bool bResize = (baFind.size() != baReplace.size());
+
+            // The selection, otherwise everything or from the cursor
+            qint64 nOffset = state.nSelectionOffset;
+            qint64 nSize = state.nSelectionSize;
+
+            if (nSize == 0) {
+                nOffset = bAll ? 0 : state.nCursorOffset;
+                nSize = pDataSource->getSize() - nOffset;
+            }
+
+            if (bResize && (!qobject_cast<QFile *>(pDataSource->getDevice()))) {
+                _errorMessage(tr("Patterns of different size can be replaced only in files"));
+            } else {
+                ReplaceProcess previewProcess;
+                previewProcess.setData(pDataSource, nOffset, nSize, baFind, QByteArray(), ReplaceProcess::RM_PREVIEW, bAll ? N_REPLACE_PREVIEW : 1);
+
+                DialogHexProcess dhp(this, &previewProcess, tr("Search"));
+
+                if (dhp.exec() == QDialog::Accepted) {
+                    qint64 nCount = previewProcess.getCount();
+                    QVector<qint64> listOffsets = previewProcess.getOffsets();
+
+                    if (nCount == 0) {
+                        QMessageBox::information(this, sTitle, tr("Nothing found"));
+                    } else if (!bAll) {
+                        qint64 nHitOffset = listOffsets.at(0);
+
+                        ui->scrollAreaHex->replace(nHitOffset, nOffset + nSize - nHitOffset, baFind, baReplace, 1);
+                        ui->scrollAreaHex->goToOffset(nHitOffset);
+                        ui->scrollAreaHex->setFocus();
+                        ui->scrollAreaHex->reload();
+                    } else {
+                        QString sDetails;
+                        qint32 nNumberOfOffsets = listOffsets.count();
+
+                        for (qint32 i = 0; i < nNumberOfOffsets; i++) {
+                            qint64 nHitOffset = listOffsets.at(i);
+                            qint64 nBefore = qMin(nHitOffset, (qint64)8);
+
+                            QByteArray baBefore = ui->scrollAreaHex->readArray(nHitOffset - nBefore, nBefore);
+                            QByteArray baAfter = ui->scrollAreaHex->readArray(nHitOffset + baFind.size(), 8);
+
+                            sDetails += QString("%1: %2 [%3] %4\n")
+                                            .arg(nHitOffset, 16, 16, QChar('0'))
+                                            .arg(QString(baBefore.toHex(' ')), QString(baFind.left(16).toHex(' ')), QString(baAfter.toHex(' ')));
+                        }
+
+                        if (nCount > nNumberOfOffsets) {
+                            sDetails += QString("...\n");
+                        }
+
+                        QString sText = tr("Replace %1 occurrences?").arg(nCount);
+
+                        if (bResize) {
+                            sText += QString("\n") + tr("The file is rewritten from the first occurrence, this cannot be undone.");
+                        }
+
+                        QMessageBox messageBox(QMessageBox::Question, sTitle, sText, QMessageBox::Yes | QMessageBox::No, this);
+                        messageBox.setDetailedText(sDetails);
+
+                        if (messageBox.exec() == QMessageBox::Yes) {
+                            qint64 nReplaced = 0;
+
+                            ui->scrollAreaHex->replace(nOffset, nSize, baFind, baReplace, -1, &nReplaced);
+
+                            QMessageBox::information(this, sTitle, tr("%1 occurrences replaced").arg(nReplaced));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
 QString QHexViewWidget::getDumpName()
 {
     QString sResult;
@@ -332,6 +1343,75 @@ QString QHexViewWidget::getDumpName()
     return sResult;
 }
 
+void QHexViewWidget::_export(ExportProcess::EF format, bool bClipboard)
+{
+    QHexView::STATE state = ui->scrollAreaHex->getState();
+    QHexViewDataSource *pDataSource = ui->scrollAreaHex->getDataSource();
+
+    qint64 nOffset = state.nSelectionOffset;
+    qint64 nSize = state.nSelectionSize;
+    qint64 nAddress = state.nSelectionAddress;
+
+    if (pDataSource && (nSize == 0) && (!bClipboard)) {
+        nOffset = 0;
+        nSize = pDataSource->getSize();
+        nAddress = state.nCursorAddress - state.nCursorOffset;
+    }
+
+    bool bProceed = (pDataSource && nSize);
+
+    if (bProceed && bClipboard && (ExportProcess::getOutputSize(format, nSize) > N_CLIPBOARD_LIMIT)) {
+        // Large selections are streamed to a file instead of being held in memory
+        bProceed = (QMessageBox::question(this, tr("Copy"), tr("The selection is too large for the clipboard. Export to a file?")) == QMessageBox::Yes);
+        bClipboard = false;
+    }
+
+    if (bProceed) {
+        ExportProcess exportProcess;
+
+        if (bClipboard) {
+            QBuffer buffer;
+            buffer.open(QIODevice::WriteOnly);
+
+            exportProcess.setData(pDataSource, nOffset, nSize, format, &buffer, nAddress);
+
+            DialogHexProcess dhp(this, &exportProcess, tr("Copy"));
+
+            if (dhp.exec() == QDialog::Accepted) {
+                QApplication::clipboard()->setText(QString::fromLatin1(buffer.data()));
+            }
+        } else {
+            QString sSuffix = ExportProcess::getFileSuffix(format);
+            QString sFilter = QString("%1 (*.%2)").arg(ExportProcess::formatToString(format), sSuffix);
+            QString sSaveFileName = getDumpName();
+            sSaveFileName = sSaveFileName.left(sSaveFileName.lastIndexOf(".") + 1) + sSuffix;
+
+            QString sFileName = QFileDialog::getSaveFileName(this, tr("Export"), sSaveFileName, sFilter);
+
+            if (!sFileName.isEmpty()) {
+                // Nothing is left behind on cancel or error, an existing file is replaced only by a complete export
+                QSaveFile file(sFileName);
+
+                if (file.open(QIODevice::WriteOnly)) {
+                    exportProcess.setData(pDataSource, nOffset, nSize, format, &file, nAddress);
+
+                    DialogHexProcess dhp(this, &exportProcess, tr("Export"));
+
+                    if (dhp.exec() == QDialog::Accepted) {
+                        if (!file.commit()) {
+                            _errorMessage(QString("%1: %2").arg(tr("Cannot save file"), sFileName));
+                        }
+                    } else {
+                        file.cancelWriting();
+                    }
+                } else {
+                    _errorMessage(QString("%1: %2").arg(tr("Cannot open file"), sFileName));
+                }
+            }
+        }
+    }
+}
+
 void QHexViewWidget::registerShortcuts(bool bState)
 {
     //    if(bState)
@@ -355,3 +1435,145 @@ void QHexViewWidget::registerShortcuts(bool bState)
     //        if(g_scSignature)     {delete g_scSignature;    g_scSignature=nullptr;}
     //    }
 }
+
+void QHexViewWidget::_openSession()
+{
+    QFile *pFile = qobject_cast<QFile *>(g_pDevice);
+
+    if (g_bSession && pFile && (pFile->fileName() != "")) {
+        g_sSessionFileName = pFile->fileName();
+        g_sessionKey = QHexViewSession::getKey(g_sSessionFileName);
+
+        // Stale sessions are not opened and are replaced on close
+        g_session.open(QHexViewSession::getSessionFileName(g_sSessionFileName), g_sessionKey);
+
+        // A map of the host is used as is
+        g_bSessionMemoryMap = (g_options.memoryMap.listRecords.count() == 0);
+
+        const char *pData = nullptr;
+        qint64 nSize = 0;
+
+        if (g_bSessionMemoryMap && g_session.getSection(QHexViewSession::SECTION_MEMORY_MAP, &pData, &nSize)) {
+            QHexViewSession::dataToMemoryMap(pData, nSize, &g_options.memoryMap);
+        }
+    }
+}
+
+void QHexViewWidget::_loadSession()
+{
+    if (g_session.isOpen()) {
+        const char *pData = nullptr;
+        qint64 nSize = 0;
+        QHexViewSession::STATE state = {};
+
+        if (g_session.getSection(QHexViewSession::SECTION_ANNOTATIONS, &pData, &nSize)) {
+            ui->scrollAreaHex->clearAnnotations();
+            ui->scrollAreaHex->appendAnnotations(QHexViewSession::dataToAnnotations(pData, nSize));
+        }
+
+        if (g_session.getSection(QHexViewSession::SECTION_STATE, &pData, &nSize) && QHexViewSession::dataToState(pData, nSize, &state)) {
+            if (QHexViewEncoding::getEncodings().contains((QHexViewEncoding::ENC)state.nEncoding)) {
+                ui->scrollAreaHex->setEncoding((QHexViewEncoding::ENC)state.nEncoding);
+            }
+
+            if (QHexView::getDisplayModes().contains((QHexView::DM)state.nDisplayMode)) {
+                ui->scrollAreaHex->setDisplayMode((QHexView::DM)state.nDisplayMode, state.nIsBigEndian);
+            }
+
+            if (state.nSelectionSize) {
+                _selectOffsetRange(state.nSelectionOffset, state.nSelectionSize);
+            } else {
+                goToOffset(state.nCursorOffset);
+            }
+        }
+
+        _loadSessionStrings();
+    }
+}
+
+void QHexViewWidget::_loadSessionStrings()
+{
+    const char *pData = nullptr;
+    qint64 nSize = 0;
+
+    // The records are read from the mapped file when the list is shown
+    if (g_pStringsWidget && g_session.getSection(QHexViewSession::SECTION_STRINGS, &pData, &nSize)) {
+        g_pStringsWidget->setIndexData(pData, nSize);
+    }
+}
+
+void QHexViewWidget::_closeSession()
+{
+    if (g_sSessionFileName != "") {
+        QHexViewSession session;
+        bool bCreated = false;
+
+        // Saved, grown or resized since the open: the old indexes do not match the file anymore
+        QHexViewSession::KEY key = QHexViewSession::getKey(g_sSessionFileName);
+        bool bUnchanged = QHexViewSession::isKeyEqual(key, g_sessionKey);
+
+        // Offsets of the decompressed view do not belong to the file
+        if (!g_pCompressedDataSource) {
+            bCreated = session.create(QHexViewSession::getSessionFileName(g_sSessionFileName), key);
+        }
+
+        if (bCreated) {
+            QHexView::STATE state = ui->scrollAreaHex->getState();
+
+            QHexViewSession::STATE sessionState = {};
+            sessionState.nCursorOffset = state.nCursorOffset;
+            sessionState.nSelectionOffset = state.nSelectionOffset;
+            sessionState.nSelectionSize = state.nSelectionSize;
+            sessionState.nDisplayMode = ui->scrollAreaHex->getDisplayMode();
+            sessionState.nEncoding = ui->scrollAreaHex->getEncoding();
+            sessionState.nIsBigEndian = ui->scrollAreaHex->isBigEndian();
+
+            session.addSection(QHexViewSession::SECTION_STATE, QHexViewSession::stateToData(sessionState));
+
+            QVector<QHexViewAnnotations::ANNOTATION> listAnnotations = ui->scrollAreaHex->getAnnotations();
+
+            if (listAnnotations.count()) {
+                session.addSection(QHexViewSession::SECTION_ANNOTATIONS, QHexViewSession::annotationsToData(listAnnotations));
+            }
+
+            // A changed file is parsed again on the next open
+            if (g_bSessionMemoryMap && bUnchanged) {
+                session.addSection(QHexViewSession::SECTION_MEMORY_MAP, QHexViewSession::memoryMapToData(*ui->scrollAreaHex->getMemoryMap()));
+            }
+
+            const char *pData = nullptr;
+            qint64 nSize = 0;
+
+            // Complete only if the data did not change after the scan
+            if (g_pStringsWidget && g_pStringsWidget->isIndexComplete()) {
+                QIODevice *pDevice = session.beginSection(QHexViewSession::SECTION_STRINGS);
+
+                if (pDevice && g_pStringsWidget->saveIndex(pDevice)) {
+                    session.endSection();
+                }
+            } else if (bUnchanged && g_session.getSection(QHexViewSession::SECTION_STRINGS, &pData, &nSize)) {
+                // Not scanned again: the index of the old file is kept
+                QIODevice *pDevice = session.beginSection(QHexViewSession::SECTION_STRINGS);
+
+                if (pDevice && (pDevice->write(pData, nSize) == nSize)) {
+                    session.endSection();
+                }
+            }
+        }
+
+        if (g_pStringsWidget) {
+            // The index may be read from the old file
+            g_pStringsWidget->setData(ui->scrollAreaHex->getDataSource());
+        }
+
+        g_session.close();
+
+        if (bCreated) {
+            session.commit();
+        }
+
+        g_sSessionFileName.clear();
+        g_sessionKey = {};
+        g_bSessionMemoryMap = false;
+    }
+}
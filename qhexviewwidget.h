@@ -21,18 +21,34 @@
 #ifndef QHEXVIEWWIDGET_H
 #define QHEXVIEWWIDGET_H
 
+#include <QActionGroup>
+#include <QBuffer>
+#include <QColorDialog>
 #include <QFileDialog>
+#include <QInputDialog>
 #include <QMenu>
 #include <QMessageBox>
+#include <QSaveFile>
 #include <QShortcut>
 #include <QWidget>
 
-#include "dialogdumpprocess.h"
 #include "dialoggotoaddress.h"
+#include "dialoghexprocess.h"
 #include "dialoghexsignature.h"
 #include "dialogsearch.h"
+#include "annotationprocess.h"
+#include "compressedindexprocess.h"
+#include "dialoghex.h"
+#include "dialoghexcompare.h"
 #include "dialogsearchprocess.h"
+#include "exportprocess.h"
+#include "filedumpprocess.h"
+#include "hashprocess.h"
 #include "qhexview.h"
+#include "qhexviewsession.h"
+#include "qhexviewstringswidget.h"
+#include "qhexviewtransformdatasource.h"
+#include "transformindexprocess.h"
 #include "xshortcuts.h"
 
 namespace Ui {
@@ -46,10 +62,12 @@ public:
     explicit QHexViewWidget(QWidget *pParent = nullptr);
     ~QHexViewWidget();
     void setData(QIODevice *pDevice, QHexView::OPTIONS *pOptions = nullptr);
+    void setDataSource(QHexViewDataSource *pDataSource, QHexView::OPTIONS *pOptions = nullptr);
     void setBackupFileName(QString sBackupFileName);
     void setSaveDirectory(QString sSaveDirectory);
     void enableHeader(bool bState);
     void enableReadOnly(bool bState);
+    void enableSession(bool bState);  // before setData: state, annotations and indexes are kept next to the file
     bool setReadonly(bool bState);
     void reload();
     bool isEdited();
@@ -73,13 +91,61 @@ private slots:
     void _dumpToFile();
     void _find();
     void _findNext();
+    void _processRequested(HexProcess *pProcess, QString sTitle);
+    void _replace();
+    void _replaceAll();
     void _selectAll();
     void _copyAsHex();
+    void _copyAs(QAction *pAction);
+    void _exportAs(QAction *pAction);
+    void _undo();
+    void _redo();
+    void _pasteHex();
+    void _pasteBytes();
+    void _fill();
+    void _increment();
+    void _xor();
+    void _save();
+    void _saveAs();
+    void _discardChanges();
     void _signature();
+    void _hash();
+    void _strings();
+    void _compare();
+    void _selectOffsetRange(qint64 nOffset, qint64 nSize);
+    void _follow(bool bState);
+    void _refresh(bool bState);
+    void _watchSelection();
+    void _nextDataExtent();
+    void _transform();
+    void _loadTemplates();
+    void _addStructure();
+    void _clearStructures();
+    void _addBookmark();
+    void _addAnnotation();
+    void _removeAnnotations();
+    void _clearAnnotations();
+    void _nextBookmark();
+    void _prevBookmark();
+    void _importAnnotations();
+    void _exportAnnotations();
+    void _memoryMapColors(bool bState);
+    void _encoding(QAction *pAction);
+    void _displayMode(QAction *pAction);
+    void _bigEndian(bool bState);
+    void _decompressed(bool bState);
+    void _reloadData();
     void _customContextMenu(const QPoint &pos);
     void _errorMessage(QString sText);
     QString getDumpName();
+    void _export(ExportProcess::EF format, bool bClipboard);
+    void _patchSelection(PatchProcess::PO op, QString sTitle);
+    void _replaceData(bool bAll);
     void registerShortcuts(bool bState);
+    void _openSession();  // before the data is set: the memory map is restored from it
+    void _loadSession();
+    void _loadSessionStrings();
+    void _closeSession();  // saved first
 
 private:
     Ui::QHexViewWidget *ui;
@@ -93,6 +159,23 @@ private:
     QShortcut *g_scSignature;
 
     QString g_sSaveDirectory;
+    QHexViewStringsWidget *g_pStringsWidget;
+    QIODevice *g_pDevice;
+    QHexViewDataSource *g_pDataSource;
+    QHexView::OPTIONS g_options;
+    QHexViewCompressedDataSource *g_pCompressedDataSource;
+    QString g_sTransforms;
+    QString g_sReplaceFind;
+    QString g_sReplaceWith;
+    QList<QHexViewStructures::STRUCT> g_listStructs;  // loaded templates
+    bool g_bSession;
+    QHexViewSession g_session;  // mapped, the strings index may point into it
+    QString g_sSessionFileName;
+    QHexViewSession::KEY g_sessionKey;  // of the file when the session was opened, the old indexes belong to it
+    bool g_bSessionMemoryMap;           // not passed by the host, saved with the session
+
+    const qint64 N_CLIPBOARD_LIMIT = 0x4000000;  // 64 MB of text
+    const qint64 N_REPLACE_PREVIEW = 100;          // occurrences listed before replace all
 };
 
 #endif  // QHEXVIEWWIDGET_H
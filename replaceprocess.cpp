@@ -0,0 +1,431 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "replaceprocess.h"
+
+ReplaceProcess::ReplaceProcess(QObject *pParent) : HexProcess(pParent)
+{
+    g_pDataSource = nullptr;
+    g_nOffset = 0;
+    g_nSize = 0;
+    g_mode = RM_PREVIEW;
+    g_nLimit = -1;
+    g_nCount = 0;
+    g_pUndo = nullptr;
+    g_bUndoData = false;
+    g_nUndoOffset = 0;
+    g_nUndoEnd = 0;
+}
+
+void ReplaceProcess::setData(QHexViewDataSource *pDataSource, qint64 nOffset, qint64 nSize, const QByteArray &baFind, const QByteArray &baReplace, RM mode,
+                             qint64 nLimit)
+{
+    g_pDataSource = pDataSource;
+    g_nOffset = nOffset;
+    g_nSize = nSize;
+    g_baFind = baFind;
+    g_baReplace = baReplace;
+    g_mode = mode;
+    g_nLimit = nLimit;
+}
+
+void ReplaceProcess::setOffsets(const QVector<qint64> &listOffsets)
+{
+    g_listOffsets = listOffsets;
+}
+
+void ReplaceProcess::setUndoDevice(QIODevice *pDevice)
+{
+    g_pUndo = pDevice;
+}
+
+qint64 ReplaceProcess::getUndoOffset()
+{
+    return g_nUndoOffset;
+}
+
+qint64 ReplaceProcess::getUndoSize()
+{
+    return g_nUndoEnd - g_nUndoOffset;
+}
+
+qint64 ReplaceProcess::getCount()
+{
+    return g_nCount;
+}
+
+QVector<qint64> ReplaceProcess::getOffsets()
+{
+    return g_listOffsets;
+}
+
+bool ReplaceProcess::_process()
+{
+    bool bResult = false;
+
+    g_nCount = 0;
+
+    if (openSource(g_pDataSource)) {
+        if (g_mode == RM_RESTORE) {
+            bResult = _restore();
+        } else {
+            g_listOffsets.clear();
+            g_bUndoData = false;
+            g_nUndoOffset = 0;
+            g_nUndoEnd = 0;
+
+            bResult = _search();
+        }
+
+        closeSource();
+    }
+
+    return bResult;
+}
+
+bool ReplaceProcess::_search()
+{
+    bool bResult = false;
+
+    setTotal(g_nSize);
+    setStatus((g_mode == RM_PREVIEW) ? tr("Search") : tr("Replace"));
+
+    qint64 nFindSize = g_baFind.size();
+    bool bValid = (nFindSize > 0) && (nFindSize <= N_BUFFER_SIZE / 2);
+
+    if (g_mode == RM_REPLACE) {
+        bValid = bValid && (g_baReplace.size() == nFindSize);
+    }
+
+    QFile *pFile = nullptr;
+    QTemporaryFile output;
+
+    if (bValid && (g_mode == RM_RESIZE)) {
+        // Only files can change their size in place
+        pFile = qobject_cast<QFile *>(g_pDataSource->getDevice());
+        bValid = pFile && pFile->isWritable() && output.open();
+    }
+
+    if (bValid) {
+        QByteArrayMatcher matcher(g_baFind);
+        QByteArray baBuffer(N_BUFFER_SIZE, 0);
+        char *pBuffer = baBuffer.data();
+
+        qint64 nEnd = g_nOffset + g_nSize;
+        qint64 nPosition = g_nOffset;
+        qint64 nStart = -1;  // RM_RESIZE: first hit, the output holds the new data from there
+        bool bLimit = false;
+
+        // An occurrence with a nonzero byte needs a data extent, holes are skipped.
+        // Not when resizing, the output gets every byte
+        bool bSkipHoles = (g_mode != RM_RESIZE) && g_pDataSource->isSparse() && (g_baFind.count('\0') != nFindSize);
+
+        bResult = true;
+
+        while (bResult && (!bLimit) && (nPosition + nFindSize <= nEnd) && (!isStopped())) {
+            if ((g_mode == RM_REPLACE) && g_pUndo && (!g_bUndoData) && (g_listOffsets.count() > N_MAX_UNDO_OFFSETS)) {
+                // 8 bytes per hit: a one byte pattern over a large file would not fit in memory
+                bResult = _startUndoData(nPosition);
+
+                if (!bResult) {
+                    break;
+                }
+            }
+
+            if (bSkipHoles) {
+                qint64 nDataOffset = g_pDataSource->getNextData(nPosition);
+
+                if (nDataOffset == -1) {
+                    break;
+                }
+
+                // The zeros at the end of the hole can be the start of the pattern
+                nPosition = qMax(nPosition, nDataOffset - (nFindSize - 1));
+
+                if (nPosition + nFindSize > nEnd) {
+                    break;
+                }
+            }
+
+            qint64 nReadSize = qMin(N_BUFFER_SIZE, nEnd - nPosition);
+
+            if (readAt(nPosition, pBuffer, nReadSize) != nReadSize) {
+                emit errorMessage(tr("Read error"));
+                bResult = false;
+                break;
+            }
+
+            qint32 nFrom = 0;
+            qint32 nCopied = 0;      // RM_RESIZE: part of the buffer already in the output
+            qint32 nSpanStart = -1;  // RM_REPLACE: first changed byte of the buffer
+
+            while (bResult) {
+                if ((g_mode != RM_PREVIEW) && (g_nLimit != -1) && (g_nCount >= g_nLimit)) {
+                    bLimit = true;
+                    break;
+                }
+
+                qint32 nIndex = matcher.indexIn(pBuffer, (qint32)nReadSize, nFrom);
+
+                if (nIndex == -1) {
+                    break;
+                }
+
+                g_nCount++;
+
+                if (g_mode == RM_PREVIEW) {
+                    if ((g_nLimit == -1) || (g_listOffsets.count() < g_nLimit)) {
+                        g_listOffsets.append(nPosition + nIndex);
+                    }
+                } else if (g_mode == RM_REPLACE) {
+                    if (g_bUndoData) {
+                        // The old bytes up to the end of the hit, before they are changed
+                        if (!_appendUndoData(nPosition + nIndex + nFindSize, nPosition, pBuffer)) {
+                            emit errorMessage(tr("Cannot create undo data"));
+                            bResult = false;
+                            break;
+                        }
+                    } else {
+                        g_listOffsets.append(nPosition + nIndex);
+                    }
+
+                    memcpy(pBuffer + nIndex, g_baReplace.constData(), nFindSize);
+
+                    if (nSpanStart == -1) {
+                        nSpanStart = nIndex;
+                    }
+                } else if (g_mode == RM_RESIZE) {
+                    if (nStart == -1) {
+                        nStart = nPosition + nIndex;
+                        nCopied = nIndex;
+                    }
+
+                    if ((output.write(pBuffer + nCopied, nIndex - nCopied) != nIndex - nCopied) || (output.write(g_baReplace) != g_baReplace.size())) {
+                        emit errorMessage(tr("Write error"));
+                        bResult = false;
+                    }
+
+                    nCopied = nIndex + (qint32)nFindSize;
+                }
+
+                nFrom = nIndex + (qint32)nFindSize;
+            }
+
+            // The tail that can hold the start of an occurrence is read again with the next block
+            qint64 nAdvance = nReadSize;
+
+            if (bLimit) {
+                nAdvance = nFrom;
+            } else if (nPosition + nReadSize < nEnd) {
+                nAdvance = qMax((qint64)nFrom, nReadSize - (nFindSize - 1));
+            }
+
+            if (bResult && (nSpanStart != -1)) {
+                // One positional write for all hits of the block
+                qint64 nSpanSize = nFrom - nSpanStart;
+
+                if (g_pDataSource->writeAt(nPosition + nSpanStart, pBuffer + nSpanStart, nSpanSize) != nSpanSize) {
+                    emit errorMessage(tr("Write error"));
+                    bResult = false;
+                }
+            }
+
+            if (bResult && (nStart != -1) && (nAdvance > nCopied)) {
+                if (output.write(pBuffer + nCopied, nAdvance - nCopied) != nAdvance - nCopied) {
+                    emit errorMessage(tr("Write error"));
+                    bResult = false;
+                }
+            }
+
+            nPosition += nAdvance;
+
+            setCurrent(nPosition - g_nOffset);
+        }
+
+        if (bResult && (!isStopped()) && (nStart != -1)) {
+            // The data after the searched range moves too
+            qint64 nSourceSize = g_pDataSource->getSize();
+
+            while (bResult && (nPosition < nSourceSize)) {
+                qint64 nReadSize = qMin(N_BUFFER_SIZE, nSourceSize - nPosition);
+
+                if ((readAt(nPosition, pBuffer, nReadSize) != nReadSize) || (output.write(pBuffer, nReadSize) != nReadSize)) {
+                    emit errorMessage(tr("Write error"));
+                    bResult = false;
+                }
+
+                nPosition += nReadSize;
+            }
+
+            if (bResult) {
+                bResult = _writeBack(pFile, &output, nStart);
+            }
+        }
+    }
+
+    return bResult;
+}
+
+bool ReplaceProcess::_restore()
+{
+    bool bResult = false;
+
+    qint64 nDataSize = g_baReplace.size();
+    qint32 nNumberOfOffsets = g_listOffsets.count();
+
+    setTotal(nNumberOfOffsets);
+    setStatus(tr("Restore"));
+
+    if ((nDataSize > 0) && (nDataSize <= N_BUFFER_SIZE)) {
+        QByteArray baBuffer(N_BUFFER_SIZE, 0);
+        char *pBuffer = baBuffer.data();
+
+        bResult = true;
+
+        qint32 i = 0;
+
+        while (bResult && (i < nNumberOfOffsets) && (!isStopped())) {
+            // Offsets close to each other share one read and one write
+            qint64 nSpanStart = g_listOffsets.at(i);
+            qint32 j = i;
+
+            while ((j + 1 < nNumberOfOffsets) && (g_listOffsets.at(j + 1) + nDataSize - nSpanStart <= N_BUFFER_SIZE)) {
+                j++;
+            }
+
+            qint64 nSpanSize = g_listOffsets.at(j) + nDataSize - nSpanStart;
+
+            if ((j != i) && (readAt(nSpanStart, pBuffer, nSpanSize) != nSpanSize)) {
+                emit errorMessage(tr("Read error"));
+                bResult = false;
+                break;
+            }
+
+            for (qint32 k = i; k <= j; k++) {
+                memcpy(pBuffer + (g_listOffsets.at(k) - nSpanStart), g_baReplace.constData(), nDataSize);
+            }
+
+            if (g_pDataSource->writeAt(nSpanStart, pBuffer, nSpanSize) != nSpanSize) {
+                emit errorMessage(tr("Write error"));
+                bResult = false;
+            }
+
+            i = j + 1;
+
+            setCurrent(i);
+        }
+    }
+
+    return bResult;
+}
+
+bool ReplaceProcess::_startUndoData(qint64 nPosition)
+{
+    // The hits before nPosition are written: the data there is read back and the pattern is put in again
+    g_nUndoOffset = g_listOffsets.first();
+    g_nUndoEnd = g_nUndoOffset;
+
+    bool bResult = _appendUndoData(nPosition, nPosition, nullptr);
+
+    qint32 nNumberOfOffsets = g_listOffsets.count();
+
+    for (qint32 i = 0; bResult && (i < nNumberOfOffsets); i++) {
+        bResult = g_pUndo->seek(g_listOffsets.at(i) - g_nUndoOffset) && (g_pUndo->write(g_baFind) == g_baFind.size());
+    }
+
+    bResult = bResult && g_pUndo->seek(g_nUndoEnd - g_nUndoOffset);
+
+    if (bResult) {
+        g_listOffsets.clear();
+        g_listOffsets.squeeze();
+        g_bUndoData = true;
+    } else {
+        emit errorMessage(tr("Cannot create undo data"));
+    }
+
+    return bResult;
+}
+
+bool ReplaceProcess::_appendUndoData(qint64 nTo, qint64 nPosition, const char *pBuffer)
+{
+    bool bResult = true;
+
+    // Before nPosition the source has the old data, from there the buffer
+    qint64 nSourceEnd = qMin(nTo, nPosition);
+
+    if (g_nUndoEnd < nSourceEnd) {
+        QByteArray baBuffer((qint32)qMin(N_BUFFER_SIZE, nSourceEnd - g_nUndoEnd), 0);
+
+        while (bResult && (g_nUndoEnd < nSourceEnd)) {
+            qint64 nSize = qMin((qint64)baBuffer.size(), nSourceEnd - g_nUndoEnd);
+
+            bResult = (readAt(g_nUndoEnd, baBuffer.data(), nSize) == nSize) && (g_pUndo->write(baBuffer.constData(), nSize) == nSize);
+
+            g_nUndoEnd += nSize;
+        }
+    }
+
+    if (bResult && (nTo > g_nUndoEnd)) {
+        qint64 nSize = nTo - g_nUndoEnd;
+
+        bResult = (g_pUndo->write(pBuffer + (g_nUndoEnd - nPosition), nSize) == nSize);
+
+        g_nUndoEnd = nTo;
+    }
+
+    return bResult;
+}
+
+bool ReplaceProcess::_writeBack(QFile *pFile, QIODevice *pOutput, qint64 nStart)
+{
+    bool bResult = pOutput->seek(0);
+
+    qint64 nOutputSize = pOutput->size();
+
+    setTotal(nOutputSize);
+    setCurrent(0);
+    setStatus(tr("Write"));
+
+    QByteArray baBuffer(N_BUFFER_SIZE, 0);
+    char *pBuffer = baBuffer.data();
+
+    qint64 nCurrent = 0;
+
+    // Not stopped here, the file would be left half rewritten
+    while (bResult && (nCurrent < nOutputSize)) {
+        qint64 nSize = qMin(N_BUFFER_SIZE, nOutputSize - nCurrent);
+
+        if ((pOutput->read(pBuffer, nSize) != nSize) || (g_pDataSource->writeAt(nStart + nCurrent, pBuffer, nSize) != nSize)) {
+            emit errorMessage(tr("Write error"));
+            bResult = false;
+        }
+
+        nCurrent += nSize;
+
+        setCurrent(nCurrent);
+    }
+
+    if (bResult && (!pFile->resize(nStart + nOutputSize))) {
+        emit errorMessage(tr("Cannot resize file"));
+        bResult = false;
+    }
+
+    return bResult;
+}
@@ -0,0 +1,85 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef REPLACEPROCESS_H
+#define REPLACEPROCESS_H
+
+#include <QByteArrayMatcher>
+#include <QFile>
+#include <QTemporaryFile>
+#include <QVector>
+
+#include "hexprocess.h"
+
+// Non-overlapping occurrences of a byte pattern, from left to right
+class ReplaceProcess : public HexProcess {
+    Q_OBJECT
+
+public:
+    enum RM {
+        RM_PREVIEW = 0,  // count, the first nLimit offsets are kept
+        RM_REPLACE,      // patterns of equal size, in place
+        RM_RESIZE,       // patterns of different size, the file is rewritten from the first hit
+        RM_RESTORE       // write the pattern at the offsets set by setOffsets, for undo
+    };
+
+    enum {
+        N_MAX_UNDO_OFFSETS = 0x400000  // RM_REPLACE: more hits are undone from the old data in the undo device
+    };
+
+    explicit ReplaceProcess(QObject *pParent = nullptr);
+    // nLimit: offsets kept by RM_PREVIEW, maximum number of replacements otherwise. -1 no limit
+    void setData(QHexViewDataSource *pDataSource, qint64 nOffset, qint64 nSize, const QByteArray &baFind, const QByteArray &baReplace, RM mode, qint64 nLimit = -1);
+    void setOffsets(const QVector<qint64> &listOffsets);
+    // RM_REPLACE: gets the old data from the first hit to the end of the last one if there are too many offsets
+    void setUndoDevice(QIODevice *pDevice);
+    qint64 getCount();
+    QVector<qint64> getOffsets();  // empty if the undo device was used
+    qint64 getUndoOffset();
+    qint64 getUndoSize();
+
+protected:
+    bool _process() override;
+
+private:
+    bool _search();
+    bool _restore();
+    bool _startUndoData(qint64 nPosition);
+    bool _appendUndoData(qint64 nTo, qint64 nPosition, const char *pBuffer);
+    bool _writeBack(QFile *pFile, QIODevice *pOutput, qint64 nStart);
+
+    const qint64 N_BUFFER_SIZE = 0x100000;
+
+    QHexViewDataSource *g_pDataSource;
+    qint64 g_nOffset;
+    qint64 g_nSize;
+    QByteArray g_baFind;
+    QByteArray g_baReplace;
+    RM g_mode;
+    qint64 g_nLimit;
+    qint64 g_nCount;
+    QVector<qint64> g_listOffsets;
+    QIODevice *g_pUndo;
+    bool g_bUndoData;
+    qint64 g_nUndoOffset;
+    qint64 g_nUndoEnd;
+};
+
+#endif  // REPLACEPROCESS_H
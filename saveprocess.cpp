@@ -0,0 +1,110 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "saveprocess.h"
+
+SaveProcess::SaveProcess(QObject *pParent) : HexProcess(pParent)
+{
+    g_pOverlay = nullptr;
+}
+
+void SaveProcess::setData(QHexViewOverlayDataSource *pOverlay)
+{
+    g_pOverlay = pOverlay;
+}
+
+bool SaveProcess::_process()
+{
+    bool bResult = false;
+
+    QHexViewDataSource *pSource = g_pOverlay ? g_pOverlay->getSource() : nullptr;
+
+    if (openSource(pSource)) {
+        QMap<qint64, QByteArray> mapExtents = g_pOverlay->getExtents();
+
+        setTotal(g_pOverlay->getModifiedSize());
+        setStatus(tr("Save"));
+
+        bResult = true;
+
+        qint64 nCurrent = 0;
+        QByteArray baBuffer;
+        qint64 nBufferOffset = -1;
+
+        // Not stopped: the file and the edits in memory must stay in one state
+        for (QMap<qint64, QByteArray>::const_iterator it = mapExtents.constBegin(); bResult && (it != mapExtents.constEnd()); it++) {
+            qint64 nOffset = it.key();
+            const QByteArray &baData = it.value();
+
+            if (nBufferOffset != -1) {
+                qint64 nGap = nOffset - (nBufferOffset + baBuffer.size());
+
+                if ((nGap <= N_MERGE_GAP) && (baBuffer.size() + nGap + baData.size() <= N_BUFFER_SIZE)) {
+                    qint32 nBufferSize = baBuffer.size();
+                    baBuffer.resize(nBufferSize + nGap);
+
+                    if (readAt(nOffset - nGap, baBuffer.data() + nBufferSize, nGap) != nGap) {
+                        emit errorMessage(tr("Read error"));
+                        bResult = false;
+                        break;
+                    }
+                } else {
+                    bResult = _write(pSource, nBufferOffset, baBuffer);
+                    nBufferOffset = -1;
+                }
+            }
+
+            if (bResult) {
+                if (nBufferOffset == -1) {
+                    nBufferOffset = nOffset;
+                    baBuffer = baData;
+                } else {
+                    baBuffer.append(baData);
+                }
+
+                nCurrent += baData.size();
+                setCurrent(nCurrent);
+            }
+        }
+
+        if (bResult && (nBufferOffset != -1)) {
+            bResult = _write(pSource, nBufferOffset, baBuffer);
+        }
+
+        if (bResult) {
+            g_pOverlay->clear();
+        }
+
+        closeSource();
+    }
+
+    return bResult;
+}
+
+bool SaveProcess::_write(QHexViewDataSource *pSource, qint64 nOffset, const QByteArray &baData)
+{
+    bool bResult = (pSource->writeAt(nOffset, baData.constData(), baData.size()) == baData.size());
+
+    if (!bResult) {
+        emit errorMessage(tr("Write error"));
+    }
+
+    return bResult;
+}
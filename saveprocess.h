@@ -0,0 +1,47 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef SAVEPROCESS_H
+#define SAVEPROCESS_H
+
+#include "hexprocess.h"
+#include "qhexviewoverlaydatasource.h"
+
+// Writes the edits of an overlay to its source. Near extents are joined to one write
+class SaveProcess : public HexProcess {
+    Q_OBJECT
+
+public:
+    explicit SaveProcess(QObject *pParent = nullptr);
+    void setData(QHexViewOverlayDataSource *pOverlay);
+
+protected:
+    bool _process() override;
+
+private:
+    bool _write(QHexViewDataSource *pSource, qint64 nOffset, const QByteArray &baData);
+
+    const qint64 N_BUFFER_SIZE = 0x400000;
+    const qint64 N_MERGE_GAP = 0x1000;  // the unchanged bytes between two extents are rewritten
+
+    QHexViewOverlayDataSource *g_pOverlay;
+};
+
+#endif  // SAVEPROCESS_H
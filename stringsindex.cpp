@@ -0,0 +1,180 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "stringsindex.h"
+
+StringsIndex::StringsIndex()
+{
+    g_nCount = 0;
+    g_pData = nullptr;
+    g_cachePages.setMaxCost(64);
+}
+
+StringsIndex::~StringsIndex()
+{
+    close();
+}
+
+bool StringsIndex::open()
+{
+    QMutexLocker locker(&g_mutex);
+
+    bool bResult = g_file.isOpen();
+
+    if (!bResult) {
+        bResult = g_file.open();
+    }
+
+    return bResult;
+}
+
+void StringsIndex::close()
+{
+    QMutexLocker locker(&g_mutex);
+
+    if (g_file.isOpen()) {
+        g_file.close();
+    }
+
+    g_listPending.clear();
+    g_cachePages.clear();
+    g_nCount = 0;
+    g_pData = nullptr;
+}
+
+void StringsIndex::clear()
+{
+    QMutexLocker locker(&g_mutex);
+
+    g_file.resize(0);
+    g_listPending.clear();
+    g_cachePages.clear();
+    g_nCount = 0;
+    g_pData = nullptr;
+}
+
+void StringsIndex::append(const RECORD &record)
+{
+    g_listPending.append(record);
+
+    if (g_listPending.count() >= N_PENDING_SIZE) {
+        flush();
+    }
+}
+
+void StringsIndex::flush()
+{
+    if (g_listPending.count()) {
+        QMutexLocker locker(&g_mutex);
+
+        qint64 nSize = g_listPending.count() * (qint64)sizeof(RECORD);
+
+        if (g_file.seek(g_nCount * (qint64)sizeof(RECORD)) && (g_file.write((const char *)g_listPending.constData(), nSize) == nSize)) {
+            // The last page may be incomplete
+            g_cachePages.remove(g_nCount / N_PAGE_SIZE);
+            g_nCount += g_listPending.count();
+        }
+
+        g_listPending.clear();
+    }
+}
+
+qint64 StringsIndex::getCount()
+{
+    QMutexLocker locker(&g_mutex);
+
+    return g_nCount;
+}
+
+StringsIndex::RECORD StringsIndex::getRecord(qint64 nIndex)
+{
+    QMutexLocker locker(&g_mutex);
+
+    RECORD result = {};
+    result.nOffset = -1;
+
+    if (g_pData) {
+        if ((nIndex >= 0) && (nIndex < g_nCount)) {
+            result = g_pData[nIndex];
+        }
+    } else if ((nIndex >= 0) && (nIndex < g_nCount)) {
+        qint64 nPage = nIndex / N_PAGE_SIZE;
+
+        QVector<RECORD> *pPage = g_cachePages.object(nPage);
+
+        if (!pPage) {
+            qint64 nPageCount = qMin((qint64)N_PAGE_SIZE, g_nCount - nPage * N_PAGE_SIZE);
+
+            pPage = new QVector<RECORD>((qint32)nPageCount);
+
+            if (g_file.seek(nPage * N_PAGE_SIZE * (qint64)sizeof(RECORD))) {
+                g_file.read((char *)pPage->data(), nPageCount * (qint64)sizeof(RECORD));
+            }
+
+            g_cachePages.insert(nPage, pPage);
+        }
+
+        result = pPage->at((qint32)(nIndex % N_PAGE_SIZE));
+    }
+
+    return result;
+}
+
+void StringsIndex::setData(const RECORD *pData, qint64 nCount)
+{
+    QMutexLocker locker(&g_mutex);
+
+    g_listPending.clear();
+    g_cachePages.clear();
+    g_pData = pData;
+    g_nCount = nCount;
+}
+
+bool StringsIndex::save(QIODevice *pDevice)
+{
+    flush();
+
+    QMutexLocker locker(&g_mutex);
+
+    bool bResult = true;
+
+    if (g_pData) {
+        qint64 nSize = g_nCount * (qint64)sizeof(RECORD);
+
+        bResult = (pDevice->write((const char *)g_pData, nSize) == nSize);
+    } else {
+        // Page by page, the index can be larger than the memory
+        QByteArray baBuffer(N_PAGE_SIZE * (qint32)sizeof(RECORD), 0);
+        qint64 nTotalSize = g_nCount * (qint64)sizeof(RECORD);
+        qint64 nCurrent = 0;
+
+        bResult = (nTotalSize == 0) || g_file.seek(0);
+
+        while (bResult && (nCurrent < nTotalSize)) {
+            qint64 nSize = qMin(nTotalSize - nCurrent, (qint64)baBuffer.size());
+
+            bResult = (g_file.read(baBuffer.data(), nSize) == nSize) && (pDevice->write(baBuffer.constData(), nSize) == nSize);
+
+            nCurrent += nSize;
+        }
+    }
+
+    return bResult;
+}
@@ -0,0 +1,69 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef STRINGSINDEX_H
+#define STRINGSINDEX_H
+
+#include <QCache>
+#include <QIODevice>
+#include <QMutex>
+#include <QTemporaryFile>
+#include <QVector>
+
+// Fixed-size records in a temporary file, pages are loaded on demand
+class StringsIndex {
+public:
+    enum ST {
+        ST_ANSI = 0,
+        ST_UTF16LE,
+        ST_UTF16BE
+    };
+
+    struct RECORD {
+        qint64 nOffset;
+        quint32 nSize;
+        quint32 nType;
+    };
+
+    StringsIndex();
+    ~StringsIndex();
+    bool open();
+    void close();
+    void clear();
+    void append(const RECORD &record);
+    void flush();
+    qint64 getCount();
+    RECORD getRecord(qint64 nIndex);
+    void setData(const RECORD *pData, qint64 nCount);  // records kept elsewhere (a mapped session), read only
+    bool save(QIODevice *pDevice);
+
+private:
+    const qint32 N_PAGE_SIZE = 0x1000;  // records
+    const qint32 N_PENDING_SIZE = 0x1000;
+
+    QMutex g_mutex;
+    const RECORD *g_pData;
+    QTemporaryFile g_file;
+    QVector<RECORD> g_listPending;
+    qint64 g_nCount;
+    QCache<qint64, QVector<RECORD>> g_cachePages;
+};
+
+#endif  // STRINGSINDEX_H
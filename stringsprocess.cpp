@@ -0,0 +1,273 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "stringsprocess.h"
+
+#ifdef Q_PROCESSOR_X86_64
+#include <emmintrin.h>
+#endif
+
+StringsProcess::StringsProcess(QObject *pParent) : HexProcess(pParent)
+{
+    g_pDataSource = nullptr;
+    g_options = {};
+    g_pIndex = nullptr;
+
+    for (qint32 i = 0; i < __STATE_SIZE; i++) {
+        g_nStart[i] = -1;
+    }
+}
+
+void StringsProcess::setData(QHexViewDataSource *pDataSource, OPTIONS options, StringsIndex *pIndex)
+{
+    g_pDataSource = pDataSource;
+    g_options = options;
+    g_pIndex = pIndex;
+}
+
+void StringsProcess::getMasks(const char *pData, qint32 nSize, quint64 *pPrintable, quint64 *pZero)
+{
+    qint32 nNumberOfWords = (nSize + 63) / 64;
+
+    for (qint32 i = 0; i < nNumberOfWords; i++) {
+        quint64 nPrintable = 0;
+        quint64 nZero = 0;
+        qint32 nOffset = i * 64;
+
+#ifdef Q_PROCESSOR_X86_64
+        if (nOffset + 64 <= nSize) {
+            // Printable is 0x20-0x7E, bytes above 0x7F are negative in the signed compare
+            const __m128i xLow = _mm_set1_epi8(0x1F);
+            const __m128i xHigh = _mm_set1_epi8(0x7F);
+            const __m128i xNull = _mm_setzero_si128();
+
+            for (qint32 j = 0; j < 4; j++) {
+                __m128i xData = _mm_loadu_si128((const __m128i *)(pData + nOffset + j * 16));
+                quint32 nP = (quint32)_mm_movemask_epi8(_mm_and_si128(_mm_cmpgt_epi8(xData, xLow), _mm_cmplt_epi8(xData, xHigh)));
+                quint32 nZ = (quint32)_mm_movemask_epi8(_mm_cmpeq_epi8(xData, xNull));
+
+                nPrintable |= ((quint64)nP) << (j * 16);
+                nZero |= ((quint64)nZ) << (j * 16);
+            }
+        } else
+#endif
+        {
+            for (qint32 j = 0; (j < 64) && (nOffset + j < nSize); j++) {
+                quint8 nByte = (quint8)pData[nOffset + j];
+
+                if ((nByte >= 0x20) && (nByte <= 0x7E)) {
+                    nPrintable |= (1ULL << j);
+                }
+
+                if (nByte == 0) {
+                    nZero |= (1ULL << j);
+                }
+            }
+        }
+
+        pPrintable[i] = nPrintable;
+        pZero[i] = nZero;
+    }
+}
+
+bool StringsProcess::_process()
+{
+    bool bResult = false;
+
+    for (qint32 i = 0; i < __STATE_SIZE; i++) {
+        g_nStart[i] = -1;
+    }
+
+    if (g_pIndex && g_pIndex->open() && openSource(g_pDataSource)) {
+        bResult = true;
+
+        qint64 nTotalSize = g_pDataSource->getSize();
+
+        setTotal(nTotalSize);
+        setStatus(tr("Strings"));
+
+        // One byte of lookahead, UTF-16 needs the byte after the last one
+        QByteArray baBuffer;
+        baBuffer.resize(N_BUFFER_SIZE + 1);
+
+        bool bIsSparse = g_pDataSource->isSparse();
+
+        qint64 nCurrent = 0;
+
+        while ((nCurrent < nTotalSize) && (!isStopped())) {
+            if (bIsSparse) {
+                qint64 nDataOffset = g_pDataSource->getNextData(nCurrent);
+
+                if (nDataOffset == -1) {
+                    nDataOffset = nTotalSize;
+                }
+
+                // A hole has no strings: a few zeros close the open ones, the rest is skipped
+                if (nDataOffset - nCurrent > N_HOLE_SIZE) {
+                    QByteArray baZeros(N_HOLE_SIZE + 1, 0);
+
+                    _scanBlock(baZeros.constData(), N_HOLE_SIZE, nCurrent);
+
+                    nCurrent = nDataOffset;
+
+                    setCurrent(nCurrent);
+
+                    continue;
+                }
+            }
+
+            qint32 nBlockSize = (qint32)qMin(nTotalSize - nCurrent, (qint64)N_BUFFER_SIZE);
+            qint32 nReadSize = (qint32)qMin(nTotalSize - nCurrent, (qint64)N_BUFFER_SIZE + 1);
+
+            if (readAt(nCurrent, baBuffer.data(), nReadSize) != nReadSize) {
+                emit errorMessage(tr("Read error"));
+                bResult = false;
+                break;
+            }
+
+            if (nReadSize == nBlockSize) {
+                baBuffer[nBlockSize] = (char)0xFF;
+            }
+
+            _scanBlock(baBuffer.data(), nBlockSize, nCurrent);
+
+            nCurrent += nBlockSize;
+
+            g_pIndex->flush();
+
+            setCurrent(nCurrent);
+        }
+
+        if (bResult && (!isStopped())) {
+            for (qint32 i = 0; i < __STATE_SIZE; i++) {
+                _closeState((STATE)i, nTotalSize);
+            }
+        }
+
+        g_pIndex->flush();
+
+        closeSource();
+    }
+
+    return bResult;
+}
+
+void StringsProcess::_scanBlock(const char *pData, qint32 nSize, qint64 nBase)
+{
+    qint32 nNumberOfWords = (nSize + 1 + 63) / 64;
+
+    g_listPrintable.resize(nNumberOfWords + 1);
+    g_listZero.resize(nNumberOfWords + 1);
+
+    getMasks(pData, nSize + 1, g_listPrintable.data(), g_listZero.data());
+
+    g_listPrintable[nNumberOfWords] = 0;
+    g_listZero[nNumberOfWords] = 0;
+
+    const quint64 *pPrintable = g_listPrintable.constData();
+    const quint64 *pZero = g_listZero.constData();
+
+    qint32 nBlockWords = (nSize + 63) / 64;
+
+    for (qint32 i = 0; i < nBlockWords; i++) {
+        // Bit j of UTF16LE is set if the char at j is printable and j+1 is zero, UTF16BE the other way round
+        quint64 nAnsi = g_options.bAnsi ? pPrintable[i] : 0;
+        quint64 nUTF16LE = g_options.bUTF16LE ? (pPrintable[i] & ((pZero[i] >> 1) | (pZero[i + 1] << 63))) : 0;
+        quint64 nUTF16BE = g_options.bUTF16BE ? (pZero[i] & ((pPrintable[i] >> 1) | (pPrintable[i + 1] << 63))) : 0;
+
+        qint32 nNumberOfBits = qMin(nSize - i * 64, 64);
+
+        if (nNumberOfBits == 64) {
+            bool bIdle = (g_nStart[STATE_UTF16LE_EVEN] == -1) && (g_nStart[STATE_UTF16LE_ODD] == -1) && (g_nStart[STATE_UTF16BE_EVEN] == -1) &&
+                         (g_nStart[STATE_UTF16BE_ODD] == -1) && (nUTF16LE == 0) && (nUTF16BE == 0);
+
+            if (bIdle) {
+                if (((g_nStart[STATE_ANSI] == -1) && (nAnsi == 0)) || ((g_nStart[STATE_ANSI] != -1) && (nAnsi == ~0ULL))) {
+                    continue;
+                }
+            }
+        }
+
+        for (qint32 j = 0; j < nNumberOfBits; j++) {
+            qint64 nPosition = nBase + i * 64 + j;
+            qint32 nParity = (qint32)(nPosition & 1);
+
+            if ((nAnsi >> j) & 1) {
+                if (g_nStart[STATE_ANSI] == -1) {
+                    g_nStart[STATE_ANSI] = nPosition;
+                }
+            } else {
+                _closeState(STATE_ANSI, nPosition);
+            }
+
+            STATE stateLE = (STATE)(STATE_UTF16LE_EVEN + nParity);
+
+            if ((nUTF16LE >> j) & 1) {
+                if (g_nStart[stateLE] == -1) {
+                    g_nStart[stateLE] = nPosition;
+                }
+            } else {
+                _closeState(stateLE, nPosition);
+            }
+
+            STATE stateBE = (STATE)(STATE_UTF16BE_EVEN + nParity);
+
+            if ((nUTF16BE >> j) & 1) {
+                if (g_nStart[stateBE] == -1) {
+                    g_nStart[stateBE] = nPosition;
+                }
+            } else {
+                _closeState(stateBE, nPosition);
+            }
+        }
+    }
+}
+
+void StringsProcess::_closeState(STATE state, qint64 nPosition)
+{
+    if (g_nStart[state] != -1) {
+        qint64 nSize = nPosition - g_nStart[state];
+
+        StringsIndex::RECORD record = {};
+        record.nOffset = g_nStart[state];
+        record.nSize = (quint32)nSize;
+
+        bool bAdd = false;
+
+        if (state == STATE_ANSI) {
+            record.nType = StringsIndex::ST_ANSI;
+            bAdd = (nSize >= g_options.nMinLength);
+        } else {
+            if ((state == STATE_UTF16LE_EVEN) || (state == STATE_UTF16LE_ODD)) {
+                record.nType = StringsIndex::ST_UTF16LE;
+            } else {
+                record.nType = StringsIndex::ST_UTF16BE;
+            }
+
+            bAdd = ((nSize / 2) >= g_options.nMinLength);
+        }
+
+        if (bAdd) {
+            g_pIndex->append(record);
+        }
+
+        g_nStart[state] = -1;
+    }
+}
@@ -0,0 +1,70 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef STRINGSPROCESS_H
+#define STRINGSPROCESS_H
+
+#include "hexprocess.h"
+#include "stringsindex.h"
+
+class StringsProcess : public HexProcess {
+    Q_OBJECT
+
+public:
+    struct OPTIONS {
+        qint32 nMinLength;
+        bool bAnsi;
+        bool bUTF16LE;
+        bool bUTF16BE;
+    };
+
+    explicit StringsProcess(QObject *pParent = nullptr);
+    void setData(QHexViewDataSource *pDataSource, OPTIONS options, StringsIndex *pIndex);
+
+    static void getMasks(const char *pData, qint32 nSize, quint64 *pPrintable, quint64 *pZero);
+
+protected:
+    bool _process() override;
+
+private:
+    enum STATE {
+        STATE_ANSI = 0,
+        STATE_UTF16LE_EVEN,
+        STATE_UTF16LE_ODD,
+        STATE_UTF16BE_EVEN,
+        STATE_UTF16BE_ODD,
+        __STATE_SIZE
+    };
+
+    void _scanBlock(const char *pData, qint32 nSize, qint64 nBase);
+    void _closeState(STATE state, qint64 nPosition);
+
+    const qint32 N_BUFFER_SIZE = 0x100000;
+    const qint32 N_HOLE_SIZE = 16;
+
+    QHexViewDataSource *g_pDataSource;
+    OPTIONS g_options;
+    StringsIndex *g_pIndex;
+    qint64 g_nStart[__STATE_SIZE];
+    QVector<quint64> g_listPrintable;
+    QVector<quint64> g_listZero;
+};
+
+#endif  // STRINGSPROCESS_H
@@ -0,0 +1,240 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "annotationstest.h"
+
+#include <limits>
+
+void AnnotationsTest::overlaps_data()
+{
+    QTest::addColumn<qint32>("nCount");
+
+    // Full trees, one record more and less, and the scanned subtrees alone
+    QList<qint32> listCounts = {0, 1, 2, 3, 7, 15, 16, 17, 31, 32, 33, 100, 257, 1000};
+
+    for (qint32 i = 0; i < listCounts.count(); i++) {
+        QTest::newRow(QByteArray::number(listCounts.at(i)).constData()) << listCounts.at(i);
+    }
+}
+
+void AnnotationsTest::overlaps()
+{
+    QFETCH(qint32, nCount);
+
+    QHexViewAnnotations annotations;
+    _fill(&annotations, nCount, 0x1234 + nCount);
+
+    QCOMPARE(annotations.getCount(), nCount);
+
+    _compare(&annotations, 0x5678 + nCount);
+}
+
+void AnnotationsTest::overlapsAfterRemove()
+{
+    QHexViewAnnotations annotations;
+    _fill(&annotations, 300, 0x9ABC);
+
+    quint32 nState = 0xDEF0;
+
+    for (qint32 i = 0; i < 20; i++) {
+        qint64 nOffset = _random(&nState) % 0x10000;
+        qint32 nBefore = annotations.getCount();
+        qint32 nRemoved = annotations.remove(nOffset);
+
+        QCOMPARE(annotations.getCount(), nBefore - nRemoved);
+        QVERIFY(annotations.getOverlaps(nOffset, 1).isEmpty());
+
+        _compare(&annotations, nState);
+    }
+
+    // Added after the queries, indexed again on the next one
+    _fill(&annotations, 50, 0x1357);
+
+    _compare(&annotations, 0x2468);
+}
+
+void AnnotationsTest::bookmarks()
+{
+    QHexViewAnnotations annotations;
+
+    QHexViewAnnotations::ANNOTATION annotation = {};
+    annotation.nSize = 1;
+
+    annotation.nOffset = 0x300;
+    annotation.bBookmark = true;
+    annotations.add(annotation);
+
+    annotation.nOffset = 0x100;
+    annotations.add(annotation);
+
+    annotation.nOffset = 0x200;
+    annotation.bBookmark = false;
+    annotations.add(annotation);
+
+    QCOMPARE(annotations.getNextBookmark(0), (qint64)0x100);
+    QCOMPARE(annotations.getNextBookmark(0x100), (qint64)0x300);
+    QCOMPARE(annotations.getNextBookmark(0x300), (qint64)-1);
+    QCOMPARE(annotations.getPrevBookmark(0x300), (qint64)0x100);
+    QCOMPARE(annotations.getPrevBookmark(0x100), (qint64)-1);
+}
+
+void AnnotationsTest::lineToAnnotation_data()
+{
+    QTest::addColumn<QByteArray>("baLine");
+    QTest::addColumn<bool>("bResult");
+    QTest::addColumn<qint64>("nOffset");
+    QTest::addColumn<qint64>("nSize");
+
+    QTest::newRow("record") << QByteArray("0x10\t0x20\t#80ff0000\tannotation\ttext") << true << (qint64)0x10 << (qint64)0x20;
+    QTest::newRow("decimal") << QByteArray("16\t32") << true << (qint64)16 << (qint64)32;
+    QTest::newRow("comment") << QByteArray("; 0x10\t0x20") << false << (qint64)0 << (qint64)0;
+    QTest::newRow("one column") << QByteArray("0x10") << false << (qint64)0 << (qint64)0;
+    QTest::newRow("negative offset") << QByteArray("-1\t1") << false << (qint64)0 << (qint64)0;
+    QTest::newRow("negative size") << QByteArray("1\t-1") << false << (qint64)0 << (qint64)0;
+    QTest::newRow("not a number") << QByteArray("x\t1") << false << (qint64)0 << (qint64)0;
+    // The end would be past qint64
+    QTest::newRow("end overflow") << QByteArray("0x10\t0x7fffffffffffffff") << false << (qint64)0 << (qint64)0;
+    QTest::newRow("end at max") << QByteArray("0x10\t0x7fffffffffffffef") << true << (qint64)0x10 << (qint64)0x7FFFFFFFFFFFFFEFLL;
+}
+
+void AnnotationsTest::lineToAnnotation()
+{
+    QFETCH(QByteArray, baLine);
+    QFETCH(bool, bResult);
+    QFETCH(qint64, nOffset);
+    QFETCH(qint64, nSize);
+
+    QHexViewAnnotations::ANNOTATION annotation = {};
+
+    QCOMPARE(QHexViewAnnotations::lineToAnnotation(baLine, &annotation), bResult);
+
+    if (bResult) {
+        QCOMPARE(annotation.nOffset, nOffset);
+        QCOMPARE(annotation.nSize, nSize);
+    }
+}
+
+void AnnotationsTest::lineRoundTrip()
+{
+    QHexViewAnnotations::ANNOTATION annotation = {};
+    annotation.nOffset = 0x1234;
+    annotation.nSize = 0x56;
+    annotation.nColor = qRgba(0x12, 0x34, 0x56, 0x78);
+    annotation.bBookmark = true;
+    annotation.sText = QString::fromUtf8("text\twith a tab");
+
+    QHexViewAnnotations::ANNOTATION result = {};
+
+    QVERIFY(QHexViewAnnotations::lineToAnnotation(QHexViewAnnotations::annotationToLine(annotation), &result));
+
+    QCOMPARE(result.nOffset, annotation.nOffset);
+    QCOMPARE(result.nSize, annotation.nSize);
+    QCOMPARE(result.nColor, annotation.nColor);
+    QCOMPARE(result.bBookmark, annotation.bBookmark);
+    QCOMPARE(result.sText, annotation.sText);
+}
+
+void AnnotationsTest::addClamp()
+{
+    QHexViewAnnotations annotations;
+
+    QHexViewAnnotations::ANNOTATION annotation = {};
+    annotation.nOffset = 0x100;
+    annotation.nSize = std::numeric_limits<qint64>::max();
+    annotations.add(annotation);
+
+    annotation.nOffset = 0x200;
+    annotation.nSize = 0;
+    annotations.add(annotation);
+
+    QCOMPARE(annotations.getAnnotation(0).nSize, std::numeric_limits<qint64>::max() - 0x100);
+    QCOMPARE(annotations.getAnnotation(1).nSize, (qint64)1);
+
+    QCOMPARE(annotations.getOverlaps(std::numeric_limits<qint64>::max() - 0x10, 0x10).count(), 1);
+    QCOMPARE(annotations.getOverlaps(0x200, 1).count(), 2);
+    QCOMPARE(annotations.getOverlaps(0, 0x100).count(), 0);
+}
+
+quint32 AnnotationsTest::_random(quint32 *pnState)
+{
+    // xorshift32, the same records on every run
+    quint32 nValue = *pnState;
+    nValue ^= nValue << 13;
+    nValue ^= nValue >> 17;
+    nValue ^= nValue << 5;
+    *pnState = nValue;
+
+    return nValue;
+}
+
+void AnnotationsTest::_fill(QHexViewAnnotations *pAnnotations, qint32 nCount, quint32 nSeed)
+{
+    quint32 nState = nSeed;
+
+    for (qint32 i = 0; i < nCount; i++) {
+        QHexViewAnnotations::ANNOTATION annotation = {};
+        annotation.nOffset = _random(&nState) % 0x10000;
+
+        // Mostly short, some long records over many others
+        if ((_random(&nState) % 8) == 0) {
+            annotation.nSize = 1 + _random(&nState) % 0x8000;
+        } else {
+            annotation.nSize = 1 + _random(&nState) % 0x40;
+        }
+
+        annotation.bBookmark = ((_random(&nState) % 4) == 0);
+
+        pAnnotations->add(annotation);
+    }
+}
+
+QVector<qint32> AnnotationsTest::_getOverlaps(const QVector<QHexViewAnnotations::ANNOTATION> &listAnnotations, qint64 nOffset, qint64 nSize)
+{
+    QVector<qint32> listResult;
+
+    for (qint32 i = 0; i < listAnnotations.count(); i++) {
+        if ((listAnnotations.at(i).nOffset < nOffset + nSize) && (nOffset < listAnnotations.at(i).nOffset + listAnnotations.at(i).nSize)) {
+            listResult.append(i);
+        }
+    }
+
+    return listResult;
+}
+
+void AnnotationsTest::_compare(QHexViewAnnotations *pAnnotations, quint32 nSeed)
+{
+    QVector<QHexViewAnnotations::ANNOTATION> listAnnotations = pAnnotations->getAnnotations();
+
+    for (qint32 i = 1; i < listAnnotations.count(); i++) {
+        QVERIFY(listAnnotations.at(i - 1).nOffset <= listAnnotations.at(i).nOffset);
+    }
+
+    QList<qint64> listSizes = {1, 2, 16, 300, 0x4000, 0x20000};
+    quint32 nState = nSeed;
+
+    for (qint32 i = 0; i < 200; i++) {
+        qint64 nOffset = (qint64)(_random(&nState) % 0x11000) - 0x10;
+        qint64 nSize = listSizes.at(_random(&nState) % listSizes.count());
+
+        QCOMPARE(pAnnotations->getOverlaps(nOffset, nSize), _getOverlaps(listAnnotations, nOffset, nSize));
+    }
+
+    QVERIFY(pAnnotations->getOverlaps(0, 0).isEmpty());
+}
@@ -0,0 +1,49 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef ANNOTATIONSTEST_H
+#define ANNOTATIONSTEST_H
+
+#include <QtTest>
+
+#include "qhexviewannotations.h"
+
+class AnnotationsTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void overlaps_data();
+    void overlaps();
+    void overlapsAfterRemove();
+    void bookmarks();
+    void lineToAnnotation_data();
+    void lineToAnnotation();
+    void lineRoundTrip();
+    void addClamp();
+
+private:
+    static quint32 _random(quint32 *pnState);
+    static void _fill(QHexViewAnnotations *pAnnotations, qint32 nCount, quint32 nSeed);
+    // Every record is looked at
+    static QVector<qint32> _getOverlaps(const QVector<QHexViewAnnotations::ANNOTATION> &listAnnotations, qint64 nOffset, qint64 nSize);
+    static void _compare(QHexViewAnnotations *pAnnotations, quint32 nSeed);
+};
+
+#endif  // ANNOTATIONSTEST_H
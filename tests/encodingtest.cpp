@@ -0,0 +1,228 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "encodingtest.h"
+
+void EncodingTest::tables_data()
+{
+    QTest::addColumn<qint32>("nEncoding");
+    QTest::addColumn<qint32>("nByte");
+    QTest::addColumn<quint32>("nGlyph");
+
+    QTest::newRow("ascii letter") << (qint32)QHexViewEncoding::ENC_ASCII << 0x41 << (quint32)'A';
+    QTest::newRow("ascii control") << (qint32)QHexViewEncoding::ENC_ASCII << 0x0A << (quint32)'.';
+    QTest::newRow("ascii high") << (qint32)QHexViewEncoding::ENC_ASCII << 0x80 << (quint32)'.';
+    QTest::newRow("latin1") << (qint32)QHexViewEncoding::ENC_LATIN1 << 0xE9 << (quint32)0xE9;
+    QTest::newRow("latin1 c1") << (qint32)QHexViewEncoding::ENC_LATIN1 << 0x85 << (quint32)'.';
+    QTest::newRow("cp1251") << (qint32)QHexViewEncoding::ENC_CP1251 << 0xC0 << (quint32)0x0410;
+    QTest::newRow("cp1251 numero") << (qint32)QHexViewEncoding::ENC_CP1251 << 0xB9 << (quint32)0x2116;
+    QTest::newRow("cp1251 undefined") << (qint32)QHexViewEncoding::ENC_CP1251 << 0x98 << (quint32)'.';
+    QTest::newRow("cp866") << (qint32)QHexViewEncoding::ENC_CP866 << 0x80 << (quint32)0x0410;
+    QTest::newRow("cp866 yo") << (qint32)QHexViewEncoding::ENC_CP866 << 0xF0 << (quint32)0x0401;
+    QTest::newRow("cp866 box") << (qint32)QHexViewEncoding::ENC_CP866 << 0xC4 << (quint32)0x2500;
+    QTest::newRow("ebcdic letter") << (qint32)QHexViewEncoding::ENC_EBCDIC << 0xC1 << (quint32)'A';
+    QTest::newRow("ebcdic digit") << (qint32)QHexViewEncoding::ENC_EBCDIC << 0xF0 << (quint32)'0';
+    QTest::newRow("ebcdic space") << (qint32)QHexViewEncoding::ENC_EBCDIC << 0x40 << (quint32)' ';
+    QTest::newRow("ebcdic dot") << (qint32)QHexViewEncoding::ENC_EBCDIC << 0x4B << (quint32)'.';
+}
+
+void EncodingTest::tables()
+{
+    QFETCH(qint32, nEncoding);
+    QFETCH(qint32, nByte);
+    QFETCH(quint32, nGlyph);
+
+    QVector<quint32> listGlyphs = _decode((QHexViewEncoding::ENC)nEncoding, QByteArray(1, (char)nByte));
+
+    QCOMPARE(listGlyphs.count(), 1);
+    QCOMPARE(listGlyphs.at(0), nGlyph);
+}
+
+void EncodingTest::tableRoundTrip_data()
+{
+    QTest::addColumn<qint32>("nEncoding");
+
+    QList<QHexViewEncoding::ENC> listEncodings = QHexViewEncoding::getEncodings();
+
+    for (qint32 i = 0; i < listEncodings.count(); i++) {
+        if (!QHexViewEncoding::isMultiByte(listEncodings.at(i))) {
+            QTest::newRow(QHexViewEncoding::encodingToString(listEncodings.at(i)).toLatin1().constData()) << (qint32)listEncodings.at(i);
+        }
+    }
+}
+
+void EncodingTest::tableRoundTrip()
+{
+    QFETCH(qint32, nEncoding);
+
+    QHexViewEncoding::ENC encoding = (QHexViewEncoding::ENC)nEncoding;
+
+    QByteArray baData(256, 0);
+
+    for (qint32 i = 0; i < 256; i++) {
+        baData[i] = (char)i;
+    }
+
+    QVector<quint32> listGlyphs = _decode(encoding, baData);
+
+    // Every shown character is typed back as a byte with the same glyph
+    for (qint32 i = 0; i < 256; i++) {
+        quint32 nGlyph = listGlyphs.at(i);
+
+        if (nGlyph != '.') {
+            QByteArray baChar;
+            QByteArray baString;
+
+            QVERIFY(QHexViewEncoding::encodeChar(encoding, QChar((ushort)nGlyph), &baChar));
+            QVERIFY(QHexViewEncoding::encodeString(encoding, QString(QChar((ushort)nGlyph)), &baString));
+            QCOMPARE(baChar.size(), 1);
+            QCOMPARE(baString, baChar);
+            QCOMPARE(listGlyphs.at((quint8)baChar.at(0)), nGlyph);
+        }
+    }
+}
+
+void EncodingTest::utf8()
+{
+    QByteArray baData("a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80");
+
+    // The character is shown in its first cell, the other bytes of the sequence are blank
+    QVector<quint32> listExpected = {'a', 0xE9, ' ', 0x20AC, ' ', ' ', 0x1F600, ' ', ' ', ' '};
+
+    QCOMPARE(_decode(QHexViewEncoding::ENC_UTF8, baData), listExpected);
+}
+
+void EncodingTest::utf8Invalid()
+{
+    // Overlong, surrogate, truncated, not a lead byte
+    QCOMPARE(_decode(QHexViewEncoding::ENC_UTF8, QByteArray("\xC0\x80")), QVector<quint32>({'.', '.'}));
+    QCOMPARE(_decode(QHexViewEncoding::ENC_UTF8, QByteArray("\xED\xA0\x80")), QVector<quint32>({'.', '.', '.'}));
+    QCOMPARE(_decode(QHexViewEncoding::ENC_UTF8, QByteArray("\xE2\x82")), QVector<quint32>({'.', '.'}));
+    QCOMPARE(_decode(QHexViewEncoding::ENC_UTF8, QByteArray("\xFF" "A")), QVector<quint32>({'.', 'A'}));
+}
+
+void EncodingTest::utf8Window()
+{
+    // ASCII runs of 16 bytes take the vector path, the rest the scalar one
+    QByteArray baData = QByteArray(37, 'x') + QByteArray("\xC3\xA9") + QByteArray(20, '\n') + QByteArray("\xE2\x82\xAC");
+    QVector<quint32> listExpected;
+
+    for (qint32 i = 0; i < 37; i++) {
+        listExpected.append('x');
+    }
+
+    listExpected.append(0xE9);
+    listExpected.append(' ');
+
+    for (qint32 i = 0; i < 20; i++) {
+        listExpected.append('.');
+    }
+
+    listExpected.append(0x20AC);
+    listExpected.append(' ');
+    listExpected.append(' ');
+
+    QCOMPARE(_decode(QHexViewEncoding::ENC_UTF8, baData), listExpected);
+
+    // A window that starts inside a sequence shows it in its first cell
+    QByteArray baSequence("\xE2\x82\xAC" "z");
+    QVector<quint32> listGlyphs;
+
+    QHexViewEncoding::decode(QHexViewEncoding::ENC_UTF8, baSequence.constData(), baSequence.size(), 1, 3, 1, &listGlyphs);
+
+    QCOMPARE(listGlyphs, QVector<quint32>({0x20AC, ' ', 'z'}));
+}
+
+void EncodingTest::utf16_data()
+{
+    QTest::addColumn<qint32>("nEncoding");
+
+    QTest::newRow("le") << (qint32)QHexViewEncoding::ENC_UTF16LE;
+    QTest::newRow("be") << (qint32)QHexViewEncoding::ENC_UTF16BE;
+}
+
+void EncodingTest::utf16()
+{
+    QFETCH(qint32, nEncoding);
+
+    QHexViewEncoding::ENC encoding = (QHexViewEncoding::ENC)nEncoding;
+
+    // An ASCII run for the vector path, then a control, a BMP character and a surrogate pair
+    QString sText = QString("abcdefghijklmnop") + QChar(0x0A) + QChar(0x20AC) + QString::fromUtf8("\xF0\x9F\x98\x80");
+    QByteArray baData;
+
+    QVERIFY(QHexViewEncoding::encodeString(encoding, sText, &baData));
+    QCOMPARE(baData.size(), sText.size() * 2);
+
+    QVector<quint32> listExpected;
+
+    for (qint32 i = 0; i < 16; i++) {
+        listExpected.append(sText.at(i).unicode());
+        listExpected.append(' ');
+    }
+
+    listExpected << '.' << ' ' << 0x20AC << ' ' << 0x1F600 << ' ' << ' ' << ' ';
+
+    QCOMPARE(_decode(encoding, baData), listExpected);
+
+    // Unpaired surrogate
+    QByteArray baSurrogate;
+
+    QVERIFY(QHexViewEncoding::encodeString(encoding, QString(QChar(0xD83D)) + QChar('A'), &baSurrogate));
+    QCOMPARE(_decode(encoding, baSurrogate), QVector<quint32>({'.', ' ', 'A', ' '}));
+}
+
+void EncodingTest::utf16Odd()
+{
+    // Code units start at even offsets of the data, not of the window
+    QByteArray baData("A\x00" "B\x00", 4);
+
+    QCOMPARE(_decode(QHexViewEncoding::ENC_UTF16LE, baData.mid(1), 1), QVector<quint32>({'.', 'B', ' '}));
+}
+
+void EncodingTest::encodeChar()
+{
+    QByteArray baResult;
+
+    QVERIFY(QHexViewEncoding::encodeChar(QHexViewEncoding::ENC_UTF16LE, QChar(0xE9), &baResult));
+    QCOMPARE(baResult, QByteArray("\xE9\x00", 2));
+
+    QVERIFY(QHexViewEncoding::encodeChar(QHexViewEncoding::ENC_UTF16BE, QChar(0x20AC), &baResult));
+    QCOMPARE(baResult, QByteArray("\x20\xAC", 2));
+
+    QVERIFY(QHexViewEncoding::encodeChar(QHexViewEncoding::ENC_UTF8, QChar(0x20AC), &baResult));
+    QCOMPARE(baResult, QByteArray("\xE2\x82\xAC"));
+
+    QVERIFY(QHexViewEncoding::encodeChar(QHexViewEncoding::ENC_EBCDIC, QChar('A'), &baResult));
+    QCOMPARE(baResult, QByteArray("\xC1"));
+
+    // Half of a surrogate pair, and a character the code page does not have
+    QVERIFY(!QHexViewEncoding::encodeChar(QHexViewEncoding::ENC_UTF16LE, QChar(0xD83D), &baResult));
+    QVERIFY(!QHexViewEncoding::encodeChar(QHexViewEncoding::ENC_ASCII, QChar(0xE9), &baResult));
+}
+
+QVector<quint32> EncodingTest::_decode(QHexViewEncoding::ENC encoding, const QByteArray &baData, qint64 nOffset)
+{
+    QVector<quint32> listResult;
+
+    QHexViewEncoding::decode(encoding, baData.constData(), baData.size(), 0, baData.size(), nOffset, &listResult);
+
+    return listResult;
+}
@@ -0,0 +1,48 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef ENCODINGTEST_H
+#define ENCODINGTEST_H
+
+#include <QtTest>
+
+#include "qhexviewencoding.h"
+
+class EncodingTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void tables_data();
+    void tables();
+    void tableRoundTrip_data();
+    void tableRoundTrip();
+    void utf8();
+    void utf8Invalid();
+    void utf8Window();
+    void utf16_data();
+    void utf16();
+    void utf16Odd();
+    void encodeChar();
+
+private:
+    static QVector<quint32> _decode(QHexViewEncoding::ENC encoding, const QByteArray &baData, qint64 nOffset = 0);
+};
+
+#endif  // ENCODINGTEST_H
@@ -0,0 +1,104 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "hashprocesstest.h"
+
+#include "hashprocess.h"
+
+void HashProcessTest::crc32_data()
+{
+    QTest::addColumn<QByteArray>("baData");
+    QTest::addColumn<quint32>("nCRC");
+
+    QTest::newRow("empty") << QByteArray() << (quint32)0;
+    QTest::newRow("check") << QByteArray("123456789") << (quint32)0xCBF43926;
+    QTest::newRow("fox") << QByteArray("The quick brown fox jumps over the lazy dog") << (quint32)0x414FA339;
+    QTest::newRow("zeros") << QByteArray(4096, 0) << (quint32)0xC71C0011;
+}
+
+void HashProcessTest::crc32()
+{
+    QFETCH(QByteArray, baData);
+    QFETCH(quint32, nCRC);
+
+    QCOMPARE(HashProcess::crc32(0, baData.constData(), baData.size()), nCRC);
+    QCOMPARE(HashProcess::crc32Table(0, baData.constData(), baData.size()), nCRC);
+}
+
+void HashProcessTest::crc32Clmul_data()
+{
+    QTest::addColumn<qint32>("nSize");
+
+    // Around the 64 byte blocks and the 16 byte folds of the carry-less multiply path
+    QList<qint32> listSizes = {0, 1, 15, 16, 17, 63, 64, 65, 79, 80, 127, 128, 129, 191, 255, 256, 1000, 4096, 65537};
+
+    for (qint32 i = 0; i < listSizes.count(); i++) {
+        QTest::newRow(QString::number(listSizes.at(i)).toLatin1().constData()) << listSizes.at(i);
+    }
+}
+
+void HashProcessTest::crc32Clmul()
+{
+    QFETCH(qint32, nSize);
+
+    QByteArray baData = _getData(nSize + 16);
+
+    // Unaligned starts too
+    for (qint32 i = 0; i < 16; i++) {
+        const char *pData = baData.constData() + i;
+
+        QCOMPARE(HashProcess::crc32(0, pData, nSize), HashProcess::crc32Table(0, pData, nSize));
+        QCOMPARE(HashProcess::crc32(0x12345678, pData, nSize), HashProcess::crc32Table(0x12345678, pData, nSize));
+    }
+}
+
+void HashProcessTest::crc32Chunks()
+{
+    // As the process hashes: the value of one buffer is continued with the next
+    QByteArray baData = _getData(100000);
+    quint32 nCRC = HashProcess::crc32Table(0, baData.constData(), baData.size());
+
+    QList<qint32> listChunkSizes = {1, 7, 64, 100, 4096, 33333};
+
+    for (qint32 i = 0; i < listChunkSizes.count(); i++) {
+        quint32 nValue = 0;
+
+        for (qint32 j = 0; j < baData.size(); j += listChunkSizes.at(i)) {
+            nValue = HashProcess::crc32(nValue, baData.constData() + j, qMin(listChunkSizes.at(i), baData.size() - j));
+        }
+
+        QCOMPARE(nValue, nCRC);
+    }
+}
+
+QByteArray HashProcessTest::_getData(qint32 nSize)
+{
+    QByteArray baResult(nSize, 0);
+
+    // Fixed sequence, the same on every run
+    quint32 nValue = 0x2545F491;
+
+    for (qint32 i = 0; i < nSize; i++) {
+        nValue = nValue * 1103515245 + 12345;
+        baResult[i] = (char)(nValue >> 16);
+    }
+
+    return baResult;
+}
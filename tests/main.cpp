@@ -0,0 +1,63 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include <QCoreApplication>
+#include <QtTest>
+
+#include "annotationstest.h"
+#include "encodingtest.h"
+#include "hashprocesstest.h"
+#include "processmemorydevicetest.h"
+#include "remotedatasourcetest.h"
+#include "structurestest.h"
+#include "transformdatasourcetest.h"
+
+int main(int argc, char *argv[])
+{
+    // Started again by the process memory test as the process to read
+    if ((argc == 2) && (QByteArray(argv[1]) == "--memory-child")) {
+        return ProcessMemoryDeviceTest::runChild();
+    }
+
+    QCoreApplication app(argc, argv);
+
+    QList<QObject *> listTests;
+    listTests.append(new AnnotationsTest);
+    listTests.append(new EncodingTest);
+    listTests.append(new HashProcessTest);
+    listTests.append(new ProcessMemoryDeviceTest);
+    listTests.append(new RemoteDataSourceTest);
+    listTests.append(new StructuresTest);
+    listTests.append(new TransformDataSourceTest);
+
+    qint32 nResult = 0;
+    qint32 nNumberOfTests = listTests.count();
+
+    // Every test class is run, the exit code counts the failed ones
+    for (qint32 i = 0; i < nNumberOfTests; i++) {
+        if (QTest::qExec(listTests.at(i), argc, argv)) {
+            nResult++;
+        }
+    }
+
+    qDeleteAll(listTests);
+
+    return nResult;
+}
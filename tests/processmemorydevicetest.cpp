@@ -0,0 +1,212 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "processmemorydevicetest.h"
+
+#include "processmemorydevice.h"
+
+#ifdef Q_OS_LINUX
+#include <stdio.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+int ProcessMemoryDeviceTest::runChild()
+{
+    int nResult = 1;
+
+#ifdef Q_OS_LINUX
+    qint64 nPageSize = sysconf(_SC_PAGESIZE);
+    char *pData = (char *)mmap(nullptr, (size_t)(3 * nPageSize), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (pData != MAP_FAILED) {
+        for (qint64 i = 0; i < 3 * nPageSize; i++) {
+            pData[i] = _getByte(i);
+        }
+
+        if (mprotect(pData + nPageSize, (size_t)nPageSize, PROT_NONE) == 0) {
+            printf("%llx\n", (unsigned long long)pData);
+            fflush(stdout);
+
+            // Alive until the test closes the pipe
+            char cValue = 0;
+
+            while (::read(0, &cValue, 1) > 0) {
+            }
+
+            nResult = 0;
+        }
+    }
+#endif
+
+    return nResult;
+}
+
+void ProcessMemoryDeviceTest::initTestCase()
+{
+#ifndef Q_OS_LINUX
+    QSKIP("The process memory device is Linux only");
+#endif
+    g_nAddress = 0;
+    g_nPageSize = 0;
+
+#ifdef Q_OS_LINUX
+    g_nPageSize = sysconf(_SC_PAGESIZE);
+#endif
+
+    g_process.start(QCoreApplication::applicationFilePath(), QStringList() << "--memory-child");
+
+    QVERIFY(g_process.waitForStarted());
+    QVERIFY(g_process.waitForReadyRead(10000));
+
+    bool bOk = false;
+    g_nAddress = QString::fromLatin1(g_process.readLine()).trimmed().toULongLong(&bOk, 16);
+
+    QVERIFY(bOk);
+}
+
+void ProcessMemoryDeviceTest::cleanupTestCase()
+{
+    if (g_process.state() != QProcess::NotRunning) {
+        g_process.closeWriteChannel();
+
+        if (!g_process.waitForFinished(10000)) {
+            g_process.kill();
+        }
+    }
+}
+
+void ProcessMemoryDeviceTest::regions()
+{
+    QList<ProcessMemoryDevice::REGION> listRegions = ProcessMemoryDevice::readRegions(g_process.processId());
+
+    QVERIFY(listRegions.count());
+
+    // The device offsets are contiguous and the page without access is not readable
+    bool bFound = false;
+
+    for (qint32 i = 0; i < listRegions.count(); i++) {
+        if (i) {
+            QCOMPARE(listRegions.at(i).nOffset, listRegions.at(i - 1).nOffset + listRegions.at(i - 1).nSize);
+        }
+
+        quint64 nAddress = g_nAddress + g_nPageSize;
+
+        if ((nAddress >= listRegions.at(i).nAddress) && (nAddress < listRegions.at(i).nAddress + listRegions.at(i).nSize)) {
+            QVERIFY(!listRegions.at(i).bReadable);
+            bFound = true;
+        }
+    }
+
+    QVERIFY(bFound);
+}
+
+void ProcessMemoryDeviceTest::read()
+{
+    ProcessMemoryDevice device(g_process.processId());
+
+    if (!device.open(QIODevice::ReadOnly)) {
+        QSKIP("The memory of the child process cannot be opened (ptrace restrictions)");
+    }
+
+    qint64 nOffset = _getOffset(&device, g_nAddress);
+
+    QVERIFY(nOffset != -1);
+    QVERIFY(device.seek(nOffset));
+
+    QByteArray baData = device.read(g_nPageSize);
+
+    QCOMPARE(baData.size(), (qint32)g_nPageSize);
+
+    for (qint32 i = 0; i < baData.size(); i++) {
+        QCOMPARE(baData.at(i), _getByte(i));
+    }
+}
+
+void ProcessMemoryDeviceTest::readUnreadable()
+{
+    ProcessMemoryDevice device(g_process.processId());
+
+    if (!device.open(QIODevice::ReadOnly)) {
+        QSKIP("The memory of the child process cannot be opened (ptrace restrictions)");
+    }
+
+    qint64 nOffset = _getOffset(&device, g_nAddress);
+
+    QVERIFY(nOffset != -1);
+
+    // The read stops at the page without access
+    QVERIFY(device.seek(nOffset));
+    QCOMPARE(device.read(3 * g_nPageSize).size(), (qint32)g_nPageSize);
+    QVERIFY(device.isOffsetReadable(nOffset));
+    QVERIFY(!device.isOffsetReadable(nOffset + g_nPageSize));
+
+    // and the page after it is read again
+    QVERIFY(device.seek(nOffset + 2 * g_nPageSize));
+
+    QByteArray baData = device.read(g_nPageSize);
+
+    QCOMPARE(baData.size(), (qint32)g_nPageSize);
+
+    for (qint32 i = 0; i < baData.size(); i++) {
+        QCOMPARE(baData.at(i), _getByte(2 * g_nPageSize + i));
+    }
+}
+
+void ProcessMemoryDeviceTest::write()
+{
+    ProcessMemoryDevice device(g_process.processId());
+
+    if (!device.open(QIODevice::ReadWrite)) {
+        QSKIP("The memory of the child process cannot be opened for writing (ptrace restrictions)");
+    }
+
+    qint64 nOffset = _getOffset(&device, g_nAddress + 2 * g_nPageSize + 0x10);
+
+    QVERIFY(nOffset != -1);
+
+    QByteArray baData("\x11\x22\x33\x44", 4);
+
+    QVERIFY(device.seek(nOffset));
+    QCOMPARE(device.write(baData), (qint64)baData.size());
+    QVERIFY(device.seek(nOffset));
+    QCOMPARE(device.read(baData.size()), baData);
+}
+
+qint64 ProcessMemoryDeviceTest::_getOffset(ProcessMemoryDevice *pDevice, quint64 nAddress)
+{
+    qint64 nResult = -1;
+
+    QList<ProcessMemoryDevice::REGION> listRegions = pDevice->getRegions();
+
+    for (qint32 i = 0; i < listRegions.count(); i++) {
+        if ((nAddress >= listRegions.at(i).nAddress) && (nAddress < listRegions.at(i).nAddress + listRegions.at(i).nSize)) {
+            nResult = listRegions.at(i).nOffset + (qint64)(nAddress - listRegions.at(i).nAddress);
+            break;
+        }
+    }
+
+    return nResult;
+}
+
+char ProcessMemoryDeviceTest::_getByte(qint64 nIndex)
+{
+    return (char)((nIndex * 7 + 3) ^ (nIndex >> 8));
+}
@@ -0,0 +1,53 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef PROCESSMEMORYDEVICETEST_H
+#define PROCESSMEMORYDEVICETEST_H
+
+#include <QProcess>
+#include <QtTest>
+
+class ProcessMemoryDevice;
+
+// Reads and writes the memory of a child process started from the test executable
+class ProcessMemoryDeviceTest : public QObject {
+    Q_OBJECT
+
+public:
+    static int runChild();  // maps three pages, the middle one without access, and prints their address
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void regions();
+    void read();
+    void readUnreadable();
+    void write();
+
+private:
+    qint64 _getOffset(ProcessMemoryDevice *pDevice, quint64 nAddress);
+    static char _getByte(qint64 nIndex);
+
+    QProcess g_process;
+    quint64 g_nAddress;
+    qint64 g_nPageSize;
+};
+
+#endif  // PROCESSMEMORYDEVICETEST_H
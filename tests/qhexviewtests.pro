@@ -0,0 +1,28 @@
+QT += testlib widgets
+
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+TARGET = qhexviewtests
+TEMPLATE = app
+
+HEADERS += \
+    annotationstest.h \
+    encodingtest.h \
+    hashprocesstest.h \
+    processmemorydevicetest.h \
+    remotedatasourcetest.h \
+    structurestest.h \
+    transformdatasourcetest.h
+
+SOURCES += \
+    annotationstest.cpp \
+    encodingtest.cpp \
+    hashprocesstest.cpp \
+    main.cpp \
+    processmemorydevicetest.cpp \
+    remotedatasourcetest.cpp \
+    structurestest.cpp \
+    transformdatasourcetest.cpp
+
+include(../qhexview.pri)
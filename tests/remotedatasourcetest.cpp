@@ -0,0 +1,317 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "remotedatasourcetest.h"
+
+#include <QtConcurrent>
+#include <QtEndian>
+
+#include "qhexviewremotedatasource.h"
+
+RemoteTestServer::RemoteTestServer(const QByteArray &baData) : QObject(nullptr)
+{
+    g_pServer = nullptr;
+    g_pSocket = nullptr;
+    g_baData = baData;
+    g_nDropReads = 0;
+    g_nShortReads = 0;
+    g_nDelay = 0;
+    g_nNumberOfReads = 0;
+}
+
+void RemoteTestServer::setDropReads(qint32 nCount)
+{
+    QMutexLocker locker(&g_mutex);
+
+    g_nDropReads = nCount;
+}
+
+void RemoteTestServer::setShortReads(qint32 nCount)
+{
+    QMutexLocker locker(&g_mutex);
+
+    g_nShortReads = nCount;
+}
+
+void RemoteTestServer::setDelay(qint32 nDelay)
+{
+    QMutexLocker locker(&g_mutex);
+
+    g_nDelay = nDelay;
+}
+
+qint32 RemoteTestServer::getNumberOfReads()
+{
+    QMutexLocker locker(&g_mutex);
+
+    return g_nNumberOfReads;
+}
+
+QByteArray RemoteTestServer::getData()
+{
+    QMutexLocker locker(&g_mutex);
+
+    return g_baData;
+}
+
+quint16 RemoteTestServer::listen()
+{
+    quint16 nResult = 0;
+
+    g_pServer = new QTcpServer(this);
+
+    connect(g_pServer, SIGNAL(newConnection()), this, SLOT(_newConnection()));
+
+    if (g_pServer->listen(QHostAddress::LocalHost, 0)) {
+        nResult = g_pServer->serverPort();
+    }
+
+    return nResult;
+}
+
+void RemoteTestServer::close()
+{
+    delete g_pSocket;
+    g_pSocket = nullptr;
+
+    delete g_pServer;
+    g_pServer = nullptr;
+}
+
+void RemoteTestServer::_newConnection()
+{
+    // One client at a time, each test connects again
+    delete g_pSocket;
+
+    g_pSocket = g_pServer->nextPendingConnection();
+    g_pSocket->setParent(this);
+    g_baReceived.clear();
+
+    connect(g_pSocket, SIGNAL(readyRead()), this, SLOT(_readyRead()));
+}
+
+void RemoteTestServer::_readyRead()
+{
+    g_baReceived.append(g_pSocket->readAll());
+
+    while ((g_baReceived.size() >= 4) && (g_baReceived.size() - 4 >= (qint32)qFromLittleEndian<quint32>(g_baReceived.constData()))) {
+        const char *pFrame = g_baReceived.constData() + 4;
+        qint32 nFrameSize = (qint32)qFromLittleEndian<quint32>(g_baReceived.constData());
+
+        quint8 nCommand = (quint8)pFrame[0];
+        quint32 nId = qFromLittleEndian<quint32>(pFrame + 1);
+        quint64 nOffset = qFromLittleEndian<quint64>(pFrame + 5);
+        quint32 nLength = qFromLittleEndian<quint32>(pFrame + 13);
+        QByteArray baPayload(pFrame + 17, nFrameSize - 17);
+
+        g_baReceived.remove(0, 4 + nFrameSize);
+
+        QMutexLocker locker(&g_mutex);
+
+        if (nCommand == QHexViewRemoteDataSource::CMD_INFO) {
+            _answer(nCommand, nId, 0, (quint64)g_baData.size(), QHexViewRemoteDataSource::RF_WRITABLE, QByteArray());
+        } else if (nCommand == QHexViewRemoteDataSource::CMD_READ) {
+            g_nNumberOfReads++;
+
+            if (g_nDropReads) {
+                g_nDropReads--;
+            } else {
+                quint32 nAnswer = (quint32)qMax((qint64)0, qMin((qint64)nLength, (qint64)g_baData.size() - (qint64)nOffset));
+
+                if (g_nShortReads && (nAnswer > N_BLOCK_SIZE)) {
+                    g_nShortReads--;
+                    nAnswer = N_BLOCK_SIZE;
+                }
+
+                QByteArray baAnswer = g_baData.mid((qint32)nOffset, (qint32)nAnswer);
+
+                if (g_nDelay) {
+                    QTimer::singleShot(g_nDelay, this, [=]() { _answer(nCommand, nId, 0, nOffset, nAnswer, baAnswer); });
+                } else {
+                    _answer(nCommand, nId, 0, nOffset, nAnswer, baAnswer);
+                }
+            }
+        } else if (nCommand == QHexViewRemoteDataSource::CMD_WRITE) {
+            quint8 nStatus = 1;
+
+            if (nOffset + nLength <= (quint64)g_baData.size()) {
+                g_baData.replace((qint32)nOffset, (qint32)nLength, baPayload);
+                nStatus = 0;
+            }
+
+            _answer(nCommand, nId, nStatus, nOffset, nLength, QByteArray());
+        }
+    }
+}
+
+void RemoteTestServer::_answer(quint8 nCommand, quint32 nId, quint8 nStatus, quint64 nOffset, quint32 nLength, const QByteArray &baData)
+{
+    QByteArray baFrame(22, 0);
+    char *pFrame = baFrame.data();
+
+    qToLittleEndian<quint32>((quint32)(18 + baData.size()), pFrame);
+    pFrame[4] = (char)nCommand;
+    qToLittleEndian<quint32>(nId, pFrame + 5);
+    pFrame[9] = (char)nStatus;
+    qToLittleEndian<quint64>(nOffset, pFrame + 10);
+    qToLittleEndian<quint32>(nLength, pFrame + 18);
+
+    if (g_pSocket) {
+        g_pSocket->write(baFrame + baData);
+    }
+}
+
+void RemoteDataSourceTest::initTestCase()
+{
+    g_baData.resize(4 * 0x10000 + 0x123);
+
+    for (qint32 i = 0; i < g_baData.size(); i++) {
+        g_baData[i] = (char)((i * 7) ^ (i >> 8));
+    }
+
+    g_pServer = new RemoteTestServer(g_baData);
+    g_pServer->moveToThread(&g_thread);
+    g_thread.start();
+
+    g_nPort = 0;
+
+    QMetaObject::invokeMethod(g_pServer, "listen", Qt::BlockingQueuedConnection, Q_RETURN_ARG(quint16, g_nPort));
+
+    QVERIFY(g_nPort != 0);
+}
+
+void RemoteDataSourceTest::cleanupTestCase()
+{
+    QMetaObject::invokeMethod(g_pServer, "close", Qt::BlockingQueuedConnection);
+
+    g_thread.quit();
+    g_thread.wait();
+
+    delete g_pServer;
+}
+
+void RemoteDataSourceTest::init()
+{
+    g_nChanged = 0;
+
+    g_pDataSource = new QHexViewRemoteDataSource;
+
+    connect(g_pDataSource, SIGNAL(dataChanged(qint64, qint64)), this, SLOT(_dataChanged(qint64, qint64)));
+
+    QVERIFY(g_pDataSource->connectToHost("127.0.0.1", g_nPort));
+}
+
+void RemoteDataSourceTest::cleanup()
+{
+    delete g_pDataSource;
+    g_pDataSource = nullptr;
+
+    g_pServer->setDropReads(0);
+    g_pServer->setShortReads(0);
+    g_pServer->setDelay(0);
+}
+
+void RemoteDataSourceTest::info()
+{
+    QCOMPARE(g_pDataSource->getSize(), (qint64)g_baData.size());
+    QVERIFY(g_pDataSource->isWritable());
+}
+
+void RemoteDataSourceTest::read()
+{
+    // Across a block border and up to the end
+    QCOMPARE(_readInThread(g_pDataSource, 0xFFF0, 0x20), g_baData.mid(0xFFF0, 0x20));
+    QCOMPARE(_readInThread(g_pDataSource, 0, g_baData.size()), g_baData);
+    QCOMPARE(_readInThread(g_pDataSource, g_baData.size() - 0x10, 0x100), g_baData.right(0x10));
+}
+
+void RemoteDataSourceTest::readGuiThread()
+{
+    g_pServer->setDelay(500);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // Returns before the answer, the view is told when the data is there
+    _read(g_pDataSource, 0x30000, 0x100);
+
+    QVERIFY(timer.elapsed() < 500);
+
+    QTRY_VERIFY(g_nChanged > 0);
+    QCOMPARE(_read(g_pDataSource, 0x30000, 0x100), g_baData.mid(0x30000, 0x100));
+}
+
+void RemoteDataSourceTest::lostReply()
+{
+    g_pServer->setDropReads(1);
+
+    qint32 nNumberOfReads = g_pServer->getNumberOfReads();
+
+    // The first request is never answered, it is sent again when it expires
+    QCOMPARE(_readInThread(g_pDataSource, 0x10000, 0x100), g_baData.mid(0x10000, 0x100));
+    QVERIFY(g_pServer->getNumberOfReads() > nNumberOfReads + 1);
+}
+
+void RemoteDataSourceTest::shortReply()
+{
+    g_pServer->setShortReads(1);
+
+    // Only the first block comes back, the others are requested again
+    QCOMPARE(_readInThread(g_pDataSource, 0, 3 * 0x10000), g_baData.left(3 * 0x10000));
+}
+
+void RemoteDataSourceTest::write()
+{
+    QByteArray baPatch("\x11\x22\x33\x44", 4);
+
+    QCOMPARE(_readInThread(g_pDataSource, 0x1FFFE, 4), g_baData.mid(0x1FFFE, 4));
+    QCOMPARE(g_pDataSource->writeAt(0x1FFFE, baPatch.constData(), baPatch.size()), (qint64)baPatch.size());
+
+    // The cached blocks are dropped, the read sees the server
+    QCOMPARE(g_pServer->getData().mid(0x1FFFE, 4), baPatch);
+    QCOMPARE(_readInThread(g_pDataSource, 0x1FFFE, 4), baPatch);
+
+    QVERIFY(g_pDataSource->writeAt(0x1FFFE, g_baData.constData() + 0x1FFFE, 4) == 4);
+}
+
+void RemoteDataSourceTest::_dataChanged(qint64 nOffset, qint64 nSize)
+{
+    Q_UNUSED(nOffset)
+    Q_UNUSED(nSize)
+
+    g_nChanged++;
+}
+
+QByteArray RemoteDataSourceTest::_read(QHexViewRemoteDataSource *pDataSource, qint64 nOffset, qint64 nSize)
+{
+    QByteArray baResult((qint32)nSize, 0);
+
+    qint64 nRead = pDataSource->readAt(nOffset, baResult.data(), nSize);
+
+    baResult.resize((qint32)qMax(nRead, (qint64)0));
+
+    return baResult;
+}
+
+QByteArray RemoteDataSourceTest::_readInThread(QHexViewRemoteDataSource *pDataSource, qint64 nOffset, qint64 nSize)
+{
+    // Off the GUI thread a read waits for all its blocks
+    return QtConcurrent::run(&RemoteDataSourceTest::_read, pDataSource, nOffset, nSize).result();
+}
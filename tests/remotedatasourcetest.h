@@ -0,0 +1,99 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef REMOTEDATASOURCETEST_H
+#define REMOTEDATASOURCETEST_H
+
+#include <QMutex>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+#include <QTimer>
+#include <QtTest>
+
+class QHexViewRemoteDataSource;
+
+// Stand-in for a remote agent, runs in its own thread so blocking reads of the test get answers
+class RemoteTestServer : public QObject {
+    Q_OBJECT
+
+public:
+    explicit RemoteTestServer(const QByteArray &baData);
+
+    void setDropReads(qint32 nCount);   // the next read requests are not answered
+    void setShortReads(qint32 nCount);  // the next read requests get only their first block
+    void setDelay(qint32 nDelay);       // ms before a read is answered
+    qint32 getNumberOfReads();
+    QByteArray getData();
+
+public slots:
+    quint16 listen();
+    void close();
+
+private slots:
+    void _newConnection();
+    void _readyRead();
+
+private:
+    void _answer(quint8 nCommand, quint32 nId, quint8 nStatus, quint64 nOffset, quint32 nLength, const QByteArray &baData);
+
+    const quint32 N_BLOCK_SIZE = 0x10000;  // of QHexViewRemoteDataSource
+
+    QTcpServer *g_pServer;
+    QTcpSocket *g_pSocket;
+    QByteArray g_baReceived;
+    QMutex g_mutex;
+    QByteArray g_baData;
+    qint32 g_nDropReads;
+    qint32 g_nShortReads;
+    qint32 g_nDelay;
+    qint32 g_nNumberOfReads;
+};
+
+class RemoteDataSourceTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+    void info();
+    void read();
+    void readGuiThread();
+    void lostReply();
+    void shortReply();
+    void write();
+
+    void _dataChanged(qint64 nOffset, qint64 nSize);
+
+private:
+    static QByteArray _read(QHexViewRemoteDataSource *pDataSource, qint64 nOffset, qint64 nSize);
+    static QByteArray _readInThread(QHexViewRemoteDataSource *pDataSource, qint64 nOffset, qint64 nSize);
+
+    QThread g_thread;
+    RemoteTestServer *g_pServer;
+    QHexViewRemoteDataSource *g_pDataSource;
+    QByteArray g_baData;
+    quint16 g_nPort;
+    qint32 g_nChanged;
+};
+
+#endif  // REMOTEDATASOURCETEST_H
@@ -0,0 +1,210 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "structurestest.h"
+
+#include <limits>
+
+void StructuresTest::parse()
+{
+    QString sText = "/* header */\n"
+                    "struct HEADER {\n"
+                    "    char sMagic[4];  // signature\n"
+                    "    uint16 nVersion;\n"
+                    "    DWORD nFlags;\n"
+                    "    double dValue;\n"
+                    "};\n";
+
+    QList<QHexViewStructures::STRUCT> listStructs;
+    QString sError;
+
+    QVERIFY(QHexViewStructures::parseTemplates(sText, &listStructs, &sError));
+    QCOMPARE(listStructs.count(), 1);
+
+    const QHexViewStructures::STRUCT &structure = listStructs.at(0);
+
+    QCOMPARE(structure.sName, QString("HEADER"));
+    QCOMPARE(structure.nSize, 18);
+    QCOMPARE(structure.listFields.count(), 4);
+
+    QCOMPARE(structure.listFields.at(0).sName, QString("sMagic"));
+    QCOMPARE(structure.listFields.at(0).type, QHexViewStructures::FT_CHAR);
+    QCOMPARE(structure.listFields.at(0).nOffset, 0);
+    QCOMPARE(structure.listFields.at(0).nCount, 4);
+    QCOMPARE(structure.listFields.at(1).type, QHexViewStructures::FT_UINT16);
+    QCOMPARE(structure.listFields.at(1).nOffset, 4);
+    QCOMPARE(structure.listFields.at(2).type, QHexViewStructures::FT_UINT32);
+    QCOMPARE(structure.listFields.at(2).nOffset, 6);
+    QCOMPARE(structure.listFields.at(3).type, QHexViewStructures::FT_DOUBLE);
+    QCOMPARE(structure.listFields.at(3).nOffset, 10);
+}
+
+void StructuresTest::parseNested()
+{
+    QString sText = "struct POINT { int16 x; int16 y; };\n"
+                    "struct SHAPE { uint8 nType; POINT origin; POINT points[2]; };\n";
+
+    QList<QHexViewStructures::STRUCT> listStructs;
+
+    QVERIFY(QHexViewStructures::parseTemplates(sText, &listStructs));
+    QCOMPARE(listStructs.count(), 2);
+
+    const QHexViewStructures::STRUCT &structure = listStructs.at(1);
+
+    QCOMPARE(structure.nSize, 13);
+    QCOMPARE(structure.listFields.count(), 7);
+    QCOMPARE(structure.listFields.at(1).sName, QString("origin.x"));
+    QCOMPARE(structure.listFields.at(1).nOffset, 1);
+    QCOMPARE(structure.listFields.at(4).sName, QString("points[0].y"));
+    QCOMPARE(structure.listFields.at(4).nOffset, 7);
+    QCOMPARE(structure.listFields.at(6).sName, QString("points[1].y"));
+    QCOMPARE(structure.listFields.at(6).nOffset, 11);
+}
+
+void StructuresTest::parseErrors_data()
+{
+    QTest::addColumn<QString>("sText");
+
+    QTest::newRow("empty") << QString("// nothing");
+    QTest::newRow("unknown type") << QString("struct A { foo a; };");
+    QTest::newRow("zero count") << QString("struct A { uint8 a[0]; };");
+    QTest::newRow("bad count") << QString("struct A { uint8 a[x]; };");
+    QTest::newRow("declaration") << QString("struct A { uint8; };");
+    // The product is above 2^31, it wrapped in qint32
+    QTest::newRow("array overflow") << QString("struct A { uint64 a[0x7FFFFFFF]; };");
+    QTest::newRow("array too large") << QString("struct A { char a[0x10000001]; };");
+    QTest::newRow("sum too large") << QString("struct A { char a[0x8000000]; char b[0x8000000]; char c; };");
+    QTest::newRow("nested too large") << QString("struct A { uint32 a[0x1000000]; }; struct B { A b[5]; };");
+    QTest::newRow("nested overflow") << QString("struct A { uint64 a[0x1000000]; }; struct B { A b[0x100]; };");
+}
+
+void StructuresTest::parseErrors()
+{
+    QFETCH(QString, sText);
+
+    QList<QHexViewStructures::STRUCT> listStructs;
+    QString sError;
+
+    QVERIFY(!QHexViewStructures::parseTemplates(sText, &listStructs, &sError));
+    QVERIFY(!sError.isEmpty());
+}
+
+void StructuresTest::spans_data()
+{
+    QTest::addColumn<qint64>("nOffset");
+    QTest::addColumn<qint64>("nSize");
+
+    QTest::newRow("all") << (qint64)0 << (qint64)0x1000;
+    QTest::newRow("before") << (qint64)0 << (qint64)0x10;
+    QTest::newRow("first byte") << (qint64)0x10 << (qint64)1;
+    QTest::newRow("inside a field") << (qint64)0x13 << (qint64)1;
+    QTest::newRow("element border") << (qint64)0x1C << (qint64)4;
+    QTest::newRow("overlapping records") << (qint64)0x40 << (qint64)0x30;
+    QTest::newRow("last byte") << (qint64)0x179 << (qint64)1;
+    QTest::newRow("after") << (qint64)0x17A << (qint64)0x100;
+}
+
+void StructuresTest::spans()
+{
+    QFETCH(qint64, nOffset);
+    QFETCH(qint64, nSize);
+
+    QList<QHexViewStructures::STRUCT> listStructs;
+
+    QVERIFY(QHexViewStructures::parseTemplates("struct A { uint16 a; uint8 b[3]; uint32 c; char d; };\n"
+                                               "struct B { A a; double b; };\n",
+                                               &listStructs));
+
+    // Ordered by offset, with records over each other
+    QList<RECORD> listRecords;
+    listRecords.append({listStructs.at(0), 0x10, 16});
+    listRecords.append({listStructs.at(1), 0x44, 4});
+    listRecords.append({listStructs.at(0), 0x50, 1});
+    listRecords.append({listStructs.at(1), 0x120, 5});
+
+    QHexViewStructures structures;
+
+    for (qint32 i = 0; i < listRecords.count(); i++) {
+        structures.addRecord(listRecords.at(i).structure, listRecords.at(i).nOffset, listRecords.at(i).nCount);
+    }
+
+    QVector<QHexViewStructures::SPAN> listSpans = structures.getSpans(nOffset, nSize);
+    QVector<QHexViewStructures::SPAN> listExpected = _getSpans(listRecords, nOffset, nSize);
+
+    QCOMPARE(listSpans.count(), listExpected.count());
+
+    for (qint32 i = 0; i < listSpans.count(); i++) {
+        QCOMPARE(listSpans.at(i).nOffset, listExpected.at(i).nOffset);
+        QCOMPARE(listSpans.at(i).nSize, listExpected.at(i).nSize);
+        QCOMPARE(listSpans.at(i).nRecord, listExpected.at(i).nRecord);
+        QCOMPARE(listSpans.at(i).nIndex, listExpected.at(i).nIndex);
+        QCOMPARE(listSpans.at(i).nField, listExpected.at(i).nField);
+    }
+}
+
+void StructuresTest::addRecordOverflow()
+{
+    QList<QHexViewStructures::STRUCT> listStructs;
+
+    QVERIFY(QHexViewStructures::parseTemplates("struct A { uint64 a; };", &listStructs));
+
+    QHexViewStructures structures;
+
+    // The end of the last element would not fit in qint64
+    structures.addRecord(listStructs.at(0), 0x10, std::numeric_limits<qint64>::max() / 8);
+    structures.addRecord(listStructs.at(0), -1, 1);
+    structures.addRecord(listStructs.at(0), 0, 0);
+
+    QVERIFY(structures.isEmpty());
+
+    // The largest count that fits
+    structures.addRecord(listStructs.at(0), 8, (std::numeric_limits<qint64>::max() - 8) / 8);
+
+    QVERIFY(!structures.isEmpty());
+    QCOMPARE(structures.getSpans(std::numeric_limits<qint64>::max() - 0x100, 0x10).count(), 3);
+}
+
+QVector<QHexViewStructures::SPAN> StructuresTest::_getSpans(const QList<RECORD> &listRecords, qint64 nOffset, qint64 nSize)
+{
+    QVector<QHexViewStructures::SPAN> listResult;
+
+    for (qint32 i = 0; i < listRecords.count(); i++) {
+        const RECORD &record = listRecords.at(i);
+
+        for (qint64 j = 0; j < record.nCount; j++) {
+            for (qint32 k = 0; k < record.structure.listFields.count(); k++) {
+                const QHexViewStructures::FIELD &field = record.structure.listFields.at(k);
+
+                QHexViewStructures::SPAN span = {};
+                span.nOffset = record.nOffset + j * record.structure.nSize + field.nOffset;
+                span.nSize = (qint64)QHexViewStructures::getTypeSize(field.type) * field.nCount;
+                span.nRecord = i;
+                span.nIndex = j;
+                span.nField = k;
+
+                if ((span.nOffset < nOffset + nSize) && (span.nOffset + span.nSize > nOffset)) {
+                    listResult.append(span);
+                }
+            }
+        }
+    }
+
+    return listResult;
+}
@@ -0,0 +1,51 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef STRUCTURESTEST_H
+#define STRUCTURESTEST_H
+
+#include <QtTest>
+
+#include "qhexviewstructures.h"
+
+class StructuresTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void parse();
+    void parseNested();
+    void parseErrors_data();
+    void parseErrors();
+    void spans_data();
+    void spans();
+    void addRecordOverflow();
+
+private:
+    struct RECORD {
+        QHexViewStructures::STRUCT structure;
+        qint64 nOffset;
+        qint64 nCount;
+    };
+
+    // Every element of every record, as getSpans() orders them
+    static QVector<QHexViewStructures::SPAN> _getSpans(const QList<RECORD> &listRecords, qint64 nOffset, qint64 nSize);
+};
+
+#endif  // STRUCTURESTEST_H
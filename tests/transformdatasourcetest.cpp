@@ -0,0 +1,206 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "transformdatasourcetest.h"
+
+#include <QBuffer>
+
+#include "qhexviewtransformdatasource.h"
+#include "transformindexprocess.h"
+
+void TransformDataSourceTest::xorKey_data()
+{
+    QTest::addColumn<QByteArray>("baKey");
+
+    // Shorter than, equal to and longer than a vector, and not dividing it
+    QTest::newRow("1") << QByteArray("\x5A", 1);
+    QTest::newRow("3") << QByteArray("key");
+    QTest::newRow("16") << QByteArray("0123456789ABCDEF");
+    QTest::newRow("17") << QByteArray("0123456789ABCDEFG");
+    QTest::newRow("100") << _getData(100);
+}
+
+void TransformDataSourceTest::xorKey()
+{
+    QFETCH(QByteArray, baKey);
+
+    QList<qint32> listSizes = {0, 1, 15, 16, 17, 63, 64, 65, 100, 1000, 4099};
+    QList<qint64> listPhases = {0, 1, 5, 0xC000};
+
+    for (qint32 i = 0; i < listSizes.count(); i++) {
+        for (qint32 j = 0; j < listPhases.count(); j++) {
+            qint32 nSize = listSizes.at(i);
+            qint64 nPhase = listPhases.at(j);
+
+            // Unaligned start
+            QByteArray baData = _getData(nSize + 1);
+            QByteArray baExpected = baData;
+
+            for (qint32 k = 0; k < nSize; k++) {
+                baExpected[k + 1] = (char)(baExpected.at(k + 1) ^ baKey.at((qint32)((nPhase + k) % baKey.size())));
+            }
+
+            QHexViewTransformDataSource::xorKey(baData.data() + 1, nSize, baKey.constData(), baKey.size(), nPhase);
+
+            QCOMPARE(baData, baExpected);
+        }
+    }
+}
+
+void TransformDataSourceTest::addValue()
+{
+    QList<qint32> listSizes = {0, 1, 15, 16, 17, 64, 1000};
+    QList<quint8> listValues = {0, 1, 0x7F, 0x80, 0xFF};
+
+    for (qint32 i = 0; i < listSizes.count(); i++) {
+        for (qint32 j = 0; j < listValues.count(); j++) {
+            QByteArray baData = _getData(listSizes.at(i) + 1);
+            QByteArray baExpected = baData;
+
+            for (qint32 k = 1; k < baExpected.size(); k++) {
+                baExpected[k] = (char)((quint8)baExpected.at(k) + listValues.at(j));
+            }
+
+            QHexViewTransformDataSource::addValue(baData.data() + 1, listSizes.at(i), listValues.at(j));
+
+            QCOMPARE(baData, baExpected);
+        }
+    }
+}
+
+void TransformDataSourceTest::rotateLeft()
+{
+    QList<qint32> listSizes = {0, 1, 15, 16, 17, 64, 1000};
+
+    for (qint32 i = 0; i < listSizes.count(); i++) {
+        for (qint32 nBits = 0; nBits < 8; nBits++) {
+            QByteArray baData = _getData(listSizes.at(i) + 1);
+            QByteArray baExpected = baData;
+
+            for (qint32 k = 1; k < baExpected.size(); k++) {
+                quint8 nByte = (quint8)baExpected.at(k);
+                baExpected[k] = (char)((quint8)(nByte << nBits) | (nByte >> ((8 - nBits) & 7)));
+            }
+
+            QHexViewTransformDataSource::rotateLeft(baData.data() + 1, listSizes.at(i), nBits);
+
+            QCOMPARE(baData, baExpected);
+        }
+    }
+}
+
+void TransformDataSourceTest::decode_data()
+{
+    QTest::addColumn<QByteArray>("baInput");
+    QTest::addColumn<QString>("sTransform");
+    QTest::addColumn<QByteArray>("baExpected");
+
+    // Larger than a decode block and an index chunk, with line breaks in between
+    QByteArray baData = _getData(0x30001);
+    QByteArray baBase64 = baData.toBase64();
+    QByteArray baLines;
+
+    for (qint32 i = 0; i < baBase64.size(); i += 76) {
+        baLines.append(baBase64.mid(i, 76));
+        baLines.append("\r\n");
+    }
+
+    QByteArray baHex = baData.toHex();
+    QByteArray baSpaced;
+
+    for (qint32 i = 0; i < baHex.size(); i += 2) {
+        baSpaced.append(baHex.mid(i, 2));
+        baSpaced.append(' ');
+    }
+
+    QTest::newRow("empty") << QByteArray() << QString("base64") << QByteArray();
+    QTest::newRow("base64") << QByteArray("TWFu") << QString("base64") << QByteArray("Man");
+    QTest::newRow("base64 padding") << QByteArray("TWE=") << QString("base64") << QByteArray("Ma");
+    QTest::newRow("base64 url") << QByteArray("-_-_") << QString("base64") << QByteArray::fromBase64("+/+/");
+    QTest::newRow("base64 lines") << baLines << QString("base64") << baData;
+    QTest::newRow("hex") << QByteArray("4D 61 6e") << QString("hex") << QByteArray("Man");
+    QTest::newRow("hex spaced") << baSpaced << QString("hex") << baData;
+}
+
+void TransformDataSourceTest::decode()
+{
+    QFETCH(QByteArray, baInput);
+    QFETCH(QString, sTransform);
+    QFETCH(QByteArray, baExpected);
+
+    QCOMPARE(_decode(baInput, 0, baInput.size(), sTransform), baExpected);
+}
+
+void TransformDataSourceTest::decodeInRange()
+{
+    // Only the selection is decoded, the rest of the source is not part of it
+    QByteArray baInput = "####TWFu####";
+
+    QCOMPARE(_decode(baInput, 4, 4, "base64"), QByteArray("Man"));
+}
+
+QByteArray TransformDataSourceTest::_getData(qint32 nSize)
+{
+    QByteArray baResult(nSize, 0);
+
+    // Fixed sequence, the same on every run
+    quint32 nValue = 0x2545F491;
+
+    for (qint32 i = 0; i < nSize; i++) {
+        nValue = nValue * 1103515245 + 12345;
+        baResult[i] = (char)(nValue >> 16);
+    }
+
+    return baResult;
+}
+
+QByteArray TransformDataSourceTest::_decode(const QByteArray &baInput, qint64 nOffset, qint64 nSize, const QString &sTransform)
+{
+    QByteArray baResult;
+
+    QBuffer buffer;
+    buffer.setData(baInput);
+
+    QHexViewBufferDataSource source(&buffer);
+
+    QList<QHexViewTransformDataSource::TRANSFORM> listTransforms;
+
+    if (QHexViewTransformDataSource::parseTransforms(sTransform, &listTransforms)) {
+        QHexViewTransformDataSource transform(&source, nOffset, nSize, listTransforms.at(0));
+
+        TransformIndexProcess indexProcess;
+        indexProcess.setData(&source, nOffset, nSize, listTransforms.at(0).type);
+        indexProcess.process();
+
+        if (indexProcess.isSuccess()) {
+            transform.setIndex(indexProcess.getResult());
+
+            baResult.resize((qint32)transform.getSize());
+
+            if (baResult.size()) {
+                qint64 nRead = transform.readAt(0, baResult.data(), baResult.size());
+
+                baResult.resize((qint32)qMax(nRead, (qint64)0));
+            }
+        }
+    }
+
+    return baResult;
+}
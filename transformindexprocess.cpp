@@ -0,0 +1,93 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "transformindexprocess.h"
+
+TransformIndexProcess::TransformIndexProcess(QObject *pParent) : HexProcess(pParent)
+{
+    g_pDataSource = nullptr;
+    g_nOffset = 0;
+    g_nSize = 0;
+    g_type = QHexViewTransformDataSource::TT_NONE;
+}
+
+void TransformIndexProcess::setData(QHexViewDataSource *pDataSource, qint64 nOffset, qint64 nSize, QHexViewTransformDataSource::TT type)
+{
+    g_pDataSource = pDataSource;
+    g_nOffset = nOffset;
+    g_nSize = nSize;
+    g_type = type;
+    g_listChunkChars.clear();
+}
+
+QVector<qint64> TransformIndexProcess::getResult()
+{
+    return g_listChunkChars;
+}
+
+bool TransformIndexProcess::_process()
+{
+    bool bResult = false;
+
+    if (openSource(g_pDataSource)) {
+        setTotal(g_nSize);
+        setStatus(tr("Index"));
+
+        const qint64 nChunkSize = QHexViewTransformDataSource::N_INDEX_CHUNK_SIZE;
+
+        QByteArray baChunk(nChunkSize, 0);
+
+        qint64 nNumberOfChars = 0;
+        qint64 nCurrent = 0;
+
+        g_listChunkChars.clear();
+
+        while ((nCurrent < g_nSize) && (!isStopped())) {
+            g_listChunkChars.append(nNumberOfChars);
+
+            qint64 nSize = qMin(nChunkSize, g_nSize - nCurrent);
+
+            if (readAt(g_nOffset + nCurrent, baChunk.data(), nSize) != nSize) {
+                break;
+            }
+
+            nNumberOfChars += QHexViewTransformDataSource::countChars(baChunk.constData(), nSize, g_type);
+            nCurrent += nSize;
+
+            setCurrent(nCurrent);
+        }
+
+        if (nCurrent >= g_nSize) {
+            g_listChunkChars.append(nNumberOfChars);
+
+            bResult = true;
+        } else {
+            g_listChunkChars.clear();
+
+            if (!isStopped()) {
+                emit errorMessage(QString("%1: 0x%2").arg(tr("Cannot read"), QString::number(g_nOffset + nCurrent, 16)));
+            }
+        }
+
+        closeSource();
+    }
+
+    return bResult;
+}
@@ -0,0 +1,47 @@
+// copyright (c) 2019-2026 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef TRANSFORMINDEXPROCESS_H
+#define TRANSFORMINDEXPROCESS_H
+
+#include "hexprocess.h"
+#include "qhexviewtransformdatasource.h"
+
+// Counts the base64 or hex characters of the input for QHexViewTransformDataSource::setIndex
+class TransformIndexProcess : public HexProcess {
+    Q_OBJECT
+
+public:
+    explicit TransformIndexProcess(QObject *pParent = nullptr);
+    void setData(QHexViewDataSource *pDataSource, qint64 nOffset, qint64 nSize, QHexViewTransformDataSource::TT type);
+    QVector<qint64> getResult();
+
+protected:
+    bool _process() override;
+
+private:
+    QHexViewDataSource *g_pDataSource;
+    qint64 g_nOffset;
+    qint64 g_nSize;
+    QHexViewTransformDataSource::TT g_type;
+    QVector<qint64> g_listChunkChars;
+};
+
+#endif  // TRANSFORMINDEXPROCESS_H